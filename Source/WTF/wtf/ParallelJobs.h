@@ -48,6 +48,9 @@
 //     // Execute parallel jobs
 //     parallelJobs.execute();
 //
+// The number of jobs is not limited to the number of cores. Splitting the work into
+// more, smaller jobs than there are threads lets the backend balance uneven work.
+//
 
 #if ENABLE(THREADING_GENERIC)
 #include <wtf/ParallelJobsGeneric.h>
@@ -30,112 +30,356 @@
 #if ENABLE(THREADING_GENERIC)
 
 #include "ParallelJobs.h"
+#include <atomic>
+#include <mutex>
+#include <wtf/CurrentTime.h>
+#include <wtf/Deque.h>
 #include <wtf/NumberOfCores.h>
+#include <wtf/ThreadSpecific.h>
+#include <wtf/Threading.h>
 
 namespace WTF {
 
-Vector< RefPtr<ParallelEnvironment::ThreadPrivate> >* ParallelEnvironment::s_threadPool = 0;
+// All parallel jobs in the process are run by one pool of numberOfProcessorCores() - 1 worker
+// threads. The pool is created on first use and lives until the process exits. The thread that
+// calls execute() works on the jobs too.
+//
+// Every worker owns a deque of job ranges. The owner takes one job at a time from the front.
+// A thread that runs out of work steals the back half of the last range in another deque, so
+// large ranges are split up only when some thread is actually idle. Threads that are not pool
+// workers submit to one extra shared deque.
+//
+// A job may call execute() itself. The calling thread then keeps running jobs, its own or
+// stolen ones, until the nested batch is done, so nested parallelism never blocks a worker.
 
-ParallelEnvironment::ParallelEnvironment(ThreadFunction threadFunction, size_t sizeOfParameter, int requestedJobNumber) :
-    m_threadFunction(threadFunction),
-    m_sizeOfParameter(sizeOfParameter)
-{
-    ASSERT_ARG(requestedJobNumber, requestedJobNumber >= 1);
+static const int maximumJobsPerCore = 4;
+
+static std::atomic<bool> collectsStatistics(false);
+
+struct ParallelJobBatch {
+    ParallelEnvironment::ThreadFunction threadFunction;
+    unsigned char* parameters;
+    size_t sizeOfParameter;
+    std::atomic<int> remainingJobs;
+};
+
+struct ParallelJobRange {
+    ParallelJobBatch* batch;
+    int begin;
+    int end;
+};
 
-    int maxNumberOfCores = numberOfProcessorCores();
+class ParallelJobQueue {
+    WTF_MAKE_NONCOPYABLE(ParallelJobQueue); WTF_MAKE_FAST_ALLOCATED;
+public:
+    ParallelJobQueue() { }
 
-    if (!requestedJobNumber || requestedJobNumber > maxNumberOfCores)
-        requestedJobNumber = static_cast<unsigned>(maxNumberOfCores);
+    void append(const ParallelJobRange& range)
+    {
+        MutexLocker locker(m_mutex);
+        m_ranges.append(range);
+    }
 
-    if (!s_threadPool)
-        s_threadPool = new Vector< RefPtr<ThreadPrivate> >();
+    bool takeFirstJob(ParallelJobRange& job)
+    {
+        MutexLocker locker(m_mutex);
+        if (m_ranges.isEmpty())
+            return false;
 
-    // The main thread should be also a worker.
-    int maxNumberOfNewThreads = requestedJobNumber - 1;
+        ParallelJobRange& first = m_ranges.first();
+        job.batch = first.batch;
+        job.begin = first.begin;
+        job.end = first.begin + 1;
+        if (++first.begin == first.end)
+            m_ranges.removeFirst();
+        return true;
+    }
 
-    for (int i = 0; i < maxNumberOfCores && m_threads.size() < static_cast<unsigned>(maxNumberOfNewThreads); ++i) {
-        if (s_threadPool->size() < static_cast<unsigned>(i) + 1U)
-            s_threadPool->append(ThreadPrivate::create());
+    bool stealHalf(ParallelJobRange& stolen)
+    {
+        MutexLocker locker(m_mutex);
+        if (m_ranges.isEmpty())
+            return false;
 
-        if ((*s_threadPool)[i]->tryLockFor(this))
-            m_threads.append((*s_threadPool)[i]);
+        ParallelJobRange& last = m_ranges.last();
+        int count = (last.end - last.begin + 1) / 2;
+        stolen.batch = last.batch;
+        stolen.begin = last.end - count;
+        stolen.end = last.end;
+        last.end -= count;
+        if (last.begin == last.end)
+            m_ranges.removeLast();
+        return true;
     }
 
-    m_numberOfJobs = m_threads.size() + 1;
+private:
+    Mutex m_mutex;
+    Deque<ParallelJobRange> m_ranges;
+};
+
+class ParallelWorkerPool {
+    WTF_MAKE_NONCOPYABLE(ParallelWorkerPool); WTF_MAKE_FAST_ALLOCATED;
+public:
+    static ParallelWorkerPool& shared();
+
+    void execute(ParallelJobBatch&, int numberOfJobs);
+
+    ParallelEnvironment::Statistics statistics()
+    {
+        MutexLocker locker(m_statisticsMutex);
+        return m_statistics;
+    }
+
+    void resetStatistics()
+    {
+        MutexLocker locker(m_statisticsMutex);
+        m_statistics = ParallelEnvironment::Statistics();
+    }
+
+private:
+    struct WorkerContext {
+        ParallelWorkerPool* pool;
+        unsigned queueIndex;
+    };
+
+    ParallelWorkerPool();
+
+    static void workerThread(void*);
+    void runWorker(unsigned queueIndex);
+
+    unsigned currentQueueIndex();
+    bool takeJob(unsigned queueIndex, ParallelJobRange&);
+    void runJob(const ParallelJobRange&);
+
+    unsigned currentGeneration();
+    void notifyWorkAvailable();
+    void waitForWork(unsigned generation);
+
+    // One queue per worker, followed by the queue shared by all other threads.
+    Vector<std::unique_ptr<ParallelJobQueue>> m_queues;
+    unsigned m_sharedQueueIndex;
+
+    // Holds queueIndex + 1 on worker threads and 0 everywhere else. Leaked with the pool.
+    ThreadSpecific<unsigned>* m_workerQueueIndex;
+
+    Mutex m_mutex;
+    ThreadCondition m_condition;
+    unsigned m_generation;
+
+    Mutex m_statisticsMutex;
+    ParallelEnvironment::Statistics m_statistics;
+};
+
+ParallelWorkerPool& ParallelWorkerPool::shared()
+{
+    static ParallelWorkerPool* pool;
+    static std::once_flag onceFlag;
+    std::call_once(onceFlag, [] {
+        pool = new ParallelWorkerPool;
+    });
+    return *pool;
 }
 
-void ParallelEnvironment::execute(void* parameters)
+ParallelWorkerPool::ParallelWorkerPool()
+    : m_sharedQueueIndex(std::max(numberOfProcessorCores() - 1, 0))
+    , m_workerQueueIndex(new ThreadSpecific<unsigned>)
+    , m_generation(0)
 {
-    unsigned char* currentParameter = static_cast<unsigned char*>(parameters);
-    size_t i;
-    for (i = 0; i < m_threads.size(); ++i) {
-        m_threads[i]->execute(m_threadFunction, currentParameter);
-        currentParameter += m_sizeOfParameter;
+    for (unsigned i = 0; i <= m_sharedQueueIndex; ++i)
+        m_queues.append(std::make_unique<ParallelJobQueue>());
+
+    // A worker that fails to start leaves its queue empty; only the owner appends to it.
+    for (unsigned i = 0; i < m_sharedQueueIndex; ++i) {
+        WorkerContext* context = new WorkerContext;
+        context->pool = this;
+        context->queueIndex = i;
+        if (!createThread(&ParallelWorkerPool::workerThread, context, "Parallel worker"))
+            delete context;
     }
+}
+
+void ParallelWorkerPool::workerThread(void* data)
+{
+    WorkerContext* context = static_cast<WorkerContext*>(data);
+    ParallelWorkerPool* pool = context->pool;
+    unsigned queueIndex = context->queueIndex;
+    delete context;
 
-    // The work for the main thread.
-    (*m_threadFunction)(currentParameter);
+    **pool->m_workerQueueIndex = queueIndex + 1;
+    pool->runWorker(queueIndex);
+}
 
-    // Wait until all jobs are done.
-    for (i = 0; i < m_threads.size(); ++i)
-        m_threads[i]->waitForFinish();
+void ParallelWorkerPool::runWorker(unsigned queueIndex)
+{
+    while (true) {
+        unsigned generation = currentGeneration();
+        ParallelJobRange job;
+        if (takeJob(queueIndex, job)) {
+            runJob(job);
+            continue;
+        }
+        waitForWork(generation);
+    }
 }
 
-bool ParallelEnvironment::ThreadPrivate::tryLockFor(ParallelEnvironment* parent)
+unsigned ParallelWorkerPool::currentQueueIndex()
 {
-    bool locked = m_mutex.tryLock();
+    unsigned workerQueueIndex = **m_workerQueueIndex;
+    return workerQueueIndex ? workerQueueIndex - 1 : m_sharedQueueIndex;
+}
+
+bool ParallelWorkerPool::takeJob(unsigned queueIndex, ParallelJobRange& job)
+{
+    if (m_queues[queueIndex]->takeFirstJob(job))
+        return true;
 
-    if (!locked)
-        return false;
+    for (unsigned i = 1; i < m_queues.size(); ++i) {
+        unsigned victimIndex = (queueIndex + i) % m_queues.size();
+        ParallelJobRange stolen;
+        if (!m_queues[victimIndex]->stealHalf(stolen))
+            continue;
 
-    if (m_parent) {
-        m_mutex.unlock();
-        return false;
-    }
+        // Run the first stolen job now and leave the rest where other threads can steal them.
+        if (stolen.end - stolen.begin > 1) {
+            ParallelJobRange rest = { stolen.batch, stolen.begin + 1, stolen.end };
+            m_queues[queueIndex]->append(rest);
+            notifyWorkAvailable();
+        }
 
-    if (!m_threadID)
-        m_threadID = createThread(&ParallelEnvironment::ThreadPrivate::workerThread, this, "Parallel worker");
+        job.batch = stolen.batch;
+        job.begin = stolen.begin;
+        job.end = stolen.begin + 1;
 
-    if (m_threadID)
-        m_parent = parent;
+        if (collectsStatistics.load(std::memory_order_relaxed)) {
+            MutexLocker locker(m_statisticsMutex);
+            m_statistics.stolenJobCount++;
+        }
+        return true;
+    }
 
-    m_mutex.unlock();
-    return m_threadID;
+    return false;
 }
 
-void ParallelEnvironment::ThreadPrivate::execute(ThreadFunction threadFunction, void* parameters)
+void ParallelWorkerPool::runJob(const ParallelJobRange& job)
 {
-    MutexLocker lock(m_mutex);
+    ParallelJobBatch* batch = job.batch;
+    ASSERT(job.end == job.begin + 1);
+
+    if (!collectsStatistics.load(std::memory_order_relaxed))
+        (*batch->threadFunction)(batch->parameters + job.begin * batch->sizeOfParameter);
+    else {
+        double startTime = monotonicallyIncreasingTime();
+        (*batch->threadFunction)(batch->parameters + job.begin * batch->sizeOfParameter);
+        double jobTime = monotonicallyIncreasingTime() - startTime;
+
+        MutexLocker locker(m_statisticsMutex);
+        m_statistics.jobCount++;
+        m_statistics.totalJobTime += jobTime;
+        m_statistics.longestJobTime = std::max(m_statistics.longestJobTime, jobTime);
+    }
 
-    m_threadFunction = threadFunction;
-    m_parameters = parameters;
-    m_running = true;
-    m_threadCondition.signal();
+    // The batch lives on the stack of the thread that called execute(), which returns as soon
+    // as the count reaches zero. The batch must not be touched after the decrement.
+    if (!--batch->remainingJobs)
+        notifyWorkAvailable();
 }
 
-void ParallelEnvironment::ThreadPrivate::waitForFinish()
+unsigned ParallelWorkerPool::currentGeneration()
 {
-    MutexLocker lock(m_mutex);
+    MutexLocker locker(m_mutex);
+    return m_generation;
+}
 
-    while (m_running)
-        m_threadCondition.wait(m_mutex);
+void ParallelWorkerPool::notifyWorkAvailable()
+{
+    MutexLocker locker(m_mutex);
+    ++m_generation;
+    m_condition.broadcast();
 }
 
-void ParallelEnvironment::ThreadPrivate::workerThread(void* threadData)
+void ParallelWorkerPool::waitForWork(unsigned generation)
 {
-    ThreadPrivate* sharedThread = reinterpret_cast<ThreadPrivate*>(threadData);
-    MutexLocker lock(sharedThread->m_mutex);
+    MutexLocker locker(m_mutex);
+    while (m_generation == generation)
+        m_condition.wait(m_mutex);
+}
 
-    while (sharedThread->m_threadID) {
-        if (sharedThread->m_running) {
-            (*sharedThread->m_threadFunction)(sharedThread->m_parameters);
-            sharedThread->m_running = false;
-            sharedThread->m_parent = 0;
-            sharedThread->m_threadCondition.signal();
+void ParallelWorkerPool::execute(ParallelJobBatch& batch, int numberOfJobs)
+{
+    unsigned queueIndex = currentQueueIndex();
+    bool collectingStatistics = collectsStatistics.load(std::memory_order_relaxed);
+    double startTime = collectingStatistics ? monotonicallyIncreasingTime() : 0;
+
+    ParallelJobRange range = { &batch, 0, numberOfJobs };
+    m_queues[queueIndex]->append(range);
+    notifyWorkAvailable();
+
+    while (batch.remainingJobs.load()) {
+        unsigned generation = currentGeneration();
+        ParallelJobRange job;
+        if (takeJob(queueIndex, job)) {
+            runJob(job);
+            continue;
         }
 
-        sharedThread->m_threadCondition.wait(sharedThread->m_mutex);
+        // Everything left is running on other threads. Completing a batch bumps the generation.
+        if (batch.remainingJobs.load())
+            waitForWork(generation);
     }
+
+    if (collectingStatistics) {
+        MutexLocker locker(m_statisticsMutex);
+        m_statistics.executeCount++;
+        if (queueIndex != m_sharedQueueIndex)
+            m_statistics.nestedExecuteCount++;
+        m_statistics.totalExecuteTime += monotonicallyIncreasingTime() - startTime;
+    }
+}
+
+ParallelEnvironment::ParallelEnvironment(ThreadFunction threadFunction, size_t sizeOfParameter, int requestedJobNumber)
+    : m_threadFunction(threadFunction)
+    , m_sizeOfParameter(sizeOfParameter)
+{
+    ASSERT_ARG(requestedJobNumber, requestedJobNumber >= 1);
+
+    // More jobs than cores are allowed so that uneven work can be balanced by stealing.
+    int maxNumberOfJobs = numberOfProcessorCores() * maximumJobsPerCore;
+
+    if (requestedJobNumber < 1 || requestedJobNumber > maxNumberOfJobs)
+        requestedJobNumber = maxNumberOfJobs;
+
+    m_numberOfJobs = requestedJobNumber;
+}
+
+void ParallelEnvironment::execute(void* parameters)
+{
+    if (m_numberOfJobs == 1) {
+        (*m_threadFunction)(parameters);
+        return;
+    }
+
+    ParallelJobBatch batch;
+    batch.threadFunction = m_threadFunction;
+    batch.parameters = static_cast<unsigned char*>(parameters);
+    batch.sizeOfParameter = m_sizeOfParameter;
+    batch.remainingJobs = m_numberOfJobs;
+
+    ParallelWorkerPool::shared().execute(batch, m_numberOfJobs);
+}
+
+void ParallelEnvironment::setCollectsStatistics(bool enabled)
+{
+    collectsStatistics = enabled;
+}
+
+ParallelEnvironment::Statistics ParallelEnvironment::statistics()
+{
+    return ParallelWorkerPool::shared().statistics();
+}
+
+void ParallelEnvironment::resetStatistics()
+{
+    ParallelWorkerPool::shared().resetStatistics();
 }
 
 } // namespace WTF
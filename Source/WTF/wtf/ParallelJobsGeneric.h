@@ -30,13 +30,15 @@
 
 #if ENABLE(THREADING_GENERIC)
 
-#include <wtf/RefCounted.h>
-#include <wtf/Threading.h>
+#include <wtf/Noncopyable.h>
 
 namespace WTF {
 
+// Jobs are run by a process-wide work-stealing pool; see ParallelJobsGeneric.cpp.
+// The number of jobs may exceed the number of cores, so callers can split their
+// work into small tiles and let idle threads pick up the remaining ones.
 class ParallelEnvironment {
-    WTF_MAKE_FAST_ALLOCATED;
+    WTF_MAKE_NONCOPYABLE(ParallelEnvironment); WTF_MAKE_FAST_ALLOCATED;
 public:
     typedef void (*ThreadFunction)(void*);
 
@@ -49,47 +51,36 @@ public:
 
     WTF_EXPORT_PRIVATE void execute(void* parameters);
 
-    class ThreadPrivate : public RefCounted<ThreadPrivate> {
-    public:
-        ThreadPrivate()
-            : m_threadID(0)
-            , m_running(false)
-            , m_parent(0)
+    struct Statistics {
+        Statistics()
+            : executeCount(0)
+            , nestedExecuteCount(0)
+            , jobCount(0)
+            , stolenJobCount(0)
+            , totalExecuteTime(0)
+            , totalJobTime(0)
+            , longestJobTime(0)
         {
         }
 
-        bool tryLockFor(ParallelEnvironment*);
-
-        void execute(ThreadFunction, void*);
-
-        void waitForFinish();
-
-        static PassRefPtr<ThreadPrivate> create()
-        {
-            return adoptRef(new ThreadPrivate());
-        }
-
-        static void workerThread(void*);
-
-    private:
-        ThreadIdentifier m_threadID;
-        bool m_running;
-        ParallelEnvironment* m_parent;
-
-        mutable Mutex m_mutex;
-        ThreadCondition m_threadCondition;
-
-        ThreadFunction m_threadFunction;
-        void* m_parameters;
+        unsigned executeCount;
+        unsigned nestedExecuteCount;
+        unsigned jobCount;
+        unsigned stolenJobCount;
+        double totalExecuteTime;
+        double totalJobTime;
+        double longestJobTime;
     };
 
+    // Timing every job has a cost, so statistics are only gathered once enabled.
+    WTF_EXPORT_PRIVATE static void setCollectsStatistics(bool);
+    WTF_EXPORT_PRIVATE static Statistics statistics();
+    WTF_EXPORT_PRIVATE static void resetStatistics();
+
 private:
     ThreadFunction m_threadFunction;
     size_t m_sizeOfParameter;
     int m_numberOfJobs;
-
-    Vector< RefPtr<ThreadPrivate> > m_threads;
-    static Vector< RefPtr<ThreadPrivate> >* s_threadPool;
 };
 
 } // namespace WTF
@@ -45,13 +45,14 @@ public:
     {
         int maxNumberOfThreads = omp_get_max_threads();
 
-        if (!requestedJobNumber || requestedJobNumber > maxNumberOfThreads)
-            requestedJobNumber = maxNumberOfThreads;
+        // Allow more jobs than threads so that uneven work is balanced by the dynamic schedule.
+        if (!requestedJobNumber || requestedJobNumber > maxNumberOfThreads * 4)
+            requestedJobNumber = maxNumberOfThreads * 4;
 
         ASSERT(requestedJobNumber > 0);
 
         m_numberOfJobs = requestedJobNumber;
-
+        m_numberOfThreads = std::min(requestedJobNumber, maxNumberOfThreads);
     }
 
     int numberOfJobs()
@@ -61,9 +62,9 @@ public:
 
     void execute(unsigned char* parameters)
     {
-        omp_set_num_threads(m_numberOfJobs);
+        omp_set_num_threads(m_numberOfThreads);
 
-#pragma omp parallel for
+#pragma omp parallel for schedule(dynamic)
         for (int i = 0; i < m_numberOfJobs; ++i)
             (*m_threadFunction)(parameters + i * m_sizeOfParameter);
     }
@@ -72,6 +73,7 @@ private:
     ThreadFunction m_threadFunction;
     size_t m_sizeOfParameter;
     int m_numberOfJobs;
+    int m_numberOfThreads;
 };
 
 } // namespace WTF
@@ -333,6 +333,11 @@
 
 #endif /* ARM */
 
+#if CPU(X86_64) || (CPU(X86) && (defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+// All SSE2 intrinsics usage can be disabled by this macro.
+#define HAVE_SSE2_INTRINSICS 1
+#endif
+
 #if CPU(ARM) || CPU(MIPS) || CPU(SH4)
 #define WTF_CPU_NEEDS_ALIGNED_ACCESS 1
 #endif
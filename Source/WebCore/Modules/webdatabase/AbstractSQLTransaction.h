@@ -45,6 +45,7 @@ public:
     virtual bool hasCallback() const = 0;
     virtual bool hasSuccessCallback() const = 0;
     virtual bool hasErrorCallback() const = 0;
+    virtual bool pipelinesStatements() const = 0;
     virtual void setBackend(AbstractSQLTransactionBackend*) = 0;
 };
 
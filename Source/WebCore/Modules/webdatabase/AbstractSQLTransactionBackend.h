@@ -49,6 +49,12 @@ public:
     virtual AbstractSQLStatement* currentStatement() = 0;
     virtual void setShouldRetryCurrentStatement(bool) = 0;
 
+    // In pipelined mode, the statements with callbacks from the last batch the backend ran, in order,
+    // and the state to go to once their callbacks have been delivered.
+    virtual size_t completedStatementCount() = 0;
+    virtual AbstractSQLStatement* completedStatement(size_t index) = 0;
+    virtual SQLTransactionState stateAfterCompletedStatementCallbacks() = 0;
+
     virtual void executeSQL(std::unique_ptr<AbstractSQLStatement>, const String& statement,
         const Vector<SQLValue>& arguments, int permissions) = 0;
 
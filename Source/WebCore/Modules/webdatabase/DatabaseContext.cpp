@@ -229,6 +229,16 @@ bool DatabaseContext::allowDatabaseAccess() const
     return true;
 }
 
+bool DatabaseContext::pipelinesTransactionStatements() const
+{
+    if (m_scriptExecutionContext->isDocument()) {
+        Document* document = toDocument(m_scriptExecutionContext);
+        return document->settings() && document->settings()->pipelinedSQLTransactionsEnabled();
+    }
+    ASSERT(m_scriptExecutionContext->isWorkerGlobalScope());
+    return false;
+}
+
 void DatabaseContext::databaseExceededQuota(const String& name, DatabaseDetails details)
 {
     if (m_scriptExecutionContext->isDocument()) {
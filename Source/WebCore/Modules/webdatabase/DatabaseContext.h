@@ -64,6 +64,7 @@ public:
     bool stopDatabases(DatabaseTaskSynchronizer*);
 
     bool allowDatabaseAccess() const;
+    bool pipelinesTransactionStatements() const;
     void databaseExceededQuota(const String& name, DatabaseDetails);
 
 private:
@@ -65,6 +65,7 @@ SQLTransaction::SQLTransaction(Database* db, PassRefPtr<SQLTransactionCallback>
     , m_errorCallbackWrapper(errorCallback, db->scriptExecutionContext())
     , m_executeSqlAllowed(false)
     , m_readOnly(readOnly)
+    , m_pipelinesStatements(db->databaseContext()->pipelinesTransactionStatements())
 {
     ASSERT(m_database);
 }
@@ -84,6 +85,11 @@ bool SQLTransaction::hasErrorCallback() const
     return m_errorCallbackWrapper.hasCallback();
 }
 
+bool SQLTransaction::pipelinesStatements() const
+{
+    return m_pipelinesStatements;
+}
+
 void SQLTransaction::setBackend(AbstractSQLTransactionBackend* backend)
 {
     ASSERT(!m_backend);
@@ -183,6 +189,9 @@ SQLTransactionState SQLTransaction::deliverTransactionErrorCallback()
 
 SQLTransactionState SQLTransaction::deliverStatementCallback()
 {
+    if (m_pipelinesStatements)
+        return deliverCompletedStatementCallbacks();
+
     // Spec 4.3.2.6.6 and 4.3.2.6.3: If the statement callback went wrong, jump to the transaction error callback
     // Otherwise, continue to loop through the statement queue
     m_executeSqlAllowed = true;
@@ -202,6 +211,30 @@ SQLTransactionState SQLTransaction::deliverStatementCallback()
     return SQLTransactionState::RunStatements;
 }
 
+SQLTransactionState SQLTransaction::deliverCompletedStatementCallbacks()
+{
+    // The backend is idle until we transit to its next state, so the completed statements can be read without a lock.
+    // Statements queued by these callbacks are appended to the statement queue, after those that already ran.
+    m_executeSqlAllowed = true;
+
+    size_t statementCount = m_backend->completedStatementCount();
+    ASSERT(statementCount);
+    for (size_t i = 0; i < statementCount; ++i) {
+        SQLStatement* statement = static_cast<SQLStatement*>(m_backend->completedStatement(i));
+        if (statement->performCallback(this)) {
+            m_executeSqlAllowed = false;
+            m_transactionError = SQLError::create(SQLError::UNKNOWN_ERR, "the statement callback raised an exception or statement error callback did not return false");
+            return nextStateForTransactionError();
+        }
+    }
+
+    m_executeSqlAllowed = false;
+
+    // The batch stopped for a quota increase, a transaction error, or because the statement queue ran dry.
+    // In the last case, go back to the backend to run what the callbacks queued or to commit.
+    return m_backend->stateAfterCompletedStatementCallbacks();
+}
+
 SQLTransactionState SQLTransaction::deliverQuotaIncreaseCallback()
 {
     ASSERT(m_backend->currentStatement());
@@ -75,6 +75,7 @@ private:
     virtual bool hasCallback() const override;
     virtual bool hasSuccessCallback() const override;
     virtual bool hasErrorCallback() const override;
+    virtual bool pipelinesStatements() const override;
     virtual void setBackend(AbstractSQLTransactionBackend*) override;
 
     // State Machine functions:
@@ -85,6 +86,7 @@ private:
     SQLTransactionState deliverTransactionCallback();
     SQLTransactionState deliverTransactionErrorCallback();
     SQLTransactionState deliverStatementCallback();
+    SQLTransactionState deliverCompletedStatementCallbacks();
     SQLTransactionState deliverQuotaIncreaseCallback();
     SQLTransactionState deliverSuccessCallback();
 
@@ -103,6 +105,7 @@ private:
     RefPtr<SQLError> m_transactionError;
 
     bool m_readOnly;
+    bool m_pipelinesStatements;
 };
 
 } // namespace WebCore
@@ -129,7 +129,8 @@
 //     6. SQLTransactionState::RunStatements (runs in backend)
 //         - while there are statements {
 //             - run a statement.
-//             - if statementCallback is available, goto SQLTransactionState::DeliverStatementCallback.
+//             - if statementCallback is available, goto SQLTransactionState::DeliverStatementCallback,
+//               or in pipelined mode, remember the statement and keep going.
 //             - on error,
 //               goto SQLTransactionState::DeliverQuotaIncreaseCallback, or
 //               goto SQLTransactionState::DeliverStatementCallback, or
@@ -141,6 +142,8 @@
 //         - invoke script statement callback (assume available).
 //         - on error, goto SQLTransactionState::DeliverTransactionErrorCallback.
 //         - goto SQLTransactionState::RunStatements.
+//         - in pipelined mode, invoke the callbacks of all the remembered statements,
+//           then goto the state RunStatements stopped for.
 //
 //     8. SQLTransactionState::DeliverQuotaIncreaseCallback (runs in frontend)
 //         - give client a chance to increase the quota.
@@ -231,6 +234,28 @@
 // to wait for further action.
 
 
+// Pipelined transactions
+// ======================
+// Normally, RunStatements stops after every statement that has a callback and
+// waits for the frontend to deliver it. A transaction that queues thousands of
+// statements with callbacks then makes thousands of round trips between the
+// database thread and the script thread.
+//
+// When the pipelinedSQLTransactionsEnabled setting is on, RunStatements keeps
+// going instead, running the queued statements back to back in the same SQLite
+// transaction and collecting those with callbacks. It stops when the queue is
+// empty, a statement exceeds the quota, or a statement error ends the
+// transaction. If it collected any statements, it goes to
+// DeliverStatementCallback, and the frontend delivers all their callbacks in
+// order before going where the backend stopped: DeliverQuotaIncreaseCallback,
+// the transaction error states, or back to RunStatements to run the statements
+// the callbacks queued (or commit if there are none).
+//
+// Callbacks can only append statements to the queue, so statements still run
+// in the order they were queued. A callback that fails rolls back the whole
+// transaction, which undoes the statements that ran ahead of it too.
+
+
 // The Life-Cycle of a SQLTransaction i.e. Who's keeping the SQLTransaction alive? 
 // ==============================================================================
 // The RefPtr chain goes something like this:
@@ -363,6 +388,8 @@ SQLTransactionBackend::SQLTransactionBackend(DatabaseBackend* db,
     , m_lockAcquired(false)
     , m_readOnly(readOnly)
     , m_hasVersionMismatch(false)
+    , m_pipelinesStatements(m_frontend->pipelinesStatements())
+    , m_stateAfterCompletedStatementCallbacks(SQLTransactionState::Idle)
 {
     ASSERT(m_database);
     m_frontend->setBackend(this);
@@ -442,6 +469,21 @@ void SQLTransactionBackend::setShouldRetryCurrentStatement(bool shouldRetry)
     m_shouldRetryCurrentStatement = shouldRetry;
 }
 
+size_t SQLTransactionBackend::completedStatementCount()
+{
+    return m_completedStatementBackends.size();
+}
+
+AbstractSQLStatement* SQLTransactionBackend::completedStatement(size_t index)
+{
+    return m_completedStatementBackends[index]->frontend();
+}
+
+SQLTransactionState SQLTransactionBackend::stateAfterCompletedStatementCallbacks()
+{
+    return m_stateAfterCompletedStatementCallbacks;
+}
+
 SQLTransactionBackend::StateFunction SQLTransactionBackend::stateFunctionFor(SQLTransactionState state)
 {
     static const StateFunction stateFunctions[] = {
@@ -636,6 +678,9 @@ SQLTransactionState SQLTransactionBackend::runStatements()
     ASSERT(m_lockAcquired);
     SQLTransactionState nextState;
 
+    // In pipelined mode, the frontend has delivered the callbacks of the previous batch by now.
+    m_completedStatementBackends.clear();
+
     // If there is a series of statements queued up that are all successful and have no associated
     // SQLStatementCallback objects, then we can burn through the queue
     do {
@@ -660,9 +705,20 @@ SQLTransactionState SQLTransactionBackend::runStatements()
             getNextStatement();
         }
         nextState = runCurrentStatementAndGetNextState();
+
+        // In pipelined mode, hold on to the callback and keep going.
+        if (m_pipelinesStatements && nextState == SQLTransactionState::DeliverStatementCallback) {
+            m_completedStatementBackends.append(m_currentStatementBackend);
+            nextState = SQLTransactionState::RunStatements;
+        }
     } while (nextState == SQLTransactionState::RunStatements);
 
-    return nextState;
+    if (m_completedStatementBackends.isEmpty())
+        return nextState;
+
+    // The callbacks may queue more statements, so come back here rather than commit once they have run.
+    m_stateAfterCompletedStatementCallbacks = nextState == SQLTransactionState::PostflightAndCommit ? SQLTransactionState::RunStatements : nextState;
+    return SQLTransactionState::DeliverStatementCallback;
 }
 
 void SQLTransactionBackend::getNextStatement()
@@ -86,6 +86,9 @@ private:
     virtual PassRefPtr<SQLError> transactionError() override;
     virtual AbstractSQLStatement* currentStatement() override;
     virtual void setShouldRetryCurrentStatement(bool) override;
+    virtual size_t completedStatementCount() override;
+    virtual AbstractSQLStatement* completedStatement(size_t index) override;
+    virtual SQLTransactionState stateAfterCompletedStatementCallbacks() override;
     virtual void executeSQL(std::unique_ptr<AbstractSQLStatement>, const String& statement,
         const Vector<SQLValue>& arguments, int permissions) override;
 
@@ -132,6 +135,11 @@ private:
     bool m_lockAcquired;
     bool m_readOnly;
     bool m_hasVersionMismatch;
+    bool m_pipelinesStatements;
+
+    // Only used in pipelined mode. See comment about pipelined transactions in SQLTransactionBackend.cpp.
+    Vector<RefPtr<SQLStatementBackend>> m_completedStatementBackends;
+    SQLTransactionState m_stateAfterCompletedStatementCallbacks;
 
     Mutex m_statementMutex;
     Deque<RefPtr<SQLStatementBackend>> m_statementQueue;
@@ -1520,7 +1520,7 @@ PassRef<ImmutableStyleProperties> CSSParser::createStyleProperties()
     if (unusedEntries)
         results.remove(0, unusedEntries);
 
-    return ImmutableStyleProperties::create(results.data(), results.size(), m_context.mode);
+    return ImmutableStyleProperties::createDeduplicating(results.data(), results.size(), m_context.mode);
 }
 
 void CSSParser::addPropertyWithPrefixingVariant(CSSPropertyID propId, PassRefPtr<CSSValue> value, bool important, bool implicit)
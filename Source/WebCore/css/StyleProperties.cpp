@@ -33,6 +33,9 @@
 #include "StylePropertyShorthand.h"
 #include "StyleSheetContents.h"
 #include <bitset>
+#include <wtf/HashSet.h>
+#include <wtf/MainThread.h>
+#include <wtf/NeverDestroyed.h>
 #include <wtf/text/StringBuilder.h>
 
 #ifndef NDEBUG
@@ -59,6 +62,91 @@ PassRef<ImmutableStyleProperties> ImmutableStyleProperties::create(const CSSProp
     return adoptRef(*new (NotNull, slot) ImmutableStyleProperties(properties, count, cssParserMode));
 }
 
+static inline unsigned hashPropertyEntry(unsigned hash, const StylePropertyMetadata& metadata, const CSSValue* value)
+{
+    unsigned metadataBits = metadata.m_propertyID
+        | metadata.m_isSetFromShorthand << 10
+        | metadata.m_indexInShorthandsVector << 11
+        | metadata.m_important << 13
+        | metadata.m_implicit << 14
+        | metadata.m_inherited << 15;
+    return pairIntHash(pairIntHash(hash, metadataBits), PtrHash<const CSSValue*>::hash(value));
+}
+
+static inline bool metadataEqual(const StylePropertyMetadata& a, const StylePropertyMetadata& b)
+{
+    return a.m_propertyID == b.m_propertyID
+        && a.m_isSetFromShorthand == b.m_isSetFromShorthand
+        && a.m_indexInShorthandsVector == b.m_indexInShorthandsVector
+        && a.m_important == b.m_important
+        && a.m_implicit == b.m_implicit
+        && a.m_inherited == b.m_inherited;
+}
+
+struct ImmutableStylePropertiesInternHash {
+    static unsigned hash(const ImmutableStyleProperties* properties)
+    {
+        unsigned hash = intHash(static_cast<unsigned>(properties->cssParserMode()));
+        for (unsigned i = 0; i < properties->propertyCount(); ++i)
+            hash = hashPropertyEntry(hash, properties->metadataArray()[i], properties->valueArray()[i]);
+        return hash;
+    }
+    static bool equal(const ImmutableStyleProperties* a, const ImmutableStyleProperties* b) { return a == b; }
+    static const bool safeToCompareToEmptyOrDeleted = true;
+};
+
+struct ImmutableStylePropertiesInternKey {
+    const CSSProperty* properties;
+    unsigned count;
+    CSSParserMode cssParserMode;
+};
+
+struct ImmutableStylePropertiesInternTranslator {
+    static unsigned hash(const ImmutableStylePropertiesInternKey& key)
+    {
+        unsigned hash = intHash(static_cast<unsigned>(key.cssParserMode));
+        for (unsigned i = 0; i < key.count; ++i)
+            hash = hashPropertyEntry(hash, key.properties[i].metadata(), key.properties[i].value());
+        return hash;
+    }
+
+    static bool equal(const ImmutableStyleProperties* properties, const ImmutableStylePropertiesInternKey& key)
+    {
+        if (properties->propertyCount() != key.count || properties->cssParserMode() != key.cssParserMode)
+            return false;
+        for (unsigned i = 0; i < key.count; ++i) {
+            if (properties->valueArray()[i] != key.properties[i].value() || !metadataEqual(properties->metadataArray()[i], key.properties[i].metadata()))
+                return false;
+        }
+        return true;
+    }
+};
+
+typedef HashSet<ImmutableStyleProperties*, ImmutableStylePropertiesInternHash> ImmutableStylePropertiesInternTable;
+
+static ImmutableStylePropertiesInternTable& immutableStylePropertiesInternTable()
+{
+    ASSERT(isMainThread());
+    static NeverDestroyed<ImmutableStylePropertiesInternTable> table;
+    return table;
+}
+
+PassRef<ImmutableStyleProperties> ImmutableStyleProperties::createDeduplicating(const CSSProperty* properties, unsigned count, CSSParserMode cssParserMode)
+{
+    // Values that come from the CSSValuePool (keywords, colors, small lengths, inherit and initial) are shared,
+    // so comparing value pointers is enough to find identical declaration blocks in different rules and style attributes.
+    ImmutableStylePropertiesInternKey key = { properties, count, cssParserMode };
+    ImmutableStylePropertiesInternTable& table = immutableStylePropertiesInternTable();
+    auto it = table.find<ImmutableStylePropertiesInternTranslator>(key);
+    if (it != table.end())
+        return **it;
+
+    PassRef<ImmutableStyleProperties> result = create(properties, count, cssParserMode);
+    result.get().m_isInterned = true;
+    table.add(&result.get());
+    return result;
+}
+
 PassRef<ImmutableStyleProperties> StyleProperties::immutableCopyIfNeeded() const
 {
     if (!isMutable())
@@ -98,6 +186,9 @@ ImmutableStyleProperties::ImmutableStyleProperties(const CSSProperty* properties
 
 ImmutableStyleProperties::~ImmutableStyleProperties()
 {
+    if (m_isInterned)
+        immutableStylePropertiesInternTable().remove(this);
+
     CSSValue** valueArray = const_cast<CSSValue**>(this->valueArray());
     for (unsigned i = 0; i < m_arraySize; ++i)
         valueArray[i]->deref();
@@ -125,12 +125,14 @@ protected:
     StyleProperties(CSSParserMode cssParserMode)
         : m_cssParserMode(cssParserMode)
         , m_isMutable(true)
+        , m_isInterned(false)
         , m_arraySize(0)
     { }
 
     StyleProperties(CSSParserMode cssParserMode, unsigned immutableArraySize)
         : m_cssParserMode(cssParserMode)
         , m_isMutable(false)
+        , m_isInterned(false)
         , m_arraySize(immutableArraySize)
     { }
 
@@ -138,7 +140,8 @@ protected:
 
     unsigned m_cssParserMode : 2;
     mutable unsigned m_isMutable : 1;
-    unsigned m_arraySize : 29;
+    unsigned m_isInterned : 1;
+    unsigned m_arraySize : 28;
     
 private:
     String getShorthandValue(const StylePropertyShorthand&) const;
@@ -158,6 +161,8 @@ class ImmutableStyleProperties : public StyleProperties {
 public:
     WEBCORE_EXPORT ~ImmutableStyleProperties();
     static PassRef<ImmutableStyleProperties> create(const CSSProperty* properties, unsigned count, CSSParserMode);
+    // Returns an existing block with the same metadata and the same CSSValue objects if there is one.
+    static PassRef<ImmutableStyleProperties> createDeduplicating(const CSSProperty* properties, unsigned count, CSSParserMode);
 
     unsigned propertyCount() const { return m_arraySize; }
 
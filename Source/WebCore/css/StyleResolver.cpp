@@ -135,8 +135,11 @@
 #include "WebKitFontFamilyNames.h"
 #include "XMLNames.h"
 #include <bitset>
+#include <wtf/CurrentTime.h>
+#include <wtf/NeverDestroyed.h>
 #include <wtf/StdLibExtras.h>
 #include <wtf/Vector.h>
+#include <wtf/text/StringBuilder.h>
 
 #if ENABLE(CSS_FILTERS)
 #include "FilterOperation.h"
@@ -254,6 +257,7 @@ void StyleResolver::MatchResult::addMatchedProperties(const StyleProperties& pro
 
 StyleResolver::StyleResolver(Document& document, bool matchAuthorAndUserStyles)
     : m_matchedPropertiesCacheAdditionsSinceLastSweep(0)
+    , m_matchedPropertiesCache(adoptRef(new MatchedPropertiesCache))
     , m_matchedPropertiesCacheSweepTimer(this, &StyleResolver::sweepMatchedPropertiesCache)
     , m_document(document)
     , m_matchAuthorAndUserStyles(matchAuthorAndUserStyles)
@@ -301,10 +305,16 @@ StyleResolver::StyleResolver(Document& document, bool matchAuthorAndUserStyles)
 #endif
 
     appendAuthorStyleSheets(0, styleSheetCollection.activeAuthorStyleSheets());
+
+    shareMatchedPropertiesCacheIfPossible();
 }
 
 void StyleResolver::appendAuthorStyleSheets(unsigned firstNew, const Vector<RefPtr<CSSStyleSheet>>& styleSheets)
 {
+    // Unless this appends nothing, the style sheets no longer match those of the resolvers we share with.
+    if (!firstNew || firstNew < styleSheets.size())
+        detachSharedMatchedPropertiesCache();
+
     m_ruleSets.appendAuthorStyleSheets(firstNew, styleSheets, m_medium.get(), m_inspectorCSSOMWrappers, this);
     if (auto renderView = document().renderView())
         renderView->style().font().update(fontSelector());
@@ -358,8 +368,9 @@ void StyleResolver::sweepMatchedPropertiesCache(Timer<StyleResolver>*)
     // This may happen when an element attribute mutation causes it to generate a new inlineStyle()
     // or presentationAttributeStyle(), potentially leaving this cache with the last ref on the old one.
     Vector<unsigned, 16> toRemove;
-    MatchedPropertiesCache::iterator it = m_matchedPropertiesCache.begin();
-    MatchedPropertiesCache::iterator end = m_matchedPropertiesCache.end();
+    MatchedPropertiesCacheMap& cache = m_matchedPropertiesCache->items;
+    MatchedPropertiesCacheMap::iterator it = cache.begin();
+    MatchedPropertiesCacheMap::iterator end = cache.end();
     for (; it != end; ++it) {
         Vector<MatchedProperties>& matchedProperties = it->value.matchedProperties;
         for (size_t i = 0; i < matchedProperties.size(); ++i) {
@@ -370,9 +381,214 @@ void StyleResolver::sweepMatchedPropertiesCache(Timer<StyleResolver>*)
         }
     }
     for (size_t i = 0; i < toRemove.size(); ++i)
-        m_matchedPropertiesCache.remove(toRemove[i]);
+        cache.remove(toRemove[i]);
 
     m_matchedPropertiesCacheAdditionsSinceLastSweep = 0;
+    ++statistics().matchedPropertiesCacheSweeps;
+}
+
+void StyleResolver::shareMatchedPropertiesCacheIfPossible()
+{
+    if (sharesMatchedPropertiesCache())
+        return;
+    Page* page = m_document.page();
+    if (!page || !page->settings().sharedMatchedPropertiesCacheEnabled())
+        return;
+
+    for (Frame* frame = &page->mainFrame(); frame; frame = frame->tree().traverseNext()) {
+        Document* document = frame->document();
+        if (!document || document == &m_document)
+            continue;
+        StyleResolver* styleResolver = document->styleResolverIfExists();
+        if (styleResolver && canShareMatchedPropertiesCacheWith(*styleResolver)) {
+            m_matchedPropertiesCache = styleResolver->m_matchedPropertiesCache;
+            // The cache was private to the other resolver until now, so it may hold entries only valid for its document.
+            removeDocumentDependentItemsFromMatchedPropertiesCache();
+            ++statistics().matchedPropertiesCacheAdoptions;
+            return;
+        }
+    }
+}
+
+bool StyleResolver::canShareMatchedPropertiesCacheWith(const StyleResolver& other) const
+{
+    // Cached styles hold images loaded for their document, so only share between frames of the same origin.
+    if (!m_document.securityOrigin()->isSameSchemeHostPort(other.m_document.securityOrigin()))
+        return false;
+    if (m_matchAuthorAndUserStyles != other.m_matchAuthorAndUserStyles)
+        return false;
+    // Lengths in rem units are resolved against the root element of each document.
+    if (m_document.styleSheetCollection().usesRemUnits() || other.m_document.styleSheetCollection().usesRemUnits())
+        return false;
+
+    const Vector<RefPtr<CSSStyleSheet>>& styleSheets = m_document.styleSheetCollection().activeAuthorStyleSheets();
+    const Vector<RefPtr<CSSStyleSheet>>& otherStyleSheets = other.m_document.styleSheetCollection().activeAuthorStyleSheets();
+    if (styleSheets.size() != otherStyleSheets.size())
+        return false;
+    for (size_t i = 0; i < styleSheets.size(); ++i) {
+        if (&styleSheets[i]->contents() != &otherStyleSheets[i]->contents())
+            return false;
+    }
+    return true;
+}
+
+void StyleResolver::detachSharedMatchedPropertiesCache()
+{
+    if (!sharesMatchedPropertiesCache())
+        return;
+    m_matchedPropertiesCache = adoptRef(new MatchedPropertiesCache);
+    m_matchedPropertiesCacheAdditionsSinceLastSweep = 0;
+}
+
+static bool valueReferencesDocumentResources(const CSSValue& value)
+{
+    if (value.isValueList()) {
+        const CSSValueList& list = toCSSValueList(value);
+        for (size_t i = 0; i < list.length(); ++i) {
+            if (valueReferencesDocumentResources(*list.itemWithoutBoundsCheck(i)))
+                return true;
+        }
+        return false;
+    }
+    if (value.isImageValue() || value.isCursorImageValue() || value.isReflectValue())
+        return true;
+#if ENABLE(CSS_IMAGE_SET)
+    if (value.isImageSetValue())
+        return true;
+#endif
+    // Gradients are the only generated images that do not refer to anything in the document.
+    if (value.isImageGeneratorValue())
+        return !value.isGradientValue();
+    return value.isPrimitiveValue() && toCSSPrimitiveValue(value).isURI();
+}
+
+bool StyleResolver::isDocumentIndependentInMatchedPropertiesCache(const Vector<MatchedProperties>& matchedPropertiesVector, const RenderStyle& style)
+{
+    // Viewport units are resolved against the frame the style was resolved for.
+    if (style.hasViewportUnits())
+        return false;
+    if (style.insideLink() != NotInsideLink)
+        return false;
+
+    for (auto& matchedProperties : matchedPropertiesVector) {
+        if (matchedProperties.linkMatchType != SelectorChecker::MatchAll)
+            return false;
+        const StyleProperties& properties = *matchedProperties.properties;
+        for (unsigned i = 0, count = properties.propertyCount(); i < count; ++i) {
+            StyleProperties::PropertyReference property = properties.propertyAt(i);
+            // Font families are looked up in the @font-face rules of the document.
+            if (property.id() == CSSPropertyFontFamily || property.id() == CSSPropertyFont)
+                return false;
+            if (valueReferencesDocumentResources(*property.value()))
+                return false;
+        }
+    }
+    return true;
+}
+
+void StyleResolver::removeDocumentDependentItemsFromMatchedPropertiesCache()
+{
+    Vector<unsigned, 16> toRemove;
+    for (auto& item : m_matchedPropertiesCache->items) {
+        if (!isDocumentIndependentInMatchedPropertiesCache(item.value.matchedProperties, *item.value.renderStyle))
+            toRemove.append(item.key);
+    }
+    for (size_t i = 0; i < toRemove.size(); ++i)
+        m_matchedPropertiesCache->items.remove(toRemove[i]);
+}
+
+void StyleResolver::Statistics::reset()
+{
+    matchedPropertiesCacheHits = 0;
+    matchedPropertiesCacheInheritedOnlyHits = 0;
+    matchedPropertiesCacheMisses = 0;
+    matchedPropertiesCacheAdditions = 0;
+    matchedPropertiesCacheSweeps = 0;
+    matchedPropertiesCacheAdoptions = 0;
+    styleSharingHits = 0;
+    for (unsigned i = 0; i < NumberOfStyleSharingFailureReasons; ++i)
+        styleSharingFailures[i] = 0;
+    collectsPhaseTimes = false;
+    ruleMatchingTime = 0;
+    propertyApplicationTime = 0;
+    styleAdjustmentTime = 0;
+}
+
+StyleResolver::Statistics& StyleResolver::statistics()
+{
+    static NeverDestroyed<Statistics> statistics;
+    return statistics;
+}
+
+const char* StyleResolver::styleSharingFailureReasonName(Statistics::StyleSharingFailureReason reason)
+{
+    switch (reason) {
+    case Statistics::NotStyledElementOrNoParentStyle:
+        return "not a styled element or no parent style";
+    case Statistics::HasInlineStyle:
+        return "inline style";
+    case Statistics::HasAnimatedSMILStyle:
+        return "animated SMIL style";
+    case Statistics::IdUsedInRules:
+        return "id used in rules";
+    case Statistics::ParentPreventsSharing:
+        return "parent prevents sharing";
+    case Statistics::IsCSSTarget:
+        return "CSS target";
+    case Statistics::HasDirectionAuto:
+        return "direction auto";
+    case Statistics::NoSharingCandidate:
+        return "no sharing candidate";
+    case Statistics::SiblingRulesMatch:
+        return "sibling rules match";
+    case Statistics::UncommonAttributeRulesMatch:
+        return "uncommon attribute rules match";
+    case Statistics::NumberOfStyleSharingFailureReasons:
+        break;
+    }
+    ASSERT_NOT_REACHED();
+    return "";
+}
+
+String StyleResolver::statisticsAsText()
+{
+    const Statistics& statistics = StyleResolver::statistics();
+
+    StringBuilder result;
+    result.appendLiteral("matched properties cache: hits ");
+    result.appendNumber(statistics.matchedPropertiesCacheHits);
+    result.appendLiteral(", inherited-only hits ");
+    result.appendNumber(statistics.matchedPropertiesCacheInheritedOnlyHits);
+    result.appendLiteral(", misses ");
+    result.appendNumber(statistics.matchedPropertiesCacheMisses);
+    result.appendLiteral(", additions ");
+    result.appendNumber(statistics.matchedPropertiesCacheAdditions);
+    result.appendLiteral(", sweeps ");
+    result.appendNumber(statistics.matchedPropertiesCacheSweeps);
+    result.appendLiteral(", adoptions ");
+    result.appendNumber(statistics.matchedPropertiesCacheAdoptions);
+    result.appendLiteral("\nstyle sharing: hits ");
+    result.appendNumber(statistics.styleSharingHits);
+    result.append('\n');
+    for (unsigned i = 0; i < Statistics::NumberOfStyleSharingFailureReasons; ++i) {
+        if (!statistics.styleSharingFailures[i])
+            continue;
+        result.appendLiteral("  failed, ");
+        result.append(styleSharingFailureReasonName(static_cast<Statistics::StyleSharingFailureReason>(i)));
+        result.appendLiteral(": ");
+        result.appendNumber(statistics.styleSharingFailures[i]);
+        result.append('\n');
+    }
+    if (statistics.collectsPhaseTimes) {
+        result.appendLiteral("phase times (ms): rule matching ");
+        result.appendNumber(statistics.ruleMatchingTime * 1000);
+        result.appendLiteral(", property application ");
+        result.appendNumber(statistics.propertyApplicationTime * 1000);
+        result.appendLiteral(", style adjustment ");
+        result.appendNumber(statistics.styleAdjustmentTime * 1000);
+        result.append('\n');
+    }
+    return result.toString();
 }
 
 bool StyleResolver::classNamesAffectedByRules(const SpaceSplitString& classNames) const
@@ -679,26 +895,32 @@ inline StyledElement* StyleResolver::findSiblingForStyleSharing(Node* node, unsi
     return toStyledElement(node);
 }
 
+RenderStyle* StyleResolver::styleSharingFailed(Statistics::StyleSharingFailureReason reason)
+{
+    ++statistics().styleSharingFailures[reason];
+    return 0;
+}
+
 RenderStyle* StyleResolver::locateSharedStyle()
 {
     State& state = m_state;
     if (!state.styledElement() || !state.parentStyle())
-        return 0;
+        return styleSharingFailed(Statistics::NotStyledElementOrNoParentStyle);
 
     // If the element has inline style it is probably unique.
     if (state.styledElement()->inlineStyle())
-        return 0;
+        return styleSharingFailed(Statistics::HasInlineStyle);
     if (state.styledElement()->isSVGElement() && toSVGElement(state.styledElement())->animatedSMILStyleProperties())
-        return 0;
+        return styleSharingFailed(Statistics::HasAnimatedSMILStyle);
     // Ids stop style sharing if they show up in the stylesheets.
     if (state.styledElement()->hasID() && m_ruleSets.features().idsInRules.contains(state.styledElement()->idForStyleResolution().impl()))
-        return 0;
+        return styleSharingFailed(Statistics::IdUsedInRules);
     if (parentElementPreventsSharing(state.element()->parentElement()))
-        return 0;
+        return styleSharingFailed(Statistics::ParentPreventsSharing);
     if (state.element() == state.document().cssTarget())
-        return 0;
+        return styleSharingFailed(Statistics::IsCSSTarget);
     if (elementHasDirectionAuto(state.element()))
-        return 0;
+        return styleSharingFailed(Statistics::HasDirectionAuto);
 
     // Cache whether state.element is affected by any known class selectors.
     // FIXME: This shouldn't be a member variable. The style sharing code could be factored out of StyleResolver.
@@ -718,17 +940,18 @@ RenderStyle* StyleResolver::locateSharedStyle()
 
     // If we have exhausted all our budget or our cousins.
     if (!shareElement)
-        return 0;
+        return styleSharingFailed(Statistics::NoSharingCandidate);
 
     // Can't share if sibling rules apply. This is checked at the end as it should rarely fail.
     if (styleSharingCandidateMatchesRuleSet(m_ruleSets.sibling()))
-        return 0;
+        return styleSharingFailed(Statistics::SiblingRulesMatch);
     // Can't share if attribute rules apply.
     if (styleSharingCandidateMatchesRuleSet(m_ruleSets.uncommonAttribute()))
-        return 0;
+        return styleSharingFailed(Statistics::UncommonAttributeRulesMatch);
     // Tracking child index requires unique style for each node. This may get set by the sibling rule match above.
     if (parentElementPreventsSharing(state.element()->parentElement()))
-        return 0;
+        return styleSharingFailed(Statistics::ParentPreventsSharing);
+    ++statistics().styleSharingHits;
     return shareElement->renderStyle();
 }
 
@@ -789,6 +1012,9 @@ PassRef<RenderStyle> StyleResolver::styleForElement(Element* element, RenderStyl
     if (needsCollection)
         m_ruleSets.collectFeatures();
 
+    Statistics& statistics = StyleResolver::statistics();
+    double phaseStartTime = statistics.collectsPhaseTimes ? monotonicallyIncreasingTime() : 0;
+
     ElementRuleCollector collector(*element, state.style(), m_ruleSets, m_selectorFilter);
     collector.setRegionForStyling(regionForStyling);
     collector.setMedium(m_medium.get());
@@ -798,11 +1024,26 @@ PassRef<RenderStyle> StyleResolver::styleForElement(Element* element, RenderStyl
     else
         collector.matchAllRules(m_matchAuthorAndUserStyles, matchingBehavior != MatchAllRulesExcludingSMIL);
 
+    if (statistics.collectsPhaseTimes) {
+        double now = monotonicallyIncreasingTime();
+        statistics.ruleMatchingTime += now - phaseStartTime;
+        phaseStartTime = now;
+    }
+
     applyMatchedProperties(collector.matchedResult(), element);
 
+    if (statistics.collectsPhaseTimes) {
+        double now = monotonicallyIncreasingTime();
+        statistics.propertyApplicationTime += now - phaseStartTime;
+        phaseStartTime = now;
+    }
+
     // Clean up our style object's display and text decorations (among other fixups).
     adjustRenderStyle(*state.style(), *state.parentStyle(), element);
 
+    if (statistics.collectsPhaseTimes)
+        statistics.styleAdjustmentTime += monotonicallyIncreasingTime() - phaseStartTime;
+
     if (state.style()->hasViewportUnits())
         document().setHasStyleWithViewportUnits();
 
@@ -1558,8 +1799,8 @@ const StyleResolver::MatchedPropertiesCacheItem* StyleResolver::findFromMatchedP
 {
     ASSERT(hash);
 
-    MatchedPropertiesCache::iterator it = m_matchedPropertiesCache.find(hash);
-    if (it == m_matchedPropertiesCache.end())
+    MatchedPropertiesCacheMap::iterator it = m_matchedPropertiesCache->items.find(hash);
+    if (it == m_matchedPropertiesCache->items.end())
         return 0;
     MatchedPropertiesCacheItem& cacheItem = it->value;
 
@@ -1592,23 +1833,24 @@ void StyleResolver::addToMatchedPropertiesCache(const RenderStyle* style, const
     // The RenderStyle in the cache is really just a holder for the substructures and never used as-is.
     cacheItem.renderStyle = RenderStyle::clone(style);
     cacheItem.parentRenderStyle = RenderStyle::clone(parentStyle);
-    m_matchedPropertiesCache.add(hash, WTF::move(cacheItem));
+    m_matchedPropertiesCache->items.add(hash, WTF::move(cacheItem));
+    ++statistics().matchedPropertiesCacheAdditions;
 }
 
 void StyleResolver::invalidateMatchedPropertiesCache()
 {
-    m_matchedPropertiesCache.clear();
+    m_matchedPropertiesCache->items.clear();
 }
 
 void StyleResolver::clearCachedPropertiesAffectedByViewportUnits()
 {
     Vector<unsigned, 16> toRemove;
-    for (auto& cacheKeyValue : m_matchedPropertiesCache) {
+    for (auto& cacheKeyValue : m_matchedPropertiesCache->items) {
         if (cacheKeyValue.value.renderStyle->hasViewportUnits())
             toRemove.append(cacheKeyValue.key);
     }
     for (auto key : toRemove)
-        m_matchedPropertiesCache.remove(key);
+        m_matchedPropertiesCache->items.remove(key);
 }
 
 static bool isCacheableInMatchedPropertiesCache(const Element* element, const RenderStyle* style, const RenderStyle* parentStyle)
@@ -1676,7 +1918,9 @@ void StyleResolver::applyMatchedProperties(const MatchResult& matchResult, const
         // style declarations. We then only need to apply the inherited properties, if any, as their values can depend on the 
         // element context. This is fast and saves memory by reusing the style data structures.
         state.style()->copyNonInheritedFrom(cacheItem->renderStyle.get());
-        if (state.parentStyle()->inheritedDataShared(cacheItem->parentRenderStyle.get()) && !isAtShadowBoundary(element)) {
+        // The font of a style added by another document sharing the cache refers to that document's font selector.
+        if (state.parentStyle()->inheritedDataShared(cacheItem->parentRenderStyle.get()) && !isAtShadowBoundary(element)
+            && cacheItem->renderStyle->font().fontSelector() == fontSelector()) {
             EInsideLink linkStatus = state.style()->insideLink();
             // If the cache item parent style has identical inherited properties to the current parent style then the
             // resulting style will be identical too. We copy the inherited properties over from the cache and are done.
@@ -1684,10 +1928,13 @@ void StyleResolver::applyMatchedProperties(const MatchResult& matchResult, const
 
             // Unfortunately the link status is treated like an inherited property. We need to explicitly restore it.
             state.style()->setInsideLink(linkStatus);
+            ++statistics().matchedPropertiesCacheHits;
             return;
         }
         applyInheritedOnly = true; 
-    }
+        ++statistics().matchedPropertiesCacheInheritedOnlyHits;
+    } else if (cacheHash)
+        ++statistics().matchedPropertiesCacheMisses;
 
     // Directional properties (*-before/after) are aliases that depend on the TextDirection and WritingMode.
     // These must be resolved before we can begin the property cascade.
@@ -1767,6 +2014,8 @@ void StyleResolver::applyMatchedProperties(const MatchResult& matchResult, const
         return;
     if (!isCacheableInMatchedPropertiesCache(state.element(), state.style(), state.parentStyle()))
         return;
+    if (sharesMatchedPropertiesCache() && !isDocumentIndependentInMatchedPropertiesCache(matchResult.matchedProperties, *state.style()))
+        return;
     addToMatchedPropertiesCache(state.style(), state.parentStyle(), cacheHash, matchResult);
 }
 
@@ -41,6 +41,7 @@
 #include <memory>
 #include <wtf/HashMap.h>
 #include <wtf/HashSet.h>
+#include <wtf/RefCounted.h>
 #include <wtf/RefPtr.h>
 #include <wtf/Vector.h>
 #include <wtf/text/AtomicStringHash.h>
@@ -238,6 +239,49 @@ public:
 
     void clearCachedPropertiesAffectedByViewportUnits();
 
+    // Process-wide counters explaining where style resolution time goes, available through Internals.
+    struct Statistics {
+        enum StyleSharingFailureReason {
+            NotStyledElementOrNoParentStyle,
+            HasInlineStyle,
+            HasAnimatedSMILStyle,
+            IdUsedInRules,
+            ParentPreventsSharing,
+            IsCSSTarget,
+            HasDirectionAuto,
+            NoSharingCandidate,
+            SiblingRulesMatch,
+            UncommonAttributeRulesMatch,
+            NumberOfStyleSharingFailureReasons
+        };
+
+        Statistics() { reset(); }
+        void reset();
+
+        unsigned matchedPropertiesCacheHits;
+        unsigned matchedPropertiesCacheInheritedOnlyHits;
+        unsigned matchedPropertiesCacheMisses;
+        unsigned matchedPropertiesCacheAdditions;
+        unsigned matchedPropertiesCacheSweeps;
+        unsigned matchedPropertiesCacheAdoptions;
+        unsigned styleSharingHits;
+        unsigned styleSharingFailures[NumberOfStyleSharingFailureReasons];
+
+        // Phase times are in seconds and are only measured when collectsPhaseTimes is set, as reading the clock is not free.
+        bool collectsPhaseTimes;
+        double ruleMatchingTime;
+        double propertyApplicationTime;
+        double styleAdjustmentTime;
+    };
+    WEBCORE_EXPORT static Statistics& statistics();
+    static const char* styleSharingFailureReasonName(Statistics::StyleSharingFailureReason);
+    WEBCORE_EXPORT static String statisticsAsText();
+
+    // The matched properties cache is keyed on the exact StyleProperties that matched, so resolvers of same-origin
+    // frames in a page can share it when enabled in Settings; see canShareMatchedPropertiesCacheWith().
+    void shareMatchedPropertiesCacheIfPossible();
+    bool sharesMatchedPropertiesCache() const { return !m_matchedPropertiesCache->hasOneRef(); }
+
 #if ENABLE(CSS_FILTERS)
     bool createFilterOperations(CSSValue* inValue, FilterOperations& outOperations);
     void loadPendingSVGDocuments();
@@ -507,14 +551,26 @@ private:
     // the last reference to a style declaration are garbage collected.
     void sweepMatchedPropertiesCache(Timer<StyleResolver>*);
 
+    bool canShareMatchedPropertiesCacheWith(const StyleResolver&) const;
+    void detachSharedMatchedPropertiesCache();
+    // Entries whose style depends on the document it was resolved for, through loaded images, web fonts or
+    // visited link state, must not be seen by the other resolvers sharing the cache.
+    static bool isDocumentIndependentInMatchedPropertiesCache(const Vector<MatchedProperties>&, const RenderStyle&);
+    void removeDocumentDependentItemsFromMatchedPropertiesCache();
+
+    RenderStyle* styleSharingFailed(Statistics::StyleSharingFailureReason);
+
     bool classNamesAffectedByRules(const SpaceSplitString&) const;
     bool sharingCandidateHasIdenticalStyleAffectingAttributes(StyledElement*) const;
 
 
     unsigned m_matchedPropertiesCacheAdditionsSinceLastSweep;
 
-    typedef HashMap<unsigned, MatchedPropertiesCacheItem> MatchedPropertiesCache;
-    MatchedPropertiesCache m_matchedPropertiesCache;
+    typedef HashMap<unsigned, MatchedPropertiesCacheItem> MatchedPropertiesCacheMap;
+    struct MatchedPropertiesCache : public RefCounted<MatchedPropertiesCache> {
+        MatchedPropertiesCacheMap items;
+    };
+    RefPtr<MatchedPropertiesCache> m_matchedPropertiesCache;
 
     Timer<StyleResolver> m_matchedPropertiesCacheSweepTimer;
 
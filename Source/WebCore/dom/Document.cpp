@@ -751,14 +751,7 @@ SelectorQuery* Document::selectorQueryForString(const String& selectorString, Ex
         return nullptr;
     }
 
-    if (!m_selectorQueryCache)
-        m_selectorQueryCache = std::make_unique<SelectorQueryCache>();
-    return m_selectorQueryCache->add(selectorString, *this, ec);
-}
-
-void Document::clearSelectorQueryCache()
-{
-    m_selectorQueryCache = nullptr;
+    return selectorQueryCache().add(selectorString, *this, ec);
 }
 
 MediaQueryMatcher& Document::mediaQueryMatcher()
@@ -775,8 +768,6 @@ void Document::setCompatibilityMode(DocumentCompatibilityMode mode)
     bool wasInQuirksMode = inQuirksMode();
     m_compatibilityMode = mode;
 
-    clearSelectorQueryCache();
-
     if (inQuirksMode() != wasInQuirksMode) {
         // All user stylesheets have to reparse using the different mode.
         m_styleSheetCollection.clearPageUserSheet();
@@ -2611,8 +2602,6 @@ void Document::updateBaseURL()
         m_baseURL = URL(ParsedURLString, documentURI());
     }
 
-    clearSelectorQueryCache();
-
     if (!m_baseURL.isValid())
         m_baseURL = URL();
 
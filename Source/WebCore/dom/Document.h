@@ -140,7 +140,6 @@ class ScriptElementData;
 class ScriptRunner;
 class SecurityOrigin;
 class SelectorQuery;
-class SelectorQueryCache;
 class SerializedScriptValue;
 class SegmentedString;
 class Settings;
@@ -317,7 +316,6 @@ public:
     HTMLImageElement* imageElementByLowercasedUsemap(const AtomicStringImpl&) const;
 
     SelectorQuery* selectorQueryForString(const String&, ExceptionCode&);
-    void clearSelectorQueryCache();
 
     // DOM methods & attributes for Document
 
@@ -1545,7 +1543,6 @@ private:
 
     DocumentOrderedMap m_imagesByUsemap;
 
-    std::unique_ptr<SelectorQueryCache> m_selectorQueryCache;
 
     DocumentClassFlags m_documentClasses;
 
@@ -467,6 +467,10 @@ bool DocumentStyleSheetCollection::updateActiveStyleSheets(UpdateFlag updateFlag
     m_usesRemUnits = styleSheetsUseRemUnits(m_activeAuthorStyleSheets);
     m_pendingUpdateType = NoUpdate;
 
+    // Now that the active style sheets are known, another frame may have the same ones.
+    if (styleResolverUpdateType != Reconstruct)
+        m_document.ensureStyleResolver().shareMatchedPropertiesCacheIfPossible();
+
     return requiresFullStyleRecalc;
 }
 
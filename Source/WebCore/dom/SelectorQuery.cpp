@@ -32,6 +32,8 @@
 #include "SelectorCheckerFastPath.h"
 #include "StaticNodeList.h"
 #include "StyledElement.h"
+#include <wtf/MainThread.h>
+#include <wtf/NeverDestroyed.h>
 
 namespace WebCore {
 
@@ -127,6 +129,29 @@ inline bool SelectorDataList::selectorMatches(const SelectorData& selectorData,
     return selectorChecker.match(selectorCheckingContext);
 }
 
+// Keeps the SelectorFilter's parent stack in sync with the ancestors of the candidate element, relying on candidates being
+// visited in document order, then rejects the candidate if one of the selector's ancestor identifiers is missing from the filter.
+inline bool SelectorDataList::ancestorFilterRejects(SelectorFilter& selectorFilter, Element& element, const SelectorData& selectorData)
+{
+    ASSERT(selectorData.hasDescendantSelectorIdentifierHashes());
+
+    Element* parent = element.parentOrShadowHostElement();
+    if (!parent)
+        return false;
+
+    while (!selectorFilter.parentStackIsEmpty() && !selectorFilter.parentStackIsConsistent(parent)) {
+        if (selectorFilter.parentStackIsConsistent(parent->parentOrShadowHostElement())) {
+            selectorFilter.pushParent(parent);
+            break;
+        }
+        selectorFilter.popParent();
+    }
+    if (selectorFilter.parentStackIsEmpty())
+        selectorFilter.setupParentStack(parent);
+
+    return selectorFilter.fastRejectSelector<SelectorData::maximumIdentifierCount>(selectorData.descendantSelectorIdentifierHashes);
+}
+
 bool SelectorDataList::matches(Element& targetElement) const
 {
     unsigned selectorCount = m_selectors.size();
@@ -334,7 +359,11 @@ ALWAYS_INLINE void SelectorDataList::executeSingleSelectorData(const ContainerNo
 {
     ASSERT(m_selectors.size() == 1);
 
+    SelectorFilter selectorFilter;
+    bool canUseAncestorFilter = selectorData.hasDescendantSelectorIdentifierHashes();
     for (auto& element : elementDescendants(const_cast<ContainerNode&>(rootNode))) {
+        if (canUseAncestorFilter && ancestorFilterRejects(selectorFilter, element, selectorData))
+            continue;
         if (selectorMatches(selectorData, element, rootNode)) {
             SelectorQueryTrait::appendOutputForElement(output, &element);
             if (SelectorQueryTrait::shouldOnlyMatchFirstElement)
@@ -347,8 +376,17 @@ template <typename SelectorQueryTrait>
 ALWAYS_INLINE void SelectorDataList::executeSingleMultiSelectorData(const ContainerNode& rootNode, typename SelectorQueryTrait::OutputType& output) const
 {
     unsigned selectorCount = m_selectors.size();
+
+    // The ancestor filter can only be maintained once for all selectors if every one of them can use it.
+    SelectorFilter selectorFilter;
+    bool canUseAncestorFilter = true;
+    for (unsigned i = 0; i < selectorCount; ++i)
+        canUseAncestorFilter &= m_selectors[i].hasDescendantSelectorIdentifierHashes();
+
     for (auto& element : elementDescendants(const_cast<ContainerNode&>(rootNode))) {
         for (unsigned i = 0; i < selectorCount; ++i) {
+            if (canUseAncestorFilter && ancestorFilterRejects(selectorFilter, element, m_selectors[i]))
+                continue;
             if (selectorMatches(m_selectors[i], element, rootNode)) {
                 SelectorQueryTrait::appendOutputForElement(output, &element);
                 if (SelectorQueryTrait::shouldOnlyMatchFirstElement)
@@ -363,12 +401,14 @@ ALWAYS_INLINE void SelectorDataList::executeSingleMultiSelectorData(const Contai
 template <typename SelectorQueryTrait>
 ALWAYS_INLINE void SelectorDataList::executeCompiledSimpleSelectorChecker(const ContainerNode& searchRootNode, SelectorCompiler::SimpleSelectorChecker selectorChecker, typename SelectorQueryTrait::OutputType& output, const SelectorData& selectorData) const
 {
+    SelectorFilter selectorFilter;
+    bool canUseAncestorFilter = selectorData.hasDescendantSelectorIdentifierHashes();
     for (auto& element : elementDescendants(const_cast<ContainerNode&>(searchRootNode))) {
 #if CSS_SELECTOR_JIT_PROFILING
         selectorData.compiledSelectorUsed();
-#else
-        UNUSED_PARAM(selectorData);
 #endif
+        if (canUseAncestorFilter && ancestorFilterRejects(selectorFilter, element, selectorData))
+            continue;
         if (selectorChecker(&element)) {
             SelectorQueryTrait::appendOutputForElement(output, &element);
             if (SelectorQueryTrait::shouldOnlyMatchFirstElement)
@@ -383,12 +423,14 @@ ALWAYS_INLINE void SelectorDataList::executeCompiledSelectorCheckerWithCheckingC
     SelectorCompiler::CheckingContext checkingContext(SelectorChecker::Mode::QueryingRules);
     checkingContext.scope = rootNode.isDocumentNode() ? nullptr : &rootNode;
 
+    SelectorFilter selectorFilter;
+    bool canUseAncestorFilter = selectorData.hasDescendantSelectorIdentifierHashes();
     for (auto& element : elementDescendants(const_cast<ContainerNode&>(searchRootNode))) {
 #if CSS_SELECTOR_JIT_PROFILING
         selectorData.compiledSelectorUsed();
-#else
-        UNUSED_PARAM(selectorData);
 #endif
+        if (canUseAncestorFilter && ancestorFilterRejects(selectorFilter, element, selectorData))
+            continue;
         if (selectorChecker(&element, &checkingContext)) {
             SelectorQueryTrait::appendOutputForElement(output, &element);
             if (SelectorQueryTrait::shouldOnlyMatchFirstElement)
@@ -495,13 +537,34 @@ SelectorQuery::SelectorQuery(CSSSelectorList&& selectorList)
 {
 }
 
+static const unsigned maximumSelectorQueryCacheSize = 512;
+
+SelectorQueryCache& selectorQueryCache()
+{
+    ASSERT(isMainThread());
+    static NeverDestroyed<SelectorQueryCache> cache;
+    return cache;
+}
+
+SelectorQueryCache::Key SelectorQueryCache::makeKey(const String& selectors, CSSParserMode mode, bool isHTMLDocument)
+{
+    return Key(selectors, static_cast<unsigned>(mode) << 1 | isHTMLDocument);
+}
+
 SelectorQuery* SelectorQueryCache::add(const String& selectors, Document& document, ExceptionCode& ec)
 {
-    auto it = m_entries.find(selectors);
-    if (it != m_entries.end())
+    CSSParserContext context(document);
+    Key key = makeKey(selectors, context.mode, context.isHTMLDocument);
+
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+        ++m_statistics.hitCount;
+        m_recentlyUsedKeys.appendOrMoveToLast(key);
         return it->value.get();
+    }
+    ++m_statistics.missCount;
 
-    CSSParser parser(document);
+    CSSParser parser(context);
     CSSSelectorList selectorList;
     parser.parseSelector(selectors, selectorList);
 
@@ -516,11 +579,19 @@ SelectorQuery* SelectorQueryCache::add(const String& selectors, Document& docume
         return nullptr;
     }
 
-    const int maximumSelectorQueryCacheSize = 256;
-    if (m_entries.size() == maximumSelectorQueryCacheSize)
-        m_entries.remove(m_entries.begin());
-    
-    return m_entries.add(selectors, std::make_unique<SelectorQuery>(WTF::move(selectorList))).iterator->value.get();
+    if (m_entries.size() == maximumSelectorQueryCacheSize) {
+        m_entries.remove(m_recentlyUsedKeys.takeFirst());
+        ++m_statistics.evictionCount;
+    }
+
+    m_recentlyUsedKeys.add(key);
+    return m_entries.add(key, std::make_unique<SelectorQuery>(WTF::move(selectorList))).iterator->value.get();
+}
+
+void SelectorQueryCache::clear()
+{
+    m_entries.clear();
+    m_recentlyUsedKeys.clear();
 }
 
 }
@@ -26,10 +26,13 @@
 #ifndef SelectorQuery_h
 #define SelectorQuery_h
 
+#include "CSSParserMode.h"
 #include "CSSSelectorList.h"
 #include "NodeList.h"
 #include "SelectorCompiler.h"
+#include "SelectorFilter.h"
 #include <wtf/HashMap.h>
+#include <wtf/ListHashSet.h>
 #include <wtf/Vector.h>
 #include <wtf/text/AtomicStringHash.h>
 #include <wtf/text/CString.h>
@@ -61,9 +64,15 @@ private:
 #endif
             , isFastCheckable(isFastCheckable)
         {
+            SelectorFilter::collectIdentifierHashes(selector, descendantSelectorIdentifierHashes, maximumIdentifierCount);
         }
 
+        // Identifiers that must appear on the ancestors of a matching element, used to reject candidates early.
+        static const unsigned maximumIdentifierCount = 4;
+        bool hasDescendantSelectorIdentifierHashes() const { return descendantSelectorIdentifierHashes[0]; }
+
         const CSSSelector* selector;
+        unsigned descendantSelectorIdentifierHashes[maximumIdentifierCount];
 #if ENABLE(CSS_SELECTOR_JIT)
         mutable JSC::MacroAssemblerCodeRef compiledSelectorCodeRef;
         mutable SelectorCompilationStatus compilationStatus;
@@ -81,6 +90,7 @@ private:
     };
 
     bool selectorMatches(const SelectorData&, Element&, const ContainerNode& rootNode) const;
+    static bool ancestorFilterRejects(SelectorFilter&, Element&, const SelectorData&);
 
     template <typename SelectorQueryTrait> void execute(ContainerNode& rootNode, typename SelectorQueryTrait::OutputType&) const;
     template <typename SelectorQueryTrait> void executeFastPathForIdSelector(const ContainerNode& rootNode, const SelectorData&, const CSSSelector* idSelector, typename SelectorQueryTrait::OutputType&) const;
@@ -122,16 +132,46 @@ private:
     SelectorDataList m_selectors;
 };
 
+// Process-wide cache of parsed (and, with the selector JIT, compiled) selector queries.
+// Entries are keyed by the selector text and the parser state that affects how the
+// text is parsed, so identical queries made by different documents share one SelectorQuery.
 class SelectorQueryCache {
+    WTF_MAKE_NONCOPYABLE(SelectorQueryCache);
     WTF_MAKE_FAST_ALLOCATED;
 
 public:
+    SelectorQueryCache() { }
+
     SelectorQuery* add(const String&, Document&, ExceptionCode&);
+    void clear();
+
+    struct Statistics {
+        Statistics()
+            : hitCount(0)
+            , missCount(0)
+            , evictionCount(0)
+        {
+        }
+
+        unsigned hitCount;
+        unsigned missCount;
+        unsigned evictionCount;
+    };
+    const Statistics& statistics() const { return m_statistics; }
+    unsigned size() const { return m_entries.size(); }
 
 private:
-    HashMap<String, std::unique_ptr<SelectorQuery>> m_entries;
+    // The selector text, and the parser mode and HTML-document flag packed together.
+    typedef std::pair<String, unsigned> Key;
+    static Key makeKey(const String&, CSSParserMode, bool isHTMLDocument);
+
+    HashMap<Key, std::unique_ptr<SelectorQuery>> m_entries;
+    ListHashSet<Key> m_recentlyUsedKeys;
+    Statistics m_statistics;
 };
 
+SelectorQueryCache& selectorQueryCache();
+
 inline bool SelectorQuery::matches(Element& element) const
 {
     return m_selectors.matches(element);
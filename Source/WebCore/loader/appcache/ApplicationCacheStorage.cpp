@@ -47,6 +47,11 @@ namespace WebCore {
 
 static const char flatFileSubdirectory[] = "ApplicationCache";
 
+// Resources are read back whole when a cache is loaded, so let SQLite map the database instead of copying
+// it in page by page. Storing a large cache can grow the write-ahead log a lot; truncate it afterwards.
+static const int64_t memoryMappedSize = 64 * 1024 * 1024;
+static const int64_t journalSizeLimit = 8 * 1024 * 1024;
+
 template <class T>
 class StorageIDJournal {
 public:  
@@ -625,6 +630,9 @@ void ApplicationCacheStorage::openDatabase(bool createIfDoesNotExist)
     
     if (!m_database.isOpen())
         return;
+
+    m_database.setMemoryMappedSize(memoryMappedSize);
+    m_database.setJournalSizeLimit(journalSizeLimit);
     
     verifySchemaVersion();
     
@@ -677,11 +685,16 @@ void ApplicationCacheStorage::openDatabase(bool createIfDoesNotExist)
 bool ApplicationCacheStorage::executeStatement(SQLiteStatement& statement)
 {
     ASSERT(SQLiteDatabaseTracker::hasTransactionInProgress());
-    bool result = statement.executeCommand();
+    bool result = statement.step() == SQLResultDone;
     if (!result)
         LOG_ERROR("Application Cache Storage: failed to execute statement \"%s\" error \"%s\"", 
                   statement.query().utf8().data(), m_database.lastErrorMsg());
-    
+
+    // Cached statements outlive the call, so don't let them hold on to their bound values,
+    // which can be whole resource bodies.
+    statement.reset();
+    statement.clearBindings();
+
     return result;
 }    
 
@@ -753,26 +766,28 @@ bool ApplicationCacheStorage::store(ApplicationCache* cache, ResourceStorageIDJo
     {
         size_t whitelistSize = onlineWhitelist.size();
         for (size_t i = 0; i < whitelistSize; ++i) {
-            SQLiteStatement statement(m_database, "INSERT INTO CacheWhitelistURLs (url, cache) VALUES (?, ?)");
-            statement.prepare();
+            SQLiteStatement* statement = m_database.cachedStatement("INSERT INTO CacheWhitelistURLs (url, cache) VALUES (?, ?)");
+            if (!statement)
+                return false;
 
-            statement.bindText(1, onlineWhitelist[i]);
-            statement.bindInt64(2, cacheStorageID);
+            statement->bindText(1, onlineWhitelist[i]);
+            statement->bindInt64(2, cacheStorageID);
 
-            if (!executeStatement(statement))
+            if (!executeStatement(*statement))
                 return false;
         }
     }
 
     // Store online whitelist wildcard flag.
     {
-        SQLiteStatement statement(m_database, "INSERT INTO CacheAllowsAllNetworkRequests (wildcard, cache) VALUES (?, ?)");
-        statement.prepare();
+        SQLiteStatement* statement = m_database.cachedStatement("INSERT INTO CacheAllowsAllNetworkRequests (wildcard, cache) VALUES (?, ?)");
+        if (!statement)
+            return false;
 
-        statement.bindInt64(1, cache->allowsAllNetworkRequests());
-        statement.bindInt64(2, cacheStorageID);
+        statement->bindInt64(1, cache->allowsAllNetworkRequests());
+        statement->bindInt64(2, cacheStorageID);
 
-        if (!executeStatement(statement))
+        if (!executeStatement(*statement))
             return false;
     }
     
@@ -781,14 +796,15 @@ bool ApplicationCacheStorage::store(ApplicationCache* cache, ResourceStorageIDJo
     {
         size_t fallbackCount = fallbackURLs.size();
         for (size_t i = 0; i < fallbackCount; ++i) {
-            SQLiteStatement statement(m_database, "INSERT INTO FallbackURLs (namespace, fallbackURL, cache) VALUES (?, ?, ?)");
-            statement.prepare();
+            SQLiteStatement* statement = m_database.cachedStatement("INSERT INTO FallbackURLs (namespace, fallbackURL, cache) VALUES (?, ?, ?)");
+            if (!statement)
+                return false;
 
-            statement.bindText(1, fallbackURLs[i].first);
-            statement.bindText(2, fallbackURLs[i].second);
-            statement.bindInt64(3, cacheStorageID);
+            statement->bindText(1, fallbackURLs[i].first);
+            statement->bindText(2, fallbackURLs[i].second);
+            statement->bindInt64(3, cacheStorageID);
 
-            if (!executeStatement(statement))
+            if (!executeStatement(*statement))
                 return false;
         }
     }
@@ -810,14 +826,14 @@ bool ApplicationCacheStorage::store(ApplicationCacheResource* resource, unsigned
         return false;
 
     // First, insert the data
-    SQLiteStatement dataStatement(m_database, "INSERT INTO CacheResourceData (data, path) VALUES (?, ?)");
-    if (dataStatement.prepare() != SQLResultOk)
+    SQLiteStatement* dataStatement = m_database.cachedStatement("INSERT INTO CacheResourceData (data, path) VALUES (?, ?)");
+    if (!dataStatement)
         return false;
     
 
     String fullPath;
     if (!resource->path().isEmpty())
-        dataStatement.bindText(2, pathGetFileName(resource->path()));
+        dataStatement->bindText(2, pathGetFileName(resource->path()));
     else if (shouldStoreResourceAsFlatFile(resource)) {
         // First, check to see if creating the flat file would violate the maximum total quota. We don't need
         // to check the per-origin quota here, as it was already checked in storeNewestCache().
@@ -842,13 +858,16 @@ bool ApplicationCacheStorage::store(ApplicationCacheResource* resource, unsigned
         
         fullPath = pathByAppendingComponent(flatFileDirectory, path);
         resource->setPath(fullPath);
-        dataStatement.bindText(2, path);
+        dataStatement->bindText(2, path);
     } else {
         if (resource->data()->size())
-            dataStatement.bindBlob(1, resource->data()->data(), resource->data()->size());
+            dataStatement->bindBlob(1, resource->data()->data(), resource->data()->size());
     }
     
-    if (!dataStatement.executeCommand()) {
+    int dataResult = dataStatement->step();
+    dataStatement->reset();
+    dataStatement->clearBindings();
+    if (dataResult != SQLResultDone) {
         // Clean up the file which we may have written to:
         if (!fullPath.isEmpty())
             deleteFile(fullPath);
@@ -872,36 +891,36 @@ bool ApplicationCacheStorage::store(ApplicationCacheResource* resource, unsigned
     
     String headers = stringBuilder.toString();
     
-    SQLiteStatement resourceStatement(m_database, "INSERT INTO CacheResources (url, statusCode, responseURL, headers, data, mimeType, textEncodingName) VALUES (?, ?, ?, ?, ?, ?, ?)");
-    if (resourceStatement.prepare() != SQLResultOk)
+    SQLiteStatement* resourceStatement = m_database.cachedStatement("INSERT INTO CacheResources (url, statusCode, responseURL, headers, data, mimeType, textEncodingName) VALUES (?, ?, ?, ?, ?, ?, ?)");
+    if (!resourceStatement)
         return false;
     
     // The same ApplicationCacheResource are used in ApplicationCacheResource::size()
     // to calculate the approximate size of an ApplicationCacheResource object. If
     // you change the code below, please also change ApplicationCacheResource::size().
-    resourceStatement.bindText(1, resource->url());
-    resourceStatement.bindInt64(2, resource->response().httpStatusCode());
-    resourceStatement.bindText(3, resource->response().url());
-    resourceStatement.bindText(4, headers);
-    resourceStatement.bindInt64(5, dataId);
-    resourceStatement.bindText(6, resource->response().mimeType());
-    resourceStatement.bindText(7, resource->response().textEncodingName());
-
-    if (!executeStatement(resourceStatement))
+    resourceStatement->bindText(1, resource->url());
+    resourceStatement->bindInt64(2, resource->response().httpStatusCode());
+    resourceStatement->bindText(3, resource->response().url());
+    resourceStatement->bindText(4, headers);
+    resourceStatement->bindInt64(5, dataId);
+    resourceStatement->bindText(6, resource->response().mimeType());
+    resourceStatement->bindText(7, resource->response().textEncodingName());
+
+    if (!executeStatement(*resourceStatement))
         return false;
 
     unsigned resourceId = static_cast<unsigned>(m_database.lastInsertRowID());
     
     // Finally, insert the cache entry
-    SQLiteStatement entryStatement(m_database, "INSERT INTO CacheEntries (cache, type, resource) VALUES (?, ?, ?)");
-    if (entryStatement.prepare() != SQLResultOk)
+    SQLiteStatement* entryStatement = m_database.cachedStatement("INSERT INTO CacheEntries (cache, type, resource) VALUES (?, ?, ?)");
+    if (!entryStatement)
         return false;
     
-    entryStatement.bindInt64(1, cacheStorageID);
-    entryStatement.bindInt64(2, resource->type());
-    entryStatement.bindInt64(3, resourceId);
+    entryStatement->bindInt64(1, cacheStorageID);
+    entryStatement->bindInt64(2, resource->type());
+    entryStatement->bindInt64(3, resourceId);
     
-    if (!executeStatement(entryStatement))
+    if (!executeStatement(*entryStatement))
         return false;
     
     // Did we successfully write the resource data to a file? If so,
@@ -922,14 +941,14 @@ bool ApplicationCacheStorage::storeUpdatedType(ApplicationCacheResource* resourc
     ASSERT(resource->storageID());
 
     // First, insert the data
-    SQLiteStatement entryStatement(m_database, "UPDATE CacheEntries SET type=? WHERE resource=?");
-    if (entryStatement.prepare() != SQLResultOk)
+    SQLiteStatement* entryStatement = m_database.cachedStatement("UPDATE CacheEntries SET type=? WHERE resource=?");
+    if (!entryStatement)
         return false;
 
-    entryStatement.bindInt64(1, resource->type());
-    entryStatement.bindInt64(2, resource->storageID());
+    entryStatement->bindInt64(1, resource->type());
+    entryStatement->bindInt64(2, resource->storageID());
 
-    return executeStatement(entryStatement);
+    return executeStatement(*entryStatement);
 }
 
 bool ApplicationCacheStorage::store(ApplicationCacheResource* resource, ApplicationCache* cache)
@@ -955,14 +974,14 @@ bool ApplicationCacheStorage::store(ApplicationCacheResource* resource, Applicat
     }
 
     // A resource was added to the cache. Update the total data size for the cache.
-    SQLiteStatement sizeUpdateStatement(m_database, "UPDATE Caches SET size=size+? WHERE id=?");
-    if (sizeUpdateStatement.prepare() != SQLResultOk)
+    SQLiteStatement* sizeUpdateStatement = m_database.cachedStatement("UPDATE Caches SET size=size+? WHERE id=?");
+    if (!sizeUpdateStatement)
         return false;
 
-    sizeUpdateStatement.bindInt64(1, resource->estimatedSizeInStorage());
-    sizeUpdateStatement.bindInt64(2, cache->storageID());
+    sizeUpdateStatement->bindInt64(1, resource->estimatedSizeInStorage());
+    sizeUpdateStatement->bindInt64(2, cache->storageID());
 
-    if (!executeStatement(sizeUpdateStatement))
+    if (!executeStatement(*sizeUpdateStatement))
         return false;
     
     storeResourceTransaction.commit();
@@ -1120,34 +1139,33 @@ static inline void parseHeaders(const String& headers, ResourceResponse& respons
 PassRefPtr<ApplicationCache> ApplicationCacheStorage::loadCache(unsigned storageID)
 {
     ASSERT(SQLiteDatabaseTracker::hasTransactionInProgress());
-    SQLiteStatement cacheStatement(m_database,
-                                   "SELECT url, statusCode, type, mimeType, textEncodingName, headers, CacheResourceData.data, CacheResourceData.path FROM CacheEntries INNER JOIN CacheResources ON CacheEntries.resource=CacheResources.id "
-                                   "INNER JOIN CacheResourceData ON CacheResourceData.id=CacheResources.data WHERE CacheEntries.cache=?");
-    if (cacheStatement.prepare() != SQLResultOk) {
+    SQLiteStatement* cacheStatement = m_database.cachedStatement("SELECT url, statusCode, type, mimeType, textEncodingName, headers, CacheResourceData.data, CacheResourceData.path FROM CacheEntries INNER JOIN CacheResources ON CacheEntries.resource=CacheResources.id "
+        "INNER JOIN CacheResourceData ON CacheResourceData.id=CacheResources.data WHERE CacheEntries.cache=?");
+    if (!cacheStatement) {
         LOG_ERROR("Could not prepare cache statement, error \"%s\"", m_database.lastErrorMsg());
         return 0;
     }
     
-    cacheStatement.bindInt64(1, storageID);
+    cacheStatement->bindInt64(1, storageID);
 
     RefPtr<ApplicationCache> cache = ApplicationCache::create();
 
     String flatFileDirectory = pathByAppendingComponent(m_cacheDirectory, flatFileSubdirectory);
 
     int result;
-    while ((result = cacheStatement.step()) == SQLResultRow) {
-        URL url(ParsedURLString, cacheStatement.getColumnText(0));
+    while ((result = cacheStatement->step()) == SQLResultRow) {
+        URL url(ParsedURLString, cacheStatement->getColumnText(0));
         
-        int httpStatusCode = cacheStatement.getColumnInt(1);
+        int httpStatusCode = cacheStatement->getColumnInt(1);
 
-        unsigned type = static_cast<unsigned>(cacheStatement.getColumnInt64(2));
+        unsigned type = static_cast<unsigned>(cacheStatement->getColumnInt64(2));
 
         Vector<char> blob;
-        cacheStatement.getColumnBlobAsVector(6, blob);
+        cacheStatement->getColumnBlobAsVector(6, blob);
         
         RefPtr<SharedBuffer> data = SharedBuffer::adoptVector(blob);
         
-        String path = cacheStatement.getColumnText(7);
+        String path = cacheStatement->getColumnText(7);
         long long size = 0;
         if (path.isEmpty())
             size = data->size();
@@ -1156,13 +1174,13 @@ PassRefPtr<ApplicationCache> ApplicationCacheStorage::loadCache(unsigned storage
             getFileSize(path, size);
         }
         
-        String mimeType = cacheStatement.getColumnText(3);
-        String textEncodingName = cacheStatement.getColumnText(4);
+        String mimeType = cacheStatement->getColumnText(3);
+        String textEncodingName = cacheStatement->getColumnText(4);
         
         ResourceResponse response(url, mimeType, size, textEncodingName, "");
         response.setHTTPStatusCode(httpStatusCode);
 
-        String headers = cacheStatement.getColumnText(5);
+        String headers = cacheStatement->getColumnText(5);
         parseHeaders(headers, response);
         
         RefPtr<ApplicationCacheResource> resource = ApplicationCacheResource::create(url, response, type, data.release(), path);
@@ -1175,6 +1193,7 @@ PassRefPtr<ApplicationCache> ApplicationCacheStorage::loadCache(unsigned storage
 
     if (result != SQLResultDone)
         LOG_ERROR("Could not load cache resources, error \"%s\"", m_database.lastErrorMsg());
+    cacheStatement->reset();
 
     if (!cache->manifestResource()) {
         LOG_ERROR("Could not load application cache because there was no manifest resource");
@@ -1182,47 +1201,50 @@ PassRefPtr<ApplicationCache> ApplicationCacheStorage::loadCache(unsigned storage
     }
 
     // Load the online whitelist
-    SQLiteStatement whitelistStatement(m_database, "SELECT url FROM CacheWhitelistURLs WHERE cache=?");
-    if (whitelistStatement.prepare() != SQLResultOk)
+    SQLiteStatement* whitelistStatement = m_database.cachedStatement("SELECT url FROM CacheWhitelistURLs WHERE cache=?");
+    if (!whitelistStatement)
         return 0;
-    whitelistStatement.bindInt64(1, storageID);
+    whitelistStatement->bindInt64(1, storageID);
     
     Vector<URL> whitelist;
-    while ((result = whitelistStatement.step()) == SQLResultRow) 
-        whitelist.append(URL(ParsedURLString, whitelistStatement.getColumnText(0)));
+    while ((result = whitelistStatement->step()) == SQLResultRow) 
+        whitelist.append(URL(ParsedURLString, whitelistStatement->getColumnText(0)));
 
     if (result != SQLResultDone)
         LOG_ERROR("Could not load cache online whitelist, error \"%s\"", m_database.lastErrorMsg());
+    whitelistStatement->reset();
 
     cache->setOnlineWhitelist(whitelist);
 
     // Load online whitelist wildcard flag.
-    SQLiteStatement whitelistWildcardStatement(m_database, "SELECT wildcard FROM CacheAllowsAllNetworkRequests WHERE cache=?");
-    if (whitelistWildcardStatement.prepare() != SQLResultOk)
+    SQLiteStatement* whitelistWildcardStatement = m_database.cachedStatement("SELECT wildcard FROM CacheAllowsAllNetworkRequests WHERE cache=?");
+    if (!whitelistWildcardStatement)
         return 0;
-    whitelistWildcardStatement.bindInt64(1, storageID);
+    whitelistWildcardStatement->bindInt64(1, storageID);
     
-    result = whitelistWildcardStatement.step();
+    result = whitelistWildcardStatement->step();
     if (result != SQLResultRow)
         LOG_ERROR("Could not load cache online whitelist wildcard flag, error \"%s\"", m_database.lastErrorMsg());
 
-    cache->setAllowsAllNetworkRequests(whitelistWildcardStatement.getColumnInt64(0));
+    cache->setAllowsAllNetworkRequests(whitelistWildcardStatement->getColumnInt64(0));
 
-    if (whitelistWildcardStatement.step() != SQLResultDone)
+    if (whitelistWildcardStatement->step() != SQLResultDone)
         LOG_ERROR("Too many rows for online whitelist wildcard flag");
+    whitelistWildcardStatement->reset();
 
     // Load fallback URLs.
-    SQLiteStatement fallbackStatement(m_database, "SELECT namespace, fallbackURL FROM FallbackURLs WHERE cache=?");
-    if (fallbackStatement.prepare() != SQLResultOk)
+    SQLiteStatement* fallbackStatement = m_database.cachedStatement("SELECT namespace, fallbackURL FROM FallbackURLs WHERE cache=?");
+    if (!fallbackStatement)
         return 0;
-    fallbackStatement.bindInt64(1, storageID);
+    fallbackStatement->bindInt64(1, storageID);
     
     FallbackURLVector fallbackURLs;
-    while ((result = fallbackStatement.step()) == SQLResultRow) 
-        fallbackURLs.append(std::make_pair(URL(ParsedURLString, fallbackStatement.getColumnText(0)), URL(ParsedURLString, fallbackStatement.getColumnText(1))));
+    while ((result = fallbackStatement->step()) == SQLResultRow) 
+        fallbackURLs.append(std::make_pair(URL(ParsedURLString, fallbackStatement->getColumnText(0)), URL(ParsedURLString, fallbackStatement->getColumnText(1))));
 
     if (result != SQLResultDone)
         LOG_ERROR("Could not load fallback URLs, error \"%s\"", m_database.lastErrorMsg());
+    fallbackStatement->reset();
 
     cache->setFallbackURLs(fallbackURLs);
     
@@ -349,6 +349,7 @@ inline void CachedImage::createImage()
     } else {
         m_image = BitmapImage::create(this);
         toBitmapImage(m_image.get())->setAllowSubsampling(m_loader && m_loader->frameLoader()->frame().settings().imageSubsamplingEnabled());
+        toBitmapImage(m_image.get())->setAllowsAsynchronousDecoding(m_loader && m_loader->frameLoader()->frame().settings().asynchronousImageDecodingEnabled());
     }
 
     if (m_image) {
@@ -68,6 +68,10 @@ static const int iconExpirationTime = 60*60*24*4;
 
 static const int updateTimerDelay = 5; 
 
+// Map up to 32MB of the database file, and keep the write-ahead log from holding on to more than 4MB
+static const int64_t iconDatabaseMemoryMappedSize = 32 * 1024 * 1024;
+static const int64_t iconDatabaseJournalSizeLimit = 4 * 1024 * 1024;
+
 static bool checkIntegrityOnOpen = false;
 
 #if PLATFORM(GTK)
@@ -1146,6 +1150,12 @@ void IconDatabase::performOpenInitialization()
     if (!SQLiteStatement(m_syncDB, "PRAGMA cache_size = 200;").executeCommand())         
         LOG_ERROR("SQLite database could not set cache_size");
 
+    // Icons are written in batches on this thread and can always be refetched, so there is no need to
+    // sync every commit. Reading the database through a memory mapping saves a copy of each icon.
+    m_syncDB.setSynchronous(SQLiteDatabase::SyncNormal);
+    m_syncDB.setMemoryMappedSize(iconDatabaseMemoryMappedSize);
+    m_syncDB.setJournalSizeLimit(iconDatabaseJournalSizeLimit);
+
     // Tell backup software (i.e., Time Machine) to never back up the icon database, because  
     // it's a large file that changes frequently, thus using a lot of backup disk space, and 
     // it's unlikely that many users would be upset about it not being backed up. We could 
@@ -1758,20 +1768,7 @@ void IconDatabase::deleteAllPreparedStatements()
 {
     ASSERT_ICON_SYNC_THREAD();
     
-    m_setIconIDForPageURLStatement.clear();
-    m_removePageURLStatement.clear();
-    m_getIconIDForIconURLStatement.clear();
-    m_getImageDataForIconURLStatement.clear();
-    m_addIconToIconInfoStatement.clear();
-    m_addIconToIconDataStatement.clear();
-    m_getImageDataStatement.clear();
-    m_deletePageURLsForIconURLStatement.clear();
-    m_deleteIconFromIconInfoStatement.clear();
-    m_deleteIconFromIconDataStatement.clear();
-    m_updateIconInfoStatement.clear();
-    m_updateIconDataStatement.clear();
-    m_setIconInfoStatement.clear();
-    m_setIconDataStatement.clear();
+    m_syncDB.clearStatementCache();
 }
 
 void* IconDatabase::cleanupSyncThread()
@@ -1806,24 +1803,6 @@ void* IconDatabase::cleanupSyncThread()
     return 0;
 }
 
-// readySQLiteStatement() handles two things
-// 1 - If the SQLDatabase& argument is different, the statement must be destroyed and remade.  This happens when the user
-//     switches to and from private browsing
-// 2 - Lazy construction of the Statement in the first place, in case we've never made this query before
-inline void readySQLiteStatement(OwnPtr<SQLiteStatement>& statement, SQLiteDatabase& db, const String& str)
-{
-    if (statement && (statement->database() != &db || statement->isExpired())) {
-        if (statement->isExpired())
-            LOG(IconDatabase, "SQLiteStatement associated with %s is expired", str.ascii().data());
-        statement.clear();
-    }
-    if (!statement) {
-        statement = adoptPtr(new SQLiteStatement(db, str));
-        if (statement->prepare() != SQLResultOk)
-            LOG_ERROR("Preparing statement %s failed", str.ascii().data());
-    }
-}
-
 void IconDatabase::setIconURLForPageURLInSQLDatabase(const String& iconURL, const String& pageURL)
 {
     ASSERT_ICON_SYNC_THREAD();
@@ -1846,30 +1825,34 @@ void IconDatabase::setIconIDForPageURLInSQLDatabase(int64_t iconID, const String
 {
     ASSERT_ICON_SYNC_THREAD();
     
-    readySQLiteStatement(m_setIconIDForPageURLStatement, m_syncDB, "INSERT INTO PageURL (url, iconID) VALUES ((?), ?);");
-    m_setIconIDForPageURLStatement->bindText(1, pageURL);
-    m_setIconIDForPageURLStatement->bindInt64(2, iconID);
+    SQLiteStatement* statement = m_syncDB.cachedStatement("INSERT INTO PageURL (url, iconID) VALUES ((?), ?);");
+    if (!statement)
+        return;
+    statement->bindText(1, pageURL);
+    statement->bindInt64(2, iconID);
 
-    int result = m_setIconIDForPageURLStatement->step();
+    int result = statement->step();
     if (result != SQLResultDone) {
         ASSERT_NOT_REACHED();
         LOG_ERROR("setIconIDForPageURLQuery failed for url %s", urlForLogging(pageURL).ascii().data());
     }
 
-    m_setIconIDForPageURLStatement->reset();
+    statement->reset();
 }
 
 void IconDatabase::removePageURLFromSQLDatabase(const String& pageURL)
 {
     ASSERT_ICON_SYNC_THREAD();
     
-    readySQLiteStatement(m_removePageURLStatement, m_syncDB, "DELETE FROM PageURL WHERE url = (?);");
-    m_removePageURLStatement->bindText(1, pageURL);
+    SQLiteStatement* statement = m_syncDB.cachedStatement("DELETE FROM PageURL WHERE url = (?);");
+    if (!statement)
+        return;
+    statement->bindText(1, pageURL);
 
-    if (m_removePageURLStatement->step() != SQLResultDone)
+    if (statement->step() != SQLResultDone)
         LOG_ERROR("removePageURLFromSQLDatabase failed for url %s", urlForLogging(pageURL).ascii().data());
     
-    m_removePageURLStatement->reset();
+    statement->reset();
 }
 
 
@@ -1877,19 +1860,21 @@ int64_t IconDatabase::getIconIDForIconURLFromSQLDatabase(const String& iconURL)
 {
     ASSERT_ICON_SYNC_THREAD();
     
-    readySQLiteStatement(m_getIconIDForIconURLStatement, m_syncDB, "SELECT IconInfo.iconID FROM IconInfo WHERE IconInfo.url = (?);");
-    m_getIconIDForIconURLStatement->bindText(1, iconURL);
+    SQLiteStatement* statement = m_syncDB.cachedStatement("SELECT IconInfo.iconID FROM IconInfo WHERE IconInfo.url = (?);");
+    if (!statement)
+        return 0;
+    statement->bindText(1, iconURL);
     
-    int64_t result = m_getIconIDForIconURLStatement->step();
+    int64_t result = statement->step();
     if (result == SQLResultRow)
-        result = m_getIconIDForIconURLStatement->getColumnInt64(0);
+        result = statement->getColumnInt64(0);
     else {
         if (result != SQLResultDone)
             LOG_ERROR("getIconIDForIconURLFromSQLDatabase failed for url %s", urlForLogging(iconURL).ascii().data());
         result = 0;
     }
 
-    m_getIconIDForIconURLStatement->reset();
+    statement->reset();
     return result;
 }
 
@@ -1901,22 +1886,26 @@ int64_t IconDatabase::addIconURLToSQLDatabase(const String& iconURL)
     // In practice the only caller of this method is always wrapped in a transaction itself so placing another
     // here is unnecessary
     
-    readySQLiteStatement(m_addIconToIconInfoStatement, m_syncDB, "INSERT INTO IconInfo (url, stamp) VALUES (?, 0);");
-    m_addIconToIconInfoStatement->bindText(1, iconURL);
+    SQLiteStatement* statement = m_syncDB.cachedStatement("INSERT INTO IconInfo (url, stamp) VALUES (?, 0);");
+    if (!statement)
+        return 0;
+    statement->bindText(1, iconURL);
     
-    int result = m_addIconToIconInfoStatement->step();
-    m_addIconToIconInfoStatement->reset();
+    int result = statement->step();
+    statement->reset();
     if (result != SQLResultDone) {
         LOG_ERROR("addIconURLToSQLDatabase failed to insert %s into IconInfo", urlForLogging(iconURL).ascii().data());
         return 0;
     }
     int64_t iconID = m_syncDB.lastInsertRowID();
     
-    readySQLiteStatement(m_addIconToIconDataStatement, m_syncDB, "INSERT INTO IconData (iconID, data) VALUES (?, ?);");
-    m_addIconToIconDataStatement->bindInt64(1, iconID);
+    statement = m_syncDB.cachedStatement("INSERT INTO IconData (iconID, data) VALUES (?, ?);");
+    if (!statement)
+        return 0;
+    statement->bindInt64(1, iconID);
     
-    result = m_addIconToIconDataStatement->step();
-    m_addIconToIconDataStatement->reset();
+    result = statement->step();
+    statement->reset();
     if (result != SQLResultDone) {
         LOG_ERROR("addIconURLToSQLDatabase failed to insert %s into IconData", urlForLogging(iconURL).ascii().data());
         return 0;
@@ -1931,18 +1920,20 @@ PassRefPtr<SharedBuffer> IconDatabase::getImageDataForIconURLFromSQLDatabase(con
     
     RefPtr<SharedBuffer> imageData;
     
-    readySQLiteStatement(m_getImageDataForIconURLStatement, m_syncDB, "SELECT IconData.data FROM IconData WHERE IconData.iconID IN (SELECT iconID FROM IconInfo WHERE IconInfo.url = (?));");
-    m_getImageDataForIconURLStatement->bindText(1, iconURL);
+    SQLiteStatement* statement = m_syncDB.cachedStatement("SELECT IconData.data FROM IconData WHERE IconData.iconID IN (SELECT iconID FROM IconInfo WHERE IconInfo.url = (?));");
+    if (!statement)
+        return nullptr;
+    statement->bindText(1, iconURL);
     
-    int result = m_getImageDataForIconURLStatement->step();
+    int result = statement->step();
     if (result == SQLResultRow) {
         Vector<char> data;
-        m_getImageDataForIconURLStatement->getColumnBlobAsVector(0, data);
+        statement->getColumnBlobAsVector(0, data);
         imageData = SharedBuffer::create(data.data(), data.size());
     } else if (result != SQLResultDone)
         LOG_ERROR("getImageDataForIconURLFromSQLDatabase failed for url %s", urlForLogging(iconURL).ascii().data());
 
-    m_getImageDataForIconURLStatement->reset();
+    statement->reset();
     
     return imageData.release();
 }
@@ -1963,27 +1954,29 @@ void IconDatabase::removeIconFromSQLDatabase(const String& iconURL)
     if (!iconID)
         return;
     
-    readySQLiteStatement(m_deletePageURLsForIconURLStatement, m_syncDB, "DELETE FROM PageURL WHERE PageURL.iconID = (?);");
-    m_deletePageURLsForIconURLStatement->bindInt64(1, iconID);
-    
-    if (m_deletePageURLsForIconURLStatement->step() != SQLResultDone)
-        LOG_ERROR("m_deletePageURLsForIconURLStatement failed for url %s", urlForLogging(iconURL).ascii().data());
-    
-    readySQLiteStatement(m_deleteIconFromIconInfoStatement, m_syncDB, "DELETE FROM IconInfo WHERE IconInfo.iconID = (?);");
-    m_deleteIconFromIconInfoStatement->bindInt64(1, iconID);
-    
-    if (m_deleteIconFromIconInfoStatement->step() != SQLResultDone)
-        LOG_ERROR("m_deleteIconFromIconInfoStatement failed for url %s", urlForLogging(iconURL).ascii().data());
-        
-    readySQLiteStatement(m_deleteIconFromIconDataStatement, m_syncDB, "DELETE FROM IconData WHERE IconData.iconID = (?);");
-    m_deleteIconFromIconDataStatement->bindInt64(1, iconID);
+    SQLiteStatement* statement = m_syncDB.cachedStatement("DELETE FROM PageURL WHERE PageURL.iconID = (?);");
+    if (statement) {
+        statement->bindInt64(1, iconID);
+        if (statement->step() != SQLResultDone)
+            LOG_ERROR("Deleting page URLs failed for url %s", urlForLogging(iconURL).ascii().data());
+        statement->reset();
+    }
     
-    if (m_deleteIconFromIconDataStatement->step() != SQLResultDone)
-        LOG_ERROR("m_deleteIconFromIconDataStatement failed for url %s", urlForLogging(iconURL).ascii().data());
+    statement = m_syncDB.cachedStatement("DELETE FROM IconInfo WHERE IconInfo.iconID = (?);");
+    if (statement) {
+        statement->bindInt64(1, iconID);
+        if (statement->step() != SQLResultDone)
+            LOG_ERROR("Deleting icon info failed for url %s", urlForLogging(iconURL).ascii().data());
+        statement->reset();
+    }
         
-    m_deletePageURLsForIconURLStatement->reset();
-    m_deleteIconFromIconInfoStatement->reset();
-    m_deleteIconFromIconDataStatement->reset();
+    statement = m_syncDB.cachedStatement("DELETE FROM IconData WHERE IconData.iconID = (?);");
+    if (statement) {
+        statement->bindInt64(1, iconID);
+        if (statement->step() != SQLResultDone)
+            LOG_ERROR("Deleting icon data failed for url %s", urlForLogging(iconURL).ascii().data());
+        statement->reset();
+    }
 }
 
 void IconDatabase::writeIconSnapshotToSQLDatabase(const IconSnapshot& snapshot)
@@ -2009,56 +2002,64 @@ void IconDatabase::writeIconSnapshotToSQLDatabase(const IconSnapshot& snapshot)
     // If there is already an iconID in place, update the database.  
     // Otherwise, insert new records
     if (iconID) {    
-        readySQLiteStatement(m_updateIconInfoStatement, m_syncDB, "UPDATE IconInfo SET stamp = ?, url = ? WHERE iconID = ?;");
-        m_updateIconInfoStatement->bindInt64(1, snapshot.timestamp());
-        m_updateIconInfoStatement->bindText(2, snapshot.iconURL());
-        m_updateIconInfoStatement->bindInt64(3, iconID);
+        SQLiteStatement* statement = m_syncDB.cachedStatement("UPDATE IconInfo SET stamp = ?, url = ? WHERE iconID = ?;");
+        if (!statement)
+            return;
+        statement->bindInt64(1, snapshot.timestamp());
+        statement->bindText(2, snapshot.iconURL());
+        statement->bindInt64(3, iconID);
 
-        if (m_updateIconInfoStatement->step() != SQLResultDone)
+        if (statement->step() != SQLResultDone)
             LOG_ERROR("Failed to update icon info for url %s", urlForLogging(snapshot.iconURL()).ascii().data());
         
-        m_updateIconInfoStatement->reset();
+        statement->reset();
         
-        readySQLiteStatement(m_updateIconDataStatement, m_syncDB, "UPDATE IconData SET data = ? WHERE iconID = ?;");
-        m_updateIconDataStatement->bindInt64(2, iconID);
+        statement = m_syncDB.cachedStatement("UPDATE IconData SET data = ? WHERE iconID = ?;");
+        if (!statement)
+            return;
+        statement->bindInt64(2, iconID);
                 
         // If we *have* image data, bind it to this statement - Otherwise bind "null" for the blob data, 
         // signifying that this icon doesn't have any data    
         if (snapshot.data() && snapshot.data()->size())
-            m_updateIconDataStatement->bindBlob(1, snapshot.data()->data(), snapshot.data()->size());
+            statement->bindBlob(1, snapshot.data()->data(), snapshot.data()->size());
         else
-            m_updateIconDataStatement->bindNull(1);
+            statement->bindNull(1);
         
-        if (m_updateIconDataStatement->step() != SQLResultDone)
+        if (statement->step() != SQLResultDone)
             LOG_ERROR("Failed to update icon data for url %s", urlForLogging(snapshot.iconURL()).ascii().data());
 
-        m_updateIconDataStatement->reset();
+        statement->reset();
     } else {    
-        readySQLiteStatement(m_setIconInfoStatement, m_syncDB, "INSERT INTO IconInfo (url,stamp) VALUES (?, ?);");
-        m_setIconInfoStatement->bindText(1, snapshot.iconURL());
-        m_setIconInfoStatement->bindInt64(2, snapshot.timestamp());
+        SQLiteStatement* statement = m_syncDB.cachedStatement("INSERT INTO IconInfo (url,stamp) VALUES (?, ?);");
+        if (!statement)
+            return;
+        statement->bindText(1, snapshot.iconURL());
+        statement->bindInt64(2, snapshot.timestamp());
 
-        if (m_setIconInfoStatement->step() != SQLResultDone)
+        if (statement->step() != SQLResultDone)
             LOG_ERROR("Failed to set icon info for url %s", urlForLogging(snapshot.iconURL()).ascii().data());
         
-        m_setIconInfoStatement->reset();
+        statement->reset();
         
         int64_t iconID = m_syncDB.lastInsertRowID();
 
-        readySQLiteStatement(m_setIconDataStatement, m_syncDB, "INSERT INTO IconData (iconID, data) VALUES (?, ?);");
-        m_setIconDataStatement->bindInt64(1, iconID);
+        statement = m_syncDB.cachedStatement("INSERT INTO IconData (iconID, data) VALUES (?, ?);");
+        if (!statement)
+            return;
+        statement->bindInt64(1, iconID);
 
         // If we *have* image data, bind it to this statement - Otherwise bind "null" for the blob data, 
         // signifying that this icon doesn't have any data    
         if (snapshot.data() && snapshot.data()->size())
-            m_setIconDataStatement->bindBlob(2, snapshot.data()->data(), snapshot.data()->size());
+            statement->bindBlob(2, snapshot.data()->data(), snapshot.data()->size());
         else
-            m_setIconDataStatement->bindNull(2);
+            statement->bindNull(2);
         
-        if (m_setIconDataStatement->step() != SQLResultDone)
+        if (statement->step() != SQLResultDone)
             LOG_ERROR("Failed to set icon data for url %s", urlForLogging(snapshot.iconURL()).ascii().data());
 
-        m_setIconDataStatement->reset();
+        statement->reset();
     }
 }
 
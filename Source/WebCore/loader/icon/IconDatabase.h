@@ -230,21 +230,6 @@ private:
     IconDatabaseClient* m_client;
     
     SQLiteDatabase m_syncDB;
-    
-    OwnPtr<SQLiteStatement> m_setIconIDForPageURLStatement;
-    OwnPtr<SQLiteStatement> m_removePageURLStatement;
-    OwnPtr<SQLiteStatement> m_getIconIDForIconURLStatement;
-    OwnPtr<SQLiteStatement> m_getImageDataForIconURLStatement;
-    OwnPtr<SQLiteStatement> m_addIconToIconInfoStatement;
-    OwnPtr<SQLiteStatement> m_addIconToIconDataStatement;
-    OwnPtr<SQLiteStatement> m_getImageDataStatement;
-    OwnPtr<SQLiteStatement> m_deletePageURLsForIconURLStatement;
-    OwnPtr<SQLiteStatement> m_deleteIconFromIconInfoStatement;
-    OwnPtr<SQLiteStatement> m_deleteIconFromIconDataStatement;
-    OwnPtr<SQLiteStatement> m_updateIconInfoStatement;
-    OwnPtr<SQLiteStatement> m_updateIconDataStatement;
-    OwnPtr<SQLiteStatement> m_setIconInfoStatement;
-    OwnPtr<SQLiteStatement> m_setIconDataStatement;
 };
 
 #endif // !ENABLE(ICONDATABASE)
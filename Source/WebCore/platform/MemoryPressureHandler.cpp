@@ -36,6 +36,8 @@
 #include "Page.h"
 #include "PageCache.h"
 #include "ScrollingThread.h"
+#include "SelectorQuery.h"
+#include "ShadowBlur.h"
 #include "StorageThread.h"
 #include "WorkerThread.h"
 #include <wtf/CurrentTime.h>
@@ -43,6 +45,10 @@
 #include <wtf/Functional.h>
 #include <wtf/StdLibExtras.h>
 
+#if USE(HARFBUZZ)
+#include "HarfBuzzFace.h"
+#endif
+
 namespace WebCore {
 
 WEBCORE_EXPORT bool MemoryPressureHandler::ReliefLogger::s_loggingEnabled = false;
@@ -80,10 +86,21 @@ void MemoryPressureHandler::releaseNoncriticalMemory()
         clearWidthCaches();
     }
 
+#if USE(HARFBUZZ)
+    {
+        ReliefLogger log("Clear HarfBuzz shaped word caches");
+        HarfBuzzFace::clearShapedWordCaches();
+    }
+#endif
+
     {
         ReliefLogger log("Discard Selector Query Cache");
-        for (auto* document : Document::allDocuments())
-            document->clearSelectorQueryCache();
+        selectorQueryCache().clear();
+    }
+
+    {
+        ReliefLogger log("Discard shadow blur templates");
+        ShadowBlur::purgeTemplateCache();
     }
 
     {
@@ -144,7 +161,7 @@ void MemoryPressureHandler::releaseMemory(bool critical)
     }
 }
 
-#if !PLATFORM(COCOA)
+#if !PLATFORM(COCOA) && !OS(LINUX) && !OS(WINDOWS)
 void MemoryPressureHandler::install() { }
 void MemoryPressureHandler::uninstall() { }
 void MemoryPressureHandler::holdOff(unsigned) { }
@@ -115,6 +115,10 @@ private:
     void respondToMemoryPressure(bool critical);
     static void platformReleaseMemory(bool critical);
 
+#if OS(LINUX) || OS(WINDOWS)
+    static void waitForMemoryPressureEvents(void*);
+#endif
+
     bool m_installed;
     time_t m_lastRespondTime;
     LowMemoryHandler m_lowMemoryHandler;
@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2014 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "AsynchronousImageDecoder.h"
+
+#if !USE(CG)
+
+#include "ImageDecoder.h"
+#include "ImageSource.h"
+#include "SharedBuffer.h"
+#include <wtf/MainThread.h>
+#include <wtf/MessageQueue.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/NumberOfCores.h>
+#include <wtf/Threading.h>
+
+namespace WebCore {
+
+// Decoding is mostly bound by memory bandwidth, so a couple of threads are enough to keep
+// large images off the main thread without competing with it for every core.
+static const int maximumNumberOfDecodingThreads = 2;
+
+class ImageDecodingThreadPool {
+    WTF_MAKE_NONCOPYABLE(ImageDecodingThreadPool); WTF_MAKE_FAST_ALLOCATED;
+public:
+    ImageDecodingThreadPool()
+    {
+        ASSERT(isMainThread());
+        int numberOfThreads = std::max(1, std::min(WTF::numberOfProcessorCores() - 1, maximumNumberOfDecodingThreads));
+        for (int i = 0; i < numberOfThreads; ++i)
+            createThread(&ImageDecodingThreadPool::threadEntryPoint, this, "WebCore: ImageDecoder");
+    }
+
+    void dispatch(const std::function<void ()>& function)
+    {
+        m_queue.append(std::make_unique<std::function<void ()>>(function));
+    }
+
+private:
+    static void threadEntryPoint(void* context)
+    {
+        ImageDecodingThreadPool* pool = static_cast<ImageDecodingThreadPool*>(context);
+        while (auto function = pool->m_queue.waitForMessage())
+            (*function)();
+    }
+
+    MessageQueue<std::function<void ()>> m_queue;
+};
+
+static ImageDecodingThreadPool& imageDecodingThreadPool()
+{
+    static NeverDestroyed<ImageDecodingThreadPool> pool;
+    return pool;
+}
+
+PassRefPtr<AsynchronousImageDecoder> AsynchronousImageDecoder::create(const SharedBuffer& encodedData, CompletionHandler completionHandler)
+{
+    return adoptRef(new AsynchronousImageDecoder(encodedData, WTF::move(completionHandler)));
+}
+
+AsynchronousImageDecoder::AsynchronousImageDecoder(const SharedBuffer& encodedData, CompletionHandler completionHandler)
+    : m_encodedData(SharedBuffer::create(encodedData.data(), encodedData.size()))
+    , m_decoderSubsamplingLevel(0)
+    , m_completionHandler(WTF::move(completionHandler))
+    , m_isDecoding(false)
+{
+    ASSERT(isMainThread());
+}
+
+AsynchronousImageDecoder::~AsynchronousImageDecoder()
+{
+}
+
+void AsynchronousImageDecoder::decodeFrame(size_t index, SubsamplingLevel subsamplingLevel)
+{
+    ASSERT(isMainThread());
+    if (!m_completionHandler || isDecodingFrame(index))
+        return;
+
+    FrameRequest request = { index, subsamplingLevel };
+    m_requestedFrames.append(request);
+    if (!m_isDecoding)
+        startNextRequest();
+}
+
+bool AsynchronousImageDecoder::isDecodingFrame(size_t index) const
+{
+    ASSERT(isMainThread());
+    for (const auto& request : m_requestedFrames) {
+        if (request.index == index)
+            return true;
+    }
+    return false;
+}
+
+void AsynchronousImageDecoder::cancel()
+{
+    ASSERT(isMainThread());
+    m_completionHandler = nullptr;
+
+    // Keep the running request so that nothing new is started before it returns.
+    while (m_requestedFrames.size() > (m_isDecoding ? 1 : 0))
+        m_requestedFrames.removeLast();
+}
+
+void AsynchronousImageDecoder::startNextRequest()
+{
+    ASSERT(isMainThread());
+    ASSERT(!m_requestedFrames.isEmpty());
+    ASSERT(!m_isDecoding);
+
+    m_isDecoding = true;
+    size_t index = m_requestedFrames.first().index;
+    SubsamplingLevel subsamplingLevel = m_requestedFrames.first().subsamplingLevel;
+
+    // The decoding thread only uses this reference; it is adopted and released back on the main
+    // thread, so the decoder is never destroyed on a decoding thread.
+    ref();
+    AsynchronousImageDecoder* decoder = this;
+    imageDecodingThreadPool().dispatch([decoder, index, subsamplingLevel] {
+        DecodedFrame decodedFrame = decoder->decodeFrameOnDecodingThread(index, subsamplingLevel);
+        callOnMainThread([decoder, index, decodedFrame] {
+            RefPtr<AsynchronousImageDecoder> protectedDecoder = adoptRef(decoder);
+            decoder->didDecodeFrame(index, decodedFrame);
+        });
+    });
+}
+
+void AsynchronousImageDecoder::didDecodeFrame(size_t index, const DecodedFrame& decodedFrame)
+{
+    ASSERT(isMainThread());
+    ASSERT(m_isDecoding);
+    ASSERT(!m_requestedFrames.isEmpty() && m_requestedFrames.first().index == index);
+    m_requestedFrames.removeFirst();
+    m_isDecoding = false;
+
+    if (!m_completionHandler)
+        return;
+
+    // The handler may cancel this decoder or request more frames.
+    RefPtr<AsynchronousImageDecoder> protectedThis(this);
+    m_completionHandler(index, decodedFrame);
+
+    if (m_completionHandler && !m_isDecoding && !m_requestedFrames.isEmpty())
+        startNextRequest();
+}
+
+AsynchronousImageDecoder::DecodedFrame AsynchronousImageDecoder::decodeFrameOnDecodingThread(size_t index, SubsamplingLevel subsamplingLevel)
+{
+    ASSERT(!isMainThread());
+    DecodedFrame decodedFrame;
+
+    // Same rule as ImageSource::createFrameAtIndex(): a decoder works at a single subsampling level,
+    // and only an image with a single frame is decoded again to change it.
+    if (m_decoder && subsamplingLevel != m_decoderSubsamplingLevel && m_decoder->supportsSubsampling() && m_decoder->frameCount() == 1)
+        m_decoder = nullptr;
+
+    if (!m_decoder) {
+        m_decoder = std::unique_ptr<ImageDecoder>(ImageDecoder::create(*m_encodedData, ImageSource::AlphaPremultiplied, ImageSource::GammaAndColorProfileApplied));
+        if (!m_decoder)
+            return decodedFrame;
+#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+        if (ImageSource::maxPixelsPerDecodedImage())
+            m_decoder->setMaxNumPixels(ImageSource::maxPixelsPerDecodedImage());
+#endif
+        m_decoderSubsamplingLevel = subsamplingLevel;
+        if (subsamplingLevel)
+            m_decoder->setSubsamplingLevel(subsamplingLevel);
+        m_decoder->setData(m_encodedData.get(), true);
+    }
+
+    ImageFrame* buffer = m_decoder->frameBufferAtIndex(index);
+    if (!buffer || buffer->status() == ImageFrame::FrameEmpty || m_decoder->size().isEmpty())
+        return decodedFrame;
+
+    decodedFrame.frame = buffer->asNewNativeImageCopy();
+    decodedFrame.orientation = m_decoder->orientation();
+    decodedFrame.subsamplingLevel = m_decoderSubsamplingLevel;
+    decodedFrame.isComplete = buffer->status() == ImageFrame::FrameComplete;
+    decodedFrame.hasAlpha = m_decoder->frameHasAlphaAtIndex(index);
+    decodedFrame.frameBytes = m_decoder->frameBytesAtIndex(index);
+
+    // Same clamping as ImageSource::frameDurationAtIndex().
+    decodedFrame.duration = buffer->duration() / 1000.0f;
+    if (decodedFrame.duration < 0.011f)
+        decodedFrame.duration = 0.100f;
+
+    // The pixels now live in the copy. Later frames of an animation may still need the
+    // ones the decoder keeps around, so only drop what comes before this frame.
+    m_decoder->clearFrameBufferCache(index);
+
+    return decodedFrame;
+}
+
+} // namespace WebCore
+
+#endif // !USE(CG)
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2014 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef AsynchronousImageDecoder_h
+#define AsynchronousImageDecoder_h
+
+#if !USE(CG)
+
+#include "ImageOrientation.h"
+#include "ImageSource.h"
+#include "NativeImagePtr.h"
+#include <functional>
+#include <memory>
+#include <wtf/Deque.h>
+#include <wtf/PassRefPtr.h>
+#include <wtf/RefPtr.h>
+#include <wtf/ThreadSafeRefCounted.h>
+
+namespace WebCore {
+
+class ImageDecoder;
+class SharedBuffer;
+
+// Decodes frames of one image on a small pool of background threads, for BitmapImage's
+// asynchronous decoding mode. It works on its own copy of the encoded data with its own
+// ImageDecoder, so the main thread's decoder is never touched off the main thread.
+//
+// Requests are made and completed on the main thread. They are run one at a time, in
+// order, because the decoder keeps state from one animation frame to the next.
+class AsynchronousImageDecoder : public ThreadSafeRefCounted<AsynchronousImageDecoder> {
+public:
+    struct DecodedFrame {
+        DecodedFrame()
+            : subsamplingLevel(0)
+            , duration(0)
+            , frameBytes(0)
+            , isComplete(false)
+            , hasAlpha(true)
+        {
+        }
+
+        NativeImagePtr frame;
+        ImageOrientation orientation;
+        SubsamplingLevel subsamplingLevel;
+        float duration;
+        unsigned frameBytes;
+        bool isComplete;
+        bool hasAlpha;
+    };
+
+    typedef std::function<void (size_t index, const DecodedFrame&)> CompletionHandler;
+
+    static PassRefPtr<AsynchronousImageDecoder> create(const SharedBuffer& encodedData, CompletionHandler);
+    ~AsynchronousImageDecoder();
+
+    void decodeFrame(size_t index, SubsamplingLevel);
+    bool isDecodingFrame(size_t index) const;
+
+    // Drops the completion handler and any requests that have not started yet.
+    // A decode that is already running finishes, but its result is discarded.
+    void cancel();
+
+private:
+    AsynchronousImageDecoder(const SharedBuffer& encodedData, CompletionHandler);
+
+    void startNextRequest();
+    void didDecodeFrame(size_t index, const DecodedFrame&);
+
+    // Called on a decoding thread.
+    DecodedFrame decodeFrameOnDecodingThread(size_t index, SubsamplingLevel);
+
+    struct FrameRequest {
+        size_t index;
+        SubsamplingLevel subsamplingLevel;
+    };
+
+    // Only used on decoding threads once the object is created.
+    RefPtr<SharedBuffer> m_encodedData;
+    std::unique_ptr<ImageDecoder> m_decoder;
+    SubsamplingLevel m_decoderSubsamplingLevel; // The level m_decoder was created with.
+
+    // Only used on the main thread.
+    CompletionHandler m_completionHandler;
+    Deque<FrameRequest> m_requestedFrames; // The first one is being decoded while m_isDecoding is set.
+    bool m_isDecoding;
+};
+
+} // namespace WebCore
+
+#endif // !USE(CG)
+
+#endif // AsynchronousImageDecoder_h
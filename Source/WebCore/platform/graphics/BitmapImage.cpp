@@ -35,6 +35,8 @@
 #include "MIMETypeRegistry.h"
 #include "Timer.h"
 #include <wtf/CurrentTime.h>
+#include <wtf/HashSet.h>
+#include <wtf/NeverDestroyed.h>
 #include <wtf/Vector.h>
 #include <wtf/text/WTFString.h>
 
@@ -44,6 +46,29 @@
 
 namespace WebCore {
 
+// Animated images larger than the cutoff only keep the frames that come next in
+// the animation. The decoded frames of all animated images also share a budget.
+#if PLATFORM(IOS)
+static const unsigned largeAnimationCutoff = 2097152;
+static const unsigned animatedImagesFrameBudget = 8388608;
+#else
+static const unsigned largeAnimationCutoff = 5242880;
+static const unsigned animatedImagesFrameBudget = 33554432;
+#endif
+
+typedef HashSet<BitmapImage*> AnimatedImageSet;
+
+static AnimatedImageSet& animatedImages()
+{
+    static NeverDestroyed<AnimatedImageSet> images;
+    return images;
+}
+
+#if !USE(CG)
+// Smaller frames decode quickly enough that painting a placeholder for them would only add flicker.
+static const unsigned minimumFrameBytesForAsynchronousDecoding = 256 * 1024;
+#endif
+
 BitmapImage::BitmapImage(ImageObserver* observer)
     : Image(observer)
     , m_minimumSubsamplingLevel(0)
@@ -73,12 +98,15 @@ BitmapImage::BitmapImage(ImageObserver* observer)
     , m_sizeAvailable(false)
     , m_hasUniformFrameSize(true)
     , m_haveFrameCount(false)
+    , m_allowsAsynchronousDecoding(false)
+    , m_advanceAnimationWhenFrameIsDecoded(false)
     , m_cachedImage(0)
 {
 }
 
 BitmapImage::~BitmapImage()
 {
+    cancelAsynchronousDecoding();
     invalidatePlatformData();
     stopAnimation();
 }
@@ -101,6 +129,9 @@ bool BitmapImage::hasSingleSecurityOrigin() const
 
 void BitmapImage::destroyDecodedData(bool destroyAll)
 {
+    if (destroyAll)
+        cancelAsynchronousDecoding();
+
     unsigned frameBytesCleared = 0;
     const size_t clearBeforeFrame = destroyAll ? m_frames.size() : m_currentFrame;
 
@@ -122,27 +153,55 @@ void BitmapImage::destroyDecodedData(bool destroyAll)
     return;
 }
 
-void BitmapImage::destroyDecodedDataIfNecessary(bool destroyAll)
+void BitmapImage::destroyDecodedDataIfNecessary()
 {
-    // Animated images over a certain size are considered large enough that we'll only hang on
-    // to one frame at a time.
-#if PLATFORM(IOS)
-    const unsigned largeAnimationCutoff = 2097152;
-#else
-    const unsigned largeAnimationCutoff = 5242880;
-#endif
+    // The animation is stopped while it advances to the next frame, and when it
+    // is reset, but the frames of this image still count against the budget.
+    AnimatedImageSet& images = animatedImages();
+    bool isAnimating = images.contains(this);
+    unsigned totalDecodedSize = isAnimating ? 0 : m_decodedSize;
+    for (auto* image : images)
+        totalDecodedSize += image->m_decodedSize;
+    unsigned imageCount = images.size() + (isAnimating ? 0 : 1);
 
+    AnimatedImageFrameWindow frameWindow(largeAnimationCutoff, animatedImagesFrameBudget);
+    unsigned windowBytes = frameWindow.windowBytes(totalDecodedSize, imageCount);
+    destroyFramesOutsideWindow(windowBytes);
+
+    // Over budget, the other animating images are trimmed to the same share.
+    if (!frameWindow.isOverBudget(totalDecodedSize))
+        return;
+    for (auto* image : images) {
+        if (image != this)
+            image->destroyFramesOutsideWindow(windowBytes);
+    }
+}
+
+void BitmapImage::destroyFramesOutsideWindow(unsigned windowBytes)
+{
     // If we have decoded frames but there is no encoded data, we shouldn't destroy
     // the decoded image since we won't be able to reconstruct it later.
-    if (!data() && m_frames.size())
+    if (m_decodedSize <= windowBytes || !data())
         return;
 
-    unsigned allFrameBytes = 0;
-    for (size_t i = 0; i < m_frames.size(); ++i)
-        allFrameBytes += m_frames[i].m_frameBytes;
+    // The frames that were just shown are the ones needed again the latest.
+    Vector<unsigned> decodedFrameBytes;
+    decodedFrameBytes.reserveInitialCapacity(m_frames.size());
+    for (auto& frame : m_frames)
+        decodedFrameBytes.uncheckedAppend(!frame.m_frame ? 0 : frame.m_frameBytes);
+
+    unsigned frameBytesCleared = 0;
+    for (size_t index : AnimatedImageFrameWindow::framesOutsideWindow(decodedFrameBytes, m_currentFrame, windowBytes)) {
+        FrameData& frame = m_frames[index];
+        unsigned frameBytes = frame.m_frameBytes;
+        if (frame.clear(false)) {
+            frameBytesCleared += frameBytes;
+            m_source.clearFrameAtIndex(index);
+        }
+    }
 
-    if (allFrameBytes > largeAnimationCutoff)
-        destroyDecodedData(destroyAll);
+    if (frameBytesCleared)
+        destroyMetadataAndNotify(frameBytesCleared);
 }
 
 void BitmapImage::destroyMetadataAndNotify(unsigned frameBytesCleared)
@@ -260,6 +319,9 @@ bool BitmapImage::getHotSpot(IntPoint& hotSpot) const
 
 bool BitmapImage::dataChanged(bool allDataReceived)
 {
+    // The asynchronous decoder works on a copy of the data, which is now out of date.
+    cancelAsynchronousDecoding();
+
     // Because we're modifying the current frame, clear its (now possibly
     // inaccurate) metadata as well.
 #if !PLATFORM(IOS)
@@ -477,6 +539,8 @@ void BitmapImage::startAnimation(CatchUpAnimation catchUpIfNecessary)
     if (m_frameTimer || !shouldAnimate() || frameCount() <= 1)
         return;
 
+    animatedImages().add(this);
+
     // If we aren't already animating, set now as the animation start time.
     const double time = monotonicallyIncreasingTime();
     if (!m_desiredFrameStartTime)
@@ -530,6 +594,11 @@ void BitmapImage::startAnimation(CatchUpAnimation catchUpIfNecessary)
         // Haven't yet reached time for next frame to start; delay until then.
         m_frameTimer = std::make_unique<Timer<BitmapImage>>(this, &BitmapImage::advanceAnimation);
         m_frameTimer->startOneShot(std::max(m_desiredFrameStartTime - time, 0.));
+
+        // Use the wait to decode the next frame in the background.
+        SubsamplingLevel subsamplingLevel = animationSubsamplingLevel();
+        if (shouldDecodeFrameAsynchronously(nextFrame, subsamplingLevel))
+            decodeFrameAsynchronously(nextFrame, subsamplingLevel);
     } else {
         // We've already reached or passed the time for the next frame to start.
         // See if we've also passed the time for frames after that to start, in
@@ -579,6 +648,11 @@ void BitmapImage::stopAnimation()
     // This timer is used to animate all occurrences of this image.  Don't invalidate
     // the timer unless all renderers have stopped drawing.
     m_frameTimer = nullptr;
+    m_advanceAnimationWhenFrameIsDecoded = false;
+
+    // Only animating images share the budget for decoded frames. The next
+    // startAnimation() adds the image again.
+    animatedImages().remove(this);
 }
 
 void BitmapImage::resetAnimation()
@@ -589,8 +663,8 @@ void BitmapImage::resetAnimation()
     m_desiredFrameStartTime = 0;
     m_animationFinished = false;
     
-    // For extremely large animations, when the animation is reset, we just throw everything away.
-    destroyDecodedDataIfNecessary(true);
+    // For large animations, only keep the frames at the start of the animation.
+    destroyDecodedDataIfNecessary();
 }
 
 void BitmapImage::drawPattern(GraphicsContext* ctxt, const FloatRect& tileRect, const AffineTransform& transform,
@@ -631,6 +705,16 @@ void BitmapImage::drawPattern(GraphicsContext* ctxt, const FloatRect& tileRect,
 
 void BitmapImage::advanceAnimation(Timer<BitmapImage>&)
 {
+    // Keep showing the current frame until the next one has been decoded in the background.
+    // The timer stays set meanwhile, so that startAnimation() does not schedule another advance.
+    size_t nextFrame = m_currentFrame + 1;
+    SubsamplingLevel subsamplingLevel = animationSubsamplingLevel();
+    if (nextFrame < frameCount() && (isDecodingFrameAsynchronously(nextFrame) || shouldDecodeFrameAsynchronously(nextFrame, subsamplingLevel))) {
+        decodeFrameAsynchronously(nextFrame, subsamplingLevel);
+        m_advanceAnimationWhenFrameIsDecoded = true;
+        return;
+    }
+
     internalAdvanceAnimation(false);
     // At this point the image region has been marked dirty, and if it's
     // onscreen, we'll soon make a call to draw(), which will call
@@ -644,7 +728,6 @@ bool BitmapImage::internalAdvanceAnimation(bool skippingFrames)
     
     ++m_currentFrame;
     bool advancedAnimation = true;
-    bool destroyAll = false;
     if (m_currentFrame >= frameCount()) {
         ++m_repetitionsComplete;
 
@@ -658,12 +741,10 @@ bool BitmapImage::internalAdvanceAnimation(bool skippingFrames)
             m_desiredFrameStartTime = 0;
             --m_currentFrame;
             advancedAnimation = false;
-        } else {
+        } else
             m_currentFrame = 0;
-            destroyAll = true;
-        }
     }
-    destroyDecodedDataIfNecessary(destroyAll);
+    destroyDecodedDataIfNecessary();
 
     // We need to draw this frame if we advanced to it while not skipping, or if
     // while trying to skip frames we hit the last frame and thus had to stop.
@@ -672,6 +753,168 @@ bool BitmapImage::internalAdvanceAnimation(bool skippingFrames)
     return advancedAnimation;
 }
 
+bool BitmapImage::decodeCurrentFrameAsynchronouslyIfNeeded(float presentationScaleHint)
+{
+    size_t index = currentFrame();
+    if (isDecodingFrameAsynchronously(index))
+        return true;
+
+    // The same level frameAtIndex() would decode the frame at when it is drawn.
+    SubsamplingLevel subsamplingLevel = std::min(m_source.subsamplingLevelForScale(presentationScaleHint), m_minimumSubsamplingLevel);
+    if (!shouldDecodeFrameAsynchronously(index, subsamplingLevel))
+        return false;
+
+    decodeFrameAsynchronously(index, subsamplingLevel);
+    return true;
+}
+
+PassRefPtr<Image> BitmapImage::imageForPendingCurrentFrame()
+{
+    // The current frame at a lower resolution, or else the closest frame before it.
+    size_t numFrames = std::min(frameCount(), m_frames.size());
+    for (size_t i = 0; i < numFrames; ++i) {
+        size_t index = (m_currentFrame + numFrames - i) % numFrames;
+        if (m_frames[index].m_frame)
+            return BitmapImage::create(m_frames[index].m_frame);
+    }
+    return nullptr;
+}
+
+SubsamplingLevel BitmapImage::animationSubsamplingLevel() const
+{
+    // Frames of an animation are all decoded at the level of the first one, see ImageSource::createFrameAtIndex().
+    return m_currentFrame < m_frames.size() ? m_frames[m_currentFrame].m_subsamplingLevel : 0;
+}
+
+bool BitmapImage::shouldDecodeFrameAsynchronously(size_t index, SubsamplingLevel subsamplingLevel)
+{
+#if !USE(CG)
+    // Frames of a partially loaded image are decoded progressively, on the main thread.
+    if (!m_allowsAsynchronousDecoding || !m_allDataReceived || !data())
+        return false;
+
+    if (index >= frameCount() || (index < m_frames.size() && m_frames[index].m_frame && m_frames[index].m_subsamplingLevel <= subsamplingLevel))
+        return false;
+
+    return m_source.frameBytesAtIndex(index, subsamplingLevel) >= minimumFrameBytesForAsynchronousDecoding;
+#else
+    UNUSED_PARAM(index);
+    UNUSED_PARAM(subsamplingLevel);
+    return false;
+#endif
+}
+
+bool BitmapImage::isDecodingFrameAsynchronously(size_t index) const
+{
+#if !USE(CG)
+    return m_asynchronousDecoder && m_asynchronousDecoder->isDecodingFrame(index);
+#else
+    UNUSED_PARAM(index);
+    return false;
+#endif
+}
+
+void BitmapImage::decodeFrameAsynchronously(size_t index, SubsamplingLevel subsamplingLevel)
+{
+#if !USE(CG)
+    if (!m_asynchronousDecoder) {
+        m_asynchronousDecoder = AsynchronousImageDecoder::create(*data(), [this](size_t index, const AsynchronousImageDecoder::DecodedFrame& decodedFrame) {
+            didDecodeFrameAsynchronously(index, decodedFrame);
+        });
+    }
+    m_asynchronousDecoder->decodeFrame(index, subsamplingLevel);
+#else
+    UNUSED_PARAM(index);
+    UNUSED_PARAM(subsamplingLevel);
+#endif
+}
+
+void BitmapImage::cancelAsynchronousDecoding()
+{
+#if !USE(CG)
+    if (!m_asynchronousDecoder)
+        return;
+
+    m_asynchronousDecoder->cancel();
+    m_asynchronousDecoder = nullptr;
+
+    // Nothing will advance an animation that was waiting for a frame; let the next draw restart it.
+    if (m_advanceAnimationWhenFrameIsDecoded)
+        stopAnimation();
+#endif
+}
+
+#if !USE(CG)
+void BitmapImage::didDecodeFrameAsynchronously(size_t index, const AsynchronousImageDecoder::DecodedFrame& decodedFrame)
+{
+    size_t numFrames = frameCount();
+    if (!decodedFrame.frame || index >= numFrames) {
+        // Let the synchronous path deal with whatever went wrong, and report it as usual.
+        cancelAsynchronousDecoding();
+        m_allowsAsynchronousDecoding = false;
+        if (imageObserver())
+            imageObserver()->changedInRect(this, IntRect(IntPoint(), expandedIntSize(size())));
+        return;
+    }
+
+    if (m_frames.size() < numFrames)
+        m_frames.grow(numFrames);
+
+    // The frame may have been decoded synchronously in the meantime, e.g. to draw it into a canvas.
+    // A frame that is only cached at a lower resolution is replaced.
+    FrameData& frameData = m_frames[index];
+    if (frameData.m_frame && frameData.m_subsamplingLevel > decodedFrame.subsamplingLevel) {
+        int sizeChange = -safeCast<int>(frameData.m_frameBytes);
+        frameData.clear(false);
+        invalidatePlatformData();
+        m_decodedSize += sizeChange;
+        if (imageObserver())
+            imageObserver()->decodedSizeChanged(this, sizeChange);
+    }
+
+    if (!frameData.m_frame) {
+        frameData.m_frame = decodedFrame.frame;
+        frameData.m_subsamplingLevel = decodedFrame.subsamplingLevel;
+        frameData.m_orientation = decodedFrame.orientation;
+        frameData.m_haveMetadata = true;
+        frameData.m_isComplete = decodedFrame.isComplete;
+        if (repetitionCount(false) != cAnimationNone)
+            frameData.m_duration = decodedFrame.duration;
+        frameData.m_hasAlpha = decodedFrame.hasAlpha;
+        frameData.m_frameBytes = decodedFrame.frameBytes;
+
+        if (index && m_source.frameSizeAtIndex(index) != m_size)
+            m_hasUniformFrameSize = false;
+
+        int deltaBytes = safeCast<int>(frameData.m_frameBytes);
+        m_decodedSize += deltaBytes;
+        deltaBytes -= m_decodedPropertiesSize;
+        m_decodedPropertiesSize = 0;
+        if (imageObserver())
+            imageObserver()->decodedSizeChanged(this, deltaBytes);
+
+        if (numFrames == 1)
+            checkForSolidColor();
+    }
+
+    // A single frame will not be asked for again, so free the background decoder's copy of it.
+    if (numFrames == 1)
+        cancelAsynchronousDecoding();
+
+    if (!imageObserver())
+        return;
+
+    if (m_advanceAnimationWhenFrameIsDecoded && index == m_currentFrame + 1) {
+        m_advanceAnimationWhenFrameIsDecoded = false;
+        internalAdvanceAnimation(false);
+        return;
+    }
+
+    if (index == m_currentFrame)
+        imageObserver()->changedInRect(this, IntRect(IntPoint(), expandedIntSize(size())));
+}
+#endif
+
 bool BitmapImage::mayFillWithSolidColor()
 {
     if (!m_checkedForSolidColor && frameCount() > 0) {
@@ -29,6 +29,7 @@
 #define BitmapImage_h
 
 #include "Image.h"
+#include "AsynchronousImageDecoder.h"
 #include "Color.h"
 #include "ImageOrientation.h"
 #include "ImageSource.h"
@@ -98,6 +99,61 @@ public:
     unsigned m_frameBytes;
 };
 
+// =================================================
+// AnimatedImageFrameWindow Class
+// =================================================
+
+// Decides which decoded frames animated images keep. Each image keeps the
+// current frame and the frames that follow it in playback order, wrapping
+// around at the end of the animation, while they fit in its window. The
+// decoded frames of all animated images share a budget; within it, each window
+// is the large animation cutoff, and beyond it every image gets an equal share.
+class AnimatedImageFrameWindow {
+public:
+    AnimatedImageFrameWindow(unsigned largeAnimationCutoff, unsigned budget)
+        : m_largeAnimationCutoff(largeAnimationCutoff)
+        , m_budget(budget)
+    {
+    }
+
+    bool isOverBudget(unsigned totalDecodedBytes) const { return totalDecodedBytes > m_budget; }
+
+    unsigned windowBytes(unsigned totalDecodedBytes, unsigned animatedImageCount) const
+    {
+        if (!isOverBudget(totalDecodedBytes) || !animatedImageCount)
+            return m_largeAnimationCutoff;
+        return std::min(m_largeAnimationCutoff, m_budget / animatedImageCount);
+    }
+
+    // |frameBytes| holds the size of each frame, or 0 for the frames that are
+    // not decoded. Returns the decoded frames that fall outside the window; the
+    // current frame is always inside it.
+    static Vector<size_t> framesOutsideWindow(const Vector<unsigned>& frameBytes, size_t currentFrame, unsigned windowBytes)
+    {
+        Vector<size_t> frames;
+        unsigned windowBytesUsed = 0;
+        bool windowIsFull = false;
+        for (size_t i = 0; i < frameBytes.size(); ++i) {
+            size_t index = (currentFrame + i) % frameBytes.size();
+            if (!frameBytes[index])
+                continue;
+
+            if (!i || (!windowIsFull && windowBytesUsed + frameBytes[index] <= windowBytes)) {
+                windowBytesUsed += frameBytes[index];
+                continue;
+            }
+
+            windowIsFull = true;
+            frames.append(index);
+        }
+        return frames;
+    }
+
+private:
+    unsigned m_largeAnimationCutoff;
+    unsigned m_budget;
+};
+
 // =================================================
 // BitmapImage Class
 // =================================================
@@ -183,6 +239,16 @@ public:
 
     bool allowSubsampling() const { return m_allowSubsampling; }
     void setAllowSubsampling(bool allowSubsampling) { m_allowSubsampling = allowSubsampling; }
+
+    bool allowsAsynchronousDecoding() const { return m_allowsAsynchronousDecoding; }
+    void setAllowsAsynchronousDecoding(bool allowsAsynchronousDecoding) { m_allowsAsynchronousDecoding = allowsAsynchronousDecoding; }
+
+    // Starts decoding the current frame on a background thread if it is large and not decoded yet, at the
+    // subsampling level it is drawn at for the given scale. Returns whether that frame is still being
+    // decoded, in which case the caller should draw imageForPendingCurrentFrame() or a placeholder instead
+    // of the image; the observer is told to repaint once the frame is ready.
+    bool decodeCurrentFrameAsynchronouslyIfNeeded(float presentationScaleHint = 1);
+    PassRefPtr<Image> imageForPendingCurrentFrame();
     
 private:
     void updateSize(ImageOrientationDescription = ImageOrientationDescription()) const;
@@ -236,9 +302,16 @@ protected:
     // low without redecoding the whole image on every frame.
     virtual void destroyDecodedData(bool destroyAll = true) override;
 
-    // If the image is large enough, calls destroyDecodedData() and passes
-    // |destroyAll| along.
-    void destroyDecodedDataIfNecessary(bool destroyAll);
+    // Keeps the decoded frames of an animated image within its share of the
+    // budget all animated images have, trimming other animated images too when
+    // that budget is exceeded.
+    void destroyDecodedDataIfNecessary();
+
+    // Destroys the decoded frames that do not fit in |windowBytes|, starting
+    // with the ones furthest from the current frame in playback order. Unlike
+    // destroyDecodedData(), this keeps the decoder, which can decode the frames
+    // again without starting over from the first one.
+    void destroyFramesOutsideWindow(unsigned windowBytes);
 
     // Generally called by destroyDecodedData(), destroys whole-image metadata
     // and notifies observers that the memory footprint has (hopefully)
@@ -270,6 +343,16 @@ protected:
     // Handle platform-specific data
     void invalidatePlatformData();
 
+    // Asynchronous decoding.
+    bool shouldDecodeFrameAsynchronously(size_t index, SubsamplingLevel);
+    bool isDecodingFrameAsynchronously(size_t index) const;
+    void decodeFrameAsynchronously(size_t index, SubsamplingLevel);
+    SubsamplingLevel animationSubsamplingLevel() const;
+    void cancelAsynchronousDecoding();
+#if !USE(CG)
+    void didDecodeFrameAsynchronously(size_t index, const AsynchronousImageDecoder::DecodedFrame&);
+#endif
+
     // Checks to see if the image is a 1x1 solid color.  We optimize these images and just do a fill rect instead.
     // This check should happen regardless whether m_checkedForSolidColor is already set, as the frame may have
     // changed.
@@ -332,6 +415,13 @@ private:
     mutable bool m_hasUniformFrameSize : 1;
     mutable bool m_haveFrameCount : 1;
 
+    bool m_allowsAsynchronousDecoding : 1; // Whether large frames may be decoded on a background thread once all data is received.
+    bool m_advanceAnimationWhenFrameIsDecoded : 1; // Whether the animation is waiting for the next frame to be decoded asynchronously.
+
+#if !USE(CG)
+    RefPtr<AsynchronousImageDecoder> m_asynchronousDecoder;
+#endif
+
     RefPtr<Image> m_cachedImage;
 };
 
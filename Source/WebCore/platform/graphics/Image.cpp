@@ -242,7 +242,6 @@ void Image::drawTiled(GraphicsContext* ctxt, const FloatRect& dstRect, const Flo
 #endif
 }
 
-#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
 FloatRect Image::adjustSourceRectForDownSampling(const FloatRect& srcRect, const IntSize& scaledSize) const
 {
     const FloatSize unscaledSize = size();
@@ -257,7 +256,6 @@ FloatRect Image::adjustSourceRectForDownSampling(const FloatRect& srcRect, const
 
     return scaledSrcRect;
 }
-#endif
 
 void Image::computeIntrinsicDimensions(Length& intrinsicWidth, Length& intrinsicHeight, FloatSize& intrinsicRatio)
 {
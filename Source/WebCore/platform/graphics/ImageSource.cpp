@@ -35,6 +35,7 @@
 
 #include "ImageOrientation.h"
 #include "NotImplemented.h"
+#include <wtf/MathExtras.h>
 
 namespace WebCore {
 
@@ -46,6 +47,7 @@ ImageSource::ImageSource(ImageSource::AlphaOption alphaOption, ImageSource::Gamm
     : m_decoder(0)
     , m_alphaOption(alphaOption)
     , m_gammaAndColorProfileOption(gammaAndColorProfileOption)
+    , m_subsamplingLevel(0)
 {
 }
 
@@ -68,6 +70,12 @@ void ImageSource::clear(bool destroyAll, size_t clearBeforeFrame, SharedBuffer*
         setData(data, allDataReceived);
 }
 
+void ImageSource::clearFrameAtIndex(size_t index)
+{
+    if (m_decoder)
+        m_decoder->clearFrameBuffer(index);
+}
+
 bool ImageSource::initialized() const
 {
     return m_decoder;
@@ -85,6 +93,8 @@ void ImageSource::setData(SharedBuffer* data, bool allDataReceived)
         if (m_decoder && s_maxPixelsPerDecodedImage)
             m_decoder->setMaxNumPixels(s_maxPixelsPerDecodedImage);
 #endif
+        if (m_decoder && m_subsamplingLevel)
+            m_decoder->setSubsamplingLevel(m_subsamplingLevel);
     }
 
     if (m_decoder)
@@ -96,14 +106,19 @@ String ImageSource::filenameExtension() const
     return m_decoder ? m_decoder->filenameExtension() : String();
 }
 
-SubsamplingLevel ImageSource::subsamplingLevelForScale(float) const
+SubsamplingLevel ImageSource::subsamplingLevelForScale(float scale) const
 {
-    return 0;
+    // There are four subsampling levels: 0 = 1x, 1 = 0.5x, 2 = 0.25x, 3 = 0.125x. Round
+    // towards the larger size so that the decoded frame is only ever scaled down when drawn.
+    float clampedScale = std::max<float>(0.125, std::min<float>(1, scale));
+    int result = floorf(log2f(1 / clampedScale));
+    ASSERT(result >= 0 && result <= 3);
+    return result;
 }
 
 bool ImageSource::allowSubsamplingOfFrameAtIndex(size_t) const
 {
-    return false;
+    return m_decoder && m_decoder->supportsSubsampling();
 }
 
 bool ImageSource::isSizeAvailable()
@@ -148,11 +163,22 @@ size_t ImageSource::frameCount() const
     return m_decoder ? m_decoder->frameCount() : 0;
 }
 
-PassNativeImagePtr ImageSource::createFrameAtIndex(size_t index, SubsamplingLevel)
+PassNativeImagePtr ImageSource::createFrameAtIndex(size_t index, SubsamplingLevel subsamplingLevel)
 {
     if (!m_decoder)
         return 0;
 
+    // A decoder works at a single subsampling level, so decode from scratch to change it. Frames of
+    // an animation depend on each other, so they all stay at the level the first one was decoded at.
+    if (subsamplingLevel != m_subsamplingLevel && m_decoder->supportsSubsampling() && m_decoder->frameCount() == 1) {
+        RefPtr<SharedBuffer> data = m_decoder->data();
+        bool allDataReceived = m_decoder->isAllDataReceived();
+        m_subsamplingLevel = subsamplingLevel;
+        clear(true, 0, data.get(), allDataReceived);
+        if (!m_decoder)
+            return 0;
+    }
+
     ImageFrame* buffer = m_decoder->frameBufferAtIndex(index);
     if (!buffer || buffer->status() == ImageFrame::FrameEmpty)
         return 0;
@@ -129,6 +129,12 @@ public:
                SharedBuffer* data = NULL,
                bool allDataReceived = false);
 
+    // Tells the ImageSource that the Image no longer holds the decoded data of
+    // this one frame. Unlike clear(false, ...), the frame and the ones before it
+    // may be created again afterwards; decoders that composite frames onto each
+    // other decode it again starting from the closest frame they still have.
+    void clearFrameAtIndex(size_t);
+
     bool initialized() const;
 
     void setData(SharedBuffer* data, bool allDataReceived);
@@ -175,6 +181,7 @@ private:
 #if !USE(CG)
     AlphaOption m_alphaOption;
     GammaAndColorProfileOption m_gammaAndColorProfileOption;
+    SubsamplingLevel m_subsamplingLevel; // The level m_decoder was created with.
 #endif
 #if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
     static unsigned s_maxPixelsPerDecodedImage;
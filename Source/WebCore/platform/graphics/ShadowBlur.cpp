@@ -36,6 +36,7 @@
 #include "ImageBuffer.h"
 #include "Timer.h"
 #include <wtf/MathExtras.h>
+#include <wtf/NeverDestroyed.h>
 #include <wtf/Noncopyable.h>
 
 namespace WebCore {
@@ -165,6 +166,137 @@ ScratchBuffer& ScratchBuffer::shared()
     return scratchBuffer;
 }
 
+// Everything that determines the contents of a blurred template used by the tiling paths.
+struct ShadowTemplateKey {
+    bool isInset;
+    FloatSize blurRadius;
+    Color color;
+    ColorSpace colorSpace;
+    IntSize templateSize;
+    IntSize edgeSize;
+    FloatRoundedRect::Radii radii;
+
+    bool operator==(const ShadowTemplateKey& other) const
+    {
+        return isInset == other.isInset && blurRadius == other.blurRadius && color == other.color && colorSpace == other.colorSpace
+            && templateSize == other.templateSize && edgeSize == other.edgeSize && radii == other.radii;
+    }
+};
+
+// The tiling paths only blur a small template and stretch its nine pieces over the shadowed
+// rect, so the template does not depend on the size of the rect. Keeping recent templates
+// lets pages that draw many differently sized boxes with a few shadow styles skip the blur.
+// Entries are evicted least recently used first once the memory budget is exceeded, and the
+// whole cache is dropped when it goes unused for a while or under memory pressure.
+class ShadowTemplateCache {
+    WTF_MAKE_NONCOPYABLE(ShadowTemplateCache); WTF_MAKE_FAST_ALLOCATED;
+public:
+    ShadowTemplateCache()
+        : m_purgeTimer(this, &ShadowTemplateCache::timerFired)
+        , m_totalCost(0)
+    {
+    }
+
+    static ShadowTemplateCache& shared();
+
+    ImageBuffer* find(const ShadowTemplateKey& key)
+    {
+        for (size_t i = 0; i < m_entries.size(); ++i) {
+            if (!(m_entries[i]->key == key))
+                continue;
+
+            // Keep the most recently used entry last.
+            std::unique_ptr<Entry> entry = WTF::move(m_entries[i]);
+            m_entries.remove(i);
+            m_entries.append(WTF::move(entry));
+            return m_entries.last()->buffer.get();
+        }
+        return nullptr;
+    }
+
+    void add(const ShadowTemplateKey& key, std::unique_ptr<ImageBuffer> buffer)
+    {
+        size_t cost = static_cast<size_t>(key.templateSize.width()) * key.templateSize.height() * 4;
+        if (cost > maximumTotalCost)
+            return;
+
+        while (!m_entries.isEmpty() && (m_totalCost + cost > maximumTotalCost || m_entries.size() >= maximumEntryCount)) {
+            m_totalCost -= m_entries.first()->cost;
+            m_entries.remove(0);
+        }
+
+        auto entry = std::make_unique<Entry>();
+        entry->key = key;
+        entry->buffer = WTF::move(buffer);
+        entry->cost = cost;
+        m_entries.append(WTF::move(entry));
+        m_totalCost += cost;
+    }
+
+    void schedulePurge()
+    {
+        if (m_purgeTimer.isActive())
+            m_purgeTimer.stop();
+
+        const double templateCachePurgeInterval = 10;
+        m_purgeTimer.startOneShot(templateCachePurgeInterval);
+    }
+
+    void clear()
+    {
+        m_entries.clear();
+        m_totalCost = 0;
+    }
+
+private:
+    static const size_t maximumTotalCost = 2 * 1024 * 1024;
+    static const size_t maximumEntryCount = 64;
+
+    struct Entry {
+        WTF_MAKE_FAST_ALLOCATED;
+    public:
+        ShadowTemplateKey key;
+        std::unique_ptr<ImageBuffer> buffer;
+        size_t cost;
+    };
+
+    void timerFired(Timer<ShadowTemplateCache>*)
+    {
+        clear();
+    }
+
+    Vector<std::unique_ptr<Entry>> m_entries; // Least recently used first.
+    Timer<ShadowTemplateCache> m_purgeTimer;
+    size_t m_totalCost;
+};
+
+ShadowTemplateCache& ShadowTemplateCache::shared()
+{
+    static NeverDestroyed<ShadowTemplateCache> cache;
+    return cache;
+}
+
+static ShadowBlur::Statistics& mutableStatistics()
+{
+    static ShadowBlur::Statistics statistics;
+    return statistics;
+}
+
+ShadowBlur::Statistics ShadowBlur::statistics()
+{
+    return mutableStatistics();
+}
+
+void ShadowBlur::resetStatistics()
+{
+    mutableStatistics() = Statistics();
+}
+
+void ShadowBlur::purgeTemplateCache()
+{
+    ShadowTemplateCache::shared().clear();
+}
+
 static const int templateSideLength = 1;
 
 #if USE(CG)
@@ -293,6 +425,8 @@ void ShadowBlur::clear()
 
 void ShadowBlur::blurLayerImage(unsigned char* imageData, const IntSize& size, int rowStride)
 {
+    mutableStatistics().blurCount++;
+
     const int channels[4] = { 3, 0, 1, 3 };
 
     int lobes[3][2]; // indexed by pass, and left/right lobe
@@ -675,17 +809,22 @@ void ShadowBlur::drawInsetShadowWithoutTiling(GraphicsContext* graphicsContext,
 
 void ShadowBlur::drawInsetShadowWithTiling(GraphicsContext* graphicsContext, const FloatRect& rect, const FloatRoundedRect& holeRect, const IntSize& templateSize, const IntSize& edgeSize)
 {
-    m_layerImage = ScratchBuffer::shared().getScratchBuffer(templateSize);
-    if (!m_layerImage)
-        return;
+    ShadowTemplateKey key = { true, m_blurRadius, m_color, m_colorSpace, templateSize, edgeSize, holeRect.radii() };
+    std::unique_ptr<ImageBuffer> newTemplate;
+    m_layerImage = ShadowTemplateCache::shared().find(key);
+    if (m_layerImage)
+        mutableStatistics().templateCacheHitCount++;
+    else {
+        mutableStatistics().templateCacheMissCount++;
+        newTemplate = ImageBuffer::create(templateSize, 1);
+        if (!newTemplate)
+            return;
+        m_layerImage = newTemplate.get();
 
-    // Draw the rectangle with hole.
-    FloatRect templateBounds(0, 0, templateSize.width(), templateSize.height());
-    FloatRect templateHole = FloatRect(edgeSize.width(), edgeSize.height(), templateSize.width() - 2 * edgeSize.width(), templateSize.height() - 2 * edgeSize.height());
+        // Draw the rectangle with hole.
+        FloatRect templateBounds(0, 0, templateSize.width(), templateSize.height());
+        FloatRect templateHole = FloatRect(edgeSize.width(), edgeSize.height(), templateSize.width() - 2 * edgeSize.width(), templateSize.height() - 2 * edgeSize.height());
 
-    // Only redraw in the scratch buffer if its cached contents don't match our needs
-    bool redrawNeeded = ScratchBuffer::shared().setCachedInsetShadowValues(m_blurRadius, m_color, m_colorSpace, templateBounds, templateHole, holeRect.radii());
-    if (redrawNeeded) {
         // Draw shadow into a new ImageBuffer.
         GraphicsContext* shadowContext = m_layerImage->context();
         GraphicsContextStateSaver shadowStateSaver(*shadowContext);
@@ -735,20 +874,27 @@ void ShadowBlur::drawInsetShadowWithTiling(GraphicsContext* graphicsContext, con
     drawLayerPieces(graphicsContext, destHoleBounds, holeRect.radii(), edgeSize, templateSize, InnerShadow);
 
     m_layerImage = 0;
-    ScratchBuffer::shared().scheduleScratchBufferPurge();
+    if (newTemplate)
+        ShadowTemplateCache::shared().add(key, WTF::move(newTemplate));
+    ShadowTemplateCache::shared().schedulePurge();
 }
 
 void ShadowBlur::drawRectShadowWithTiling(GraphicsContext* graphicsContext, const FloatRoundedRect& shadowedRect, const IntSize& templateSize, const IntSize& edgeSize)
 {
-    m_layerImage = ScratchBuffer::shared().getScratchBuffer(templateSize);
-    if (!m_layerImage)
-        return;
+    ShadowTemplateKey key = { false, m_blurRadius, m_color, m_colorSpace, templateSize, edgeSize, shadowedRect.radii() };
+    std::unique_ptr<ImageBuffer> newTemplate;
+    m_layerImage = ShadowTemplateCache::shared().find(key);
+    if (m_layerImage)
+        mutableStatistics().templateCacheHitCount++;
+    else {
+        mutableStatistics().templateCacheMissCount++;
+        newTemplate = ImageBuffer::create(templateSize, 1);
+        if (!newTemplate)
+            return;
+        m_layerImage = newTemplate.get();
 
-    FloatRect templateShadow = FloatRect(edgeSize.width(), edgeSize.height(), templateSize.width() - 2 * edgeSize.width(), templateSize.height() - 2 * edgeSize.height());
+        FloatRect templateShadow = FloatRect(edgeSize.width(), edgeSize.height(), templateSize.width() - 2 * edgeSize.width(), templateSize.height() - 2 * edgeSize.height());
 
-    // Only redraw in the scratch buffer if its cached contents don't match our needs
-    bool redrawNeeded = ScratchBuffer::shared().setCachedShadowValues(m_blurRadius, m_color, m_colorSpace, templateShadow, shadowedRect.radii(), m_layerSize);
-    if (redrawNeeded) {
         // Draw shadow into the ImageBuffer.
         GraphicsContext* shadowContext = m_layerImage->context();
         GraphicsContextStateSaver shadowStateSaver(*shadowContext);
@@ -780,7 +926,9 @@ void ShadowBlur::drawRectShadowWithTiling(GraphicsContext* graphicsContext, cons
     drawLayerPieces(graphicsContext, shadowBounds, shadowedRect.radii(), edgeSize, templateSize, OuterShadow);
 
     m_layerImage = 0;
-    ScratchBuffer::shared().scheduleScratchBufferPurge();
+    if (newTemplate)
+        ShadowTemplateCache::shared().add(key, WTF::move(newTemplate));
+    ShadowTemplateCache::shared().schedulePurge();
 }
 
 void ShadowBlur::drawLayerPieces(GraphicsContext* graphicsContext, const FloatRect& shadowBounds, const FloatRoundedRect::Radii& radii, const IntSize& bufferPadding, const IntSize& templateSize, ShadowDirection direction)
@@ -72,6 +72,25 @@ public:
 
     ShadowType type() const { return m_type; }
 
+    struct Statistics {
+        Statistics()
+            : blurCount(0)
+            , templateCacheHitCount(0)
+            , templateCacheMissCount(0)
+        {
+        }
+
+        unsigned blurCount;
+        unsigned templateCacheHitCount;
+        unsigned templateCacheMissCount;
+    };
+
+    static Statistics statistics();
+    static void resetStatistics();
+
+    // Drops the blurred templates kept for the tiling paths.
+    static void purgeTemplateCache();
+
 private:
     void updateShadowBlurValues();
 
@@ -39,6 +39,7 @@ public:
     virtual ~Tile() { }
 
     virtual bool isDirty() const = 0;
+    virtual IntRect dirtyRect() const = 0;
     virtual void invalidate(const IntRect&) = 0;
     virtual Vector<IntRect> updateBackBuffer() = 0;
     virtual void swapBackBufferToFront() = 0;
@@ -25,10 +25,20 @@
 #include "GraphicsContext.h"
 #include "TiledBackingStoreClient.h"
 
+#if USE(CAIRO)
+#include "DisplayListCairo.h"
+#endif
+
 namespace WebCore {
 
 static const int defaultTileDimension = 512;
 
+#if USE(CAIRO)
+// Recording the union of the dirty rects paints whatever lies between them too,
+// so only record when that adds at most this much to the dirty area.
+static const unsigned maximumDisplayListToDirtyAreaRatio = 2;
+#endif
+
 static IntPoint innerBottomRight(const IntRect& rect)
 {
     // Actually, the rect does not contain rect.maxX(). Refer to IntRect::contain.
@@ -78,6 +88,8 @@ void TiledBackingStore::coverWithTilesIfNeeded()
 
 void TiledBackingStore::invalidate(const IntRect& contentsDirtyRect)
 {
+    discardDisplayList(contentsDirtyRect);
+
     IntRect dirtyRect(mapFromContents(contentsDirtyRect));
     IntRect keepRectFitToTileSize = tileRectForCoordinate(tileCoordinateForPoint(m_keepRect.location()));
     keepRectFitToTileSize.unite(tileRectForCoordinate(tileCoordinateForPoint(innerBottomRight(m_keepRect))));
@@ -118,6 +130,8 @@ void TiledBackingStore::updateTileBuffers()
         return;
     }
 
+    recordDisplayListIfNeeded(dirtyTiles);
+
     // FIXME: In single threaded case, tile back buffers could be updated asynchronously 
     // one by one and then swapped to front in one go. This would minimize the time spent
     // blocking on tile updates.
@@ -131,6 +145,64 @@ void TiledBackingStore::updateTileBuffers()
     m_client->tiledBackingStorePaintEnd(paintedArea);
 }
 
+void TiledBackingStore::paintTileContents(GraphicsContext* context, const IntRect& contentsRect)
+{
+#if USE(CAIRO)
+    if (m_displayList && m_displayList->scale() == m_contentsScale && m_displayList->bounds().contains(contentsRect)) {
+        m_displayList->replay(*context, contentsRect);
+        return;
+    }
+#endif
+    m_client->tiledBackingStorePaint(context, contentsRect);
+}
+
+void TiledBackingStore::recordDisplayListIfNeeded(const Vector<RefPtr<Tile>>& dirtyTiles)
+{
+#if USE(CAIRO)
+    // Painting the client walks its content again for every tile, so when a paint
+    // spans several tiles the content is recorded once and replayed into each of them.
+    // The recording is kept until the content changes, for tiles that are created
+    // later on, e.g. when scrolling back.
+    if (dirtyTiles.size() < 2)
+        return;
+
+    IntRect dirtyRect;
+    uint64_t dirtyArea = 0;
+    for (auto& tile : dirtyTiles) {
+        const IntRect& tileDirtyRect = tile->dirtyRect();
+        dirtyRect.unite(tileDirtyRect);
+        dirtyArea += static_cast<uint64_t>(tileDirtyRect.width()) * tileDirtyRect.height();
+    }
+
+    IntRect contentsRect = mapToContents(dirtyRect);
+    if (contentsRect.isEmpty())
+        return;
+    if (m_displayList && m_displayList->scale() == m_contentsScale && m_displayList->bounds().contains(contentsRect))
+        return;
+    if (static_cast<uint64_t>(dirtyRect.width()) * dirtyRect.height() > maximumDisplayListToDirtyAreaRatio * dirtyArea)
+        return;
+
+    // Tiles replay the recording under the contents scale, so record under it as well.
+    // Otherwise whatever is rasterized while recording, such as shadows, filters, masks
+    // and images decoded at their drawn size, would be rasterized at scale 1 and blurry.
+    m_displayList = std::make_unique<DisplayListCairo>(contentsRect, m_contentsScale);
+    m_client->tiledBackingStorePaint(&m_displayList->recordingContext(), contentsRect);
+    m_displayList->endRecording();
+#else
+    UNUSED_PARAM(dirtyTiles);
+#endif
+}
+
+void TiledBackingStore::discardDisplayList(const IntRect& contentsDirtyRect)
+{
+#if USE(CAIRO)
+    if (m_displayList && m_displayList->bounds().intersects(contentsDirtyRect))
+        m_displayList = nullptr;
+#else
+    UNUSED_PARAM(contentsDirtyRect);
+#endif
+}
+
 void TiledBackingStore::paint(GraphicsContext* context, const IntRect& rect)
 {
     context->save();
@@ -173,6 +245,9 @@ void TiledBackingStore::setContentsScale(float scale)
         return;
 
     m_contentsScale = scale;
+#if USE(CAIRO)
+    m_displayList = nullptr;
+#endif
     m_tiles.clear();
     coverWithTilesIfNeeded();
 }
@@ -450,6 +525,9 @@ void TiledBackingStore::setKeepRect(const IntRect& keepRect)
 
 void TiledBackingStore::removeAllNonVisibleTiles()
 {
+#if USE(CAIRO)
+    m_displayList = nullptr;
+#endif
     IntRect boundedVisibleRect = mapFromContents(intersection(m_client->tiledBackingStoreVisibleRect(), m_client->tiledBackingStoreContentsRect()));
     setKeepRect(boundedVisibleRect);
 }
@@ -28,6 +28,7 @@
 #include "Tile.h"
 #include "TiledBackingStoreBackend.h"
 #include "Timer.h"
+#include <memory>
 #include <wtf/Assertions.h>
 #include <wtf/HashMap.h>
 #include <wtf/RefPtr.h>
@@ -38,6 +39,10 @@ class GraphicsContext;
 class TiledBackingStore;
 class TiledBackingStoreClient;
 
+#if USE(CAIRO)
+class DisplayListCairo;
+#endif
+
 class TiledBackingStore {
     WTF_MAKE_NONCOPYABLE(TiledBackingStore); WTF_MAKE_FAST_ALLOCATED;
 public:
@@ -61,6 +66,9 @@ public:
     void invalidate(const IntRect& dirtyRect);
     void paint(GraphicsContext*, const IntRect&);
 
+    // Called by tiles to paint the client's contents into their buffers.
+    void paintTileContents(GraphicsContext*, const IntRect& contentsRect);
+
     IntSize tileSize() { return m_tileSize; }
     void setTileSize(const IntSize&);
 
@@ -102,6 +110,9 @@ private:
 
     void paintCheckerPattern(GraphicsContext*, const IntRect&, const Tile::Coordinate&);
 
+    void recordDisplayListIfNeeded(const Vector<RefPtr<Tile>>& dirtyTiles);
+    void discardDisplayList(const IntRect& contentsDirtyRect);
+
 private:
     TiledBackingStoreClient* m_client;
     std::unique_ptr<TiledBackingStoreBackend> m_backend;
@@ -109,6 +120,11 @@ private:
     typedef HashMap<Tile::Coordinate, RefPtr<Tile> > TileMap;
     TileMap m_tiles;
 
+#if USE(CAIRO)
+    // The client's contents, recorded once when a paint covers several tiles.
+    std::unique_ptr<DisplayListCairo> m_displayList;
+#endif
+
     Timer<TiledBackingStore> m_tileBufferUpdateTimer;
     Timer<TiledBackingStore> m_backingStoreUpdateTimer;
 
@@ -53,6 +53,8 @@ BitmapImage::BitmapImage(PassRefPtr<cairo_surface_t> nativeImage, ImageObserver*
     , m_haveSize(true)
     , m_sizeAvailable(true)
     , m_haveFrameCount(true)
+    , m_allowsAsynchronousDecoding(false)
+    , m_advanceAnimationWhenFrameIsDecoded(false)
 {
     m_frames.grow(1);
     m_frames[0].m_hasAlpha = cairo_surface_get_content(nativeImage.get()) != CAIRO_CONTENT_COLOR;
@@ -70,7 +72,11 @@ void BitmapImage::draw(GraphicsContext* context, const FloatRect& dst, const Flo
 
     startAnimation();
 
-    RefPtr<cairo_surface_t> surface = frameAtIndex(m_currentFrame);
+    // Let a large image be decoded close to the size it is drawn at, if subsampling is allowed.
+    FloatRect transformedDestinationRect = context->getCTM().mapRect(dst);
+    float subsamplingScale = std::min<float>(1, std::max(transformedDestinationRect.width() / src.width(), transformedDestinationRect.height() / src.height()));
+
+    RefPtr<cairo_surface_t> surface = frameAtIndex(m_currentFrame, subsamplingScale);
     if (!surface) // If it's too early we won't have an image yet.
         return;
 
@@ -87,12 +93,9 @@ void BitmapImage::draw(GraphicsContext* context, const FloatRect& dst, const Flo
     else
         context->setCompositeOperation(op, blendMode);
 
-#if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
+    // Down sampling and subsampling may have given us a frame that is smaller than size().
     IntSize scaledSize = cairoSurfaceSize(surface.get());
     FloatRect adjustedSrcRect = adjustSourceRectForDownSampling(src, scaledSize);
-#else
-    FloatRect adjustedSrcRect(src);
-#endif
 
     ImageOrientation frameOrientation(description.imageOrientation());
     if (description.respectImageOrientation() == RespectImageOrientation)
@@ -123,6 +126,20 @@ void BitmapImage::draw(GraphicsContext* context, const FloatRect& dst, const Flo
 void BitmapImage::determineMinimumSubsamplingLevel() const
 {
     m_minimumSubsamplingLevel = 0;
+
+    if (!m_allowSubsampling)
+        return;
+
+    if (!m_source.allowSubsamplingOfFrameAtIndex(0))
+        return;
+
+    // Smaller images are cheap to keep at full size, and would only be decoded again
+    // whenever they are drawn larger.
+    const int cMinimumImageAreaForSubsampling = 512 * 512;
+    const SubsamplingLevel maxSubsamplingLevel = 3;
+
+    if (m_size.area() >= cMinimumImageAreaForSubsampling)
+        m_minimumSubsamplingLevel = maxSubsamplingLevel;
 }
 
 void BitmapImage::checkForSolidColor()
@@ -133,7 +150,8 @@ void BitmapImage::checkForSolidColor()
     if (frameCount() > 1)
         return;
 
-    RefPtr<cairo_surface_t> surface = frameAtIndex(m_currentFrame);
+    // A subsampled frame that is already decoded would be decoded again at full size by frameAtIndex().
+    RefPtr<cairo_surface_t> surface = haveFrameAtIndex(m_currentFrame) ? m_frames[m_currentFrame].m_frame : frameAtIndex(m_currentFrame);
     if (!surface) // If it's too early we won't have an image yet.
         return;
 
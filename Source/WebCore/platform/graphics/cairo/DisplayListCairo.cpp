@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2014 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "DisplayListCairo.h"
+
+#if USE(CAIRO)
+
+#include "FloatRect.h"
+#include "GraphicsContext.h"
+#include "PlatformContextCairo.h"
+#include <cairo.h>
+
+namespace WebCore {
+
+DisplayListCairo::DisplayListCairo(const IntRect& bounds, float scale)
+    : m_bounds(bounds)
+    , m_scale(scale)
+{
+    ASSERT(scale > 0);
+
+    // The surface is in device space, i.e. the bounds with the scale applied.
+    IntRect deviceBounds = enclosingIntRect(FloatRect(bounds.x() * scale, bounds.y() * scale, bounds.width() * scale, bounds.height() * scale));
+    cairo_rectangle_t extents = { static_cast<double>(deviceBounds.x()), static_cast<double>(deviceBounds.y()), static_cast<double>(deviceBounds.width()), static_cast<double>(deviceBounds.height()) };
+    m_surface = adoptRef(cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA, &extents));
+}
+
+DisplayListCairo::~DisplayListCairo()
+{
+}
+
+GraphicsContext& DisplayListCairo::recordingContext()
+{
+    if (!m_recordingContext) {
+        RefPtr<cairo_t> cr = adoptRef(cairo_create(m_surface.get()));
+        cairo_scale(cr.get(), m_scale, m_scale);
+        m_recordingContext = std::make_unique<GraphicsContext>(cr.get());
+    }
+    return *m_recordingContext;
+}
+
+void DisplayListCairo::endRecording()
+{
+    m_recordingContext = nullptr;
+    cairo_surface_flush(m_surface.get());
+}
+
+void DisplayListCairo::replay(GraphicsContext& context, const IntRect& clipRect) const
+{
+    ASSERT(!m_recordingContext);
+
+    // Cairo keeps the recorded commands in a bounding box tree, so those outside
+    // the clip are skipped rather than rasterized and thrown away.
+    cairo_t* cr = context.platformContext()->cr();
+    cairo_save(cr);
+    cairo_rectangle(cr, clipRect.x(), clipRect.y(), clipRect.width(), clipRect.height());
+    cairo_clip(cr);
+    // The recording already has the scale applied, so undo it rather than scaling the pixels twice.
+    cairo_scale(cr, 1 / m_scale, 1 / m_scale);
+    cairo_set_source_surface(cr, m_surface.get(), 0, 0);
+    cairo_paint(cr);
+    cairo_restore(cr);
+}
+
+} // namespace WebCore
+
+#endif // USE(CAIRO)
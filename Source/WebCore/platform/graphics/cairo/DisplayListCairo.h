@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2014 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DisplayListCairo_h
+#define DisplayListCairo_h
+
+#if USE(CAIRO)
+
+#include "IntRect.h"
+#include "RefPtrCairo.h"
+#include <memory>
+#include <wtf/FastMalloc.h>
+#include <wtf/Noncopyable.h>
+
+namespace WebCore {
+
+class GraphicsContext;
+
+// Records drawing into a Cairo recording surface, so that content painted once can be
+// replayed into several destinations, such as the tiles of a TiledBackingStore.
+// Drawing is recorded under the given scale, and has to be replayed under that same
+// scale: what GraphicsContext rasterizes itself, like shadows, is recorded as pixels.
+class DisplayListCairo {
+    WTF_MAKE_NONCOPYABLE(DisplayListCairo); WTF_MAKE_FAST_ALLOCATED;
+public:
+    DisplayListCairo(const IntRect& bounds, float scale);
+    ~DisplayListCairo();
+
+    const IntRect& bounds() const { return m_bounds; }
+    float scale() const { return m_scale; }
+
+    // Drawing done into this context, in the coordinates of bounds(), is recorded
+    // until endRecording() is called.
+    GraphicsContext& recordingContext();
+    void endRecording();
+
+    // Draws the recorded commands that intersect clipRect into the context. The
+    // context's transformation is expected to include the recording scale.
+    void replay(GraphicsContext&, const IntRect& clipRect) const;
+
+private:
+    IntRect m_bounds;
+    float m_scale;
+    RefPtr<cairo_surface_t> m_surface;
+    std::unique_ptr<GraphicsContext> m_recordingContext;
+};
+
+} // namespace WebCore
+
+#endif // USE(CAIRO)
+
+#endif // DisplayListCairo_h
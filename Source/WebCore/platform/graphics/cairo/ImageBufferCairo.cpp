@@ -33,6 +33,7 @@
 #include "CairoUtilities.h"
 #include "Color.h"
 #include "GraphicsContext.h"
+#include "ImageBufferCairoSSE2.h"
 #include "MIMETypeRegistry.h"
 #include "NotImplemented.h"
 #include "Pattern.h"
@@ -203,9 +204,6 @@ PassRefPtr<Uint8ClampedArray> getImageData(const IntRect& rect, const ImageBuffe
 {
     RefPtr<Uint8ClampedArray> result = Uint8ClampedArray::createUninitialized(rect.width() * rect.height() * 4);
 
-    if (rect.x() < 0 || rect.y() < 0 || (rect.x() + rect.width()) > size.width() || (rect.y() + rect.height()) > size.height())
-        result->zeroFill();
-
     int originx = rect.x();
     int destx = 0;
     if (originx < 0) {
@@ -228,6 +226,23 @@ PassRefPtr<Uint8ClampedArray> getImageData(const IntRect& rect, const ImageBuffe
         endy = size.height();
     int numRows = endy - originy;
 
+    // Only zero the parts of the result that are outside the buffer; the rest is overwritten below.
+    unsigned destBytesPerRow = 4 * rect.width();
+    if (numColumns <= 0 || numRows <= 0) {
+        result->zeroFill();
+        return result.release();
+    }
+    if (desty || numRows < rect.height() || destx || numColumns < rect.width()) {
+        unsigned char* resultData = result->data();
+        memset(resultData, 0, desty * destBytesPerRow);
+        memset(resultData + (desty + numRows) * destBytesPerRow, 0, (rect.height() - desty - numRows) * destBytesPerRow);
+        for (int y = desty; y < desty + numRows; ++y) {
+            unsigned char* destRow = resultData + y * destBytesPerRow;
+            memset(destRow, 0, destx * 4);
+            memset(destRow + (destx + numColumns) * 4, 0, (rect.width() - destx - numColumns) * 4);
+        }
+    }
+
     IntRect imageRect(originx, originy, numColumns, numRows);
     RefPtr<cairo_surface_t> imageSurface = copySurfaceToImageAndAdjustRect(data.m_surface.get(), imageRect);
     originx = imageRect.x();
@@ -240,12 +255,15 @@ PassRefPtr<Uint8ClampedArray> getImageData(const IntRect& rect, const ImageBuffe
     unsigned char* dataSrc = cairo_image_surface_get_data(imageSurface.get());
     unsigned char* dataDst = result->data();
     int stride = cairo_image_surface_get_stride(imageSurface.get());
-    unsigned destBytesPerRow = 4 * rect.width();
 
     unsigned char* destRows = dataDst + desty * destBytesPerRow + destx * 4;
     for (int y = 0; y < numRows; ++y) {
         unsigned* row = reinterpret_cast_ptr<unsigned*>(dataSrc + stride * (y + originy));
-        for (int x = 0; x < numColumns; x++) {
+        int x = 0;
+#if HAVE(SSE2_INTRINSICS)
+        x = copyARGB32ToRGBASSE2(row + originx, destRows, numColumns, multiplied == Unmultiplied);
+#endif
+        for (; x < numColumns; x++) {
             int basex = x * 4;
             unsigned* pixel = row + x + originx;
 
@@ -258,9 +276,9 @@ PassRefPtr<Uint8ClampedArray> getImageData(const IntRect& rect, const ImageBuffe
 
             if (multiplied == Unmultiplied) {
                 if (alpha && alpha != 255) {
-                    red = red * 255 / alpha;
-                    green = green * 255 / alpha;
-                    blue = blue * 255 / alpha;
+                    red = std::min(red * 255 / alpha, 255u);
+                    green = std::min(green * 255 / alpha, 255u);
+                    blue = std::min(blue * 255 / alpha, 255u);
                 }
             }
 
@@ -327,7 +345,11 @@ void ImageBuffer::putByteArray(Multiply multiplied, Uint8ClampedArray* source, c
     unsigned char* srcRows = source->data() + originy * srcBytesPerRow + originx * 4;
     for (int y = 0; y < numRows; ++y) {
         unsigned* row = reinterpret_cast_ptr<unsigned*>(pixelData + stride * (y + desty));
-        for (int x = 0; x < numColumns; x++) {
+        int x = 0;
+#if HAVE(SSE2_INTRINSICS)
+        x = copyRGBAToARGB32SSE2(srcRows, row + destx, numColumns, multiplied == Unmultiplied);
+#endif
+        for (; x < numColumns; x++) {
             int basex = x * 4;
             unsigned* pixel = row + x + destx;
 
@@ -49,6 +49,7 @@ public:
     virtual ~TileCairo();
 
     virtual bool isDirty() const;
+    virtual IntRect dirtyRect() const;
     virtual void invalidate(const IntRect&);
     virtual Vector<IntRect> updateBackBuffer();
     virtual void swapBackBufferToFront();
@@ -91,6 +91,8 @@ BitmapImage::BitmapImage(CGImageRef cgImage, ImageObserver* observer)
     , m_haveSize(true)
     , m_sizeAvailable(true)
     , m_haveFrameCount(true)
+    , m_allowsAsynchronousDecoding(false)
+    , m_advanceAnimationWhenFrameIsDecoded(false)
 {
     CGFloat width = CGImageGetWidth(cgImage);
     CGFloat height = CGImageGetHeight(cgImage);
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2014 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ImageBufferCairoSSE2_h
+#define ImageBufferCairoSSE2_h
+
+#if USE(CAIRO) && HAVE(SSE2_INTRINSICS)
+
+#include <cmath>
+#include <emmintrin.h>
+#include <stdint.h>
+
+namespace WebCore {
+
+// Cairo's ARGB32 pixels are native endian words, so on x86 each one is stored as the bytes
+// B, G, R, A. Canvas image data is stored as R, G, B, A. Both kernels give the same results as
+// the scalar loops in ImageBufferCairo.cpp, which convert the pixels left over at the end of a row.
+
+// Reciprocals of the alpha values, rounded up so that multiplying the exact product c * 255 by
+// one truncates to c * 255 / alpha for every c. Alpha 0 and 255 leave the color unchanged.
+struct UnpremultiplyReciprocalTable {
+    UnpremultiplyReciprocalTable()
+    {
+        for (unsigned alpha = 0; alpha < 256; ++alpha) {
+            double exactReciprocal = 1.0 / (alpha && alpha != 255 ? alpha : 255);
+            float reciprocal = static_cast<float>(exactReciprocal);
+            if (reciprocal < exactReciprocal)
+                reciprocal = nextafterf(reciprocal, 1);
+            reciprocals[alpha] = reciprocal;
+        }
+    }
+
+    float reciprocals[256];
+};
+
+inline const float* unpremultiplyReciprocals()
+{
+    static const UnpremultiplyReciprocalTable table;
+    return table.reciprocals;
+}
+
+// Turns 0xAARRGGBB into 0xAABBGGRR, and back.
+inline __m128i swapRedAndBlue(__m128i pixels)
+{
+    __m128i alphaAndGreen = _mm_and_si128(pixels, _mm_set1_epi32(0xFF00FF00));
+    __m128i redAndBlue = _mm_and_si128(pixels, _mm_set1_epi32(0x00FF00FF));
+    redAndBlue = _mm_or_si128(_mm_slli_epi32(redAndBlue, 16), _mm_srli_epi32(redAndBlue, 16));
+    return _mm_or_si128(alphaAndGreen, redAndBlue);
+}
+
+inline bool areOpaque(__m128i pixels)
+{
+    __m128i alphaMask = _mm_set1_epi32(0xFF000000);
+    return _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(pixels, alphaMask), alphaMask)) == 0xFFFF;
+}
+
+inline __m128i unpremultiplyChannel(__m128i pixels, int shift, __m128 reciprocals)
+{
+    __m128i channel = _mm_and_si128(_mm_srli_epi32(pixels, shift), _mm_set1_epi32(0xFF));
+    __m128i scaledChannel = _mm_sub_epi32(_mm_slli_epi32(channel, 8), channel);
+    return _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(scaledChannel), reciprocals));
+}
+
+inline __m128i unpremultiplyARGB32ToRGBA(__m128i pixels, const uint32_t* source)
+{
+    // SSE2 has no gather, so the reciprocals are looked up one pixel at a time.
+    const float* table = unpremultiplyReciprocals();
+    __m128 reciprocals = _mm_set_ps(table[source[3] >> 24], table[source[2] >> 24], table[source[1] >> 24], table[source[0] >> 24]);
+
+    __m128i red = unpremultiplyChannel(pixels, 16, reciprocals);
+    __m128i green = unpremultiplyChannel(pixels, 8, reciprocals);
+    __m128i blue = unpremultiplyChannel(pixels, 0, reciprocals);
+    __m128i alpha = _mm_srli_epi32(pixels, 24);
+
+    // Saturating to bytes clamps colors larger than their alpha, like the scalar code does.
+    // This gives the planes R, B, G, A, which two unpacks interleave into R, G, B, A pixels.
+    __m128i planes = _mm_packus_epi16(_mm_packs_epi32(red, blue), _mm_packs_epi32(green, alpha));
+    __m128i pairs = _mm_unpacklo_epi8(planes, _mm_srli_si128(planes, 8));
+    return _mm_unpacklo_epi16(pairs, _mm_srli_si128(pairs, 8));
+}
+
+// Converts whole groups of four pixels and returns how many pixels were converted.
+inline int copyARGB32ToRGBASSE2(const uint32_t* source, unsigned char* destination, int pixelCount, bool unpremultiply)
+{
+    int x = 0;
+    for (; x + 4 <= pixelCount; x += 4) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + x));
+        if (!unpremultiply || areOpaque(pixels))
+            pixels = swapRedAndBlue(pixels);
+        else
+            pixels = unpremultiplyARGB32ToRGBA(pixels, source + x);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + x * 4), pixels);
+    }
+    return x;
+}
+
+// Takes two pixels as 16-bit R, G, B, A channels.
+inline __m128i premultiplyTwoPixels(__m128i pixels)
+{
+    // The alpha channel is multiplied by 255, which the rounding below leaves unchanged.
+    __m128i alphaLanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    __m128i factors = _mm_or_si128(_mm_andnot_si128(alphaLanes, alpha), _mm_and_si128(alphaLanes, _mm_set1_epi16(255)));
+    __m128i products = _mm_add_epi16(_mm_mullo_epi16(pixels, factors), _mm_set1_epi16(254));
+
+    // For any 16-bit x, x / 255 == (x * 0x8081) >> 23.
+    return _mm_srli_epi16(_mm_mulhi_epu16(products, _mm_set1_epi16(static_cast<short>(0x8081))), 7);
+}
+
+// Converts whole groups of four pixels and returns how many pixels were converted.
+inline int copyRGBAToARGB32SSE2(const unsigned char* source, uint32_t* destination, int pixelCount, bool premultiply)
+{
+    __m128i zero = _mm_setzero_si128();
+    int x = 0;
+    for (; x + 4 <= pixelCount; x += 4) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + x * 4));
+        if (premultiply && !areOpaque(pixels)) {
+            __m128i low = premultiplyTwoPixels(_mm_unpacklo_epi8(pixels, zero));
+            __m128i high = premultiplyTwoPixels(_mm_unpackhi_epi8(pixels, zero));
+            pixels = _mm_packus_epi16(low, high);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + x), swapRedAndBlue(pixels));
+    }
+    return x;
+}
+
+} // namespace WebCore
+
+#endif // USE(CAIRO) && HAVE(SSE2_INTRINSICS)
+
+#endif // ImageBufferCairoSSE2_h
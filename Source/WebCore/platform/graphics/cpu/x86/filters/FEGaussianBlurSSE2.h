@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2014 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FEGaussianBlurSSE2_h
+#define FEGaussianBlurSSE2_h
+
+#if ENABLE(FILTERS) && HAVE(SSE2_INTRINSICS)
+
+#include <algorithm>
+#include <emmintrin.h>
+#include <runtime/Uint8ClampedArray.h>
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+// The sums are kept as 32-bit integers so the results match the scalar boxBlur() exactly:
+// a correctly rounded float division of an integer below 2^24 never crosses an integer
+// boundary for the kernel sizes FEGaussianBlur uses, so truncating it equals sum / dx.
+
+inline __m128i loadRGBA8AsInt32(const uint32_t* source)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i pixel = _mm_cvtsi32_si128(*reinterpret_cast<const int*>(source));
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(pixel, zero), zero);
+}
+
+inline void storeInt32AsRGBA8(__m128i sum, __m128 divisor, uint32_t* destination)
+{
+    __m128i result = _mm_cvttps_epi32(_mm_div_ps(_mm_cvtepi32_ps(sum), divisor));
+    result = _mm_packs_epi32(result, result);
+    result = _mm_packus_epi16(result, result);
+    *reinterpret_cast<int*>(destination) = _mm_cvtsi128_si32(result);
+}
+
+// Horizontal pass: slides the kernel along each row, one pixel (four channels) per vector.
+inline void boxBlurHorizontalSSE2(Uint8ClampedArray* srcPixelArray, Uint8ClampedArray* dstPixelArray,
+    unsigned dx, int dxLeft, int dxRight, int effectWidth, int effectHeight)
+{
+    const uint32_t* sourcePixel = reinterpret_cast<const uint32_t*>(srcPixelArray->data());
+    uint32_t* destinationPixel = reinterpret_cast<uint32_t*>(dstPixelArray->data());
+    __m128 divisor = _mm_set1_ps(static_cast<float>(dx));
+    int maxKernelSize = std::min(dxRight, effectWidth);
+
+    for (int y = 0; y < effectHeight; ++y) {
+        const uint32_t* sourceLine = sourcePixel + y * effectWidth;
+        uint32_t* destinationLine = destinationPixel + y * effectWidth;
+
+        // Fill the kernel.
+        __m128i sum = _mm_setzero_si128();
+        for (int i = 0; i < maxKernelSize; ++i)
+            sum = _mm_add_epi32(sum, loadRGBA8AsInt32(sourceLine + i));
+
+        // Blurring.
+        for (int x = 0; x < effectWidth; ++x) {
+            storeInt32AsRGBA8(sum, divisor, destinationLine + x);
+            if (x >= dxLeft)
+                sum = _mm_sub_epi32(sum, loadRGBA8AsInt32(sourceLine + x - dxLeft));
+            if (x + dxRight < effectWidth)
+                sum = _mm_add_epi32(sum, loadRGBA8AsInt32(sourceLine + x + dxRight));
+        }
+    }
+}
+
+// Vertical pass: rather than walking each column with a row-sized stride, keep one running
+// sum per column and sweep the image row by row. Every load and store is then sequential,
+// which gives the cache behavior of a transpose-blur-transpose without the extra copies.
+inline void boxBlurVerticalSSE2(Uint8ClampedArray* srcPixelArray, Uint8ClampedArray* dstPixelArray,
+    unsigned dy, int dyLeft, int dyRight, int effectWidth, int effectHeight)
+{
+    const uint32_t* sourcePixel = reinterpret_cast<const uint32_t*>(srcPixelArray->data());
+    uint32_t* destinationPixel = reinterpret_cast<uint32_t*>(dstPixelArray->data());
+    __m128 divisor = _mm_set1_ps(static_cast<float>(dy));
+    int maxKernelSize = std::min(dyRight, effectHeight);
+
+    // Four 32-bit channel sums per column. Vector storage is not guaranteed to be 16-byte
+    // aligned on every platform, so the sums are accessed with unaligned loads and stores.
+    Vector<int32_t> columnSums(effectWidth * 4);
+    columnSums.fill(0);
+    __m128i* sums = reinterpret_cast<__m128i*>(columnSums.data());
+
+    // Fill the kernel.
+    for (int i = 0; i < maxKernelSize; ++i) {
+        const uint32_t* sourceLine = sourcePixel + i * effectWidth;
+        for (int x = 0; x < effectWidth; ++x)
+            _mm_storeu_si128(sums + x, _mm_add_epi32(_mm_loadu_si128(sums + x), loadRGBA8AsInt32(sourceLine + x)));
+    }
+
+    // Blurring.
+    for (int y = 0; y < effectHeight; ++y) {
+        uint32_t* destinationLine = destinationPixel + y * effectWidth;
+        const uint32_t* leavingLine = y >= dyLeft ? sourcePixel + (y - dyLeft) * effectWidth : nullptr;
+        const uint32_t* enteringLine = y + dyRight < effectHeight ? sourcePixel + (y + dyRight) * effectWidth : nullptr;
+
+        for (int x = 0; x < effectWidth; ++x) {
+            __m128i sum = _mm_loadu_si128(sums + x);
+            storeInt32AsRGBA8(sum, divisor, destinationLine + x);
+            if (leavingLine)
+                sum = _mm_sub_epi32(sum, loadRGBA8AsInt32(leavingLine + x));
+            if (enteringLine)
+                sum = _mm_add_epi32(sum, loadRGBA8AsInt32(enteringLine + x));
+            _mm_storeu_si128(sums + x, sum);
+        }
+    }
+}
+
+} // namespace WebCore
+
+#endif // ENABLE(FILTERS) && HAVE(SSE2_INTRINSICS)
+
+#endif // FEGaussianBlurSSE2_h
@@ -449,7 +449,8 @@ void FEConvolveMatrix::platformApplySoftware()
 
     if (clipRight >= 0 && clipBottom >= 0) {
 
-        int optimalThreadNumber = (absolutePaintRect().width() * absolutePaintRect().height()) / s_minimalRectDimension;
+        // One job per tile of s_minimalRectDimension pixels, but never more jobs than rows.
+        int optimalThreadNumber = std::min((absolutePaintRect().width() * absolutePaintRect().height()) / s_minimalRectDimension, clipBottom);
         if (optimalThreadNumber > 1) {
             WTF::ParallelJobs<InteriorPixelParameters> parallelJobs(&WebCore::FEConvolveMatrix::setInteriorPixelsWorker, optimalThreadNumber);
             const int numOfThreads = parallelJobs.numberOfJobs();
@@ -102,7 +102,7 @@ private:
     ALWAYS_INLINE void setOuterPixels(PaintingData&, int x1, int y1, int x2, int y2);
 
     // Parallelization parts
-    static const int s_minimalRectDimension = (100 * 100); // Empirical data limit for parallel jobs
+    static const int s_minimalRectDimension = (100 * 100); // Empirical data limit for parallel jobs, and the area of each job's tile
 
     template<typename Type>
     friend class ParallelJobs;
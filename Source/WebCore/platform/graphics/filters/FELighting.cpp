@@ -249,7 +249,8 @@ void FELighting::platformApplyGenericWorker(PlatformApplyGenericParameters* para
 
 inline void FELighting::platformApplyGeneric(LightingData& data, LightSource::PaintingData& paintingData)
 {
-    int optimalThreadNumber = ((data.widthDecreasedByOne - 1) * (data.heightDecreasedByOne - 1)) / s_minimalRectDimension;
+    // One job per tile of s_minimalRectDimension pixels, but never more jobs than rows.
+    int optimalThreadNumber = std::min(((data.widthDecreasedByOne - 1) * (data.heightDecreasedByOne - 1)) / s_minimalRectDimension, data.heightDecreasedByOne - 1);
     if (optimalThreadNumber > 1) {
         // Initialize parallel jobs
         WTF::ParallelJobs<PlatformApplyGenericParameters> parallelJobs(&platformApplyGenericWorker, optimalThreadNumber);
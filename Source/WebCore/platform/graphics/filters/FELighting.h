@@ -49,7 +49,7 @@ public:
     virtual void determineAbsolutePaintRect() { setAbsolutePaintRect(enclosingIntRect(maxEffectRect())); }
 
 protected:
-    static const int s_minimalRectDimension = 100 * 100; // Empirical data limit for parallel jobs
+    static const int s_minimalRectDimension = 100 * 100; // Empirical data limit for parallel jobs, and the area of each job's tile
 
     enum LightingType {
         DiffuseLighting,
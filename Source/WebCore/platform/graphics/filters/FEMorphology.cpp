@@ -164,8 +164,11 @@ void FEMorphology::platformApplyWorker(PlatformApplyParameters* param)
 
 void FEMorphology::platformApply(PaintingData* paintingData)
 {
-    int optimalThreadNumber = (paintingData->width * paintingData->height) / s_minimalArea;
-    if (optimalThreadNumber > 1) {
+    int area = paintingData->width * paintingData->height;
+    if (area / s_minimalArea > 1) {
+        // Once the image is worth splitting, split it into tiles much smaller than the threshold so
+        // the work-stealing pool can balance them. A tile is at least one row tall.
+        int optimalThreadNumber = std::min(area / s_tileArea, paintingData->height);
         ParallelJobs<PlatformApplyParameters> parallelJobs(&WebCore::FEMorphology::platformApplyWorker, optimalThreadNumber);
         int numOfThreads = parallelJobs.numberOfJobs();
         if (numOfThreads > 1) {
@@ -63,6 +63,7 @@ public:
     };
 
     static const int s_minimalArea = (300 * 300); // Empirical data limit for parallel jobs
+    static const int s_tileArea = (100 * 100); // Area of the row tiles run as parallel jobs
 
     struct PlatformApplyParameters {
         FEMorphology* filter;
@@ -367,7 +367,8 @@ void FETurbulence::platformApplySoftware()
     PaintingData paintingData(m_seed, roundedIntSize(filterPrimitiveSubregion().size()));
     initPaint(paintingData);
 
-    int optimalThreadNumber = (absolutePaintRect().width() * absolutePaintRect().height()) / s_minimalRectDimension;
+    // One job per tile of s_minimalRectDimension pixels, but never more jobs than rows.
+    int optimalThreadNumber = std::min((absolutePaintRect().width() * absolutePaintRect().height()) / s_minimalRectDimension, absolutePaintRect().height());
     if (optimalThreadNumber > 1) {
         // Initialize parallel jobs
         WTF::ParallelJobs<FillRegionParameters> parallelJobs(&WebCore::FETurbulence::fillRegionWorker, optimalThreadNumber);
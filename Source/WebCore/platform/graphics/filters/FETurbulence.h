@@ -74,7 +74,7 @@ private:
     static const int s_blockSize = 256;
     static const int s_blockMask = s_blockSize - 1;
 
-    static const int s_minimalRectDimension = (100 * 100); // Empirical data limit for parallel jobs.
+    static const int s_minimalRectDimension = (100 * 100); // Empirical data limit for parallel jobs, and the area of each job's tile.
 
     struct PaintingData {
         PaintingData(long paintingSeed, const IntSize& paintingSize)
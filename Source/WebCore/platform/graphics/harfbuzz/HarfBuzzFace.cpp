@@ -34,6 +34,8 @@
 #include "FontPlatformData.h"
 #include "hb-ot.h"
 #include "hb.h"
+#include <wtf/HashSet.h>
+#include <wtf/NeverDestroyed.h>
 
 namespace WebCore {
 
@@ -78,10 +80,21 @@ static HarfBuzzFaceCache* harfBuzzFaceCache()
     return &s_harfBuzzFaceCache;
 }
 
+// Past this many words, a face's cache is cleared and starts over, like WidthCache.
+static const unsigned maxShapedWordsPerFace = 2000;
+
+static HashSet<HarfBuzzFace*>& facesWithShapedWords()
+{
+    static NeverDestroyed<HashSet<HarfBuzzFace*>> faces;
+    return faces;
+}
+
 HarfBuzzFace::HarfBuzzFace(FontPlatformData* platformData, uint64_t uniqueID)
     : m_platformData(platformData)
     , m_uniqueID(uniqueID)
     , m_scriptForVerticalText(HB_SCRIPT_INVALID)
+    , m_hasCheckedSpaceAffectsShaping(false)
+    , m_spaceAffectsShaping(false)
 {
     HarfBuzzFaceCache::AddResult result = harfBuzzFaceCache()->add(m_uniqueID, nullptr);
     if (result.isNewEntry)
@@ -93,6 +106,8 @@ HarfBuzzFace::HarfBuzzFace(FontPlatformData* platformData, uint64_t uniqueID)
 
 HarfBuzzFace::~HarfBuzzFace()
 {
+    facesWithShapedWords().remove(this);
+
     HarfBuzzFaceCache::iterator result = harfBuzzFaceCache()->find(m_uniqueID);
     ASSERT(result != harfBuzzFaceCache()->end());
     ASSERT(result.get()->value->refCount() > 1);
@@ -122,11 +137,78 @@ static hb_script_t findScriptForVerticalGlyphSubstitution(hb_face_t* face)
     return HB_SCRIPT_INVALID;
 }
 
-void HarfBuzzFace::setScriptForVerticalGlyphSubstitution(hb_buffer_t* buffer)
+hb_script_t HarfBuzzFace::scriptForVerticalGlyphSubstitution()
 {
     if (m_scriptForVerticalText == HB_SCRIPT_INVALID)
         m_scriptForVerticalText = findScriptForVerticalGlyphSubstitution(m_face);
-    hb_buffer_set_script(buffer, m_scriptForVerticalText);
+    return m_scriptForVerticalText;
+}
+
+void HarfBuzzFace::setScriptForVerticalGlyphSubstitution(hb_buffer_t* buffer)
+{
+    hb_buffer_set_script(buffer, scriptForVerticalGlyphSubstitution());
+}
+
+static bool lookupsUseGlyph(hb_face_t* face, hb_tag_t tableTag, hb_codepoint_t glyph)
+{
+    hb_set_t* glyphs = hb_set_create();
+    bool result = false;
+    unsigned lookupCount = hb_ot_layout_table_get_lookup_count(face, tableTag);
+    for (unsigned lookupIndex = 0; lookupIndex < lookupCount && !result; ++lookupIndex) {
+        hb_set_clear(glyphs);
+        hb_ot_layout_lookup_collect_glyphs(face, tableTag, lookupIndex, glyphs, glyphs, glyphs, 0);
+        result = hb_set_has(glyphs, glyph);
+    }
+    hb_set_destroy(glyphs);
+    return result;
+}
+
+static bool lookupsUseSpaceGlyph(hb_face_t* face, hb_font_t* font)
+{
+    if (!hb_ot_layout_has_substitution(face) && !hb_ot_layout_has_positioning(face))
+        return false;
+
+    // HarfBuzzShaper normalizes every character it splits words at to a space. When
+    // the font has no space glyph, spaces are drawn with a fallback font and cannot
+    // affect the words next to them.
+    hb_codepoint_t space;
+    if (!hb_font_get_glyph(font, ' ', 0, &space))
+        return false;
+
+    return lookupsUseGlyph(face, HB_OT_TAG_GSUB, space) || lookupsUseGlyph(face, HB_OT_TAG_GPOS, space);
+}
+
+bool HarfBuzzFace::spaceAffectsShaping()
+{
+    if (!m_hasCheckedSpaceAffectsShaping) {
+        hb_font_t* font = createFont();
+        m_spaceAffectsShaping = lookupsUseSpaceGlyph(m_face, font);
+        hb_font_destroy(font);
+        m_hasCheckedSpaceAffectsShaping = true;
+    }
+    return m_spaceAffectsShaping;
+}
+
+const HarfBuzzShapedWord* HarfBuzzFace::shapedWord(const String& key) const
+{
+    auto it = m_shapedWords.find(key);
+    return it == m_shapedWords.end() ? nullptr : &it->value;
+}
+
+void HarfBuzzFace::addShapedWord(const String& key, const HarfBuzzShapedWord& word)
+{
+    if (m_shapedWords.size() >= maxShapedWordsPerFace)
+        m_shapedWords.clear();
+
+    m_shapedWords.set(key, word);
+    facesWithShapedWords().add(this);
+}
+
+void HarfBuzzFace::clearShapedWordCaches()
+{
+    for (auto* face : facesWithShapedWords())
+        face->m_shapedWords.clear();
+    facesWithShapedWords().clear();
 }
 
 } // namespace WebCore
@@ -37,11 +37,24 @@
 #include <wtf/PassRefPtr.h>
 #include <wtf/RefCounted.h>
 #include <wtf/RefPtr.h>
+#include <wtf/Vector.h>
+#include <wtf/text/StringHash.h>
+#include <wtf/text/WTFString.h>
 
 namespace WebCore {
 
 class FontPlatformData;
 
+struct HarfBuzzShapedGlyph {
+    uint16_t glyph;
+    unsigned cluster; // Index of the glyph's first character in the shaped text.
+    hb_position_t xAdvance;
+    hb_position_t xOffset;
+    hb_position_t yOffset;
+};
+
+typedef Vector<HarfBuzzShapedGlyph> HarfBuzzShapedWord;
+
 class HarfBuzzFace : public RefCounted<HarfBuzzFace> {
 public:
     static const hb_tag_t vertTag;
@@ -56,8 +69,21 @@ public:
 
     hb_font_t* createFont();
 
+    hb_script_t scriptForVerticalGlyphSubstitution();
     void setScriptForVerticalGlyphSubstitution(hb_buffer_t*);
 
+    // Whether any GSUB or GPOS lookup of the font looks at the glyph of a space,
+    // e.g. to kern the last letter of a word against it. Words must then be shaped
+    // together with the spaces around them.
+    bool spaceAffectsShaping();
+
+    // The same words are shaped every time text is measured, laid out or painted,
+    // so the glyphs HarfBuzz produced for them are cached with the face. The key
+    // holds the text and everything else that was passed to hb_shape().
+    const HarfBuzzShapedWord* shapedWord(const String& key) const;
+    void addShapedWord(const String& key, const HarfBuzzShapedWord&);
+    static void clearShapedWordCaches();
+
 private:
     HarfBuzzFace(FontPlatformData*, uint64_t);
 
@@ -69,6 +95,9 @@ private:
     WTF::HashMap<uint32_t, uint16_t>* m_glyphCacheForFaceCacheEntry;
 
     hb_script_t m_scriptForVerticalText;
+    bool m_hasCheckedSpaceAffectsShaping;
+    bool m_spaceAffectsShaping;
+    HashMap<String, HarfBuzzShapedWord> m_shapedWords;
 };
 
 }
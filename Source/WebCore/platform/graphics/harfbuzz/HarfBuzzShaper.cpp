@@ -81,9 +81,9 @@ HarfBuzzShaper::HarfBuzzRun::HarfBuzzRun(const SimpleFontData* fontData, unsigne
 {
 }
 
-void HarfBuzzShaper::HarfBuzzRun::applyShapeResult(hb_buffer_t* harfBuzzBuffer)
+void HarfBuzzShaper::HarfBuzzRun::applyShapeResult(unsigned numGlyphs)
 {
-    m_numGlyphs = hb_buffer_get_length(harfBuzzBuffer);
+    m_numGlyphs = numGlyphs;
     m_glyphs.resize(m_numGlyphs);
     m_advances.resize(m_numGlyphs);
     m_glyphToCharacterIndexes.resize(m_numGlyphs);
@@ -456,11 +456,73 @@ bool HarfBuzzShaper::collectHarfBuzzRuns()
     return !m_harfBuzzRuns.isEmpty();
 }
 
+// Words longer than this are shaped every time; they rarely repeat.
+static const unsigned maxCachedWordLength = 64;
+
+static void appendToShapedWordKey(Vector<UChar, 64>& key, uint32_t value)
+{
+    key.append(value >> 16);
+    key.append(value & 0xFFFF);
+}
+
+void HarfBuzzShaper::shapeWord(hb_buffer_t* harfBuzzBuffer, HarfBuzzFace* face, hb_font_t* harfBuzzFont, const UChar* characters, unsigned length, hb_script_t script, hb_direction_t direction, bool shouldSetDirection, HarfBuzzShapedWord& shapedWord)
+{
+    // Everything that hb_shape() depends on besides the face goes into the key.
+    Vector<UChar, 64> key;
+    bool isCacheable = length <= maxCachedWordLength;
+    if (isCacheable) {
+        appendToShapedWordKey(key, script);
+        key.append(direction);
+        key.append(shouldSetDirection);
+        key.append(m_features.size());
+        for (unsigned i = 0; i < m_features.size(); ++i) {
+            appendToShapedWordKey(key, m_features[i].tag);
+            appendToShapedWordKey(key, m_features[i].value);
+        }
+        key.append(characters, length);
+        if (const HarfBuzzShapedWord* cachedWord = face->shapedWord(String(key.data(), key.size()))) {
+            shapedWord = *cachedWord;
+            return;
+        }
+    }
+
+    hb_buffer_set_unicode_funcs(harfBuzzBuffer, hb_icu_get_unicode_funcs());
+    hb_buffer_set_script(harfBuzzBuffer, script);
+    hb_buffer_set_direction(harfBuzzBuffer, direction);
+    if (!shouldSetDirection)
+        hb_buffer_guess_segment_properties(harfBuzzBuffer);
+
+    // Add a space as pre-context to the buffer. This prevents showing dotted-circle
+    // for combining marks at the beginning of runs.
+    static const uint16_t preContext = ' ';
+    hb_buffer_add_utf16(harfBuzzBuffer, &preContext, 1, 1, 0);
+    hb_buffer_add_utf16(harfBuzzBuffer, reinterpret_cast<const uint16_t*>(characters), length, 0, length);
+
+    hb_shape(harfBuzzFont, harfBuzzBuffer, m_features.isEmpty() ? 0 : m_features.data(), m_features.size());
+
+    unsigned numGlyphs = hb_buffer_get_length(harfBuzzBuffer);
+    hb_glyph_info_t* glyphInfos = hb_buffer_get_glyph_infos(harfBuzzBuffer, 0);
+    hb_glyph_position_t* glyphPositions = hb_buffer_get_glyph_positions(harfBuzzBuffer, 0);
+    shapedWord.resize(numGlyphs);
+    for (unsigned i = 0; i < numGlyphs; ++i) {
+        HarfBuzzShapedGlyph& glyph = shapedWord[i];
+        glyph.glyph = glyphInfos[i].codepoint;
+        glyph.cluster = glyphInfos[i].cluster;
+        glyph.xAdvance = glyphPositions[i].x_advance;
+        glyph.xOffset = glyphPositions[i].x_offset;
+        glyph.yOffset = glyphPositions[i].y_offset;
+    }
+    hb_buffer_reset(harfBuzzBuffer);
+
+    if (isCacheable)
+        face->addShapedWord(String(key.data(), key.size()), shapedWord);
+}
+
 bool HarfBuzzShaper::shapeHarfBuzzRuns(bool shouldSetDirection)
 {
     HarfBuzzScopedPtr<hb_buffer_t> harfBuzzBuffer(hb_buffer_create(), hb_buffer_destroy);
-
-    hb_buffer_set_unicode_funcs(harfBuzzBuffer.get(), hb_icu_get_unicode_funcs());
+    Vector<HarfBuzzShapedGlyph, 256> runGlyphs;
+    HarfBuzzShapedWord shapedWord;
 
     for (unsigned i = 0; i < m_harfBuzzRuns.size(); ++i) {
         unsigned runIndex = m_run.rtl() ? m_harfBuzzRuns.size() - i - 1 : i;
@@ -469,52 +531,80 @@ bool HarfBuzzShaper::shapeHarfBuzzRuns(bool shouldSetDirection)
         if (currentFontData->isSVGFont())
             return false;
 
-        hb_buffer_set_script(harfBuzzBuffer.get(), currentRun->script());
-        if (shouldSetDirection)
-            hb_buffer_set_direction(harfBuzzBuffer.get(), currentRun->rtl() ? HB_DIRECTION_RTL : HB_DIRECTION_LTR);
-        else
-            // Leaving direction to HarfBuzz to guess is *really* bad, but will do for now.
-            hb_buffer_guess_segment_properties(harfBuzzBuffer.get());
-
-        // Add a space as pre-context to the buffer. This prevents showing dotted-circle
-        // for combining marks at the beginning of runs.
-        static const uint16_t preContext = ' ';
-        hb_buffer_add_utf16(harfBuzzBuffer.get(), &preContext, 1, 1, 0);
-
+        const UChar* characters = m_normalizedBuffer.get() + currentRun->startIndex();
+        unsigned numCharacters = currentRun->numCharacters();
+        Vector<UChar> upperCharacters;
         if (m_font->isSmallCaps() && u_islower(m_normalizedBuffer[currentRun->startIndex()])) {
-            String upperText = String(m_normalizedBuffer.get() + currentRun->startIndex(), currentRun->numCharacters()).upper();
+            String upperText = String(characters, numCharacters).upper();
             currentFontData = m_font->glyphDataForCharacter(upperText[0], false, SmallCapsVariant).fontData;
-            const UChar* characters = StringView(upperText).upconvertedCharacters();
-            hb_buffer_add_utf16(harfBuzzBuffer.get(), reinterpret_cast<const uint16_t*>(characters), currentRun->numCharacters(), 0, currentRun->numCharacters());
-        } else
-            hb_buffer_add_utf16(harfBuzzBuffer.get(), reinterpret_cast<const uint16_t*>(m_normalizedBuffer.get() + currentRun->startIndex()), currentRun->numCharacters(), 0, currentRun->numCharacters());
+            upperCharacters = upperText.charactersWithNullTermination();
+            characters = upperCharacters.data();
+        }
 
         FontPlatformData* platformData = const_cast<FontPlatformData*>(&currentFontData->platformData());
         HarfBuzzFace* face = platformData->harfBuzzFace();
         if (!face)
             return false;
 
+        // WebKit doesn't always set the direction, in which case HarfBuzz would
+        // guess it from the script; it is computed the same way here, since the
+        // words are laid out in that direction.
+        hb_direction_t direction;
+        if (shouldSetDirection)
+            direction = currentRun->rtl() ? HB_DIRECTION_RTL : HB_DIRECTION_LTR;
+        else {
+            // Leaving direction to HarfBuzz to guess is *really* bad, but will do for now.
+            direction = hb_script_get_horizontal_direction(currentRun->script());
+            if (direction == HB_DIRECTION_INVALID)
+                direction = HB_DIRECTION_LTR;
+        }
+        hb_script_t script = currentRun->script();
         if (m_font->fontDescription().orientation() == Vertical)
-            face->setScriptForVerticalGlyphSubstitution(harfBuzzBuffer.get());
+            script = face->scriptForVerticalGlyphSubstitution();
 
         HarfBuzzScopedPtr<hb_font_t> harfBuzzFont(face->createFont(), hb_font_destroy);
 
-        hb_shape(harfBuzzFont.get(), harfBuzzBuffer.get(), m_features.isEmpty() ? 0 : m_features.data(), m_features.size());
-
-        currentRun->applyShapeResult(harfBuzzBuffer.get());
-        setGlyphPositionsForHarfBuzzRun(currentRun, harfBuzzBuffer.get());
+        // Split the run into words and the spaces between them, so that each
+        // word is shaped on its own and can be reused wherever it appears. Fonts
+        // that kern or substitute across spaces get the whole run shaped at once.
+        Vector<std::pair<unsigned, unsigned>, 16> words;
+        unsigned wordStart = 0;
+        if (!face->spaceAffectsShaping()) {
+            for (unsigned j = 0; j < numCharacters; ++j) {
+                if (!isCodepointSpace(characters[j]))
+                    continue;
+                if (j > wordStart)
+                    words.append(std::make_pair(wordStart, j - wordStart));
+                words.append(std::make_pair(j, 1));
+                wordStart = j + 1;
+            }
+        }
+        if (wordStart < numCharacters)
+            words.append(std::make_pair(wordStart, numCharacters - wordStart));
+
+        // HarfBuzz returns glyphs in visual order, so words shaped right to
+        // left are also appended from the last one.
+        runGlyphs.clear();
+        bool isBackward = HB_DIRECTION_IS_BACKWARD(direction);
+        for (unsigned j = 0; j < words.size(); ++j) {
+            const std::pair<unsigned, unsigned>& word = words[isBackward ? words.size() - j - 1 : j];
+            shapeWord(harfBuzzBuffer.get(), face, harfBuzzFont.get(), characters + word.first, word.second, script, direction, shouldSetDirection, shapedWord);
+            for (unsigned k = 0; k < shapedWord.size(); ++k) {
+                runGlyphs.append(shapedWord[k]);
+                runGlyphs.last().cluster += word.first;
+            }
+        }
 
-        hb_buffer_reset(harfBuzzBuffer.get());
+        currentRun->applyShapeResult(runGlyphs.size());
+        setGlyphPositionsForHarfBuzzRun(currentRun, runGlyphs);
     }
 
     return true;
 }
 
-void HarfBuzzShaper::setGlyphPositionsForHarfBuzzRun(HarfBuzzRun* currentRun, hb_buffer_t* harfBuzzBuffer)
+void HarfBuzzShaper::setGlyphPositionsForHarfBuzzRun(HarfBuzzRun* currentRun, const Vector<HarfBuzzShapedGlyph, 256>& glyphs)
 {
     const SimpleFontData* currentFontData = currentRun->fontData();
-    hb_glyph_info_t* glyphInfos = hb_buffer_get_glyph_infos(harfBuzzBuffer, 0);
-    hb_glyph_position_t* glyphPositions = hb_buffer_get_glyph_positions(harfBuzzBuffer, 0);
 
     unsigned numGlyphs = currentRun->numGlyphs();
     uint16_t* glyphToCharacterIndexes = currentRun->glyphToCharacterIndexes();
@@ -523,16 +613,16 @@ void HarfBuzzShaper::setGlyphPositionsForHarfBuzzRun(HarfBuzzRun* currentRun, hb
     // HarfBuzz returns the shaping result in visual order. We need not to flip for RTL.
     for (size_t i = 0; i < numGlyphs; ++i) {
         bool runEnd = i + 1 == numGlyphs;
-        uint16_t glyph = glyphInfos[i].codepoint;
-        float offsetX = harfBuzzPositionToFloat(glyphPositions[i].x_offset);
-        float offsetY = -harfBuzzPositionToFloat(glyphPositions[i].y_offset);
-        float advance = harfBuzzPositionToFloat(glyphPositions[i].x_advance);
+        uint16_t glyph = glyphs[i].glyph;
+        float offsetX = harfBuzzPositionToFloat(glyphs[i].xOffset);
+        float offsetY = -harfBuzzPositionToFloat(glyphs[i].yOffset);
+        float advance = harfBuzzPositionToFloat(glyphs[i].xAdvance);
 
-        unsigned currentCharacterIndex = currentRun->startIndex() + glyphInfos[i].cluster;
-        bool isClusterEnd = runEnd || glyphInfos[i].cluster != glyphInfos[i + 1].cluster;
+        unsigned currentCharacterIndex = currentRun->startIndex() + glyphs[i].cluster;
+        bool isClusterEnd = runEnd || glyphs[i].cluster != glyphs[i + 1].cluster;
         float spacing = 0;
 
-        glyphToCharacterIndexes[i] = glyphInfos[i].cluster;
+        glyphToCharacterIndexes[i] = glyphs[i].cluster;
 
         if (isClusterEnd && !Font::treatAsZeroWidthSpace(m_normalizedBuffer[currentCharacterIndex]))
             spacing += m_letterSpacing;
@@ -33,6 +33,7 @@
 
 #include "FloatPoint.h"
 #include "GlyphBuffer.h"
+#include "HarfBuzzFace.h"
 #include "TextRun.h"
 #include "hb.h"
 #include <memory>
@@ -71,7 +72,7 @@ private:
             return adoptPtr(new HarfBuzzRun(fontData, startIndex, numCharacters, direction, script));
         }
 
-        void applyShapeResult(hb_buffer_t*);
+        void applyShapeResult(unsigned numGlyphs);
         void setGlyphAndPositions(unsigned index, uint16_t glyphId, float advance, float offsetX, float offsetY);
         void setWidth(float width) { m_width = width; }
 
@@ -123,7 +124,8 @@ private:
     bool shapeHarfBuzzRuns(bool shouldSetDirection);
     bool fillGlyphBuffer(GlyphBuffer*);
     void fillGlyphBufferFromHarfBuzzRun(GlyphBuffer*, HarfBuzzRun*, FloatPoint& firstOffsetOfNextRun);
-    void setGlyphPositionsForHarfBuzzRun(HarfBuzzRun*, hb_buffer_t*);
+    void shapeWord(hb_buffer_t*, HarfBuzzFace*, hb_font_t*, const UChar*, unsigned length, hb_script_t, hb_direction_t, bool shouldSetDirection, HarfBuzzShapedWord&);
+    void setGlyphPositionsForHarfBuzzRun(HarfBuzzRun*, const Vector<HarfBuzzShapedGlyph, 256>&);
 
     GlyphBufferAdvance createGlyphBufferAdvance(float, float);
 
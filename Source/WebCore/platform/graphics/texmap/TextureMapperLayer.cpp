@@ -254,11 +254,8 @@ static void resolveOverlaps(Region newRegion, Region& overlapRegion, Region& non
     nonOverlapRegion.unite(newRegion);
 }
 
-void TextureMapperLayer::computeOverlapRegions(Region& overlapRegion, Region& nonOverlapRegion, ResolveSelfOverlapMode mode)
+FloatRect TextureMapperLayer::localBoundingRect() const
 {
-    if (!m_state.visible || !m_state.contentsVisible)
-        return;
-
     FloatRect boundingRect;
     if (m_backingStore || m_state.masksToBounds || m_state.maskLayer || hasFilters())
         boundingRect = layerRect();
@@ -275,6 +272,16 @@ void TextureMapperLayer::computeOverlapRegions(Region& overlapRegion, Region& no
     }
 #endif
 
+    return boundingRect;
+}
+
+void TextureMapperLayer::computeOverlapRegions(Region& overlapRegion, Region& nonOverlapRegion, ResolveSelfOverlapMode mode)
+{
+    if (!m_state.visible || !m_state.contentsVisible)
+        return;
+
+    FloatRect boundingRect = localBoundingRect();
+
     TransformationMatrix replicaMatrix;
     if (m_state.replicaLayer) {
         replicaMatrix = replicaTransform();
@@ -450,6 +457,89 @@ void TextureMapperLayer::paintRecursive(const TextureMapperPaintOptions& options
     paintUsingOverlapRegions(paintOptions);
 }
 
+void TextureMapperLayer::addDamage(const FloatRect& rect)
+{
+    m_damagedRect.unite(rect);
+}
+
+void TextureMapperLayer::setNeedsDisplay()
+{
+    m_needsDisplay = true;
+}
+
+void TextureMapperLayer::setSubtreeNeedsDisplay()
+{
+    m_subtreeNeedsDisplay = true;
+}
+
+void TextureMapperLayer::collectDamage(Region& damage)
+{
+    computeTransformsRecursive();
+    collectDamageRecursive(damage, false);
+}
+
+void TextureMapperLayer::collectDamageRecursive(Region& damage, bool ancestorChanged)
+{
+    // A change to the mask or the replica changes how the whole subtree is drawn.
+    Region effectDamage;
+    if (m_state.maskLayer)
+        m_state.maskLayer->collectDamageRecursive(effectDamage, false);
+    if (m_state.replicaLayer)
+        m_state.replicaLayer->collectDamageRecursive(effectDamage, false);
+
+    FloatRect rect;
+    if (m_state.visible && m_state.contentsVisible) {
+        rect = localBoundingRect();
+        if (m_state.replicaLayer)
+            rect.unite(replicaTransform().mapRect(rect));
+        rect = m_currentTransform.combined().mapRect(rect);
+    }
+
+    bool subtreeChanged = ancestorChanged || m_subtreeNeedsDisplay || !effectDamage.isEmpty() || m_currentOpacity != m_previousOpacity;
+#if ENABLE(CSS_FILTERS)
+    subtreeChanged |= m_currentFilters != m_previousFilters;
+#endif
+    bool changed = subtreeChanged || m_needsDisplay || rect != m_previousRect || m_currentTransform.combined() != m_previousTransform;
+
+    Region subtreeDamage;
+    if (changed) {
+        subtreeDamage.unite(enclosingIntRect(m_previousRect));
+        subtreeDamage.unite(enclosingIntRect(rect));
+    } else if (!m_damagedRect.isEmpty())
+        subtreeDamage.unite(enclosingIntRect(m_currentTransform.combined().mapRect(intersection(m_damagedRect, layerRect()))));
+    subtreeDamage.unite(enclosingIntRect(m_removedChildrenRect));
+
+    m_previousRect = rect;
+    m_previousTransform = m_currentTransform.combined();
+    m_previousOpacity = m_currentOpacity;
+#if ENABLE(CSS_FILTERS)
+    m_previousFilters = m_currentFilters;
+#endif
+    m_damagedRect = FloatRect();
+    m_removedChildrenRect = FloatRect();
+    m_needsDisplay = false;
+    m_subtreeNeedsDisplay = false;
+
+    for (size_t i = 0; i < m_children.size(); ++i)
+        m_children[i]->collectDamageRecursive(subtreeDamage, subtreeChanged);
+
+    // The replica draws the subtree a second time, so whatever changed in it changed there too.
+    if (m_state.replicaLayer && !subtreeDamage.isEmpty())
+        subtreeDamage.unite(enclosingIntRect(replicaTransform().mapRect(FloatRect(subtreeDamage.bounds()))));
+
+    damage.unite(subtreeDamage);
+    damage.unite(effectDamage);
+}
+
+FloatRect TextureMapperLayer::previousSubtreeRect() const
+{
+    FloatRect rect = m_previousRect;
+    rect.unite(m_removedChildrenRect);
+    for (size_t i = 0; i < m_children.size(); ++i)
+        rect.unite(m_children[i]->previousSubtreeRect());
+    return rect;
+}
+
 TextureMapperLayer::~TextureMapperLayer()
 {
     for (int i = m_children.size() - 1; i >= 0; --i)
@@ -479,6 +569,7 @@ void TextureMapperLayer::addChild(TextureMapperLayer* childLayer)
 void TextureMapperLayer::removeFromParent()
 {
     if (m_parent) {
+        m_parent->m_removedChildrenRect.unite(previousSubtreeRect());
         size_t index = m_parent->m_children.find(this);
         ASSERT(index != notFound);
         m_parent->m_children.remove(index);
@@ -501,6 +592,7 @@ void TextureMapperLayer::setMaskLayer(TextureMapperLayer* maskLayer)
     if (maskLayer)
         maskLayer->m_effectTarget = this;
     m_state.maskLayer = maskLayer;
+    setSubtreeNeedsDisplay();
 }
 
 void TextureMapperLayer::setReplicaLayer(TextureMapperLayer* replicaLayer)
@@ -508,6 +600,7 @@ void TextureMapperLayer::setReplicaLayer(TextureMapperLayer* replicaLayer)
     if (replicaLayer)
         replicaLayer->m_effectTarget = this;
     m_state.replicaLayer = replicaLayer;
+    setSubtreeNeedsDisplay();
 }
 
 void TextureMapperLayer::setPosition(const FloatPoint& position)
@@ -532,6 +625,7 @@ void TextureMapperLayer::setPreserves3D(bool preserves3D)
 {
     m_state.preserves3D = preserves3D;
     m_currentTransform.setFlattening(!preserves3D);
+    setSubtreeNeedsDisplay();
 }
 
 void TextureMapperLayer::setTransform(const TransformationMatrix& transform)
@@ -552,6 +646,7 @@ void TextureMapperLayer::setContentsRect(const FloatRect& contentsRect)
         return;
     m_state.contentsRect = contentsRect;
     m_patternTransformDirty = true;
+    setNeedsDisplay();
 }
 
 void TextureMapperLayer::setContentsTileSize(const FloatSize& size)
@@ -560,6 +655,7 @@ void TextureMapperLayer::setContentsTileSize(const FloatSize& size)
         return;
     m_state.contentsTileSize = size;
     m_patternTransformDirty = true;
+    setNeedsDisplay();
 }
 
 void TextureMapperLayer::setContentsTilePhase(const FloatPoint& phase)
@@ -568,21 +664,25 @@ void TextureMapperLayer::setContentsTilePhase(const FloatPoint& phase)
         return;
     m_state.contentsTilePhase = phase;
     m_patternTransformDirty = true;
+    setNeedsDisplay();
 }
 
 void TextureMapperLayer::setMasksToBounds(bool masksToBounds)
 {
     m_state.masksToBounds = masksToBounds;
+    setSubtreeNeedsDisplay();
 }
 
 void TextureMapperLayer::setDrawsContent(bool drawsContent)
 {
     m_state.drawsContent = drawsContent;
+    setNeedsDisplay();
 }
 
 void TextureMapperLayer::setContentsVisible(bool contentsVisible)
 {
     m_state.contentsVisible = contentsVisible;
+    setNeedsDisplay();
 }
 
 void TextureMapperLayer::setContentsOpaque(bool contentsOpaque)
@@ -593,21 +693,28 @@ void TextureMapperLayer::setContentsOpaque(bool contentsOpaque)
 void TextureMapperLayer::setBackfaceVisibility(bool backfaceVisibility)
 {
     m_state.backfaceVisibility = backfaceVisibility;
+    setNeedsDisplay();
 }
 
 void TextureMapperLayer::setOpacity(float opacity)
 {
+    // The current opacity is only updated from the state when animations are synced for painting, after damage is collected.
+    if (m_state.opacity != opacity)
+        setSubtreeNeedsDisplay();
     m_state.opacity = opacity;
 }
 
 void TextureMapperLayer::setSolidColor(const Color& color)
 {
     m_state.solidColor = color;
+    setNeedsDisplay();
 }
 
 #if ENABLE(CSS_FILTERS)
 void TextureMapperLayer::setFilters(const FilterOperations& filters)
 {
+    if (m_state.filters != filters)
+        setSubtreeNeedsDisplay();
     m_state.filters = filters;
 }
 #endif
@@ -618,16 +725,19 @@ void TextureMapperLayer::setDebugVisuals(bool showDebugBorders, const Color& deb
     m_state.debugBorderColor = debugBorderColor;
     m_state.debugBorderWidth = debugBorderWidth;
     m_state.showRepaintCounter = showRepaintCounter;
+    setNeedsDisplay();
 }
 
 void TextureMapperLayer::setRepaintCount(int repaintCount)
 {
     m_state.repaintCount = repaintCount;
+    setNeedsDisplay();
 }
 
 void TextureMapperLayer::setContentsLayer(TextureMapperPlatformLayer* platformLayer)
 {
     m_contentsLayer = platformLayer;
+    setNeedsDisplay();
 }
 
 void TextureMapperLayer::setAnimations(const GraphicsLayerAnimations& animations)
@@ -643,6 +753,7 @@ void TextureMapperLayer::setFixedToViewport(bool fixedToViewport)
 void TextureMapperLayer::setBackingStore(PassRefPtr<TextureMapperBackingStore> backingStore)
 {
     m_backingStore = backingStore;
+    setNeedsDisplay();
 }
 
 bool TextureMapperLayer::descendantsOrSelfHaveRunningAnimations() const
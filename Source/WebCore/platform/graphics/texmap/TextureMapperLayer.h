@@ -57,6 +57,9 @@ public:
         , m_scrollClient(0)
         , m_isScrollable(false)
         , m_patternTransformDirty(false)
+        , m_needsDisplay(false)
+        , m_subtreeNeedsDisplay(false)
+        , m_previousOpacity(1)
     { }
 
     virtual ~TextureMapperLayer();
@@ -118,6 +121,7 @@ public:
     bool isShowingRepaintCounter() const { return m_state.showRepaintCounter; }
     void setRepaintCount(int);
     void setContentsLayer(TextureMapperPlatformLayer*);
+    TextureMapperPlatformLayer* contentsLayer() const { return m_contentsLayer; }
     void setAnimations(const GraphicsLayerAnimations&);
     void setFixedToViewport(bool);
     bool fixedToViewport() const { return m_fixedToViewport; }
@@ -133,6 +137,13 @@ public:
     void applyAnimationsRecursively();
     void addChild(TextureMapperLayer*);
 
+    // Damage tracking, which lets software compositing repaint only what changed.
+    // Damage is added in layer coordinates and collected in root layer coordinates;
+    // changes to geometry, opacity, filters and the layer tree are tracked as well.
+    void addDamage(const FloatRect&);
+    void setNeedsDisplay();
+    void collectDamage(Region&);
+
 private:
     const TextureMapperLayer& rootLayer() const
     {
@@ -159,6 +170,11 @@ private:
         ResolveSelfOverlapIfNeeded
     };
     void computeOverlapRegions(Region& overlapRegion, Region& nonOverlapRegion, ResolveSelfOverlapMode);
+    FloatRect localBoundingRect() const;
+
+    void collectDamageRecursive(Region&, bool ancestorChanged);
+    FloatRect previousSubtreeRect() const;
+    void setSubtreeNeedsDisplay();
 
     void paintRecursive(const TextureMapperPaintOptions&);
     void paintUsingOverlapRegions(const TextureMapperPaintOptions&);
@@ -270,6 +286,18 @@ private:
     FloatSize m_accumulatedScrollOffsetFractionalPart;
     TransformationMatrix m_patternTransform;
     bool m_patternTransformDirty;
+
+    // What the layer looked like when damage was last collected, in root layer coordinates.
+    bool m_needsDisplay;
+    bool m_subtreeNeedsDisplay;
+    FloatRect m_damagedRect;
+    FloatRect m_removedChildrenRect;
+    FloatRect m_previousRect;
+    TransformationMatrix m_previousTransform;
+    float m_previousOpacity;
+#if ENABLE(CSS_FILTERS)
+    FilterOperations m_previousFilters;
+#endif
 };
 
 }
@@ -23,6 +23,8 @@
 
 #include "AreaAllocator.h"
 
+#include <limits>
+
 namespace WebCore {
 
 AreaAllocator::AreaAllocator(const IntSize& size)
@@ -330,6 +332,127 @@ int GeneralAreaAllocator::overhead() const
     return m_nodeCount * sizeof(Node);
 }
 
+SkylineAreaAllocator::SkylineAreaAllocator(const IntSize& size)
+    : AreaAllocator(size)
+    , m_allocatedArea(0)
+{
+    clear();
+}
+
+SkylineAreaAllocator::~SkylineAreaAllocator()
+{
+}
+
+void SkylineAreaAllocator::clear()
+{
+    Segment segment = { 0, 0, m_size.width() };
+    m_skyline.shrink(0);
+    m_skyline.append(segment);
+    m_allocatedArea = 0;
+}
+
+void SkylineAreaAllocator::expand(const IntSize& size)
+{
+    int oldWidth = m_size.width();
+    AreaAllocator::expand(size);
+    if (m_size.width() == oldWidth)
+        return;
+
+    if (!m_skyline.last().y) {
+        m_skyline.last().width += m_size.width() - oldWidth;
+        return;
+    }
+
+    Segment segment = { oldWidth, 0, m_size.width() - oldWidth };
+    m_skyline.append(segment);
+}
+
+bool SkylineAreaAllocator::findPosition(size_t index, const IntSize& size, int& y) const
+{
+    if (m_skyline[index].x + size.width() > m_size.width())
+        return false;
+
+    // The rect rests on the highest of the segments it spans.
+    y = 0;
+    int widthLeft = size.width();
+    for (size_t i = index; widthLeft > 0; ++i) {
+        y = std::max(y, m_skyline[i].y);
+        if (y + size.height() > m_size.height())
+            return false;
+        widthLeft -= m_skyline[i].width;
+    }
+    return true;
+}
+
+void SkylineAreaAllocator::addSegment(size_t index, const IntRect& rect)
+{
+    Segment segment = { rect.x(), rect.maxY(), rect.width() };
+    m_skyline.insert(index, segment);
+
+    // Shrink or remove the segments that are now below the new one.
+    for (size_t i = index + 1; i < m_skyline.size();) {
+        Segment& next = m_skyline[i];
+        int overlap = rect.maxX() - next.x;
+        if (overlap <= 0)
+            break;
+        if (overlap < next.width) {
+            next.x += overlap;
+            next.width -= overlap;
+            break;
+        }
+        m_skyline.remove(i);
+    }
+
+    // Merge neighbouring segments at the same height.
+    for (size_t i = 0; i + 1 < m_skyline.size();) {
+        if (m_skyline[i].y == m_skyline[i + 1].y) {
+            m_skyline[i].width += m_skyline[i + 1].width;
+            m_skyline.remove(i + 1);
+        } else
+            ++i;
+    }
+}
+
+IntRect SkylineAreaAllocator::allocate(const IntSize& size)
+{
+    IntSize rounded = roundAllocation(size);
+    if (rounded.width() <= 0 || rounded.width() > m_size.width()
+        || rounded.height() <= 0 || rounded.height() > m_size.height())
+        return IntRect();
+
+    // Choose the position that keeps the skyline lowest, and of those the narrowest segment,
+    // which leaves the widest gaps free for later allocations.
+    size_t bestIndex = notFound;
+    int bestY = 0;
+    int bestTop = std::numeric_limits<int>::max();
+    int bestWidth = std::numeric_limits<int>::max();
+    for (size_t i = 0; i < m_skyline.size(); ++i) {
+        int y;
+        if (!findPosition(i, rounded, y))
+            continue;
+        int top = y + rounded.height();
+        if (top < bestTop || (top == bestTop && m_skyline[i].width < bestWidth)) {
+            bestIndex = i;
+            bestY = y;
+            bestTop = top;
+            bestWidth = m_skyline[i].width;
+        }
+    }
+
+    if (bestIndex == notFound)
+        return IntRect();
+
+    IntRect rect(m_skyline[bestIndex].x, bestY, rounded.width(), rounded.height());
+    addSegment(bestIndex, rect);
+    m_allocatedArea += rounded.width() * rounded.height();
+    return IntRect(rect.location(), size);
+}
+
+int SkylineAreaAllocator::overhead() const
+{
+    return m_skyline.capacity() * sizeof(Segment);
+}
+
 } // namespace WebCore
 
 #endif // USE(COORDINATED_GRAPHICS)
@@ -23,6 +23,7 @@
 #include "IntPoint.h"
 #include "IntRect.h"
 #include "IntSize.h"
+#include <wtf/Vector.h>
 
 #if USE(COORDINATED_GRAPHICS)
 
@@ -107,6 +108,38 @@ private:
     static void updateLargestFree(Node*);
 };
 
+// Packs allocations bottom-left against a skyline, the top edge of everything allocated so far,
+// kept as a list of horizontal segments. Unlike GeneralAreaAllocator it does not round sizes up
+// to powers of two, so many more update rects fit in the same area. Single rects cannot be
+// released; clear() frees all allocations at once.
+class SkylineAreaAllocator : public AreaAllocator {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    explicit SkylineAreaAllocator(const IntSize&);
+    virtual ~SkylineAreaAllocator();
+
+    void expand(const IntSize&);
+    IntRect allocate(const IntSize&);
+    int overhead() const;
+
+    void clear();
+    bool isEmpty() const { return !m_allocatedArea; }
+    int allocatedArea() const { return m_allocatedArea; }
+
+private:
+    struct Segment {
+        int x;
+        int y;
+        int width;
+    };
+
+    bool findPosition(size_t index, const IntSize&, int& y) const;
+    void addSegment(size_t index, const IntRect&);
+
+    Vector<Segment> m_skyline;
+    int m_allocatedArea;
+};
+
 } // namespace WebCore
 
 #endif // USE(COORDINATED_GRAPHICS)
@@ -33,10 +33,12 @@
 #include "FrameView.h"
 #include "GraphicsContext.h"
 #include "InspectorController.h"
+#include "Logging.h"
 #include "MainFrame.h"
 #include "Page.h"
 #include "Settings.h"
 #include <wtf/CurrentTime.h>
+#include <wtf/MathExtras.h>
 #include <wtf/TemporaryChange.h>
 
 // FIXME: Having this in the platform directory is a layering violation. This does not belong here.
@@ -55,6 +57,12 @@ CompositingCoordinator::CompositingCoordinator(Page* page, CompositingCoordinato
     : m_page(page)
     , m_client(client)
     , m_rootCompositingLayer(0)
+    , m_updateAreaInFrame(0)
+    , m_averageUpdateAreaPerFrame(0)
+#if !LOG_DISABLED
+    , m_lastUpdateAtlasStatisticsTime(0)
+    , m_lastUpdateAtlasStatistics(UpdateAtlas::statistics())
+#endif
     , m_isPurging(false)
     , m_isFlushingLayerChanges(false)
     , m_shouldSyncFrame(false)
@@ -358,6 +366,19 @@ void CompositingCoordinator::renderNextFrame()
 {
     for (unsigned i = 0; i < m_updateAtlases.size(); ++i)
         m_updateAtlases[i]->didSwapBuffers();
+
+    // Frames without updates say nothing about how large the atlases should be.
+    if (m_updateAreaInFrame) {
+        if (m_averageUpdateAreaPerFrame)
+            m_averageUpdateAreaPerFrame = m_averageUpdateAreaPerFrame * 0.75 + m_updateAreaInFrame * 0.25;
+        else
+            m_averageUpdateAreaPerFrame = m_updateAreaInFrame;
+        m_updateAreaInFrame = 0;
+    }
+
+#if !LOG_DISABLED
+    logUpdateAtlasStatisticsIfNeeded();
+#endif
 }
 
 void CompositingCoordinator::purgeBackingStores()
@@ -373,6 +394,8 @@ void CompositingCoordinator::purgeBackingStores()
 
 bool CompositingCoordinator::paintToSurface(const IntSize& size, CoordinatedSurface::Flags flags, uint32_t& atlasID, IntPoint& offset, CoordinatedSurface::Client* client)
 {
+    m_updateAreaInFrame += size.width() * size.height();
+
     for (unsigned i = 0; i < m_updateAtlases.size(); ++i) {
         UpdateAtlas* atlas = m_updateAtlases[i].get();
         if (atlas->supportsAlpha() == (flags & CoordinatedSurface::SupportsAlpha)) {
@@ -382,12 +405,55 @@ bool CompositingCoordinator::paintToSurface(const IntSize& size, CoordinatedSurf
         }
     }
 
-    static const int ScratchBufferDimension = 1024; // Should be a power of two.
-    m_updateAtlases.append(std::make_unique<UpdateAtlas>(this, ScratchBufferDimension, flags));
+    m_updateAtlases.append(std::make_unique<UpdateAtlas>(this, updateAtlasDimension(size), flags));
     scheduleReleaseInactiveAtlases();
     return m_updateAtlases.last()->paintOnAvailableBuffer(size, atlasID, offset, client);
 }
 
+int CompositingCoordinator::updateAtlasDimension(const IntSize& size) const
+{
+    static const int DefaultUpdateAtlasDimension = 1024; // Should be a power of two.
+    static const int MinimumUpdateAtlasDimension = 512;
+    static const int MaximumUpdateAtlasDimension = 2048;
+
+    // Size new atlases so that the updates of a typical recent frame fit in one, with some room for
+    // packing losses. Fewer, larger atlases mean fewer surfaces are created and discarded while scrolling.
+    int dimension = DefaultUpdateAtlasDimension;
+    if (m_averageUpdateAreaPerFrame) {
+        int side = static_cast<int>(std::ceil(std::sqrt(m_averageUpdateAreaPerFrame * 1.25)));
+        dimension = std::max(MinimumUpdateAtlasDimension, std::min(MaximumUpdateAtlasDimension, nextPowerOfTwo(side)));
+    }
+
+    // An update larger than that gets an atlas it fits in.
+    return std::max(dimension, nextPowerOfTwo(std::max(size.width(), size.height())));
+}
+
+#if !LOG_DISABLED
+void CompositingCoordinator::logUpdateAtlasStatisticsIfNeeded()
+{
+    double now = monotonicallyIncreasingTime();
+    if (!m_lastUpdateAtlasStatisticsTime) {
+        m_lastUpdateAtlasStatisticsTime = now;
+        return;
+    }
+
+    double elapsed = now - m_lastUpdateAtlasStatisticsTime;
+    if (elapsed < 1)
+        return;
+
+    const UpdateAtlas::Statistics& statistics = UpdateAtlas::statistics();
+    LOG(Compositing, "UpdateAtlas: %.1f allocations/s, %.1f failed allocations/s, %.1f atlas creations/s, %.1f atlas reuses/s, %zu atlases, average update area %.0f pixels per frame",
+        (statistics.allocationCount - m_lastUpdateAtlasStatistics.allocationCount) / elapsed,
+        (statistics.failedAllocationCount - m_lastUpdateAtlasStatistics.failedAllocationCount) / elapsed,
+        (statistics.atlasCreationCount - m_lastUpdateAtlasStatistics.atlasCreationCount) / elapsed,
+        (statistics.atlasReuseCount - m_lastUpdateAtlasStatistics.atlasReuseCount) / elapsed,
+        m_updateAtlases.size(), m_averageUpdateAreaPerFrame);
+
+    m_lastUpdateAtlasStatisticsTime = now;
+    m_lastUpdateAtlasStatistics = statistics;
+}
+#endif
+
 const double ReleaseInactiveAtlasesTimerInterval = 0.5;
 
 void CompositingCoordinator::scheduleReleaseInactiveAtlases()
@@ -121,6 +121,10 @@ private:
     void clearPendingStateChanges();
 
     void scheduleReleaseInactiveAtlases();
+    int updateAtlasDimension(const IntSize&) const;
+#if !LOG_DISABLED
+    void logUpdateAtlasStatisticsIfNeeded();
+#endif
 
     void releaseInactiveAtlasesTimerFired(Timer<CompositingCoordinator>*);
 
@@ -137,6 +141,13 @@ private:
     typedef HashMap<CoordinatedImageBackingID, RefPtr<CoordinatedImageBacking> > ImageBackingMap;
     ImageBackingMap m_imageBackings;
     Vector<std::unique_ptr<UpdateAtlas>> m_updateAtlases;
+    // Pixels painted into update atlases, in the current frame and on average over recent frames.
+    uint64_t m_updateAreaInFrame;
+    double m_averageUpdateAreaPerFrame;
+#if !LOG_DISABLED
+    double m_lastUpdateAtlasStatisticsTime;
+    UpdateAtlas::Statistics m_lastUpdateAtlasStatistics;
+#endif
 
     // We don't send the messages related to releasing resources to renderer during purging, because renderer already had removed all resources.
     bool m_isPurging;
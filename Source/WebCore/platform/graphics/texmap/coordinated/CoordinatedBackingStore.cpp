@@ -89,6 +89,24 @@ void CoordinatedBackingStore::updateTile(uint32_t id, const IntRect& sourceRect,
     it->value.setBackBuffer(tileRect, sourceRect, backBuffer, offset);
 }
 
+FloatRect CoordinatedBackingStore::updatedRectForTile(uint32_t id, const IntRect& sourceRect, const IntRect& tileRect) const
+{
+    CoordinatedBackingStoreTileMap::const_iterator it = m_tiles.find(id);
+    ASSERT(it != m_tiles.end());
+    FloatRect rect(sourceRect);
+    rect.move(tileRect.x(), tileRect.y());
+    rect.scale(1. / it->value.scale());
+    return rect;
+}
+
+FloatRect CoordinatedBackingStore::rectForTile(uint32_t id) const
+{
+    CoordinatedBackingStoreTileMap::const_iterator it = m_tiles.find(id);
+    if (it == m_tiles.end())
+        return FloatRect();
+    return it->value.rect();
+}
+
 PassRefPtr<BitmapTexture> CoordinatedBackingStore::texture() const
 {
     CoordinatedBackingStoreTileMap::const_iterator end = m_tiles.end();
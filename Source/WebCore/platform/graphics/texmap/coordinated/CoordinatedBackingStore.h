@@ -58,6 +58,9 @@ public:
     void removeTile(uint32_t tileID);
     void removeAllTiles();
     void updateTile(uint32_t tileID, const IntRect&, const IntRect&, PassRefPtr<CoordinatedSurface>, const IntPoint&);
+    // These return the area of the layer that a tile operation changes, in layer coordinates.
+    FloatRect updatedRectForTile(uint32_t tileID, const IntRect& sourceRect, const IntRect& tileRect) const;
+    FloatRect rectForTile(uint32_t tileID) const;
     static PassRefPtr<CoordinatedBackingStore> create() { return adoptRef(new CoordinatedBackingStore); }
     void commitTileOperations(TextureMapper*);
     PassRefPtr<BitmapTexture> texture() const;
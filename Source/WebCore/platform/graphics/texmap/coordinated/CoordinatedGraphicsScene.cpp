@@ -25,6 +25,7 @@
 #include "CoordinatedGraphicsScene.h"
 
 #include "CoordinatedBackingStore.h"
+#include "Region.h"
 #include "TextureMapper.h"
 #include "TextureMapperBackingStore.h"
 #include "TextureMapperGL.h"
@@ -54,6 +55,8 @@ CoordinatedGraphicsScene::CoordinatedGraphicsScene(CoordinatedGraphicsSceneClien
     , m_backgroundColor(Color::white)
     , m_viewBackgroundColor(Color::white)
     , m_setDrawsBackground(false)
+    , m_hasPaintedToGraphicsContext(false)
+    , m_needsFullRepaint(true)
 {
     ASSERT(isMainThread());
 }
@@ -123,6 +126,20 @@ void CoordinatedGraphicsScene::paintToGraphicsContext(PlatformGraphicsContext* p
         return;
 
     GraphicsContext graphicsContext(platformContext);
+    AffineTransform paintTransform = graphicsContext.getCTM();
+    if (!m_hasPaintedToGraphicsContext || paintTransform != m_lastPaintTransform) {
+        // The view scrolled or zoomed, so this paint may have been clipped to stale damage.
+        if (m_hasPaintedToGraphicsContext) {
+            RefPtr<CoordinatedGraphicsScene> protector(this);
+            dispatchOnMainThread([=] {
+                protector->updateViewport();
+            });
+        }
+        m_lastPaintTransform = paintTransform;
+        m_hasPaintedToGraphicsContext = true;
+        m_needsFullRepaint = true;
+    }
+
     m_textureMapper->setGraphicsContext(&graphicsContext);
     m_textureMapper->beginPainting();
 
@@ -138,6 +155,30 @@ void CoordinatedGraphicsScene::paintToGraphicsContext(PlatformGraphicsContext* p
     m_textureMapper->setGraphicsContext(0);
 }
 
+bool CoordinatedGraphicsScene::collectDamagedRects(Vector<IntRect>& rects)
+{
+    if (!m_textureMapper || m_textureMapper->accelerationMode() != TextureMapper::SoftwareMode || !m_hasPaintedToGraphicsContext)
+        return false;
+
+    syncRemoteContent();
+    TextureMapperLayer* layer = rootLayer();
+    if (!layer)
+        return false;
+
+    // Running animations are only applied while painting, so their damage can not be known here.
+    Region damage;
+    layer->collectDamage(damage);
+    if (m_needsFullRepaint || layer->descendantsOrSelfHaveRunningAnimations()) {
+        m_needsFullRepaint = false;
+        return false;
+    }
+
+    Vector<IntRect> damagedRects = damage.rects();
+    for (size_t i = 0; i < damagedRects.size(); ++i)
+        rects.append(m_lastPaintTransform.mapRect(damagedRects[i]));
+    return true;
+}
+
 void CoordinatedGraphicsScene::setScrollPosition(const FloatPoint& scrollPosition)
 {
     m_scrollPosition = scrollPosition;
@@ -190,6 +231,7 @@ void CoordinatedGraphicsScene::syncPlatformLayerIfNeeded(TextureMapperLayer* lay
         SurfaceBackingStoreMap::iterator it = m_surfaceBackingStores.find(layer);
         RefPtr<TextureMapperSurfaceBackingStore> platformLayerBackingStore = it->value;
         platformLayerBackingStore->swapBuffersIfNeeded(state.platformLayerFrontBuffer);
+        layer->setNeedsDisplay();
     }
 }
 
@@ -432,8 +474,10 @@ void CoordinatedGraphicsScene::removeTilesIfNeeded(TextureMapperLayer* layer, co
     if (!backingStore)
         return;
 
-    for (size_t i = 0; i < state.tilesToRemove.size(); ++i)
+    for (size_t i = 0; i < state.tilesToRemove.size(); ++i) {
+        layer->addDamage(backingStore->rectForTile(state.tilesToRemove[i]));
         backingStore->removeTile(state.tilesToRemove[i]);
+    }
 
     m_backingStoresWithPendingBuffers.add(backingStore);
 }
@@ -454,6 +498,7 @@ void CoordinatedGraphicsScene::updateTilesIfNeeded(TextureMapperLayer* layer, co
         ASSERT(surfaceIt != m_surfaces.end());
 
         backingStore->updateTile(tileInfo.tileID, surfaceUpdateInfo.updateRect, tileInfo.tileRect, surfaceIt->value, surfaceUpdateInfo.surfaceOffset);
+        layer->addDamage(backingStore->updatedRectForTile(tileInfo.tileID, surfaceUpdateInfo.updateRect, tileInfo.tileRect));
         m_backingStoresWithPendingBuffers.add(backingStore);
     }
 }
@@ -516,6 +561,11 @@ void CoordinatedGraphicsScene::updateImageBacking(CoordinatedImageBackingID imag
     backingStore->updateTile(1 /* id */, rect, rect, surface, rect.location());
 
     m_backingStoresWithPendingBuffers.add(backingStore);
+
+    for (auto& layer : m_layers.values()) {
+        if (layer->contentsLayer() == backingStore.get())
+            layer->setNeedsDisplay();
+    }
 }
 
 void CoordinatedGraphicsScene::clearImageBackingContents(CoordinatedImageBackingID imageID)
@@ -721,6 +771,7 @@ void CoordinatedGraphicsScene::setActive(bool active)
 void CoordinatedGraphicsScene::setBackgroundColor(const Color& color)
 {
     m_backgroundColor = color;
+    m_needsFullRepaint = true;
 }
 
 TextureMapperLayer* CoordinatedGraphicsScene::findScrollableContentsLayerAt(const FloatPoint& point)
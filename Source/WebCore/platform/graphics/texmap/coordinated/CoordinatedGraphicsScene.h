@@ -22,6 +22,7 @@
 #define CoordinatedGraphicsScene_h
 
 #if USE(COORDINATED_GRAPHICS)
+#include "AffineTransform.h"
 #include "CoordinatedGraphicsState.h"
 #include "CoordinatedSurface.h"
 #include "GraphicsContext.h"
@@ -63,6 +64,8 @@ public:
     virtual ~CoordinatedGraphicsScene();
     void paintToCurrentGLContext(const TransformationMatrix&, float, const FloatRect&, TextureMapper::PaintFlags = 0);
     void paintToGraphicsContext(PlatformGraphicsContext*);
+    // Returns false when the whole view has to be repainted, or when the scene is not painted in software.
+    bool collectDamagedRects(Vector<IntRect>&);
     void setScrollPosition(const FloatPoint&);
     void detach();
     void appendUpdate(std::function<void()>);
@@ -81,9 +84,17 @@ public:
     void commitSceneState(const CoordinatedGraphicsState&);
 
     void setBackgroundColor(const Color&);
-    void setDrawsBackground(bool enable) { m_setDrawsBackground = enable; }
+    void setDrawsBackground(bool enable)
+    {
+        m_setDrawsBackground = enable;
+        m_needsFullRepaint = true;
+    }
 
-    void setViewBackgroundColor(const Color& color) { m_viewBackgroundColor = color; }
+    void setViewBackgroundColor(const Color& color)
+    {
+        m_viewBackgroundColor = color;
+        m_needsFullRepaint = true;
+    }
     Color viewBackgroundColor() const { return m_viewBackgroundColor; }
 
 private:
@@ -188,6 +199,11 @@ private:
     Color m_viewBackgroundColor;
     bool m_setDrawsBackground;
 
+    // Damage is reported in the device coordinates of the last software paint.
+    AffineTransform m_lastPaintTransform;
+    bool m_hasPaintedToGraphicsContext;
+    bool m_needsFullRepaint;
+
     TextureMapperFPSCounter m_fpsCounter;
 };
 
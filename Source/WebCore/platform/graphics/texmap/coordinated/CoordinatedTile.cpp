@@ -101,7 +101,7 @@ void CoordinatedTile::paintToSurfaceContext(GraphicsContext* context)
 {
     context->translate(-m_dirtyRect.x(), -m_dirtyRect.y());
     context->scale(FloatSize(m_tiledBackingStore->contentsScale(), m_tiledBackingStore->contentsScale()));
-    m_tiledBackingStore->client()->tiledBackingStorePaint(context, m_tiledBackingStore->mapToContents(m_dirtyRect));
+    m_tiledBackingStore->paintTileContents(context, m_tiledBackingStore->mapToContents(m_dirtyRect));
 }
 
 void CoordinatedTile::swapBackBufferToFront()
@@ -46,6 +46,7 @@ public:
     ~CoordinatedTile();
 
     bool isDirty() const;
+    IntRect dirtyRect() const { return m_dirtyRect; }
     void invalidate(const IntRect&);
     Vector<IntRect> updateBackBuffer();
     void swapBackBufferToFront();
@@ -56,6 +56,17 @@ private:
     bool m_supportsAlpha;
 };
 
+static UpdateAtlas::Statistics& mutableStatistics()
+{
+    static UpdateAtlas::Statistics statistics;
+    return statistics;
+}
+
+const UpdateAtlas::Statistics& UpdateAtlas::statistics()
+{
+    return mutableStatistics();
+}
+
 UpdateAtlas::UpdateAtlas(Client* client, int dimension, CoordinatedSurface::Flags flags)
     : m_client(client)
     , m_inactivityInSeconds(0)
@@ -64,6 +75,8 @@ UpdateAtlas::UpdateAtlas(Client* client, int dimension, CoordinatedSurface::Flag
     m_ID = ++nextID;
     IntSize size = nextPowerOfTwo(IntSize(dimension, dimension));
     m_surface = CoordinatedSurface::create(size, flags);
+    m_areaAllocator = std::make_unique<SkylineAreaAllocator>(size);
+    ++mutableStatistics().atlasCreationCount;
 
     m_client->createUpdateAtlas(m_ID, m_surface);
 }
@@ -74,29 +87,28 @@ UpdateAtlas::~UpdateAtlas()
         m_client->removeUpdateAtlas(m_ID);
 }
 
-void UpdateAtlas::buildLayoutIfNeeded()
-{
-    if (!m_areaAllocator) {
-        m_areaAllocator = std::make_unique<GeneralAreaAllocator>(size());
-        m_areaAllocator->setMinimumAllocation(IntSize(32, 32));
-    }
-}
-
 void UpdateAtlas::didSwapBuffers()
 {
-    m_areaAllocator = nullptr;
+    // Nothing painted before the swap is needed anymore, so the whole atlas is free again. Clearing
+    // the skyline here also compacts it, since no allocation outlives a frame.
+    if (isInUse())
+        ++mutableStatistics().atlasReuseCount;
+    m_areaAllocator->clear();
 }
 
-
 bool UpdateAtlas::paintOnAvailableBuffer(const IntSize& size, uint32_t& atlasID, IntPoint& offset, CoordinatedSurface::Client* client)
 {
     m_inactivityInSeconds = 0;
-    buildLayoutIfNeeded();
     IntRect rect = m_areaAllocator->allocate(size);
 
     // No available buffer was found.
-    if (rect.isEmpty())
+    if (rect.isEmpty()) {
+        ++mutableStatistics().failedAllocationCount;
         return false;
+    }
+
+    ++mutableStatistics().allocationCount;
+    mutableStatistics().allocatedArea += size.width() * size.height();
 
     if (!m_surface)
         return false;
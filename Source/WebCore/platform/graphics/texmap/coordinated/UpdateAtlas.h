@@ -42,6 +42,17 @@ public:
         virtual void removeUpdateAtlas(uint32_t /* id */) = 0;
     };
 
+    // Counted over all atlases in the process. An atlas is reused when it was painted into during
+    // a frame and is kept for the next one rather than being discarded.
+    struct Statistics {
+        uint64_t allocationCount;
+        uint64_t failedAllocationCount;
+        uint64_t allocatedArea;
+        uint64_t atlasCreationCount;
+        uint64_t atlasReuseCount;
+    };
+    static const Statistics& statistics();
+
     UpdateAtlas(Client*, int dimension, CoordinatedSurface::Flags);
     ~UpdateAtlas();
 
@@ -62,14 +73,11 @@ public:
         const double inactiveSecondsTolerance = 3;
         return m_inactivityInSeconds > inactiveSecondsTolerance;
     }
-    bool isInUse() const { return !!m_areaAllocator; }
-
-private:
-    void buildLayoutIfNeeded();
+    bool isInUse() const { return !m_areaAllocator->isEmpty(); }
 
 private:
     Client* m_client;
-    std::unique_ptr<GeneralAreaAllocator> m_areaAllocator;
+    std::unique_ptr<SkylineAreaAllocator> m_areaAllocator;
     RefPtr<CoordinatedSurface> m_surface;
     double m_inactivityInSeconds;
     uint32_t m_ID;
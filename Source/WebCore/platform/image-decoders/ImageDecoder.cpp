@@ -153,6 +153,7 @@ void ImageFrame::clearPixelData()
 {
     m_backingStore.clear();
     m_bytes = 0;
+    m_size = IntSize();
     m_status = FrameEmpty;
     // NOTE: Do not reset other members here; clearFrameBufferCache() calls this
     // to free the bitmap data, but other functions like initFrameBuffer() and
@@ -284,7 +285,7 @@ unsigned ImageDecoder::frameBytesAtIndex(size_t index) const
     if (m_frameBufferCache.size() <= index)
         return 0;
     // FIXME: Use the dimension of the requested frame.
-    return m_size.area() * sizeof(ImageFrame::PixelData);
+    return scaledSize().area() * sizeof(ImageFrame::PixelData);
 }
 
 void ImageDecoder::prepareScaleDataIfNecessary()
@@ -293,8 +294,8 @@ void ImageDecoder::prepareScaleDataIfNecessary()
     m_scaledColumns.clear();
     m_scaledRows.clear();
 
-    int width = size().width();
-    int height = size().height();
+    int width = subsampledSize().width();
+    int height = subsampledSize().height();
     int numPixels = height * width;
     if (m_maxNumPixels <= 0 || numPixels <= m_maxNumPixels)
         return;
@@ -330,4 +331,71 @@ int ImageDecoder::scaledY(int origY, int searchStart)
     return getScaledValue<Exact>(m_scaledRows, origY, searchStart);
 }
 
+void AreaAveragingDownsampler::initialize(int sourceWidth, int sourceHeight, SubsamplingLevel level)
+{
+    m_level = level;
+    m_sourceWidth = sourceWidth;
+    m_sourceHeight = sourceHeight;
+    m_sums.resize(ImageDecoder::subsampledLength(sourceWidth, level) * 4);
+    m_sums.fill(0);
+}
+
+int AreaAveragingDownsampler::addRow(ImageFrame& frame, int sourceY, const unsigned char* samples, unsigned channels, unsigned char& nonTrivialAlphaMask)
+{
+    ASSERT(channels == 3 || channels == 4);
+    for (int x = 0; x < m_sourceWidth; ++x, samples += channels)
+        accumulate(m_sums.data() + (x >> m_level) * 4, samples[0], samples[1], samples[2], channels == 4 ? samples[3] : 255);
+
+    return writeRowIfComplete(frame, sourceY, nonTrivialAlphaMask);
+}
+
+int AreaAveragingDownsampler::addRow(ImageFrame& frame, int sourceY, const ImageFrame::PixelData* pixels, bool premultiplied, unsigned char& nonTrivialAlphaMask)
+{
+    for (int x = 0; x < m_sourceWidth; ++x) {
+        ImageFrame::PixelData pixel = pixels[x];
+        unsigned a = pixel >> 24;
+        unsigned r = (pixel >> 16) & 0xFF;
+        unsigned g = (pixel >> 8) & 0xFF;
+        unsigned b = pixel & 0xFF;
+        unsigned* sums = m_sums.data() + (x >> m_level) * 4;
+        if (premultiplied) {
+            // The color is already weighted by alpha, in units of 1/255.
+            sums[0] += r * 255;
+            sums[1] += g * 255;
+            sums[2] += b * 255;
+            sums[3] += a;
+        } else
+            accumulate(sums, r, g, b, a);
+    }
+
+    return writeRowIfComplete(frame, sourceY, nonTrivialAlphaMask);
+}
+
+int AreaAveragingDownsampler::writeRowIfComplete(ImageFrame& frame, int sourceY, unsigned char& nonTrivialAlphaMask)
+{
+    const int blockSize = 1 << m_level;
+    if ((sourceY + 1) % blockSize && sourceY + 1 < m_sourceHeight)
+        return -1;
+
+    // The last row and column of blocks may be cut short by the image edges.
+    int destinationY = sourceY >> m_level;
+    unsigned blockHeight = sourceY - (destinationY << m_level) + 1;
+    int destinationWidth = m_sums.size() / 4;
+    ImageFrame::PixelData* address = frame.getAddr(0, destinationY);
+    unsigned* sums = m_sums.data();
+    for (int x = 0; x < destinationWidth; ++x, sums += 4) {
+        unsigned blockWidth = std::min(blockSize, m_sourceWidth - (x << m_level));
+        unsigned pixelCount = blockWidth * blockHeight;
+        unsigned alphaSum = sums[3];
+        unsigned a = (alphaSum + pixelCount / 2) / pixelCount;
+        if (alphaSum)
+            frame.setRGBA(address++, (sums[0] + alphaSum / 2) / alphaSum, (sums[1] + alphaSum / 2) / alphaSum, (sums[2] + alphaSum / 2) / alphaSum, a);
+        else
+            frame.setRGBA(address++, 0, 0, 0, 0);
+        nonTrivialAlphaMask |= (255 - a);
+        sums[0] = sums[1] = sums[2] = sums[3] = 0;
+    }
+    return destinationY;
+}
+
 }
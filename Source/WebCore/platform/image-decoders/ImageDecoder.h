@@ -109,6 +109,11 @@ namespace WebCore {
         // FrameData::clear()).
         PassNativeImagePtr asNewNativeImage() const;
 
+        // Like asNewNativeImage(), but the native image owns a copy of the
+        // pixels, so it stays valid after this frame or its decoder is gone.
+        // Used to hand frames decoded on another thread to BitmapImage.
+        PassNativeImagePtr asNewNativeImageCopy() const;
+
         bool hasAlpha() const;
         const IntRect& originalFrameRect() const { return m_originalFrameRect; }
         FrameStatus status() const { return m_status; }
@@ -192,6 +197,48 @@ namespace WebCore {
         bool m_premultiplyAlpha;
     };
 
+    // Shrinks an image by 2^level on each axis by averaging each block of
+    // source pixels, for decoders whose libraries cannot scale while decoding.
+    // Source rows are added in order; once the last row of a block has been
+    // added, the averaged row is written to the frame.
+    class AreaAveragingDownsampler {
+        WTF_MAKE_NONCOPYABLE(AreaAveragingDownsampler);
+    public:
+        AreaAveragingDownsampler()
+            : m_level(0)
+            , m_sourceWidth(0)
+            , m_sourceHeight(0)
+        {
+        }
+
+        void initialize(int sourceWidth, int sourceHeight, SubsamplingLevel);
+
+        // Adds row |sourceY| of unpremultiplied RGB or RGBA samples. Returns
+        // the frame row that was completed by it, or -1.
+        int addRow(ImageFrame&, int sourceY, const unsigned char* samples, unsigned channels, unsigned char& nonTrivialAlphaMask);
+
+        // Same, for a row of pixels as stored in an ImageFrame.
+        int addRow(ImageFrame&, int sourceY, const ImageFrame::PixelData*, bool premultiplied, unsigned char& nonTrivialAlphaMask);
+
+    private:
+        void accumulate(unsigned* sums, unsigned r, unsigned g, unsigned b, unsigned a)
+        {
+            // The color is weighted by alpha so that transparent pixels do not
+            // bleed their color into the average.
+            sums[0] += r * a;
+            sums[1] += g * a;
+            sums[2] += b * a;
+            sums[3] += a;
+        }
+
+        int writeRowIfComplete(ImageFrame&, int sourceY, unsigned char& nonTrivialAlphaMask);
+
+        SubsamplingLevel m_level;
+        int m_sourceWidth;
+        int m_sourceHeight;
+        Vector<unsigned> m_sums; // Four per frame column.
+    };
+
     // ImageDecoder is a base for all format-specific decoders
     // (e.g. JPEGImageDecoder).  This base manages the ImageFrame cache.
     //
@@ -203,6 +250,7 @@ namespace WebCore {
     public:
         ImageDecoder(ImageSource::AlphaOption alphaOption, ImageSource::GammaAndColorProfileOption gammaAndColorProfileOption)
             : m_scaled(false)
+            , m_subsamplingLevel(0)
             , m_premultiplyAlpha(alphaOption == ImageSource::AlphaPremultiplied)
             , m_ignoreGammaAndColorProfile(gammaAndColorProfileOption == ImageSource::GammaAndColorProfileIgnored)
             , m_sizeAvailable(false)
@@ -229,6 +277,8 @@ namespace WebCore {
             m_isAllDataReceived = allDataReceived;
         }
 
+        SharedBuffer* data() const { return m_data.get(); }
+
         // Lazily-decodes enough of the image to get the size (if possible).
         // FIXME: Right now that has to be done by each subclass; factor the
         // decode call out and use it here.
@@ -241,7 +291,27 @@ namespace WebCore {
 
         IntSize scaledSize() const
         {
-            return m_scaled ? IntSize(m_scaledColumns.size(), m_scaledRows.size()) : size();
+            return m_scaled ? IntSize(m_scaledColumns.size(), m_scaledRows.size()) : subsampledSize();
+        }
+
+        // Subsampling decodes frames at 1/2, 1/4 or 1/8 of their size on each
+        // axis (see SubsamplingLevel in ImageSource.h), for images that are
+        // drawn much smaller than they are. The level must be set before any
+        // frame is decoded; decoders that do not support it ignore it.
+        virtual bool supportsSubsampling() const { return false; }
+        virtual void setSubsamplingLevel(SubsamplingLevel) { }
+
+        // The level the frames are actually decoded at.
+        SubsamplingLevel subsamplingLevel() const { return m_subsamplingLevel; }
+
+        IntSize subsampledSize() const
+        {
+            return IntSize(subsampledLength(size().width(), m_subsamplingLevel), subsampledLength(size().height(), m_subsamplingLevel));
+        }
+
+        static int subsampledLength(int length, SubsamplingLevel level)
+        {
+            return (length + (1 << level) - 1) >> level;
         }
 
         // This will only differ from size() for ICO (where each frame is a
@@ -353,6 +423,10 @@ namespace WebCore {
         // compositing).
         virtual void clearFrameBufferCache(size_t) { }
 
+        // Clears the decoded pixel data of one frame. It is decoded again if it
+        // is asked for later.
+        virtual void clearFrameBuffer(size_t) { }
+
 #if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
         void setMaxNumPixels(int m) { m_maxNumPixels = m; }
 #endif
@@ -376,6 +450,7 @@ namespace WebCore {
         bool m_scaled;
         Vector<int> m_scaledColumns;
         Vector<int> m_scaledRows;
+        SubsamplingLevel m_subsamplingLevel;
         bool m_premultiplyAlpha;
         bool m_ignoreGammaAndColorProfile;
         ImageOrientation m_orientation;
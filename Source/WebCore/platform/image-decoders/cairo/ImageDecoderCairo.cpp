@@ -37,4 +37,22 @@ PassNativeImagePtr ImageFrame::asNewNativeImage() const
         CAIRO_FORMAT_ARGB32, width(), height(), width() * sizeof(PixelData)));
 }
 
+PassNativeImagePtr ImageFrame::asNewNativeImageCopy() const
+{
+    RefPtr<cairo_surface_t> surface = adoptRef(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width(), height()));
+    if (cairo_surface_status(surface.get()) != CAIRO_STATUS_SUCCESS)
+        return nullptr;
+
+    cairo_surface_flush(surface.get());
+    const unsigned char* source = reinterpret_cast<const unsigned char*>(m_bytes);
+    unsigned char* destination = cairo_image_surface_get_data(surface.get());
+    size_t sourceStride = width() * sizeof(PixelData);
+    int destinationStride = cairo_image_surface_get_stride(surface.get());
+    for (int y = 0; y < height(); ++y)
+        memcpy(destination + y * destinationStride, source + y * sourceStride, sourceStride);
+    cairo_surface_mark_dirty(surface.get());
+
+    return surface.release();
+}
+
 } // namespace WebCore
@@ -35,6 +35,7 @@ namespace WebCore {
 GIFImageDecoder::GIFImageDecoder(ImageSource::AlphaOption alphaOption,
                                  ImageSource::GammaAndColorProfileOption gammaAndColorProfileOption)
     : ImageDecoder(alphaOption, gammaAndColorProfileOption)
+    , m_requestedSubsamplingLevel(0)
     , m_repetitionCount(cAnimationLoopOnce)
 {
 }
@@ -118,11 +119,51 @@ ImageFrame* GIFImageDecoder::frameBufferAtIndex(size_t index)
         return 0;
 
     ImageFrame& frame = m_frameBufferCache[index];
-    if (frame.status() != ImageFrame::FrameComplete)
+    if (frame.status() != ImageFrame::FrameComplete) {
+        // Frames of an animated GIF may have been cleared after they were
+        // decoded, so resume from the closest frame that does not need them.
+        if (m_reader)
+            m_reader->seekToFrame(decodingCheckpoint(index));
         decode(index + 1, GIFFullQuery);
+        downsampleFrameIfPossible(frame);
+    }
     return &frame;
 }
 
+void GIFImageDecoder::downsampleFrameIfPossible(ImageFrame& frame)
+{
+    if (!m_requestedSubsamplingLevel || m_subsamplingLevel || m_scaled)
+        return;
+
+    // All the data is needed to know there are no more frames.
+    if (!isAllDataReceived() || m_frameBufferCache.size() != 1 || frame.status() != ImageFrame::FrameComplete)
+        return;
+
+    SubsamplingLevel level = m_requestedSubsamplingLevel;
+    IntSize frameSize(subsampledLength(size().width(), level), subsampledLength(size().height(), level));
+    ImageFrame downsampledFrame;
+    downsampledFrame.setPremultiplyAlpha(frame.premultiplyAlpha());
+    if (!downsampledFrame.setSize(frameSize.width(), frameSize.height()))
+        return;
+
+    AreaAveragingDownsampler downsampler;
+    downsampler.initialize(size().width(), size().height(), level);
+    unsigned char nonTrivialAlphaMask = 0;
+    for (int y = 0; y < size().height(); ++y)
+        downsampler.addRow(downsampledFrame, y, frame.getAddr(0, y), frame.premultiplyAlpha(), nonTrivialAlphaMask);
+
+    downsampledFrame.setHasAlpha(frame.hasAlpha());
+    downsampledFrame.setOriginalFrameRect(IntRect(IntPoint(), frameSize));
+    downsampledFrame.setStatus(ImageFrame::FrameComplete);
+    downsampledFrame.setDuration(frame.duration());
+    downsampledFrame.setDisposalMethod(frame.disposalMethod());
+
+    // Free the full size pixels before copying, so their capacity is not kept.
+    frame.clearPixelData();
+    frame = downsampledFrame;
+    m_subsamplingLevel = level;
+}
+
 bool GIFImageDecoder::setFailed()
 {
     m_reader.clear();
@@ -179,6 +220,25 @@ void GIFImageDecoder::clearFrameBufferCache(size_t clearBeforeFrame)
     }
 }
 
+void GIFImageDecoder::clearFrameBuffer(size_t index)
+{
+    // The frame of a downsampled single frame GIF is not decoded again at the
+    // same size, so keep it.
+    if (index >= m_frameBufferCache.size() || m_subsamplingLevel)
+        return;
+
+    // Don't clear the frame we're currently decoding, nor the one the next
+    // frame in decoding order starts from, so that playing the animation
+    // forward never has to go back to an earlier checkpoint.
+    ImageFrame& frame = m_frameBufferCache[index];
+    if (frame.status() != ImageFrame::FrameComplete)
+        return;
+    if (m_reader && m_reader->currentDecodingFrame() < m_frameBufferCache.size() && requiredPreviousFrameIndex(m_reader->currentDecodingFrame()) == index)
+        return;
+
+    frame.clearPixelData();
+}
+
 bool GIFImageDecoder::haveDecodedRow(unsigned frameIndex, const Vector<unsigned char>& rowBuffer, size_t width, size_t rowNumber, unsigned repeatCount, bool writeTransparentPixels)
 {
     const GIFFrameContext* frameContext = m_reader->frameContext();
@@ -294,7 +354,10 @@ void GIFImageDecoder::gifComplete()
     // going to be.
     repetitionCount();
 
-    m_reader.clear();
+    // An animated GIF keeps its reader, so that frames cleared while animating
+    // can be decoded again from a checkpoint instead of from the first frame.
+    if (m_frameBufferCache.size() <= 1)
+        m_reader.clear();
 }
 
 void GIFImageDecoder::decode(unsigned haltAtFrame, GIFQuery query)
@@ -333,10 +396,41 @@ void GIFImageDecoder::decode(unsigned haltAtFrame, GIFQuery query)
 
     // It is also a fatal error if all data is received but we failed to decode
     // all frames completely.
-    if (isAllDataReceived() && haltAtFrame >= m_frameBufferCache.size() && m_reader)
+    if (isAllDataReceived() && haltAtFrame >= m_frameBufferCache.size() && m_reader && !m_reader->isDecodingComplete())
         setFailed();
 }
 
+size_t GIFImageDecoder::requiredPreviousFrameIndex(size_t frameIndex) const
+{
+    if (!frameIndex)
+        return notFound;
+
+    // This follows initFrameBuffer(): skip over DisposeOverwritePrevious
+    // frames, then a frame cleared to the background that covers the whole
+    // image (or is the first frame) leaves nothing to build on.
+    size_t previousIndex = frameIndex - 1;
+    while (previousIndex && m_frameBufferCache[previousIndex].disposalMethod() == ImageFrame::DisposeOverwritePrevious)
+        --previousIndex;
+
+    const ImageFrame& previousBuffer = m_frameBufferCache[previousIndex];
+    ImageFrame::FrameDisposalMethod previousMethod = previousBuffer.disposalMethod();
+    if (previousMethod == ImageFrame::DisposeNotSpecified || previousMethod == ImageFrame::DisposeKeep)
+        return previousIndex;
+    if (!previousIndex || previousBuffer.originalFrameRect().contains(IntRect(IntPoint(), scaledSize())))
+        return notFound;
+    return previousIndex;
+}
+
+size_t GIFImageDecoder::decodingCheckpoint(size_t frameIndex) const
+{
+    while (true) {
+        size_t previousIndex = requiredPreviousFrameIndex(frameIndex);
+        if (previousIndex == notFound || m_frameBufferCache[previousIndex].status() == ImageFrame::FrameComplete)
+            return frameIndex;
+        frameIndex = previousIndex;
+    }
+}
+
 bool GIFImageDecoder::initFrameBuffer(unsigned frameIndex)
 {
     // Initialize the frame rect in our buffer.
@@ -375,10 +469,10 @@ bool GIFImageDecoder::initFrameBuffer(unsigned frameIndex)
             prevBuffer = &m_frameBufferCache[--frameIndex];
             prevMethod = prevBuffer->disposalMethod();
         }
-        ASSERT(prevBuffer->status() == ImageFrame::FrameComplete);
 
         if ((prevMethod == ImageFrame::DisposeNotSpecified) || (prevMethod == ImageFrame::DisposeKeep)) {
             // Preserve the last frame as the starting state for this frame.
+            ASSERT(prevBuffer->status() == ImageFrame::FrameComplete);
             if (!buffer->copyBitmapData(*prevBuffer))
                 return setFailed();
         } else {
@@ -393,6 +487,7 @@ bool GIFImageDecoder::initFrameBuffer(unsigned frameIndex)
                     return setFailed();
             } else {
                 // Copy the whole previous buffer, then clear just its frame.
+                ASSERT(prevBuffer->status() == ImageFrame::FrameComplete);
                 if (!buffer->copyBitmapData(*prevBuffer))
                     return setFailed();
                 buffer->zeroFillFrameRect(prevRect);
@@ -46,6 +46,8 @@ namespace WebCore {
         virtual void setData(SharedBuffer* data, bool allDataReceived);
         virtual bool isSizeAvailable();
         virtual bool setSize(unsigned width, unsigned height);
+        virtual bool supportsSubsampling() const { return true; }
+        virtual void setSubsamplingLevel(SubsamplingLevel level) { m_requestedSubsamplingLevel = level; }
         virtual size_t frameCount();
         virtual int repetitionCount() const;
         virtual ImageFrame* frameBufferAtIndex(size_t index);
@@ -54,6 +56,7 @@ namespace WebCore {
         // GIFImageReader!
         virtual bool setFailed();
         virtual void clearFrameBufferCache(size_t clearBeforeFrame);
+        virtual void clearFrameBuffer(size_t);
 
         // Callbacks from the GIF reader.
         bool haveDecodedRow(unsigned frameIndex, const Vector<unsigned char>& rowBuffer, size_t width, size_t rowNumber, unsigned repeatCount, bool writeTransparentPixels);
@@ -72,7 +75,21 @@ namespace WebCore {
         // failure, this will mark the image as failed.
         bool initFrameBuffer(unsigned frameIndex);
 
+        // Returns the frame whose pixels are the starting state of the frame
+        // with the given index, or notFound if it starts from an empty image.
+        size_t requiredPreviousFrameIndex(size_t) const;
+
+        // Returns the frame to resume decoding from to get the frame with the
+        // given index: the closest frame at or before it whose starting state
+        // is still decoded or does not depend on earlier frames.
+        size_t decodingCheckpoint(size_t) const;
+
+        // Frames are composited onto each other at full size, so only a GIF
+        // with a single frame is subsampled, once that frame is complete.
+        void downsampleFrameIfPossible(ImageFrame&);
+
         bool m_currentBufferSawAlpha;
+        SubsamplingLevel m_requestedSubsamplingLevel;
         mutable int m_repetitionCount;
         OwnPtr<GIFImageReader> m_reader;
     };
@@ -381,11 +381,23 @@ bool GIFImageReader::decode(GIFImageDecoder::GIFQuery query, unsigned haltAtFram
     }
 
     // All frames decoded.
-    if (m_currentDecodingFrame == m_frames.size() && m_parseCompleted)
+    if (isDecodingComplete())
         m_client->gifComplete();
     return true;
 }
 
+void GIFImageReader::seekToFrame(size_t frameIndex)
+{
+    ASSERT(frameIndex <= m_frames.size());
+    if (frameIndex == m_currentDecodingFrame)
+        return;
+
+    // Only the frame being decoded can hold LZW state; completed frames drop theirs.
+    if (m_currentDecodingFrame < m_frames.size())
+        m_frames[m_currentDecodingFrame]->resetDecodingState();
+    m_currentDecodingFrame = frameIndex;
+}
+
 // Parse incoming GIF data stream into internal data structures.
 // Return true if parsing has progressed or there is not enough data.
 // Return false if a fatal error is encountered.
@@ -203,6 +203,13 @@ public:
 
     bool decode(const unsigned char* data, size_t length, WebCore::GIFImageDecoder* client, bool* frameDecoded);
 
+    // Drops the LZW state of a partially decoded frame, so the next decode() starts over from its first block.
+    void resetDecodingState()
+    {
+        m_lzwContext.clear();
+        m_currentLzwBlock = 0;
+    }
+
     bool isComplete() const { return m_isComplete; }
     void setComplete() { m_isComplete = true; }
     bool isHeaderDefined() const { return m_isHeaderDefined; }
@@ -264,6 +271,13 @@ public:
     }
     int loopCount() const { return m_loopCount; }
 
+    // Frames are decoded in order, starting from this one. Moving it back lets an
+    // animated GIF decode a frame again without starting over from the first frame.
+    size_t currentDecodingFrame() const { return m_currentDecodingFrame; }
+    void seekToFrame(size_t frameIndex);
+
+    bool isDecodingComplete() const { return m_currentDecodingFrame == m_frames.size() && m_parseCompleted; }
+
     const unsigned char* globalColormap() const
     {
         return m_isGlobalColormapDefined ? data(m_globalColormapPosition) : 0;
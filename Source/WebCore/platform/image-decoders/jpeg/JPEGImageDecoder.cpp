@@ -394,8 +394,14 @@ public:
             // image is a sequential JPEG.
             m_info.buffered_image = jpeg_has_multiple_scans(&m_info);
 
+            // When subsampling, let libjpeg scale the image while decoding, which
+            // also skips most of the IDCT work for the dropped resolution.
+            m_info.scale_num = 1;
+            m_info.scale_denom = 1 << m_decoder->subsamplingLevel();
+
             // Used to set up image size so arrays can be allocated.
             jpeg_calc_output_dimensions(&m_info);
+            ASSERT(static_cast<int>(m_info.output_width) == m_decoder->subsampledSize().width());
 
             // Make a one-row-high sample array that will go away when done with
             // image. Always make it big enough to hold an RGB row. Since this
@@ -58,6 +58,8 @@ namespace WebCore {
         virtual String filenameExtension() const { return "jpg"; }
         virtual bool isSizeAvailable();
         virtual bool setSize(unsigned width, unsigned height);
+        virtual bool supportsSubsampling() const { return true; }
+        virtual void setSubsamplingLevel(SubsamplingLevel level) { m_subsamplingLevel = level; }
         virtual ImageFrame* frameBufferAtIndex(size_t index);
         // CAUTION: setFailed() deletes |m_reader|.  Be careful to avoid
         // accessing deleted memory, especially when calling this from inside
@@ -241,6 +241,13 @@ bool PNGImageDecoder::setSize(unsigned width, unsigned height)
         return false;
 
     prepareScaleDataIfNecessary();
+
+    // Down sampling picks individual rows and columns, which does not combine with
+    // averaging them; it takes precedence since it bounds the memory used.
+    if (m_scaled && m_subsamplingLevel) {
+        m_subsamplingLevel = 0;
+        prepareScaleDataIfNecessary();
+    }
     return true;
 }
 
@@ -451,6 +458,9 @@ void PNGImageDecoder::rowAvailable(unsigned char* rowBuffer, unsigned rowIndex,
             }
         }
 #endif
+        if (m_subsamplingLevel)
+            m_downsampler.initialize(size().width(), size().height(), m_subsamplingLevel);
+
         buffer.setStatus(ImageFrame::FramePartial);
         buffer.setHasAlpha(false);
         buffer.setColorProfile(m_colorProfile);
@@ -476,7 +486,7 @@ void PNGImageDecoder::rowAvailable(unsigned char* rowBuffer, unsigned rowIndex,
     // make our lives easier.
     if (!rowBuffer)
         return;
-    int y = !m_scaled ? rowIndex : scaledY(rowIndex);
+    int y = m_scaled ? scaledY(rowIndex) : (rowIndex >> m_subsamplingLevel);
     if (y < 0 || y >= scaledSize().height())
         return;
 
@@ -506,19 +516,26 @@ void PNGImageDecoder::rowAvailable(unsigned char* rowBuffer, unsigned rowIndex,
     if (png_bytep interlaceBuffer = m_reader->interlaceBuffer()) {
         row = interlaceBuffer + (rowIndex * colorChannels * size().width());
         png_progressive_combine_row(m_reader->pngPtr(), row, rowBuffer);
+
+        // Rows of a block arrive over several passes, so interlaced images are
+        // averaged from the interlace buffer once they are complete.
+        if (m_subsamplingLevel)
+            return;
     }
 
-#if USE(QCMSLIB)
-    if (qcms_transform* transform = m_reader->colorTransform()) {
-        qcms_transform_data(transform, row, m_reader->rowBuffer(), size().width());
-        row = m_reader->rowBuffer();
+    row = colorCorrectedRow(row);
+
+    unsigned char nonTrivialAlphaMask = 0;
+    if (m_subsamplingLevel) {
+        m_downsampler.addRow(buffer, rowIndex, row, colorChannels, nonTrivialAlphaMask);
+        if (nonTrivialAlphaMask && !buffer.hasAlpha())
+            buffer.setHasAlpha(true);
+        return;
     }
-#endif
 
     // Write the decoded row pixels to the frame buffer.
     ImageFrame::PixelData* address = buffer.getAddr(0, y);
     int width = scaledSize().width();
-    unsigned char nonTrivialAlphaMask = 0;
 
 #if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
     if (m_scaled) {
@@ -551,10 +568,39 @@ void PNGImageDecoder::rowAvailable(unsigned char* rowBuffer, unsigned rowIndex,
         buffer.setHasAlpha(true);
 }
 
+unsigned char* PNGImageDecoder::colorCorrectedRow(unsigned char* row)
+{
+#if USE(QCMSLIB)
+    if (qcms_transform* transform = m_reader->colorTransform()) {
+        qcms_transform_data(transform, row, m_reader->rowBuffer(), size().width());
+        return m_reader->rowBuffer();
+    }
+#endif
+    return row;
+}
+
+void PNGImageDecoder::downsampleInterlacedImage()
+{
+    ImageFrame& buffer = m_frameBufferCache.first();
+    unsigned colorChannels = m_reader->hasAlpha() ? 4 : 3;
+    unsigned rowBytes = colorChannels * size().width();
+    png_bytep row = m_reader->interlaceBuffer();
+    unsigned char nonTrivialAlphaMask = 0;
+    for (int y = 0; y < size().height(); ++y, row += rowBytes)
+        m_downsampler.addRow(buffer, y, colorCorrectedRow(row), colorChannels, nonTrivialAlphaMask);
+
+    if (nonTrivialAlphaMask && !buffer.hasAlpha())
+        buffer.setHasAlpha(true);
+}
+
 void PNGImageDecoder::pngComplete()
 {
-    if (!m_frameBufferCache.isEmpty())
-        m_frameBufferCache.first().setStatus(ImageFrame::FrameComplete);
+    if (m_frameBufferCache.isEmpty())
+        return;
+
+    if (m_subsamplingLevel && m_reader->interlaceBuffer())
+        downsampleInterlacedImage();
+    m_frameBufferCache.first().setStatus(ImageFrame::FrameComplete);
 }
 
 void PNGImageDecoder::decode(bool onlySize)
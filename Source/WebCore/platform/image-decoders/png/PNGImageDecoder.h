@@ -43,6 +43,8 @@ namespace WebCore {
         virtual String filenameExtension() const { return "png"; }
         virtual bool isSizeAvailable();
         virtual bool setSize(unsigned width, unsigned height);
+        virtual bool supportsSubsampling() const { return true; }
+        virtual void setSubsamplingLevel(SubsamplingLevel level) { m_subsamplingLevel = level; }
         virtual ImageFrame* frameBufferAtIndex(size_t index);
         // CAUTION: setFailed() deletes |m_reader|.  Be careful to avoid
         // accessing deleted memory, especially when calling this from inside
@@ -65,7 +67,12 @@ namespace WebCore {
         // data coming, sets the "decode failure" flag.
         void decode(bool onlySize);
 
+        // Returns the row in |rowBuffer|, or in the reader's row buffer after color correction.
+        unsigned char* colorCorrectedRow(unsigned char* row);
+        void downsampleInterlacedImage();
+
         OwnPtr<PNGImageReader> m_reader;
+        AreaAveragingDownsampler m_downsampler;
         bool m_doNothingOnFailure;
     };
 
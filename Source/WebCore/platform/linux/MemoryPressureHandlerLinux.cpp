@@ -0,0 +1,461 @@
+/*
+ * Copyright (C) 2014 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "MemoryPressureHandler.h"
+
+#if OS(LINUX)
+
+#include "GCController.h"
+#include "MemoryCache.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/MainThread.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+#include <wtf/text/CString.h>
+#include <wtf/text/WTFString.h>
+
+namespace WebCore {
+
+// Memory pressure is reported, in order of preference, by the kernel's pressure stall information
+// (PSI) for our cgroup or for the whole system, or by cgroup v1 memory.pressure_level notifications.
+// When neither is available, the watcher thread polls how much of the cgroup or system memory is in use.
+
+// See MemoryPressureHandlerCocoa.mm for how these throttle frequent low memory events.
+static const unsigned s_minimumHoldOffTime = 5;
+static const unsigned s_holdOffMultiplier = 20;
+
+static const int s_pollIntervalInMilliseconds = 5000;
+
+// Fractions of the available memory in use at which the polling fallback reports pressure.
+static const double s_nonCriticalMemoryUsage = 0.9;
+static const double s_criticalMemoryUsage = 0.95;
+
+// PSI triggers, as microseconds of stall time within a window. Unprivileged processes
+// may only use windows that are a multiple of two seconds.
+static const char* s_nonCriticalPressureTrigger = "some 200000 2000000";
+static const char* s_criticalPressureTrigger = "full 200000 2000000";
+
+struct MemoryPressureEventSource {
+    int fd;
+    // The cgroup v1 memory.pressure_level file an eventfd was registered for.
+    int pressureLevelFD;
+    bool critical;
+};
+
+static ThreadIdentifier s_watcherThread;
+static int s_wakeUpEventFD = -1;
+static Vector<MemoryPressureEventSource> s_eventSources;
+static String s_memoryCgroupPath;
+static String s_unifiedCgroupPath;
+static std::atomic<bool> s_shouldStopWatching;
+static std::atomic<bool> s_responsePending;
+static std::atomic<double> s_holdOffUntil;
+
+static bool readUInt64FromFile(const String& path, uint64_t& value)
+{
+    FILE* file = fopen(path.utf8().data(), "r");
+    if (!file)
+        return false;
+
+    // cgroup v2 limits read "max" when unset, which fails to parse.
+    bool success = fscanf(file, "%" SCNu64, &value) == 1;
+    fclose(file);
+    return success;
+}
+
+static void findCgroupPaths()
+{
+    FILE* file = fopen("/proc/self/cgroup", "r");
+    if (!file)
+        return;
+
+    // Lines look like "4:memory:/user.slice" for cgroup v1 controllers and "0::/user.slice" for cgroup v2.
+    char line[1024];
+    while (fgets(line, sizeof(line), file)) {
+        char* controllers = strchr(line, ':');
+        if (!controllers)
+            continue;
+        ++controllers;
+        char* path = strchr(controllers, ':');
+        if (!path)
+            continue;
+        *path++ = '\0';
+        path[strcspn(path, "\n")] = '\0';
+
+        if (!*controllers) {
+            s_unifiedCgroupPath = String("/sys/fs/cgroup") + path;
+            continue;
+        }
+
+        char* savePointer;
+        for (char* controller = strtok_r(controllers, ",", &savePointer); controller; controller = strtok_r(nullptr, ",", &savePointer)) {
+            if (!strcmp(controller, "memory")) {
+                s_memoryCgroupPath = String("/sys/fs/cgroup/memory") + path;
+                break;
+            }
+        }
+    }
+    fclose(file);
+
+    // Inside a cgroup namespace the paths are relative to the namespace root, which is what is mounted.
+    if (!s_memoryCgroupPath.isEmpty() && access(s_memoryCgroupPath.utf8().data(), F_OK))
+        s_memoryCgroupPath = ASCIILiteral("/sys/fs/cgroup/memory");
+    if (!s_unifiedCgroupPath.isEmpty() && access(s_unifiedCgroupPath.utf8().data(), F_OK))
+        s_unifiedCgroupPath = ASCIILiteral("/sys/fs/cgroup");
+}
+
+static bool addPressureStallTrigger(const String& path, const char* trigger, bool critical)
+{
+    int fd = open(path.utf8().data(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd == -1)
+        return false;
+
+    if (write(fd, trigger, strlen(trigger) + 1) < 0) {
+        close(fd);
+        return false;
+    }
+
+    s_eventSources.append(MemoryPressureEventSource { fd, -1, critical });
+    return true;
+}
+
+static bool addPressureLevelListener(const char* level, bool critical)
+{
+    int pressureLevelFD = open(String(s_memoryCgroupPath + "/memory.pressure_level").utf8().data(), O_RDONLY | O_CLOEXEC);
+    if (pressureLevelFD == -1)
+        return false;
+
+    int controlFD = open(String(s_memoryCgroupPath + "/cgroup.event_control").utf8().data(), O_WRONLY | O_CLOEXEC);
+    if (controlFD == -1) {
+        close(pressureLevelFD);
+        return false;
+    }
+
+    int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd == -1) {
+        close(controlFD);
+        close(pressureLevelFD);
+        return false;
+    }
+
+    char control[64];
+    int length = snprintf(control, sizeof(control), "%d %d %s", fd, pressureLevelFD, level);
+    bool success = write(controlFD, control, length + 1) >= 0;
+    close(controlFD);
+    if (!success) {
+        close(fd);
+        close(pressureLevelFD);
+        return false;
+    }
+
+    s_eventSources.append(MemoryPressureEventSource { fd, pressureLevelFD, critical });
+    return true;
+}
+
+static void closeEventSources()
+{
+    for (auto& source : s_eventSources) {
+        close(source.fd);
+        if (source.pressureLevelFD != -1)
+            close(source.pressureLevelFD);
+    }
+    s_eventSources.clear();
+}
+
+static void addEventSources()
+{
+    if (!s_unifiedCgroupPath.isEmpty()) {
+        String path = s_unifiedCgroupPath + "/memory.pressure";
+        if (addPressureStallTrigger(path, s_nonCriticalPressureTrigger, false) && addPressureStallTrigger(path, s_criticalPressureTrigger, true))
+            return;
+        closeEventSources();
+    }
+
+    if (addPressureStallTrigger(ASCIILiteral("/proc/pressure/memory"), s_nonCriticalPressureTrigger, false)
+        && addPressureStallTrigger(ASCIILiteral("/proc/pressure/memory"), s_criticalPressureTrigger, true))
+        return;
+    closeEventSources();
+
+    // In the default mode, a "medium" listener is also notified of critical pressure.
+    if (!s_memoryCgroupPath.isEmpty() && addPressureLevelListener("medium", false) && addPressureLevelListener("critical", true))
+        return;
+    closeEventSources();
+}
+
+static bool systemMemoryUsage(uint64_t& used, uint64_t& total)
+{
+    FILE* file = fopen("/proc/meminfo", "r");
+    if (!file)
+        return false;
+
+    uint64_t memoryTotal = 0;
+    uint64_t memoryAvailable = 0;
+    bool foundAvailable = false;
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        uint64_t value;
+        if (sscanf(line, "MemTotal: %" SCNu64 " kB", &value) == 1)
+            memoryTotal = value * 1024;
+        else if (sscanf(line, "MemAvailable: %" SCNu64 " kB", &value) == 1) {
+            memoryAvailable = value * 1024;
+            foundAvailable = true;
+        }
+    }
+    fclose(file);
+
+    if (!memoryTotal || !foundAvailable)
+        return false;
+
+    used = memoryTotal - std::min(memoryAvailable, memoryTotal);
+    total = memoryTotal;
+    return true;
+}
+
+static bool memoryUsage(uint64_t& used, uint64_t& limit)
+{
+    if (!systemMemoryUsage(used, limit))
+        return false;
+
+    // Unlimited cgroups report a limit larger than the system memory, so those are ignored.
+    uint64_t cgroupUsage;
+    uint64_t cgroupLimit;
+    if (!s_unifiedCgroupPath.isEmpty()
+        && readUInt64FromFile(s_unifiedCgroupPath + "/memory.current", cgroupUsage)
+        && readUInt64FromFile(s_unifiedCgroupPath + "/memory.max", cgroupLimit)
+        && cgroupLimit < limit) {
+        used = cgroupUsage;
+        limit = cgroupLimit;
+    } else if (!s_memoryCgroupPath.isEmpty()
+        && readUInt64FromFile(s_memoryCgroupPath + "/memory.usage_in_bytes", cgroupUsage)
+        && readUInt64FromFile(s_memoryCgroupPath + "/memory.limit_in_bytes", cgroupLimit)
+        && cgroupLimit < limit) {
+        used = cgroupUsage;
+        limit = cgroupLimit;
+    }
+
+    return limit;
+}
+
+void MemoryPressureHandler::platformReleaseMemory(bool critical)
+{
+    {
+        ReliefLogger log("Destroy decoded data of live resources");
+        memoryCache()->pruneLiveResources(true);
+    }
+
+    {
+        ReliefLogger log("Collect JS garbage");
+        if (critical)
+            gcController().garbageCollectNow();
+        else
+            gcController().garbageCollectSoon();
+    }
+}
+
+void MemoryPressureHandler::waitForMemoryPressureEvents(void*)
+{
+    Vector<struct pollfd> pollFDs;
+    pollFDs.append(pollfd { s_wakeUpEventFD, POLLIN, 0 });
+    for (auto& source : s_eventSources)
+        pollFDs.append(pollfd { source.fd, static_cast<short>(source.pressureLevelFD == -1 ? POLLPRI : POLLIN), 0 });
+
+    while (!s_shouldStopWatching) {
+        int result = poll(pollFDs.data(), pollFDs.size(), s_pollIntervalInMilliseconds);
+        if (result < 0 && errno != EINTR)
+            break;
+        if (s_shouldStopWatching)
+            break;
+        if (result < 0)
+            continue;
+
+        bool underPressure = false;
+        bool critical = false;
+        for (size_t i = 1; i < pollFDs.size(); ++i) {
+            if (!pollFDs[i].revents)
+                continue;
+            // The cgroup went away; poll() ignores negative descriptors.
+            if (pollFDs[i].revents & (POLLERR | POLLNVAL)) {
+                pollFDs[i].fd = -1;
+                continue;
+            }
+
+            const MemoryPressureEventSource& source = s_eventSources[i - 1];
+            if (source.pressureLevelFD != -1) {
+                uint64_t eventCount;
+                if (read(source.fd, &eventCount, sizeof(eventCount)) != sizeof(eventCount))
+                    continue;
+            }
+            underPressure = true;
+            critical |= source.critical;
+        }
+
+        if (!result) {
+            if (s_eventSources.isEmpty()) {
+                uint64_t used;
+                uint64_t limit;
+                if (memoryUsage(used, limit)) {
+                    double usage = static_cast<double>(used) / limit;
+                    underPressure = usage >= s_nonCriticalMemoryUsage;
+                    critical = usage >= s_criticalMemoryUsage;
+                }
+            }
+            if (!underPressure && monotonicallyIncreasingTime() >= s_holdOffUntil) {
+                callOnMainThread([] {
+                    if (memoryPressureHandler().m_installed)
+                        memoryPressureHandler().setUnderMemoryPressure(false);
+                });
+            }
+        }
+
+        if (!underPressure || monotonicallyIncreasingTime() < s_holdOffUntil || s_responsePending.exchange(true))
+            continue;
+
+        if (ReliefLogger::loggingEnabled())
+            WTFLogAlways("Got memory pressure notification (%s)", critical ? "critical" : "non-critical");
+
+        callOnMainThread([critical] {
+            s_responsePending = false;
+            if (memoryPressureHandler().m_installed)
+                memoryPressureHandler().respondToMemoryPressure(critical);
+        });
+    }
+}
+
+void MemoryPressureHandler::install()
+{
+    if (m_installed)
+        return;
+
+    if (getenv("WEBKIT_MEMORY_PRESSURE_LOGGING"))
+        ReliefLogger::setLoggingEnabled(true);
+
+    s_wakeUpEventFD = eventfd(0, EFD_CLOEXEC);
+    if (s_wakeUpEventFD == -1)
+        return;
+
+    if (s_memoryCgroupPath.isEmpty() && s_unifiedCgroupPath.isEmpty())
+        findCgroupPaths();
+    addEventSources();
+
+    s_shouldStopWatching = false;
+    s_watcherThread = createThread(waitForMemoryPressureEvents, nullptr, "WebCore: MemoryPressureHandler");
+    if (!s_watcherThread) {
+        closeEventSources();
+        close(s_wakeUpEventFD);
+        s_wakeUpEventFD = -1;
+        return;
+    }
+
+    m_installed = true;
+}
+
+void MemoryPressureHandler::uninstall()
+{
+    if (!m_installed)
+        return;
+
+    // The event sources can only be closed once the thread no longer polls them. If the wake up
+    // write fails, the thread still sees the flag once its poll times out.
+    s_shouldStopWatching = true;
+    uint64_t wakeUp = 1;
+    if (write(s_wakeUpEventFD, &wakeUp, sizeof(wakeUp)) != sizeof(wakeUp))
+        LOG_ERROR("Failed to wake up the memory pressure watcher thread: %s", strerror(errno));
+    waitForThreadCompletion(s_watcherThread);
+    s_watcherThread = 0;
+
+    closeEventSources();
+    close(s_wakeUpEventFD);
+    s_wakeUpEventFD = -1;
+
+    m_installed = false;
+}
+
+void MemoryPressureHandler::holdOff(unsigned seconds)
+{
+    s_holdOffUntil = monotonicallyIncreasingTime() + seconds;
+}
+
+void MemoryPressureHandler::respondToMemoryPressure(bool critical)
+{
+    setUnderMemoryPressure(true);
+
+    double startTime = monotonicallyIncreasingTime();
+    m_lowMemoryHandler(critical);
+
+    unsigned holdOffTime = (monotonicallyIncreasingTime() - startTime) * s_holdOffMultiplier;
+    holdOff(std::max(holdOffTime, s_minimumHoldOffTime));
+}
+
+size_t MemoryPressureHandler::ReliefLogger::platformMemoryUsage()
+{
+    // Flush free memory back to the OS before every measurement.
+    // Note that this code only runs when detailed pressure relief logging is enabled.
+    WTF::releaseFastMallocFreeMemory();
+
+    FILE* file = fopen("/proc/self/statm", "r");
+    if (!file)
+        return static_cast<size_t>(-1);
+
+    // The second field is the resident set size in pages.
+    unsigned long size;
+    unsigned long residentPages;
+    bool success = fscanf(file, "%lu %lu", &size, &residentPages) == 2;
+    fclose(file);
+    if (!success)
+        return static_cast<size_t>(-1);
+
+    return static_cast<size_t>(residentPages) * sysconf(_SC_PAGESIZE);
+}
+
+void MemoryPressureHandler::ReliefLogger::platformLog()
+{
+    size_t currentMemory = platformMemoryUsage();
+    if (currentMemory == static_cast<size_t>(-1) || m_initialMemory == static_cast<size_t>(-1)) {
+        WTFLogAlways("%s (Unable to get resident memory information for process)\n", m_logString);
+        return;
+    }
+
+    ssize_t memoryDiff = currentMemory - m_initialMemory;
+    if (memoryDiff < 0)
+        WTFLogAlways("Pressure relief: %s: -RSS %zd bytes (from %zu to %zu)\n", m_logString, -memoryDiff, m_initialMemory, currentMemory);
+    else if (memoryDiff > 0)
+        WTFLogAlways("Pressure relief: %s: +RSS %zd bytes (from %zu to %zu)\n", m_logString, memoryDiff, m_initialMemory, currentMemory);
+    else
+        WTFLogAlways("Pressure relief: %s: =RSS (at %zu bytes)\n", m_logString, currentMemory);
+}
+
+} // namespace WebCore
+
+#endif // OS(LINUX)
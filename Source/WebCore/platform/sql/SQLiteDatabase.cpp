@@ -50,6 +50,8 @@ WEBCORE_EXPORT const int SQLResultConstraint = SQLITE_CONSTRAINT;
 
 static const char notOpenErrorMessage[] = "database is not open";
 
+static const unsigned defaultStatementCacheCapacity = 32;
+
 SQLiteDatabase::SQLiteDatabase()
     : m_db(0)
     , m_pageSize(-1)
@@ -60,6 +62,7 @@ SQLiteDatabase::SQLiteDatabase()
     , m_openError(SQLITE_ERROR)
     , m_openErrorMessage()
     , m_lastChangesCount(0)
+    , m_statementCacheCapacity(defaultStatementCacheCapacity)
 {
 }
 
@@ -120,6 +123,10 @@ void SQLiteDatabase::close()
     if (m_db) {
         // FIXME: This is being called on the main thread during JS GC. <rdar://problem/5739818>
         // ASSERT(currentThread() == m_openingThread);
+
+        // SQLite doesn't close a database that still has prepared statements.
+        clearStatementCache();
+
         sqlite3* db = m_db;
         {
             MutexLocker locker(m_databaseClosingMutex);
@@ -251,6 +258,160 @@ void SQLiteDatabase::setSynchronous(SynchronousPragma sync)
     executeCommand("PRAGMA synchronous = " + String::number(sync));
 }
 
+static const char* journalModeName(SQLiteDatabase::JournalMode mode)
+{
+    switch (mode) {
+    case SQLiteDatabase::JournalMode::Delete:
+        return "DELETE";
+    case SQLiteDatabase::JournalMode::Truncate:
+        return "TRUNCATE";
+    case SQLiteDatabase::JournalMode::Persist:
+        return "PERSIST";
+    case SQLiteDatabase::JournalMode::Memory:
+        return "MEMORY";
+    case SQLiteDatabase::JournalMode::WAL:
+        return "WAL";
+    case SQLiteDatabase::JournalMode::Off:
+        return "OFF";
+    }
+
+    ASSERT_NOT_REACHED();
+    return "DELETE";
+}
+
+bool SQLiteDatabase::setJournalMode(JournalMode mode)
+{
+    const char* modeName = journalModeName(mode);
+
+    // The pragma returns the journal mode in effect, which is the previous one if the change isn't
+    // possible, for instance while a transaction is in progress.
+    SQLiteStatement statement(*this, "PRAGMA journal_mode = " + String(modeName));
+    if (statement.prepare() != SQLITE_OK || statement.step() != SQLITE_ROW) {
+        LOG_ERROR("SQLite database failed to set journal_mode to %s, error: %s", modeName, lastErrorMsg());
+        return false;
+    }
+
+    String newMode = statement.getColumnText(0);
+    if (!equalIgnoringCase(newMode, modeName)) {
+        LOG_ERROR("SQLite database failed to set journal_mode to %s, it is %s", modeName, newMode.utf8().data());
+        return false;
+    }
+
+    return true;
+}
+
+bool SQLiteDatabase::setMemoryMappedSize(int64_t size)
+{
+    // SQLite caps the size at SQLITE_MAX_MMAP_SIZE, which is 0 where memory mapping isn't supported.
+    SQLiteStatement statement(*this, "PRAGMA mmap_size = " + String::number(std::max<int64_t>(size, 0)));
+    if (statement.prepare() != SQLITE_OK || statement.step() != SQLITE_ROW) {
+        LOG(SQLDatabase, "SQLite database failed to set mmap_size to %lli", static_cast<long long>(size));
+        return false;
+    }
+
+    return statement.getColumnInt64(0) == size;
+}
+
+void SQLiteDatabase::setAutomaticCheckpointInterval(int pages)
+{
+    if (m_db)
+        sqlite3_wal_autocheckpoint(m_db, std::max(pages, 0));
+    else
+        LOG(SQLDatabase, "Automatic checkpoint interval set on non-open database");
+}
+
+bool SQLiteDatabase::setJournalSizeLimit(int64_t limit)
+{
+    SQLiteStatement statement(*this, "PRAGMA journal_size_limit = " + String::number(limit));
+    if (statement.prepare() != SQLITE_OK || statement.step() != SQLITE_ROW) {
+        LOG_ERROR("SQLite database failed to set journal_size_limit to %lli, error: %s", static_cast<long long>(limit), lastErrorMsg());
+        return false;
+    }
+
+    return true;
+}
+
+bool SQLiteDatabase::checkpoint(CheckpointMode mode)
+{
+    if (!m_db)
+        return false;
+
+    int sqliteMode = SQLITE_CHECKPOINT_PASSIVE;
+    switch (mode) {
+    case CheckpointMode::Passive:
+        sqliteMode = SQLITE_CHECKPOINT_PASSIVE;
+        break;
+    case CheckpointMode::Full:
+        sqliteMode = SQLITE_CHECKPOINT_FULL;
+        break;
+    case CheckpointMode::Restart:
+        sqliteMode = SQLITE_CHECKPOINT_RESTART;
+        break;
+    }
+
+    int logFrameCount = 0;
+    int checkpointedFrameCount = 0;
+    int result = sqlite3_wal_checkpoint_v2(m_db, nullptr, sqliteMode, &logFrameCount, &checkpointedFrameCount);
+    if (result != SQLITE_OK) {
+        LOG(SQLDatabase, "SQLite database checkpoint did not complete (%i) - %s", result, lastErrorMsg());
+        return false;
+    }
+
+    LOG(SQLDatabase, "SQLite database checkpointed %i of %i frames", checkpointedFrameCount, logFrameCount);
+    return true;
+}
+
+SQLiteStatement* SQLiteDatabase::cachedStatement(const String& query)
+{
+    if (!m_db)
+        return nullptr;
+
+    auto it = m_cachedStatements.find(query);
+    if (it != m_cachedStatements.end() && !it->value->isExpired()) {
+        m_cachedStatementQueries.appendOrMoveToLast(query);
+
+        // reset() returns the error of the last step, if there was one, which the last user already saw.
+        SQLiteStatement* statement = it->value.get();
+        statement->reset();
+        statement->clearBindings();
+        return statement;
+    }
+
+    auto statement = std::make_unique<SQLiteStatement>(*this, query);
+    if (statement->prepare() != SQLITE_OK) {
+        LOG_ERROR("Preparing statement %s failed - %s", query.utf8().data(), lastErrorMsg());
+        return nullptr;
+    }
+
+    SQLiteStatement* result = statement.get();
+    m_cachedStatements.set(query, WTF::move(statement));
+    m_cachedStatementQueries.appendOrMoveToLast(query);
+
+    if (m_cachedStatementQueries.size() > m_statementCacheCapacity) {
+        m_cachedStatements.remove(m_cachedStatementQueries.first());
+        m_cachedStatementQueries.removeFirst();
+    }
+
+    return result;
+}
+
+void SQLiteDatabase::setStatementCacheCapacity(unsigned capacity)
+{
+    ASSERT(capacity);
+    m_statementCacheCapacity = std::max(capacity, 1u);
+
+    while (m_cachedStatementQueries.size() > m_statementCacheCapacity) {
+        m_cachedStatements.remove(m_cachedStatementQueries.first());
+        m_cachedStatementQueries.removeFirst();
+    }
+}
+
+void SQLiteDatabase::clearStatementCache()
+{
+    m_cachedStatementQueries.clear();
+    m_cachedStatements.clear();
+}
+
 void SQLiteDatabase::setBusyTimeout(int ms)
 {
     if (m_db)
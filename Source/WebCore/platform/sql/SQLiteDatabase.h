@@ -28,6 +28,9 @@
 #define SQLiteDatabase_h
 
 #include <functional>
+#include <memory>
+#include <wtf/HashMap.h>
+#include <wtf/ListHashSet.h>
 #include <wtf/Threading.h>
 #include <wtf/text/CString.h>
 #include <wtf/text/WTFString.h>
@@ -102,7 +105,37 @@ public:
     // NORMAL - SQLite pauses at some critical moments when writing, but much less than FULL
     // OFF - Calls return immediately after the data has been passed to disk
     enum SynchronousPragma { SyncOff = 0, SyncNormal = 1, SyncFull = 2 };
-    void setSynchronous(SynchronousPragma);
+    WEBCORE_EXPORT void setSynchronous(SynchronousPragma);
+
+    // Databases are opened in WAL mode. With WAL, SyncNormal only syncs when checkpointing, which
+    // keeps the database consistent but may lose the last transactions on power loss.
+    enum class JournalMode { Delete, Truncate, Persist, Memory, WAL, Off };
+    WEBCORE_EXPORT bool setJournalMode(JournalMode);
+
+    // Lets SQLite read up to the given number of bytes of the database file through a memory mapping
+    // instead of read() calls. Zero turns memory mapped I/O off.
+    WEBCORE_EXPORT bool setMemoryMappedSize(int64_t);
+
+    // In WAL mode, SQLite checkpoints the write-ahead log into the database whenever a commit leaves
+    // it longer than the given number of pages, 1000 by default. Zero turns automatic checkpoints
+    // off, for databases that checkpoint on their own schedule. The size limit truncates the log
+    // file after a checkpoint; a negative limit leaves it as large as it grew.
+    WEBCORE_EXPORT void setAutomaticCheckpointInterval(int pages);
+    WEBCORE_EXPORT bool setJournalSizeLimit(int64_t);
+
+    // Passive checkpoints copy what they can without waiting for readers or writers. Full waits for
+    // writers to finish, and Restart also waits for readers so the next writer starts the log over.
+    enum class CheckpointMode { Passive, Full, Restart };
+    WEBCORE_EXPORT bool checkpoint(CheckpointMode = CheckpointMode::Passive);
+
+    // Returns the statement for the query, prepared the first time it is asked for and reset with no
+    // parameters bound after that. The most recently used statements are kept, up to the capacity;
+    // a statement stays valid until it is evicted or the database is closed, so don't hold on to one
+    // across requests for other statements. The authorizer only sees a statement when it is prepared,
+    // so this isn't meant for queries from web content.
+    WEBCORE_EXPORT SQLiteStatement* cachedStatement(const String& query);
+    WEBCORE_EXPORT void setStatementCacheCapacity(unsigned);
+    void clearStatementCache();
     
     WEBCORE_EXPORT int lastError();
     WEBCORE_EXPORT const char* lastErrorMsg();
@@ -168,6 +201,10 @@ private:
     CString m_openErrorMessage;
 
     int m_lastChangesCount;
+
+    unsigned m_statementCacheCapacity;
+    ListHashSet<String> m_cachedStatementQueries;
+    HashMap<String, std::unique_ptr<SQLiteStatement>> m_cachedStatements;
 };
 
 } // namespace WebCore
@@ -54,6 +54,7 @@ public:
     WEBCORE_EXPORT int step();
     int finalize();
     WEBCORE_EXPORT int reset();
+    int clearBindings();
     
     int prepareAndStep() { if (int error = prepare()) return error; return step(); }
     
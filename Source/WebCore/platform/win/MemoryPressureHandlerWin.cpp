@@ -0,0 +1,230 @@
+/*
+ * Copyright (C) 2014 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "MemoryPressureHandler.h"
+
+#if OS(WINDOWS)
+
+#include "GCController.h"
+#include "MemoryCache.h"
+#include <stdlib.h>
+#include <windows.h>
+#include <psapi.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/MainThread.h>
+#include <wtf/Threading.h>
+
+#pragma comment(lib, "psapi")
+
+namespace WebCore {
+
+// The system signals a low memory resource notification when physical memory runs low, which is
+// treated as critical pressure. While it is not signaled, the watcher thread polls how much of the
+// physical memory is in use to report non-critical pressure before that.
+
+// See MemoryPressureHandlerCocoa.mm for how these throttle frequent low memory events.
+static const unsigned s_minimumHoldOffTime = 5;
+static const unsigned s_holdOffMultiplier = 20;
+
+static const DWORD s_pollIntervalInMilliseconds = 5000;
+
+// Percentages of the physical memory in use at which polling reports pressure.
+static const DWORD s_nonCriticalMemoryLoad = 90;
+static const DWORD s_criticalMemoryLoad = 95;
+
+static ThreadIdentifier s_watcherThread;
+static HANDLE s_wakeUpEvent;
+static HANDLE s_lowMemoryNotification;
+static std::atomic<bool> s_shouldStopWatching;
+static std::atomic<bool> s_responsePending;
+static std::atomic<double> s_holdOffUntil;
+
+void MemoryPressureHandler::platformReleaseMemory(bool critical)
+{
+    {
+        ReliefLogger log("Destroy decoded data of live resources");
+        memoryCache()->pruneLiveResources(true);
+    }
+
+    {
+        ReliefLogger log("Collect JS garbage");
+        if (critical)
+            gcController().garbageCollectNow();
+        else
+            gcController().garbageCollectSoon();
+    }
+}
+
+void MemoryPressureHandler::waitForMemoryPressureEvents(void*)
+{
+    HANDLE handles[] = { s_wakeUpEvent, s_lowMemoryNotification };
+
+    // The low memory notification stays signaled for as long as memory is low, so it is
+    // only waited on again after polling has seen the memory load drop.
+    bool waitForLowMemoryNotification = !!s_lowMemoryNotification;
+
+    while (!s_shouldStopWatching) {
+        DWORD result = WaitForMultipleObjects(waitForLowMemoryNotification ? 2 : 1, handles, FALSE, s_pollIntervalInMilliseconds);
+        if (result == WAIT_FAILED)
+            break;
+        if (s_shouldStopWatching)
+            break;
+
+        bool underPressure = false;
+        bool critical = false;
+        if (result == WAIT_OBJECT_0 + 1) {
+            underPressure = true;
+            critical = true;
+            waitForLowMemoryNotification = false;
+        } else if (result == WAIT_TIMEOUT) {
+            MEMORYSTATUSEX status;
+            status.dwLength = sizeof(status);
+            if (GlobalMemoryStatusEx(&status)) {
+                underPressure = status.dwMemoryLoad >= s_nonCriticalMemoryLoad;
+                critical = status.dwMemoryLoad >= s_criticalMemoryLoad;
+            }
+            if (!underPressure) {
+                waitForLowMemoryNotification = !!s_lowMemoryNotification;
+                if (monotonicallyIncreasingTime() >= s_holdOffUntil) {
+                    callOnMainThread([] {
+                        if (memoryPressureHandler().m_installed)
+                            memoryPressureHandler().setUnderMemoryPressure(false);
+                    });
+                }
+            }
+        }
+
+        if (!underPressure || monotonicallyIncreasingTime() < s_holdOffUntil || s_responsePending.exchange(true))
+            continue;
+
+        if (ReliefLogger::loggingEnabled())
+            WTFLogAlways("Got memory pressure notification (%s)", critical ? "critical" : "non-critical");
+
+        callOnMainThread([critical] {
+            s_responsePending = false;
+            if (memoryPressureHandler().m_installed)
+                memoryPressureHandler().respondToMemoryPressure(critical);
+        });
+    }
+}
+
+void MemoryPressureHandler::install()
+{
+    if (m_installed)
+        return;
+
+    if (getenv("WEBKIT_MEMORY_PRESSURE_LOGGING"))
+        ReliefLogger::setLoggingEnabled(true);
+
+    s_wakeUpEvent = CreateEvent(0, TRUE, FALSE, 0);
+    if (!s_wakeUpEvent)
+        return;
+
+    // Without the notification, polling alone reports pressure.
+    s_lowMemoryNotification = CreateMemoryResourceNotification(LowMemoryResourceNotification);
+
+    s_shouldStopWatching = false;
+    s_watcherThread = createThread(waitForMemoryPressureEvents, nullptr, "WebCore: MemoryPressureHandler");
+    if (!s_watcherThread) {
+        if (s_lowMemoryNotification)
+            CloseHandle(s_lowMemoryNotification);
+        s_lowMemoryNotification = 0;
+        CloseHandle(s_wakeUpEvent);
+        s_wakeUpEvent = 0;
+        return;
+    }
+
+    m_installed = true;
+}
+
+void MemoryPressureHandler::uninstall()
+{
+    if (!m_installed)
+        return;
+
+    // If the wake up event can't be set, the thread still sees the flag once its wait times out.
+    s_shouldStopWatching = true;
+    SetEvent(s_wakeUpEvent);
+    waitForThreadCompletion(s_watcherThread);
+    s_watcherThread = 0;
+
+    if (s_lowMemoryNotification)
+        CloseHandle(s_lowMemoryNotification);
+    s_lowMemoryNotification = 0;
+    CloseHandle(s_wakeUpEvent);
+    s_wakeUpEvent = 0;
+
+    m_installed = false;
+}
+
+void MemoryPressureHandler::holdOff(unsigned seconds)
+{
+    s_holdOffUntil = monotonicallyIncreasingTime() + seconds;
+}
+
+void MemoryPressureHandler::respondToMemoryPressure(bool critical)
+{
+    setUnderMemoryPressure(true);
+
+    double startTime = monotonicallyIncreasingTime();
+    m_lowMemoryHandler(critical);
+
+    unsigned holdOffTime = (monotonicallyIncreasingTime() - startTime) * s_holdOffMultiplier;
+    holdOff(std::max(holdOffTime, s_minimumHoldOffTime));
+}
+
+size_t MemoryPressureHandler::ReliefLogger::platformMemoryUsage()
+{
+    // Flush free memory back to the OS before every measurement.
+    // Note that this code only runs when detailed pressure relief logging is enabled.
+    WTF::releaseFastMallocFreeMemory();
+
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return static_cast<size_t>(-1);
+
+    return counters.WorkingSetSize;
+}
+
+void MemoryPressureHandler::ReliefLogger::platformLog()
+{
+    size_t currentMemory = platformMemoryUsage();
+    if (currentMemory == static_cast<size_t>(-1) || m_initialMemory == static_cast<size_t>(-1)) {
+        WTFLogAlways("%s (Unable to get working set information for process)\n", m_logString);
+        return;
+    }
+
+    if (currentMemory < m_initialMemory)
+        WTFLogAlways("Pressure relief: %s: -working set %Iu bytes (from %Iu to %Iu)\n", m_logString, m_initialMemory - currentMemory, m_initialMemory, currentMemory);
+    else if (currentMemory > m_initialMemory)
+        WTFLogAlways("Pressure relief: %s: +working set %Iu bytes (from %Iu to %Iu)\n", m_logString, currentMemory - m_initialMemory, m_initialMemory, currentMemory);
+    else
+        WTFLogAlways("Pressure relief: %s: =working set (at %Iu bytes)\n", m_logString, currentMemory);
+}
+
+} // namespace WebCore
+
+#endif // OS(WINDOWS)
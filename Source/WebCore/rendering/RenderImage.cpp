@@ -560,6 +560,22 @@ void RenderImage::paintIntoRect(GraphicsContext* context, const FloatRect& rect)
     if (!img || img->isNull())
         return;
 
+    // While a large frame is decoded in the background, draw what the image already has decoded, or a
+    // placeholder if it has nothing; it repaints once the frame is ready.
+    if (img->isBitmapImage()) {
+        BitmapImage* bitmapImage = toBitmapImage(img.get());
+        FloatRect deviceRect = context->getCTM().mapRect(rect);
+        FloatSize imageSize = bitmapImage->size();
+        float presentationScaleHint = imageSize.isEmpty() ? 1 : std::min<float>(1, std::max(deviceRect.width() / imageSize.width(), deviceRect.height() / imageSize.height()));
+        if (bitmapImage->decodeCurrentFrameAsynchronouslyIfNeeded(presentationScaleHint)) {
+            img = bitmapImage->imageForPendingCurrentFrame();
+            if (!img) {
+                context->fillRect(rect, Color(Color::lightGray), style().colorSpace());
+                return;
+            }
+        }
+    }
+
     HTMLImageElement* imageElt = (element() && isHTMLImageElement(element())) ? toHTMLImageElement(element()) : 0;
     CompositeOperator compositeOperator = imageElt ? imageElt->compositeOperator() : CompositeSourceOver;
     Image* image = imageResource().image().get();
@@ -568,7 +584,7 @@ void RenderImage::paintIntoRect(GraphicsContext* context, const FloatRect& rect)
 #if ENABLE(CSS_IMAGE_ORIENTATION)
     orientationDescription.setImageOrientationEnum(style().imageOrientation());
 #endif
-    context->drawImage(imageResource().image(rect.width(), rect.height()).get(), style().colorSpace(), rect,
+    context->drawImage(img.get(), style().colorSpace(), rect,
         ImagePaintingOptions(compositeOperator, BlendModeNormal, orientationDescription, useLowQualityScaling));
 }
 
@@ -51,6 +51,18 @@ static const double StorageSyncInterval = 1.0;
 // much harder to starve the rest of LocalStorage and the OS's IO subsystem in general.
 static const int MaxiumItemsToSync = 100;
 
+// Changes are appended to ItemJournal, which is cheaper than replacing rows in ItemTable, and the
+// journal is folded back into ItemTable once it gets this long. It is also folded in whenever the
+// database is closed, so the file stays readable by code that only knows about ItemTable.
+static const unsigned MaximumJournalLength = 1000;
+
+// Databases larger than this are imported incrementally on the background thread. Until the import
+// is complete, reading an item looks it up in the database instead of waiting for every item.
+static const long long IncrementalImportDatabaseSize = 512 * 1024;
+
+// How many rows an incremental import reads between looking up the items the main thread asked for.
+static const int ItemLookupInterval = 32;
+
 inline StorageAreaSync::StorageAreaSync(PassRefPtr<StorageSyncManager> storageSyncManager, PassRefPtr<StorageAreaImpl> storageArea, const String& databaseIdentifier)
     : m_syncTimer(this, &StorageAreaSync::syncTimerFired)
     , m_itemsCleared(false)
@@ -63,7 +75,9 @@ inline StorageAreaSync::StorageAreaSync(PassRefPtr<StorageSyncManager> storageSy
     , m_syncInProgress(false)
     , m_databaseOpenFailed(false)
     , m_syncCloseDatabase(false)
+    , m_journalLength(0)
     , m_importComplete(false)
+    , m_importingIncrementally(false)
 {
     ASSERT(isMainThread());
     ASSERT(m_storageArea);
@@ -275,6 +289,20 @@ void StorageAreaSync::openDatabase(OpenDatabaseParamType openingStrategy)
         return;
     }
 
+    if (!m_database.executeCommand("CREATE TABLE IF NOT EXISTS ItemJournal (key TEXT NOT NULL, value BLOB)")) {
+        LOG_ERROR("Failed to create table ItemJournal for local storage");
+        markImported();
+        m_databaseOpenFailed = true;
+        return;
+    }
+
+    // The journal is only left behind if the process went away while the database was open.
+    SQLiteStatement journalLengthQuery(m_database, "SELECT COUNT(*) FROM ItemJournal");
+    if (journalLengthQuery.prepare() == SQLResultOk && journalLengthQuery.step() == SQLResultRow)
+        m_journalLength = journalLengthQuery.getColumnInt(0);
+    else
+        LOG_ERROR("Unable to count number of rows in ItemJournal for local storage");
+
     StorageTracker::tracker().setOriginDetails(m_databaseIdentifier, databaseFilename);
 }
 
@@ -332,6 +360,16 @@ void StorageAreaSync::performImport()
         return;
     }
 
+    // Fold a journal left behind by a previous session into ItemTable, so that ItemTable alone holds every item.
+    compactJournal();
+
+    long long databaseSize;
+    if (getFileSize(m_syncManager->fullDatabaseFilename(m_databaseIdentifier), databaseSize) && databaseSize >= IncrementalImportDatabaseSize) {
+        MutexLocker locker(m_importLock);
+        m_importingIncrementally = true;
+        m_importCondition.signal();
+    }
+
     SQLiteStatement query(m_database, "SELECT key, value FROM ItemTable");
     if (query.prepare() != SQLResultOk) {
         LOG_ERROR("Unable to select items from ItemTable for local storage");
@@ -342,8 +380,10 @@ void StorageAreaSync::performImport()
     HashMap<String, String> itemMap;
 
     int result = query.step();
-    while (result == SQLResultRow) {
+    for (int count = 1; result == SQLResultRow; ++count) {
         itemMap.set(query.getColumnText(0), query.getColumnBlobAsString(1));
+        if (m_importingIncrementally && !(count % ItemLookupInterval))
+            performItemLookups();
         result = query.step();
     }
 
@@ -362,6 +402,46 @@ void StorageAreaSync::markImported()
 {
     MutexLocker locker(m_importLock);
     m_importComplete = true;
+    m_keysToLookUp.clear();
+    m_lookedUpItems.clear();
+    m_importCondition.signal();
+}
+
+void StorageAreaSync::performItemLookups()
+{
+    ASSERT(!isMainThread());
+
+    Vector<String> keys;
+    {
+        MutexLocker locker(m_importLock);
+        if (m_keysToLookUp.isEmpty())
+            return;
+        m_keysToLookUp.swap(keys);
+    }
+
+    SQLiteStatement query(m_database, "SELECT value FROM ItemTable WHERE key=?");
+    if (query.prepare() != SQLResultOk) {
+        LOG_ERROR("Unable to prepare item lookup for local storage");
+        return;
+    }
+
+    HashMap<String, String> items;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        query.bindText(1, keys[i]);
+        int result = query.step();
+        if (result == SQLResultRow)
+            items.set(keys[i], query.getColumnBlobAsString(0));
+        else if (result == SQLResultDone)
+            items.set(keys[i], String());
+        else
+            LOG_ERROR("Error looking up an item in ItemTable for local storage - %i", result);
+        query.reset();
+    }
+
+    MutexLocker locker(m_importLock);
+    HashMap<String, String>::const_iterator end = items.end();
+    for (HashMap<String, String>::const_iterator it = items.begin(); it != end; ++it)
+        m_lookedUpItems.set(it->key, it->value.isolatedCopy());
     m_importCondition.signal();
 }
 
@@ -386,6 +466,112 @@ void StorageAreaSync::blockUntilImportComplete()
     m_storageArea = 0;
 }
 
+bool StorageAreaSync::itemBeforeImportComplete(const String& key, String& value)
+{
+    ASSERT(isMainThread());
+
+    if (!m_storageArea)
+        return false;
+
+    MutexLocker locker(m_importLock);
+    while (!m_importComplete && !m_importingIncrementally)
+        m_importCondition.wait(m_importLock);
+    if (m_importComplete)
+        return false;
+
+    // If the background thread fails to look up the item, this waits for the import like any other access.
+    m_keysToLookUp.append(key.isolatedCopy());
+    while (!m_importComplete && !m_lookedUpItems.contains(key))
+        m_importCondition.wait(m_importLock);
+    if (m_importComplete)
+        return false;
+
+    value = m_lookedUpItems.take(key);
+    return true;
+}
+
+bool StorageAreaSync::writeItemsToItemTable(const HashMap<String, String>& items)
+{
+    ASSERT(!isMainThread());
+
+    SQLiteStatement insert(m_database, "INSERT INTO ItemTable VALUES (?, ?)");
+    if (insert.prepare() != SQLResultOk) {
+        LOG_ERROR("Failed to prepare insert statement - cannot write to local storage database");
+        return false;
+    }
+
+    SQLiteStatement remove(m_database, "DELETE FROM ItemTable WHERE key=?");
+    if (remove.prepare() != SQLResultOk) {
+        LOG_ERROR("Failed to prepare delete statement - cannot write to local storage database");
+        return false;
+    }
+
+    HashMap<String, String>::const_iterator end = items.end();
+    for (HashMap<String, String>::const_iterator it = items.begin(); it != end; ++it) {
+        // Based on the null-ness of the second argument, decide whether this is an insert or a delete.
+        SQLiteStatement& query = it->value.isNull() ? remove : insert;
+
+        query.bindText(1, it->key);
+
+        // If the second argument is non-null, we're doing an insert, so bind it as the value.
+        if (!it->value.isNull())
+            query.bindBlob(2, it->value);
+
+        int result = query.step();
+        if (result != SQLResultDone) {
+            LOG_ERROR("Failed to update item in the local storage database - %i", result);
+            return false;
+        }
+
+        query.reset();
+    }
+
+    return true;
+}
+
+// Replays the journal into ItemTable and empties it, keeping only the last change made to each key.
+void StorageAreaSync::compactJournal()
+{
+    ASSERT(!isMainThread());
+    ASSERT(m_database.isOpen());
+
+    if (!m_journalLength)
+        return;
+
+    SQLiteTransactionInProgressAutoCounter transactionCounter;
+
+    HashMap<String, String> items;
+    {
+        SQLiteStatement query(m_database, "SELECT key, value FROM ItemJournal ORDER BY rowid");
+        if (query.prepare() != SQLResultOk) {
+            LOG_ERROR("Unable to select items from ItemJournal for local storage");
+            return;
+        }
+
+        int result = query.step();
+        while (result == SQLResultRow) {
+            items.set(query.getColumnText(0), query.isColumnNull(1) ? String() : query.getColumnBlobAsString(1));
+            result = query.step();
+        }
+
+        if (result != SQLResultDone) {
+            LOG_ERROR("Error reading items from ItemJournal for local storage");
+            return;
+        }
+    }
+
+    SQLiteTransaction transaction(m_database);
+    transaction.begin();
+    if (!writeItemsToItemTable(items) || !m_database.executeCommand("DELETE FROM ItemJournal")) {
+        LOG_ERROR("Failed to compact ItemJournal for local storage");
+        transaction.rollback();
+        return;
+    }
+    transaction.commit();
+
+    m_journalLength = 0;
+}
+
 void StorageAreaSync::sync(bool clearItems, const HashMap<String, String>& items)
 {
     ASSERT(!isMainThread());
@@ -410,6 +596,7 @@ void StorageAreaSync::sync(bool clearItems, const HashMap<String, String>& items
     // to write new items created after the request to delete the db.
     if (m_syncCloseDatabase) {
         m_syncCloseDatabase = false;
+        compactJournal();
         m_database.close();
         return;
     }
@@ -429,17 +616,18 @@ void StorageAreaSync::sync(bool clearItems, const HashMap<String, String>& items
             LOG_ERROR("Failed to clear all items in the local storage database - %i", result);
             return;
         }
-    }
 
-    SQLiteStatement insert(m_database, "INSERT INTO ItemTable VALUES (?, ?)");
-    if (insert.prepare() != SQLResultOk) {
-        LOG_ERROR("Failed to prepare insert statement - cannot write to local storage database");
-        return;
+        if (!m_database.executeCommand("DELETE FROM ItemJournal")) {
+            LOG_ERROR("Failed to clear the journal in the local storage database");
+            return;
+        }
+        m_journalLength = 0;
     }
 
-    SQLiteStatement remove(m_database, "DELETE FROM ItemTable WHERE key=?");
-    if (remove.prepare() != SQLResultOk) {
-        LOG_ERROR("Failed to prepare delete statement - cannot write to local storage database");
+    // A null value records that the item was removed.
+    SQLiteStatement append(m_database, "INSERT INTO ItemJournal VALUES (?, ?)");
+    if (append.prepare() != SQLResultOk) {
+        LOG_ERROR("Failed to prepare journal statement - cannot write to local storage database");
         return;
     }
 
@@ -448,24 +636,25 @@ void StorageAreaSync::sync(bool clearItems, const HashMap<String, String>& items
     SQLiteTransaction transaction(m_database);
     transaction.begin();
     for (HashMap<String, String>::const_iterator it = items.begin(); it != end; ++it) {
-        // Based on the null-ness of the second argument, decide whether this is an insert or a delete.
-        SQLiteStatement& query = it->value.isNull() ? remove : insert;
-
-        query.bindText(1, it->key);
+        append.bindText(1, it->key);
+        if (it->value.isNull())
+            append.bindNull(2);
+        else
+            append.bindBlob(2, it->value);
 
-        // If the second argument is non-null, we're doing an insert, so bind it as the value.
-        if (!it->value.isNull())
-            query.bindBlob(2, it->value);
-
-        int result = query.step();
+        int result = append.step();
         if (result != SQLResultDone) {
             LOG_ERROR("Failed to update item in the local storage database - %i", result);
             break;
         }
 
-        query.reset();
+        append.reset();
+        ++m_journalLength;
     }
     transaction.commit();
+
+    if (m_journalLength >= MaximumJournalLength)
+        compactJournal();
 }
 
 void StorageAreaSync::performSync()
@@ -505,6 +694,8 @@ void StorageAreaSync::deleteEmptyDatabase()
     if (!m_database.isOpen())
         return;
 
+    compactJournal();
+
     SQLiteStatement query(m_database, "SELECT COUNT(*) FROM ItemTable");
     if (query.prepare() != SQLResultOk) {
         LOG_ERROR("Unable to count number of rows in ItemTable for local storage");
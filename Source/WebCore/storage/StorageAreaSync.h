@@ -29,6 +29,7 @@
 #include "SQLiteDatabase.h"
 #include "Timer.h"
 #include <wtf/HashMap.h>
+#include <wtf/Vector.h>
 #include <wtf/text/StringHash.h>
 
 namespace WebCore {
@@ -45,6 +46,11 @@ public:
     void scheduleFinalSync();
     void blockUntilImportComplete();
 
+    // While a large database is still being imported, reads a single item straight from the database
+    // instead of waiting for the whole import. Returns false if the caller should block until the
+    // import is complete and read the item from the StorageMap instead.
+    bool itemBeforeImportComplete(const String& key, String& value);
+
     void scheduleItemForSync(const String& key, const String& value);
     void scheduleClear();
     void scheduleCloseDatabase();
@@ -82,6 +88,9 @@ private:
     void syncTimerFired(Timer<StorageAreaSync>*);
     void openDatabase(OpenDatabaseParamType openingStrategy);
     void sync(bool clearItems, const HashMap<String, String>& items);
+    bool writeItemsToItemTable(const HashMap<String, String>& items);
+    void compactJournal();
+    void performItemLookups();
 
     const String m_databaseIdentifier;
 
@@ -94,9 +103,18 @@ private:
 
     bool m_syncCloseDatabase;
 
+    // Number of rows in ItemJournal. Only used on the background thread.
+    unsigned m_journalLength;
+
     mutable Mutex m_importLock;
     ThreadCondition m_importCondition;
     bool m_importComplete;
+
+    // Set once the background thread has decided to import incrementally and to answer lookups
+    // for single items in the meantime.
+    bool m_importingIncrementally;
+    Vector<String> m_keysToLookUp;
+    HashMap<String, String> m_lookedUpItems;
     void markImported();
     void migrateItemTableIfNeeded();
 };
@@ -84,14 +84,20 @@
 #include "RenderTreeAsText.h"
 #include "RenderView.h"
 #include "RuntimeEnabledFeatures.h"
+#include "SQLiteDatabase.h"
+#include "SQLiteStatement.h"
+#include "SQLiteTransaction.h"
 #include "SchemeRegistry.h"
 #include "ScrollingCoordinator.h"
+#include "SelectorQuery.h"
 #include "SerializedScriptValue.h"
 #include "Settings.h"
+#include "ShadowBlur.h"
 #include "ShadowRoot.h"
 #include "SourceBuffer.h"
 #include "SpellChecker.h"
 #include "StaticNodeList.h"
+#include "StyleResolver.h"
 #include "StyleSheetContents.h"
 #include "TextIterator.h"
 #include "TreeScope.h"
@@ -104,8 +110,10 @@
 #include <inspector/InspectorValues.h>
 #include <runtime/JSCInlines.h>
 #include <runtime/JSCJSValue.h>
+#include <wtf/CurrentTime.h>
 #include <wtf/text/CString.h>
 #include <wtf/text/StringBuffer.h>
+#include <wtf/text/StringBuilder.h>
 
 #if ENABLE(INPUT_TYPE_COLOR)
 #include "ColorChooser.h"
@@ -1435,6 +1443,106 @@ unsigned Internals::numberOfLiveDocuments() const
     return Document::allDocuments().size();
 }
 
+unsigned Internals::selectorQueryCacheHitCount() const
+{
+    return selectorQueryCache().statistics().hitCount;
+}
+
+unsigned Internals::selectorQueryCacheMissCount() const
+{
+    return selectorQueryCache().statistics().missCount;
+}
+
+void Internals::resetShadowBlurStatistics()
+{
+    ShadowBlur::resetStatistics();
+}
+
+unsigned Internals::shadowBlurCount() const
+{
+    return ShadowBlur::statistics().blurCount;
+}
+
+unsigned Internals::shadowTemplateCacheHitCount() const
+{
+    return ShadowBlur::statistics().templateCacheHitCount;
+}
+
+void Internals::resetStyleResolverStatistics(bool collectPhaseTimes)
+{
+    StyleResolver::Statistics& statistics = StyleResolver::statistics();
+    statistics.reset();
+    statistics.collectsPhaseTimes = collectPhaseTimes;
+}
+
+String Internals::styleResolverStatistics() const
+{
+    return StyleResolver::statisticsAsText();
+}
+
+bool Internals::styleResolverSharesMatchedPropertiesCache(ExceptionCode& ec)
+{
+    Document* document = contextDocument();
+    if (!document) {
+        ec = INVALID_ACCESS_ERR;
+        return false;
+    }
+    return document->ensureStyleResolver().sharesMatchedPropertiesCache();
+}
+
+double Internals::sqliteRepeatedQueryTime(unsigned iterations, bool useStatementCache, ExceptionCode& ec)
+{
+    static const int recordCount = 1000;
+    static const char query[] = "SELECT value FROM Records WHERE key = ?";
+
+    SQLiteDatabase database;
+    if (!database.open(":memory:") || !database.executeCommand("CREATE TABLE Records (key INTEGER PRIMARY KEY, value TEXT)")) {
+        ec = INVALID_STATE_ERR;
+        return 0;
+    }
+
+    SQLiteTransaction transaction(database);
+    transaction.begin();
+    SQLiteStatement insertStatement(database, "INSERT INTO Records (key, value) VALUES (?, ?)");
+    if (insertStatement.prepare() != SQLResultOk) {
+        ec = INVALID_STATE_ERR;
+        return 0;
+    }
+    for (int i = 0; i < recordCount; ++i) {
+        insertStatement.bindInt(1, i);
+        insertStatement.bindText(2, "Record " + String::number(i));
+        insertStatement.step();
+        insertStatement.reset();
+    }
+    transaction.commit();
+
+    double startTime = monotonicallyIncreasingTime();
+    for (unsigned i = 0; i < iterations; ++i) {
+        int key = (i * 7919) % recordCount;
+        if (useStatementCache) {
+            SQLiteStatement* statement = database.cachedStatement(query);
+            if (!statement) {
+                ec = INVALID_STATE_ERR;
+                return 0;
+            }
+            statement->bindInt(1, key);
+            if (statement->step() == SQLResultRow)
+                statement->getColumnText(0);
+            statement->reset();
+        } else {
+            SQLiteStatement statement(database, query);
+            if (statement.prepare() != SQLResultOk) {
+                ec = INVALID_STATE_ERR;
+                return 0;
+            }
+            statement.bindInt(1, key);
+            if (statement.step() == SQLResultRow)
+                statement.getColumnText(0);
+        }
+    }
+    return (monotonicallyIncreasingTime() - startTime) * 1000;
+}
+
 #if ENABLE(INSPECTOR)
 Vector<String> Internals::consoleMessageArgumentCounts() const
 {
@@ -224,6 +224,18 @@ public:
 
     unsigned numberOfLiveNodes() const;
     unsigned numberOfLiveDocuments() const;
+    unsigned selectorQueryCacheHitCount() const;
+    unsigned selectorQueryCacheMissCount() const;
+
+    void resetShadowBlurStatistics();
+    unsigned shadowBlurCount() const;
+    unsigned shadowTemplateCacheHitCount() const;
+
+    void resetStyleResolverStatistics(bool collectPhaseTimes = false);
+    String styleResolverStatistics() const;
+    bool styleResolverSharesMatchedPropertiesCache(ExceptionCode&);
+
+    double sqliteRepeatedQueryTime(unsigned iterations, bool useStatementCache, ExceptionCode&);
 
 #if ENABLE(INSPECTOR)
     Vector<String> consoleMessageArgumentCounts() const;
@@ -88,8 +88,8 @@ private:
     void getRecord(uint64_t requestID, int64_t transactionID, int64_t objectStoreID, int64_t indexID, const WebCore::IDBKeyRangeData&, int64_t cursorType);
 
     void openCursor(uint64_t requestID, int64_t transactionID, int64_t objectStoreID, int64_t indexID, int64_t cursorDirection, int64_t cursorType, int64_t taskType, const WebCore::IDBKeyRangeData&);
-    void cursorAdvance(uint64_t requestID, int64_t cursorID, uint64_t count);
-    void cursorIterate(uint64_t requestID, int64_t cursorID, const WebCore::IDBKeyData&);
+    void cursorAdvance(uint64_t requestID, int64_t cursorID, uint64_t count, uint64_t prefetchedRecordsConsumed);
+    void cursorIterate(uint64_t requestID, int64_t cursorID, const WebCore::IDBKeyData&, uint64_t prefetchedRecordsConsumed);
 
     void count(uint64_t requestID, int64_t transactionID, int64_t objectStoreID, int64_t indexID, const WebCore::IDBKeyRangeData&);
     void deleteRange(uint64_t requestID, int64_t transactionID, int64_t objectStoreID, const WebCore::IDBKeyRangeData& keyRange);
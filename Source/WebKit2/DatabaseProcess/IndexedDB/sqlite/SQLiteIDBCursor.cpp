@@ -38,6 +38,14 @@ using namespace WebCore;
 
 namespace WebKit {
 
+// How many records a cursor reads ahead, starting small so that cursors used for just a few
+// records don't read much more than they need.
+static const unsigned initialPrefetchSize = 4;
+static const unsigned maximumPrefetchSize = 64;
+
+// Keeps large values from making the replies to the WebProcess huge.
+static const size_t maximumPrefetchBytes = 256 * 1024;
+
 std::unique_ptr<SQLiteIDBCursor> SQLiteIDBCursor::maybeCreate(SQLiteIDBTransaction* transaction, const IDBIdentifier& cursorIdentifier, int64_t objectStoreID, int64_t indexID, IndexedDB::CursorDirection cursorDirection, IndexedDB::CursorType cursorType, IDBDatabaseBackend::TaskType taskType, const IDBKeyRangeData& keyRange)
 {
     auto cursor = std::unique_ptr<SQLiteIDBCursor>(new SQLiteIDBCursor(transaction, cursorIdentifier, objectStoreID, indexID, cursorDirection, cursorType, taskType, keyRange));
@@ -63,6 +71,8 @@ SQLiteIDBCursor::SQLiteIDBCursor(SQLiteIDBTransaction* transaction, const IDBIde
     , m_boundID(0)
     , m_completed(false)
     , m_errored(false)
+    , m_prefetchedRecordsAreStale(false)
+    , m_prefetchSize(0)
 {
     ASSERT(m_objectStoreID);
 }
@@ -194,6 +204,11 @@ void SQLiteIDBCursor::objectStoreRecordsChanged()
     // This is to pick up any changes that might exist.
 
     m_statementNeedsReset = true;
+
+    // Records read ahead might have changed too. They are dropped in consumePrefetchedRecords(),
+    // once the cursor has moved past the ones the WebProcess already used.
+    if (!m_prefetchedRecords.isEmpty())
+        m_prefetchedRecordsAreStale = true;
 }
 
 void SQLiteIDBCursor::resetAndRebindStatement()
@@ -249,21 +264,124 @@ bool SQLiteIDBCursor::bindArguments()
 
 bool SQLiteIDBCursor::advance(uint64_t count)
 {
-    bool isUnique = m_cursorDirection == IndexedDB::CursorDirection::NextNoDuplicate || m_cursorDirection == IndexedDB::CursorDirection::PrevNoDuplicate;
-
     for (uint64_t i = 0; i < count; ++i) {
-        if (!isUnique) {
-            if (!advanceOnce())
-                return false;
-        } else {
-            if (!advanceUnique())
-                return false;
+        if (!m_prefetchedRecords.isEmpty()) {
+            ASSERT(!m_prefetchedRecordsAreStale);
+            takePrefetchedRecord();
+            continue;
         }
+
+        if (!advanceStep())
+            return false;
     }
 
     return true;
 }
 
+bool SQLiteIDBCursor::advanceStep()
+{
+    bool isUnique = m_cursorDirection == IndexedDB::CursorDirection::NextNoDuplicate || m_cursorDirection == IndexedDB::CursorDirection::PrevNoDuplicate;
+
+    return isUnique ? advanceUnique() : advanceOnce();
+}
+
+void SQLiteIDBCursor::takePrefetchedRecord()
+{
+    PrefetchedRecord prefetchedRecord = m_prefetchedRecords.takeFirst();
+
+    m_currentKey = WTF::move(prefetchedRecord.record.key);
+    m_currentPrimaryKey = WTF::move(prefetchedRecord.record.primaryKey);
+    m_currentValueBuffer = WTF::move(prefetchedRecord.record.valueBuffer);
+    m_currentRecordID = prefetchedRecord.recordID;
+    m_completed = m_currentKey.isNull;
+}
+
+void SQLiteIDBCursor::prefetchRecords()
+{
+    ASSERT(!m_prefetchedRecordsAreStale);
+    ASSERT(!m_statementNeedsReset || m_prefetchedRecords.isEmpty());
+
+    m_prefetchSize = std::min(std::max(m_prefetchSize * 2, initialPrefetchSize), maximumPrefetchSize);
+
+    if (m_completed || m_errored)
+        return;
+
+    if (!m_prefetchedRecords.isEmpty() && m_prefetchedRecords.last().record.key.isNull)
+        return;
+
+    // The statement is stepped from the last record read ahead, so move there, and back to the
+    // current record when done.
+    IDBKeyData currentKey = m_currentKey;
+    IDBKeyData currentPrimaryKey = m_currentPrimaryKey;
+    Vector<uint8_t> currentValueBuffer = m_currentValueBuffer;
+    int64_t currentRecordID = m_currentRecordID;
+
+    size_t prefetchedBytes = 0;
+    for (auto& prefetchedRecord : m_prefetchedRecords)
+        prefetchedBytes += prefetchedRecord.record.valueBuffer.size();
+
+    if (!m_prefetchedRecords.isEmpty()) {
+        const PrefetchedRecord& lastRecord = m_prefetchedRecords.last();
+        m_currentKey = lastRecord.record.key;
+        m_currentPrimaryKey = lastRecord.record.primaryKey;
+        m_currentValueBuffer = lastRecord.record.valueBuffer;
+        m_currentRecordID = lastRecord.recordID;
+    }
+
+    bool succeeded = true;
+    while (m_prefetchedRecords.size() < m_prefetchSize && prefetchedBytes < maximumPrefetchBytes) {
+        if (!advanceStep()) {
+            succeeded = false;
+            break;
+        }
+
+        PrefetchedRecord prefetchedRecord = { { m_currentKey, m_currentPrimaryKey, m_currentValueBuffer }, m_currentRecordID };
+        m_prefetchedRecords.append(WTF::move(prefetchedRecord));
+        prefetchedBytes += m_currentValueBuffer.size();
+
+        if (m_completed)
+            break;
+    }
+
+    m_currentKey = WTF::move(currentKey);
+    m_currentPrimaryKey = WTF::move(currentPrimaryKey);
+    m_currentValueBuffer = WTF::move(currentValueBuffer);
+    m_currentRecordID = currentRecordID;
+    m_completed = false;
+
+    if (!succeeded) {
+        // Start over from the current record, so that the error is reported if and when the
+        // WebProcess actually advances to the record that could not be read.
+        LOG(IDB, "Failed to prefetch records for cursor %lli", m_cursorIdentifier.id());
+        m_prefetchedRecords.clear();
+        m_errored = false;
+        m_statementNeedsReset = true;
+    }
+}
+
+void SQLiteIDBCursor::consumePrefetchedRecords(uint64_t count)
+{
+    ASSERT(count <= m_prefetchedRecords.size());
+
+    for (uint64_t i = 0; i < count && !m_prefetchedRecords.isEmpty(); ++i)
+        takePrefetchedRecord();
+
+    if (m_prefetchedRecordsAreStale) {
+        m_prefetchedRecords.clear();
+        m_prefetchedRecordsAreStale = false;
+    }
+}
+
+Vector<IDBCursorRecord> SQLiteIDBCursor::prefetchedRecords() const
+{
+    Vector<IDBCursorRecord> records;
+    records.reserveInitialCapacity(m_prefetchedRecords.size());
+    for (auto& prefetchedRecord : m_prefetchedRecords)
+        records.uncheckedAppend(prefetchedRecord.record);
+
+    return records;
+}
+
 bool SQLiteIDBCursor::advanceUnique()
 {
     IDBKeyData currentKey = m_currentKey;
@@ -356,21 +474,21 @@ SQLiteIDBCursor::AdvanceResult SQLiteIDBCursor::internalAdvanceOnce()
             return AdvanceResult::Failure;
         }
 
-        SQLiteStatement objectStoreStatement(*m_statement->database(), "SELECT value FROM Records WHERE key = CAST(? AS TEXT) and objectStoreID = ?;");
+        SQLiteStatement* objectStoreStatement = m_transaction->cachedStatement(SQLiteIDBTransaction::SQL::GetIndexedRecordValue, "SELECT value FROM Records WHERE key = CAST(? AS TEXT) and objectStoreID = ?;");
 
-        if (objectStoreStatement.prepare() != SQLResultOk
-            || objectStoreStatement.bindBlob(1, m_currentValueBuffer.data(), m_currentValueBuffer.size()) != SQLResultOk
-            || objectStoreStatement.bindInt64(2, m_objectStoreID) != SQLResultOk) {
+        if (!objectStoreStatement
+            || objectStoreStatement->bindBlob(1, m_currentValueBuffer.data(), m_currentValueBuffer.size()) != SQLResultOk
+            || objectStoreStatement->bindInt64(2, m_objectStoreID) != SQLResultOk) {
             LOG_ERROR("Could not create index cursor statement into object store records (%i) '%s'", m_statement->database()->lastError(), m_statement->database()->lastErrorMsg());
             m_completed = true;
             m_errored = true;
             return AdvanceResult::Failure;
         }
 
-        int result = objectStoreStatement.step();
+        int result = objectStoreStatement->step();
 
         if (result == SQLResultRow)
-            objectStoreStatement.getColumnBlobAsVector(0, m_currentValueBuffer);
+            objectStoreStatement->getColumnBlobAsVector(0, m_currentValueBuffer);
         else if (result == SQLResultDone) {
             // This indicates that the record we're trying to retrieve has been removed from the object store.
             // Skip over it.
@@ -27,11 +27,13 @@
 
 #if ENABLE(INDEXED_DATABASE) && ENABLE(DATABASE_PROCESS)
 
+#include "IDBCursorRecord.h"
 #include "IDBIdentifier.h"
 #include <WebCore/IDBDatabaseBackend.h>
 #include <WebCore/IDBKeyData.h>
 #include <WebCore/IDBKeyRangeData.h>
 #include <WebCore/SQLiteStatement.h>
+#include <wtf/Deque.h>
 #include <wtf/Noncopyable.h>
 
 namespace WebCore {
@@ -69,6 +71,13 @@ public:
 
     void objectStoreRecordsChanged();
 
+    // The records following the current one are read ahead and sent to the WebProcess, which then
+    // advances through them without asking the DatabaseProcess. Before the next advance or iterate,
+    // the WebProcess reports how many of them it used so the cursor can move past them here too.
+    void prefetchRecords();
+    void consumePrefetchedRecords(uint64_t count);
+    Vector<IDBCursorRecord> prefetchedRecords() const;
+
 private:
     SQLiteIDBCursor(SQLiteIDBTransaction*, const IDBIdentifier& cursorIdentifier, int64_t objectStoreID, int64_t indexID, WebCore::IndexedDB::CursorDirection, WebCore::IndexedDB::CursorType, WebCore::IDBDatabaseBackend::TaskType, const WebCore::IDBKeyRangeData&);
 
@@ -87,6 +96,9 @@ private:
     AdvanceResult internalAdvanceOnce();
     bool advanceOnce();
     bool advanceUnique();
+    bool advanceStep();
+
+    void takePrefetchedRecord();
 
     SQLiteIDBTransaction* m_transaction;
     IDBIdentifier m_cursorIdentifier;
@@ -109,6 +121,15 @@ private:
 
     bool m_completed;
     bool m_errored;
+
+    struct PrefetchedRecord {
+        IDBCursorRecord record;
+        int64_t recordID;
+    };
+
+    Deque<PrefetchedRecord> m_prefetchedRecords;
+    bool m_prefetchedRecordsAreStale;
+    unsigned m_prefetchSize;
 };
 
 } // namespace WebKit
@@ -30,6 +30,7 @@
 #include "SQLiteIDBCursor.h"
 #include "UniqueIDBDatabaseBackingStoreSQLite.h"
 #include <WebCore/IndexedDB.h>
+#include <WebCore/SQLiteStatement.h>
 #include <WebCore/SQLiteTransaction.h>
 
 using namespace WebCore;
@@ -47,6 +48,8 @@ SQLiteIDBTransaction::SQLiteIDBTransaction(UniqueIDBDatabaseBackingStoreSQLite&
 
 SQLiteIDBTransaction::~SQLiteIDBTransaction()
 {
+    clearCachedStatements();
+
     if (inProgress())
         m_sqliteTransaction->rollback();
 
@@ -72,6 +75,7 @@ bool SQLiteIDBTransaction::commit()
     if (!m_sqliteTransaction || !m_sqliteTransaction->inProgress())
         return false;
 
+    clearCachedStatements();
     m_sqliteTransaction->commit();
 
     return !m_sqliteTransaction->inProgress();
@@ -79,6 +83,7 @@ bool SQLiteIDBTransaction::commit()
 
 bool SQLiteIDBTransaction::reset()
 {
+    clearCachedStatements();
     m_sqliteTransaction = nullptr;
     clearCursors();
 
@@ -88,12 +93,40 @@ bool SQLiteIDBTransaction::reset()
 bool SQLiteIDBTransaction::rollback()
 {
     ASSERT(m_sqliteTransaction);
+    clearCachedStatements();
     if (m_sqliteTransaction->inProgress())
         m_sqliteTransaction->rollback();
 
     return true;
 }
 
+SQLiteStatement* SQLiteIDBTransaction::cachedStatement(SQL sql, const char* query)
+{
+    ASSERT(m_sqliteTransaction);
+    ASSERT(sql < SQL::Count);
+
+    auto& statement = m_cachedStatements[static_cast<size_t>(sql)];
+    if (statement) {
+        // The result of reset() is the error from the last step, if any, which doesn't matter here.
+        statement->reset();
+        return statement.get();
+    }
+
+    statement = std::make_unique<SQLiteStatement>(m_sqliteTransaction->database(), query);
+    if (statement->prepare() != SQLResultOk) {
+        LOG_ERROR("Could not prepare cached statement '%s' - %s", query, m_sqliteTransaction->database().lastErrorMsg());
+        statement = nullptr;
+    }
+
+    return statement.get();
+}
+
+void SQLiteIDBTransaction::clearCachedStatements()
+{
+    for (auto& statement : m_cachedStatements)
+        statement = nullptr;
+}
+
 SQLiteIDBCursor* SQLiteIDBTransaction::openCursor(int64_t objectStoreID, int64_t indexID, IndexedDB::CursorDirection cursorDirection, IndexedDB::CursorType cursorType, IDBDatabaseBackend::TaskType taskType, const IDBKeyRangeData& keyRange)
 {
     ASSERT(m_sqliteTransaction);
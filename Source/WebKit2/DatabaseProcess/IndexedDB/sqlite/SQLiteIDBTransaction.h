@@ -36,6 +36,7 @@
 namespace WebCore {
 
 class SQLiteDatabase;
+class SQLiteStatement;
 class SQLiteTransaction;
 
 namespace IndexedDB {
@@ -80,10 +81,29 @@ public:
 
     WebCore::SQLiteTransaction* sqliteTransaction() const { return m_sqliteTransaction.get(); }
 
+    // Statements run for every record are prepared once per transaction and reset before each use.
+    enum class SQL {
+        GetKeyGeneratorValue,
+        SetKeyGeneratorValue,
+        KeyExistsInObjectStore,
+        PutRecord,
+        PutIndexRecord,
+        DeleteRecord,
+        DeleteIndexRecords,
+        GetRecord,
+        GetKeyRangeRecord,
+        GetIndexedRecordValue,
+        Count
+    };
+
+    // Returns nullptr if the statement could not be prepared.
+    WebCore::SQLiteStatement* cachedStatement(SQL, const char* query);
+
 private:
     SQLiteIDBTransaction(UniqueIDBDatabaseBackingStoreSQLite&, const IDBIdentifier& transactionIdentifier, WebCore::IndexedDB::TransactionMode);
 
     void clearCursors();
+    void clearCachedStatements();
 
     IDBIdentifier m_identifier;
     WebCore::IndexedDB::TransactionMode m_mode;
@@ -91,6 +111,7 @@ private:
     UniqueIDBDatabaseBackingStoreSQLite& m_backingStore;
     std::unique_ptr<WebCore::SQLiteTransaction> m_sqliteTransaction;
     HashMap<IDBIdentifier, std::unique_ptr<SQLiteIDBCursor>> m_cursors;
+    std::unique_ptr<WebCore::SQLiteStatement> m_cachedStatements[static_cast<size_t>(SQL::Count)];
 };
 
 } // namespace WebKit
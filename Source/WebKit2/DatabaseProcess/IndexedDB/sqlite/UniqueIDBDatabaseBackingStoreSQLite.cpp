@@ -655,7 +655,7 @@ bool UniqueIDBDatabaseBackingStoreSQLite::createIndex(const IDBIdentifier& trans
         generateIndexKeysForValue(m_globalObject->globalExec(), metadata, value, indexKeys);
 
         for (auto& indexKey : indexKeys) {
-            if (!uncheckedPutIndexRecord(objectStoreID, metadata.id, key, indexKey)) {
+            if (!uncheckedPutIndexRecord(*transaction, objectStoreID, metadata.id, key, indexKey)) {
                 LOG_ERROR("Unable to put index record for newly created index");
                 return false;
             }
@@ -734,19 +734,19 @@ bool UniqueIDBDatabaseBackingStoreSQLite::generateKeyNumber(const IDBIdentifier&
 
     int64_t currentValue;
     {
-        SQLiteStatement sql(*m_sqliteDB, ASCIILiteral("SELECT currentKey FROM KeyGenerators WHERE objectStoreID = ?;"));
-        if (sql.prepare() != SQLResultOk
-            || sql.bindInt64(1, objectStoreID) != SQLResultOk) {
+        SQLiteStatement* sql = transaction->cachedStatement(SQLiteIDBTransaction::SQL::GetKeyGeneratorValue, "SELECT currentKey FROM KeyGenerators WHERE objectStoreID = ?;");
+        if (!sql
+            || sql->bindInt64(1, objectStoreID) != SQLResultOk) {
             LOG_ERROR("Could not delete index id %lli from IndexInfo table (%i) - %s", objectStoreID, m_sqliteDB->lastError(), m_sqliteDB->lastErrorMsg());
             return false;
         }
-        int result = sql.step();
+        int result = sql->step();
         if (result != SQLResultRow) {
             LOG_ERROR("Could not retreive key generator value for object store, but it should be there.");
             return false;
         }
 
-        currentValue = sql.getColumnInt64(0);
+        currentValue = sql->getColumnInt64(0);
     }
 
     if (currentValue < 0 || currentValue > maxGeneratorValue)
@@ -773,11 +773,11 @@ bool UniqueIDBDatabaseBackingStoreSQLite::updateKeyGeneratorNumber(const IDBIden
     }
 
     {
-        SQLiteStatement sql(*m_sqliteDB, ASCIILiteral("INSERT INTO KeyGenerators VALUES (?, ?);"));
-        if (sql.prepare() != SQLResultOk
-            || sql.bindInt64(1, objectStoreID) != SQLResultOk
-            || sql.bindInt64(2, keyNumber) != SQLResultOk
-            || sql.step() != SQLResultDone) {
+        SQLiteStatement* sql = transaction->cachedStatement(SQLiteIDBTransaction::SQL::SetKeyGeneratorValue, "INSERT INTO KeyGenerators VALUES (?, ?);");
+        if (!sql
+            || sql->bindInt64(1, objectStoreID) != SQLResultOk
+            || sql->bindInt64(2, keyNumber) != SQLResultOk
+            || sql->step() != SQLResultDone) {
             LOG_ERROR("Could not update key generator value (%i) - %s", m_sqliteDB->lastError(), m_sqliteDB->lastErrorMsg());
             return false;
         }
@@ -806,15 +806,15 @@ bool UniqueIDBDatabaseBackingStoreSQLite::keyExistsInObjectStore(const IDBIdenti
         return false;
     }
 
-    SQLiteStatement sql(*m_sqliteDB, ASCIILiteral("SELECT key FROM Records WHERE objectStoreID = ? AND key = CAST(? AS TEXT) LIMIT 1;"));
-    if (sql.prepare() != SQLResultOk
-        || sql.bindInt64(1, objectStoreID) != SQLResultOk
-        || sql.bindBlob(2, keyBuffer->data(), keyBuffer->size()) != SQLResultOk) {
+    SQLiteStatement* sql = transaction->cachedStatement(SQLiteIDBTransaction::SQL::KeyExistsInObjectStore, "SELECT key FROM Records WHERE objectStoreID = ? AND key = CAST(? AS TEXT) LIMIT 1;");
+    if (!sql
+        || sql->bindInt64(1, objectStoreID) != SQLResultOk
+        || sql->bindBlob(2, keyBuffer->data(), keyBuffer->size()) != SQLResultOk) {
         LOG_ERROR("Could not get record from object store %lli from Records table (%i) - %s", objectStoreID, m_sqliteDB->lastError(), m_sqliteDB->lastErrorMsg());
         return false;
     }
 
-    int sqlResult = sql.step();
+    int sqlResult = sql->step();
     if (sqlResult == SQLResultOk || sqlResult == SQLResultDone) {
         keyExists = false;
         return true;
@@ -852,12 +852,12 @@ bool UniqueIDBDatabaseBackingStoreSQLite::putRecord(const IDBIdentifier& transac
         return false;
     }
     {
-        SQLiteStatement sql(*m_sqliteDB, ASCIILiteral("INSERT INTO Records VALUES (?, CAST(? AS TEXT), ?);"));
-        if (sql.prepare() != SQLResultOk
-            || sql.bindInt64(1, objectStoreID) != SQLResultOk
-            || sql.bindBlob(2, keyBuffer->data(), keyBuffer->size()) != SQLResultOk
-            || sql.bindBlob(3, valueBuffer, valueSize) != SQLResultOk
-            || sql.step() != SQLResultDone) {
+        SQLiteStatement* sql = transaction->cachedStatement(SQLiteIDBTransaction::SQL::PutRecord, "INSERT INTO Records VALUES (?, CAST(? AS TEXT), ?);");
+        if (!sql
+            || sql->bindInt64(1, objectStoreID) != SQLResultOk
+            || sql->bindBlob(2, keyBuffer->data(), keyBuffer->size()) != SQLResultOk
+            || sql->bindBlob(3, valueBuffer, valueSize) != SQLResultOk
+            || sql->step() != SQLResultDone) {
             LOG_ERROR("Could not put record for object store %lli in Records table (%i) - %s", objectStoreID, m_sqliteDB->lastError(), m_sqliteDB->lastErrorMsg());
             return false;
         }
@@ -882,10 +882,10 @@ bool UniqueIDBDatabaseBackingStoreSQLite::putIndexRecord(const IDBIdentifier& tr
         return false;
     }
 
-    return uncheckedPutIndexRecord(objectStoreID, indexID, keyValue, indexKey);
+    return uncheckedPutIndexRecord(*transaction, objectStoreID, indexID, keyValue, indexKey);
 }
 
-bool UniqueIDBDatabaseBackingStoreSQLite::uncheckedPutIndexRecord(int64_t objectStoreID, int64_t indexID, const WebCore::IDBKeyData& keyValue, const WebCore::IDBKeyData& indexKey)
+bool UniqueIDBDatabaseBackingStoreSQLite::uncheckedPutIndexRecord(SQLiteIDBTransaction& transaction, int64_t objectStoreID, int64_t indexID, const WebCore::IDBKeyData& keyValue, const WebCore::IDBKeyData& indexKey)
 {
     RefPtr<SharedBuffer> indexKeyBuffer = serializeIDBKeyData(indexKey);
     if (!indexKeyBuffer) {
@@ -899,13 +899,13 @@ bool UniqueIDBDatabaseBackingStoreSQLite::uncheckedPutIndexRecord(int64_t object
         return false;
     }
     {
-        SQLiteStatement sql(*m_sqliteDB, ASCIILiteral("INSERT INTO IndexRecords VALUES (?, ?, CAST(? AS TEXT), CAST(? AS TEXT));"));
-        if (sql.prepare() != SQLResultOk
-            || sql.bindInt64(1, indexID) != SQLResultOk
-            || sql.bindInt64(2, objectStoreID) != SQLResultOk
-            || sql.bindBlob(3, indexKeyBuffer->data(), indexKeyBuffer->size()) != SQLResultOk
-            || sql.bindBlob(4, valueBuffer->data(), valueBuffer->size()) != SQLResultOk
-            || sql.step() != SQLResultDone) {
+        SQLiteStatement* sql = transaction.cachedStatement(SQLiteIDBTransaction::SQL::PutIndexRecord, "INSERT INTO IndexRecords VALUES (?, ?, CAST(? AS TEXT), CAST(? AS TEXT));");
+        if (!sql
+            || sql->bindInt64(1, indexID) != SQLResultOk
+            || sql->bindInt64(2, objectStoreID) != SQLResultOk
+            || sql->bindBlob(3, indexKeyBuffer->data(), indexKeyBuffer->size()) != SQLResultOk
+            || sql->bindBlob(4, valueBuffer->data(), valueBuffer->size()) != SQLResultOk
+            || sql->step() != SQLResultDone) {
             LOG_ERROR("Could not put index record for index %lli in object store %lli in Records table (%i) - %s", indexID, objectStoreID, m_sqliteDB->lastError(), m_sqliteDB->lastErrorMsg());
             return false;
         }
@@ -1044,12 +1044,12 @@ bool UniqueIDBDatabaseBackingStoreSQLite::deleteRecord(SQLiteIDBTransaction& tra
 
     // Delete record from object store
     {
-        SQLiteStatement sql(*m_sqliteDB, ASCIILiteral("DELETE FROM Records WHERE objectStoreID = ? AND key = CAST(? AS TEXT);"));
+        SQLiteStatement* sql = transaction.cachedStatement(SQLiteIDBTransaction::SQL::DeleteRecord, "DELETE FROM Records WHERE objectStoreID = ? AND key = CAST(? AS TEXT);");
 
-        if (sql.prepare() != SQLResultOk
-            || sql.bindInt64(1, objectStoreID) != SQLResultOk
-            || sql.bindBlob(2, keyBuffer->data(), keyBuffer->size()) != SQLResultOk
-            || sql.step() != SQLResultDone) {
+        if (!sql
+            || sql->bindInt64(1, objectStoreID) != SQLResultOk
+            || sql->bindBlob(2, keyBuffer->data(), keyBuffer->size()) != SQLResultOk
+            || sql->step() != SQLResultDone) {
             LOG_ERROR("Could not delete record from object store %lli (%i) - %s", objectStoreID, m_sqliteDB->lastError(), m_sqliteDB->lastErrorMsg());
             return false;
         }
@@ -1057,12 +1057,12 @@ bool UniqueIDBDatabaseBackingStoreSQLite::deleteRecord(SQLiteIDBTransaction& tra
 
     // Delete record from indexes store
     {
-        SQLiteStatement sql(*m_sqliteDB, ASCIILiteral("DELETE FROM IndexRecords WHERE objectStoreID = ? AND value = CAST(? AS TEXT);"));
+        SQLiteStatement* sql = transaction.cachedStatement(SQLiteIDBTransaction::SQL::DeleteIndexRecords, "DELETE FROM IndexRecords WHERE objectStoreID = ? AND value = CAST(? AS TEXT);");
 
-        if (sql.prepare() != SQLResultOk
-            || sql.bindInt64(1, objectStoreID) != SQLResultOk
-            || sql.bindBlob(2, keyBuffer->data(), keyBuffer->size()) != SQLResultOk
-            || sql.step() != SQLResultDone) {
+        if (!sql
+            || sql->bindInt64(1, objectStoreID) != SQLResultOk
+            || sql->bindBlob(2, keyBuffer->data(), keyBuffer->size()) != SQLResultOk
+            || sql->step() != SQLResultDone) {
             LOG_ERROR("Could not delete record from indexes for object store %lli (%i) - %s", objectStoreID, m_sqliteDB->lastError(), m_sqliteDB->lastErrorMsg());
             return false;
         }
@@ -1090,15 +1090,15 @@ bool UniqueIDBDatabaseBackingStoreSQLite::getKeyRecordFromObjectStore(const IDBI
     }
 
     {
-        SQLiteStatement sql(*m_sqliteDB, ASCIILiteral("SELECT value FROM Records WHERE objectStoreID = ? AND key = CAST(? AS TEXT);"));
-        if (sql.prepare() != SQLResultOk
-            || sql.bindInt64(1, objectStoreID) != SQLResultOk
-            || sql.bindBlob(2, keyBuffer->data(), keyBuffer->size()) != SQLResultOk) {
+        SQLiteStatement* sql = transaction->cachedStatement(SQLiteIDBTransaction::SQL::GetRecord, "SELECT value FROM Records WHERE objectStoreID = ? AND key = CAST(? AS TEXT);");
+        if (!sql
+            || sql->bindInt64(1, objectStoreID) != SQLResultOk
+            || sql->bindBlob(2, keyBuffer->data(), keyBuffer->size()) != SQLResultOk) {
             LOG_ERROR("Could not get record from object store %lli from Records table (%i) - %s", objectStoreID, m_sqliteDB->lastError(), m_sqliteDB->lastErrorMsg());
             return false;
         }
 
-        int sqlResult = sql.step();
+        int sqlResult = sql->step();
         if (sqlResult == SQLResultOk || sqlResult == SQLResultDone) {
             // There was no record for the key in the database.
             return true;
@@ -1110,7 +1110,7 @@ bool UniqueIDBDatabaseBackingStoreSQLite::getKeyRecordFromObjectStore(const IDBI
         }
 
         Vector<char> buffer;
-        sql.getColumnBlobAsVector(0, buffer);
+        sql->getColumnBlobAsVector(0, buffer);
         result = SharedBuffer::create(static_cast<const char*>(buffer.data()), buffer.size());
     }
 
@@ -1142,16 +1142,16 @@ bool UniqueIDBDatabaseBackingStoreSQLite::getKeyRangeRecordFromObjectStore(const
     }
 
     {
-        SQLiteStatement sql(*m_sqliteDB, ASCIILiteral("SELECT value FROM Records WHERE objectStoreID = ? AND key >= CAST(? AS TEXT) AND key <= CAST(? AS TEXT) ORDER BY key;"));
-        if (sql.prepare() != SQLResultOk
-            || sql.bindInt64(1, objectStoreID) != SQLResultOk
-            || sql.bindBlob(2, lowerBuffer->data(), lowerBuffer->size()) != SQLResultOk
-            || sql.bindBlob(3, upperBuffer->data(), upperBuffer->size()) != SQLResultOk) {
+        SQLiteStatement* sql = transaction->cachedStatement(SQLiteIDBTransaction::SQL::GetKeyRangeRecord, "SELECT value FROM Records WHERE objectStoreID = ? AND key >= CAST(? AS TEXT) AND key <= CAST(? AS TEXT) ORDER BY key;");
+        if (!sql
+            || sql->bindInt64(1, objectStoreID) != SQLResultOk
+            || sql->bindBlob(2, lowerBuffer->data(), lowerBuffer->size()) != SQLResultOk
+            || sql->bindBlob(3, upperBuffer->data(), upperBuffer->size()) != SQLResultOk) {
             LOG_ERROR("Could not get key range record from object store %lli from Records table (%i) - %s", objectStoreID, m_sqliteDB->lastError(), m_sqliteDB->lastErrorMsg());
             return false;
         }
 
-        int sqlResult = sql.step();
+        int sqlResult = sql->step();
 
         if (sqlResult == SQLResultOk || sqlResult == SQLResultDone) {
             // There was no record for the key in the database.
@@ -1164,7 +1164,7 @@ bool UniqueIDBDatabaseBackingStoreSQLite::getKeyRangeRecordFromObjectStore(const
         }
 
         Vector<char> buffer;
-        sql.getColumnBlobAsVector(0, buffer);
+        sql->getColumnBlobAsVector(0, buffer);
         result = SharedBuffer::create(static_cast<const char*>(buffer.data()), buffer.size());
     }
 
@@ -1201,7 +1201,7 @@ bool UniqueIDBDatabaseBackingStoreSQLite::count(const IDBIdentifier& transaction
     return true;
 }
 
-bool UniqueIDBDatabaseBackingStoreSQLite::openCursor(const IDBIdentifier& transactionIdentifier, int64_t objectStoreID, int64_t indexID, IndexedDB::CursorDirection cursorDirection, IndexedDB::CursorType cursorType, IDBDatabaseBackend::TaskType taskType, const IDBKeyRangeData& keyRange, int64_t& cursorID, IDBKeyData& key, IDBKeyData& primaryKey, Vector<uint8_t>& valueBuffer)
+bool UniqueIDBDatabaseBackingStoreSQLite::openCursor(const IDBIdentifier& transactionIdentifier, int64_t objectStoreID, int64_t indexID, IndexedDB::CursorDirection cursorDirection, IndexedDB::CursorType cursorType, IDBDatabaseBackend::TaskType taskType, const IDBKeyRangeData& keyRange, int64_t& cursorID, IDBKeyData& key, IDBKeyData& primaryKey, Vector<uint8_t>& valueBuffer, Vector<IDBCursorRecord>& prefetchedRecords)
 {
     ASSERT(!RunLoop::isMain());
     ASSERT(m_sqliteDB);
@@ -1223,10 +1223,13 @@ bool UniqueIDBDatabaseBackingStoreSQLite::openCursor(const IDBIdentifier& transa
     primaryKey = cursor->currentPrimaryKey();
     valueBuffer = cursor->currentValueBuffer();
 
+    cursor->prefetchRecords();
+    prefetchedRecords = cursor->prefetchedRecords();
+
     return true;
 }
 
-bool UniqueIDBDatabaseBackingStoreSQLite::advanceCursor(const IDBIdentifier& cursorIdentifier, uint64_t count, IDBKeyData& key, IDBKeyData& primaryKey, Vector<uint8_t>& valueBuffer)
+bool UniqueIDBDatabaseBackingStoreSQLite::advanceCursor(const IDBIdentifier& cursorIdentifier, uint64_t count, uint64_t prefetchedRecordsConsumed, IDBKeyData& key, IDBKeyData& primaryKey, Vector<uint8_t>& valueBuffer, Vector<IDBCursorRecord>& prefetchedRecords)
 {
     ASSERT(!RunLoop::isMain());
     ASSERT(m_sqliteDB);
@@ -1242,6 +1245,8 @@ bool UniqueIDBDatabaseBackingStoreSQLite::advanceCursor(const IDBIdentifier& cur
         return false;
     }
 
+    cursor->consumePrefetchedRecords(prefetchedRecordsConsumed);
+
     if (!cursor->advance(count)) {
         LOG_ERROR("Attempt to advance cursor %lli steps failed", count);
         return false;
@@ -1251,10 +1256,13 @@ bool UniqueIDBDatabaseBackingStoreSQLite::advanceCursor(const IDBIdentifier& cur
     primaryKey = cursor->currentPrimaryKey();
     valueBuffer = cursor->currentValueBuffer();
 
+    cursor->prefetchRecords();
+    prefetchedRecords = cursor->prefetchedRecords();
+
     return true;
 }
 
-bool UniqueIDBDatabaseBackingStoreSQLite::iterateCursor(const IDBIdentifier& cursorIdentifier, const IDBKeyData& targetKey, IDBKeyData& key, IDBKeyData& primaryKey, Vector<uint8_t>& valueBuffer)
+bool UniqueIDBDatabaseBackingStoreSQLite::iterateCursor(const IDBIdentifier& cursorIdentifier, const IDBKeyData& targetKey, uint64_t prefetchedRecordsConsumed, IDBKeyData& key, IDBKeyData& primaryKey, Vector<uint8_t>& valueBuffer, Vector<IDBCursorRecord>& prefetchedRecords)
 {
     ASSERT(!RunLoop::isMain());
     ASSERT(m_sqliteDB);
@@ -1270,6 +1278,8 @@ bool UniqueIDBDatabaseBackingStoreSQLite::iterateCursor(const IDBIdentifier& cur
         return false;
     }
 
+    cursor->consumePrefetchedRecords(prefetchedRecordsConsumed);
+
     if (!cursor->iterate(targetKey)) {
         LOG_ERROR("Attempt to iterate cursor failed");
         return false;
@@ -1279,6 +1289,9 @@ bool UniqueIDBDatabaseBackingStoreSQLite::iterateCursor(const IDBIdentifier& cur
     primaryKey = cursor->currentPrimaryKey();
     valueBuffer = cursor->currentValueBuffer();
 
+    cursor->prefetchRecords();
+    prefetchedRecords = cursor->prefetchedRecords();
+
     return true;
 }
 
@@ -33,6 +33,7 @@
 #include "AuthenticationManager.h"
 #include "CustomProtocolManager.h"
 #include "Logging.h"
+#include "MessageStatistics.h"
 #include "NetworkConnectionToWebProcess.h"
 #include "NetworkProcessCreationParameters.h"
 #include "NetworkProcessPlatformStrategies.h"
@@ -262,6 +263,7 @@ void NetworkProcess::getNetworkProcessStatistics(uint64_t callbackID)
     data.statisticsNumbers.set("LoadsActiveCount", scheduler.loadsActiveCount());
     data.statisticsNumbers.set("DownloadsActiveCount", shared().downloadManager().activeDownloadCount());
     data.statisticsNumbers.set("OutstandingAuthenticationChallengesCount", shared().authenticationManager().outstandingAuthenticationChallengeCount());
+    IPC::MessageStatistics::shared().addStatistics(data.statisticsNumbers, ASCIILiteral("NetworkProcess"));
 
     parentProcessConnection()->send(Messages::WebContext::DidGetStatistics(data, callbackID), 0);
 }
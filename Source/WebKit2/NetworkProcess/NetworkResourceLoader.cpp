@@ -31,6 +31,7 @@
 #include "AuthenticationManager.h"
 #include "DataReference.h"
 #include "Logging.h"
+#include "MessageStatistics.h"
 #include "NetworkBlobRegistry.h"
 #include "NetworkConnectionToWebProcess.h"
 #include "NetworkProcess.h"
@@ -56,6 +57,18 @@ using namespace WebCore;
 
 namespace WebKit {
 
+// Data that arrives within this many seconds of a delivery is held back and sent along with the next one.
+static const double dataDeliveryDeadline = 0.016;
+static const size_t minimumDataChunkSize = 8 * 1024;
+#if USE(UNIX_DOMAIN_SOCKETS)
+// A full chunk, with the rest of its DidReceiveData message, still goes through the message ring of the connection.
+static const size_t maximumDataMessageHeaderSize = 256;
+static const size_t maximumDataChunkSize = IPC::Connection::maximumMessageRingBodySize - maximumDataMessageHeaderSize;
+COMPILE_ASSERT(maximumDataChunkSize + maximumDataMessageHeaderSize <= IPC::Connection::maximumMessageRingBodySize, DataChunkFitsInMessageRing);
+#else
+static const size_t maximumDataChunkSize = 512 * 1024;
+#endif
+
 struct NetworkResourceLoader::SynchronousLoadData {
         SynchronousLoadData(WebCore::ResourceRequest& request, PassRefPtr<Messages::NetworkConnectionToWebProcess::PerformSynchronousLoad::DelayedReply> reply)
         : m_originalRequest(request)
@@ -99,6 +112,11 @@ NetworkResourceLoader::NetworkResourceLoader(const NetworkResourceLoadParameters
     , m_defersLoading(parameters.defersLoading)
     , m_sandboxExtensionsAreConsumed(false)
     , m_connection(connection)
+    , m_pendingEncodedDataLength(0)
+    , m_dataChunkSize(minimumDataChunkSize)
+    , m_lastDataDeliveryTime(0)
+    , m_dataMessageCount(0)
+    , m_dataDeliveryTimer(RunLoop::main(), this, &NetworkResourceLoader::dataDeliveryTimerFired)
 {
     // Either this loader has both a webPageID and webFrameID, or it is not allowed to ask the client for authentication credentials.
     // FIXME: This is necessary because of the existence of EmptyFrameLoaderClient in WebCore.
@@ -139,6 +157,9 @@ NetworkResourceLoader::~NetworkResourceLoader()
     ASSERT(RunLoop::isMain());
     ASSERT(!m_handle);
     ASSERT(!isSynchronous() || !m_synchronousLoadData->m_delayedReply);
+
+    if (IPC::MessageStatistics::shared().isEnabled() && !isSynchronous())
+        IPC::MessageStatistics::shared().addSample(ASCIILiteral("NetworkResourceLoader data messages per load"), m_dataMessageCount);
 }
 
 bool NetworkResourceLoader::isSynchronous() const
@@ -185,6 +206,9 @@ void NetworkResourceLoader::cleanup()
 
     invalidateSandboxExtensions();
 
+    m_dataDeliveryTimer.stop();
+    m_pendingData = nullptr;
+
     // Tell the scheduler about this finished loader soon so it can start more network requests.
     NetworkProcess::shared().networkResourceLoadScheduler().removeLoader(this);
 
@@ -247,7 +271,57 @@ void NetworkResourceLoader::didReceiveBuffer(ResourceHandle* handle, PassRefPtr<
         m_bufferedData->append(buffer.get());
         return;
     }
-    sendBuffer(buffer.get(), encodedDataLength);
+
+    // The first data is not held back, so that the WebProcess can start parsing right away.
+    if (!m_dataMessageCount) {
+        m_lastDataDeliveryTime = monotonicallyIncreasingTime();
+        sendBuffer(buffer.get(), encodedDataLength);
+        return;
+    }
+
+    // Send what is held back first if the new data would take the chunk past its maximum size.
+    if (m_pendingData && m_pendingData->size() + buffer->size() > maximumDataChunkSize)
+        sendPendingData();
+
+    if (!m_pendingData)
+        m_pendingData = SharedBuffer::create();
+    m_pendingData->append(buffer.get());
+    m_pendingEncodedDataLength += encodedDataLength;
+
+    if (m_pendingData->size() >= m_dataChunkSize) {
+        sendPendingData();
+        return;
+    }
+
+    if (!m_dataDeliveryTimer.isActive())
+        m_dataDeliveryTimer.startOneShot(dataDeliveryDeadline);
+}
+
+void NetworkResourceLoader::dataDeliveryTimerFired()
+{
+    sendPendingData();
+}
+
+void NetworkResourceLoader::sendPendingData()
+{
+    m_dataDeliveryTimer.stop();
+    if (!m_pendingData)
+        return;
+
+    RefPtr<SharedBuffer> data = m_pendingData.release();
+    int64_t encodedDataLength = m_pendingEncodedDataLength;
+    m_pendingEncodedDataLength = 0;
+
+    // Size the next chunk to what the current throughput delivers within one deadline.
+    double now = monotonicallyIncreasingTime();
+    double elapsedTime = now - m_lastDataDeliveryTime;
+    if (elapsedTime > 0) {
+        double chunkSize = data->size() * dataDeliveryDeadline / elapsedTime;
+        m_dataChunkSize = std::min<size_t>(std::max<double>(chunkSize, minimumDataChunkSize), maximumDataChunkSize);
+    }
+    m_lastDataDeliveryTime = now;
+
+    sendBuffer(data.get(), encodedDataLength);
 }
 
 void NetworkResourceLoader::didFinishLoading(ResourceHandle* handle, double finishTime)
@@ -259,6 +333,7 @@ void NetworkResourceLoader::didFinishLoading(ResourceHandle* handle, double fini
     else {
         if (m_bufferedData && m_bufferedData->size())
             sendBuffer(m_bufferedData.get(), m_bufferedData->size());
+        sendPendingData();
         send(Messages::WebResourceLoader::DidFinishResourceLoad(finishTime));
     }
 
@@ -272,8 +347,10 @@ void NetworkResourceLoader::didFail(ResourceHandle* handle, const ResourceError&
     if (isSynchronous()) {
         m_synchronousLoadData->m_error = error;
         sendReplyToSynchronousRequest(*m_synchronousLoadData, nullptr);
-    } else
+    } else {
+        sendPendingData();
         send(Messages::WebResourceLoader::DidFailResourceLoad(error));
+    }
 
     cleanup();
 }
@@ -413,6 +490,8 @@ void NetworkResourceLoader::sendBuffer(WebCore::SharedBuffer* buffer, int encode
         return;
     }
 #endif
+    m_dataMessageCount++;
+
     IPC::SharedBufferDataReference dataReference(buffer);
     sendAbortingOnFailure(Messages::WebResourceLoader::DidReceiveData(dataReference, encodedDataLength));
 }
@@ -162,6 +162,8 @@ private:
     void platformDidReceiveResponse(const WebCore::ResourceResponse&);
 
     void sendBuffer(WebCore::SharedBuffer*, int encodedDataLength);
+    void sendPendingData();
+    void dataDeliveryTimerFired();
 
     void consumeSandboxExtensions();
     void invalidateSandboxExtensions();
@@ -199,6 +201,15 @@ private:
     RefPtr<NetworkConnectionToWebProcess> m_connection;
     
     RefPtr<WebCore::SharedBuffer> m_bufferedData;
+
+    // Data is handed to the WebProcess in chunks sized to what arrives within a short deadline,
+    // rather than in one message per network callback.
+    RefPtr<WebCore::SharedBuffer> m_pendingData;
+    int64_t m_pendingEncodedDataLength;
+    size_t m_dataChunkSize;
+    double m_lastDataDeliveryTime;
+    unsigned m_dataMessageCount;
+    RunLoop::Timer<NetworkResourceLoader> m_dataDeliveryTimer;
 };
 
 } // namespace WebKit
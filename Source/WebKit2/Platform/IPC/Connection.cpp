@@ -384,6 +384,10 @@ bool Connection::sendMessage(std::unique_ptr<MessageEncoder> encoder, unsigned m
             || m_inDispatchMessageMarkedDispatchWhenWaitingForSyncReplyCount))
         encoder->setShouldDispatchMessageWhenWaitingForSyncReply(true);
 
+    // Messages are counted here rather than where they are encoded, so that the ones built by hand are counted too.
+    if (MessageStatistics::shared().isEnabled())
+        MessageStatistics::shared().didSendMessage(encoder->messageReceiverName(), encoder->messageName(), encoder->bufferSize());
+
     {
         MutexLocker locker(m_outgoingMessagesLock);
         m_outgoingMessages.append(WTF::move(encoder));
@@ -632,6 +636,11 @@ void Connection::processIncomingMessage(std::unique_ptr<MessageDecoder> message)
     ASSERT(!message->messageReceiverName().isEmpty());
     ASSERT(!message->messageName().isEmpty());
 
+    if (MessageStatistics::shared().isEnabled()) {
+        message->setReceivedTime(monotonicallyIncreasingTime());
+        MessageStatistics::shared().didReceiveMessage(message->messageReceiverName(), message->messageName(), message->length());
+    }
+
     if (message->messageReceiverName() == "IPC" && message->messageName() == "SyncMessageReply") {
         processIncomingSyncReply(WTF::move(message));
         return;
@@ -823,6 +832,8 @@ void Connection::dispatchMessage(std::unique_ptr<MessageDecoder> message)
     if (!m_client)
         return;
 
+    double dispatchStartTime = message->receivedTime() ? monotonicallyIncreasingTime() : 0;
+
     m_inDispatchMessageCount++;
 
     if (message->shouldDispatchMessageWhenWaitingForSyncReply())
@@ -848,6 +859,9 @@ void Connection::dispatchMessage(std::unique_ptr<MessageDecoder> message)
         m_client->didReceiveInvalidMessage(this, message->messageReceiverName(), message->messageName());
 
     m_didReceiveInvalidMessage = oldDidReceiveInvalidMessage;
+
+    if (dispatchStartTime)
+        MessageStatistics::shared().didDispatchMessage(message->messageReceiverName(), message->messageName(), dispatchStartTime - message->receivedTime(), monotonicallyIncreasingTime() - dispatchStartTime);
 }
 
 void Connection::dispatchOneMessage()
@@ -32,9 +32,11 @@
 #include "MessageDecoder.h"
 #include "MessageEncoder.h"
 #include "MessageReceiver.h"
+#include "MessageStatistics.h"
 #include "WorkQueue.h"
 #include <atomic>
 #include <condition_variable>
+#include <wtf/CurrentTime.h>
 #include <wtf/Deque.h>
 #include <wtf/Forward.h>
 #include <wtf/PassRefPtr.h>
@@ -49,6 +51,10 @@
 #include "PlatformProcessIdentifier.h"
 #endif
 
+#if USE(UNIX_DOMAIN_SOCKETS)
+#include "SharedMemory.h"
+#endif
+
 #if PLATFORM(WIN)
 #include "NonblockIoHandle.h"
 #endif
@@ -141,6 +147,10 @@ public:
     };
 
     static Connection::SocketPair createPlatformConnection(unsigned options = SetCloexecOnClient | SetCloexecOnServer);
+
+    // Message bodies up to this size are copied through the shared memory ring of the connection,
+    // larger ones get a shared memory mapping of their own.
+    static const size_t maximumMessageRingBodySize = 256 * 1024;
 #elif PLATFORM(WIN)
     typedef HANDLE Identifier;
     static bool identifierIsNull(Identifier identifier) { return !identifier; }
@@ -341,12 +351,22 @@ private:
     // Called on the connection queue.
     void readyReadHandler();
     bool processMessage();
+    bool createOutgoingMessageRing();
+    bool writeMessageBodyToRing(const MessageEncoder&, uint32_t& ringPosition);
 
     Vector<uint8_t> m_readBuffer;
     size_t m_readBufferSize;
     Vector<int> m_fileDescriptors;
     size_t m_fileDescriptorsSize;
     int m_socketDescriptor;
+
+    // Message bodies too large to be sent inline are written to a shared memory ring that each side
+    // creates for its outgoing messages and hands to the other side once. The socket then only carries
+    // the message header and the attachments.
+    RefPtr<WebKit::SharedMemory> m_outgoingMessageRing;
+    uint32_t m_outgoingMessageRingPosition;
+    bool m_outgoingMessageRingFailed;
+    RefPtr<WebKit::SharedMemory> m_incomingMessageRing;
 #elif PLATFORM(WIN)
     // Called on the connection queue.
     void completeReadHandler(size_t);
@@ -367,7 +387,10 @@ template<typename T> bool Connection::send(T&& message, uint64_t destinationID,
     COMPILE_ASSERT(!T::isSync, AsyncMessageExpected);
 
     auto encoder = std::make_unique<MessageEncoder>(T::receiverName(), T::name(), destinationID);
+    double encodeStartTime = MessageStatistics::shared().isEnabled() ? monotonicallyIncreasingTime() : 0;
     encoder->encode(message.arguments());
+    if (encodeStartTime)
+        MessageStatistics::shared().didEncodeMessage(T::receiverName(), T::name(), monotonicallyIncreasingTime() - encodeStartTime);
     
     return sendMessage(WTF::move(encoder), messageSendFlags);
 }
@@ -380,13 +403,22 @@ template<typename T> bool Connection::sendSync(T&& message, typename T::Reply&&
     std::unique_ptr<MessageEncoder> encoder = createSyncMessageEncoder(T::receiverName(), T::name(), destinationID, syncRequestID);
     
     // Encode the rest of the input arguments.
+    double encodeStartTime = MessageStatistics::shared().isEnabled() ? monotonicallyIncreasingTime() : 0;
     encoder->encode(message.arguments());
+    double sendStartTime = 0;
+    if (encodeStartTime) {
+        sendStartTime = monotonicallyIncreasingTime();
+        MessageStatistics::shared().didEncodeMessage(T::receiverName(), T::name(), sendStartTime - encodeStartTime);
+    }
 
     // Now send the message and wait for a reply.
     std::unique_ptr<MessageDecoder> replyDecoder = sendSyncMessage(syncRequestID, WTF::move(encoder), timeout, syncSendFlags);
     if (!replyDecoder)
         return false;
 
+    if (sendStartTime)
+        MessageStatistics::shared().didReceiveSyncReply(T::receiverName(), T::name(), monotonicallyIncreasingTime() - sendStartTime);
+
     // Decode the reply.
     return replyDecoder->decode(reply);
 }
@@ -43,6 +43,7 @@ MessageDecoder::~MessageDecoder()
 
 MessageDecoder::MessageDecoder(const DataReference& buffer, Vector<Attachment> attachments)
     : ArgumentDecoder(buffer.data(), buffer.size(), WTF::move(attachments))
+    , m_receivedTime(0)
 {
     if (!decode(m_messageFlags))
         return;
@@ -46,6 +46,10 @@ public:
     bool isSyncMessage() const;
     bool shouldDispatchMessageWhenWaitingForSyncReply() const;
 
+    // Only set while MessageStatistics is enabled.
+    double receivedTime() const { return m_receivedTime; }
+    void setReceivedTime(double receivedTime) { m_receivedTime = receivedTime; }
+
 #if PLATFORM(MAC) && __MAC_OS_X_VERSION_MIN_REQUIRED >= 1090
     void setImportanceAssertion(std::unique_ptr<ImportanceAssertion>);
 #endif
@@ -56,6 +60,7 @@ private:
     StringReference m_messageName;
 
     uint64_t m_destinationID;
+    double m_receivedTime;
 
 #if PLATFORM(MAC) && __MAC_OS_X_VERSION_MIN_REQUIRED >= 1090
     std::unique_ptr<ImportanceAssertion> m_importanceAssertion;
@@ -35,6 +35,8 @@ namespace IPC {
 static uint8_t defaultMessageFlags = 0;
 
 MessageEncoder::MessageEncoder(StringReference messageReceiverName, StringReference messageName, uint64_t destinationID)
+    : m_messageReceiverName(messageReceiverName)
+    , m_messageName(messageName)
 {
     ASSERT(!messageReceiverName.isEmpty());
 
@@ -27,19 +27,25 @@
 #define MessageEncoder_h
 
 #include "ArgumentEncoder.h"
+#include "StringReference.h"
 #include <wtf/Forward.h>
 
 namespace IPC {
 
-class StringReference;
-
 class MessageEncoder : public ArgumentEncoder {
 public:
     MessageEncoder(StringReference messageReceiverName, StringReference messageName, uint64_t destinationID);
     virtual ~MessageEncoder();
 
+    StringReference messageReceiverName() const { return m_messageReceiverName; }
+    StringReference messageName() const { return m_messageName; }
+
     void setIsSyncMessage(bool);
     void setShouldDispatchMessageWhenWaitingForSyncReply(bool);
+
+private:
+    StringReference m_messageReceiverName;
+    StringReference m_messageName;
 };
 
 } // namespace IPC
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2014 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "MessageStatistics.h"
+
+#include <stdlib.h>
+#include <wtf/StdLibExtras.h>
+#include <wtf/text/StringBuilder.h>
+
+namespace IPC {
+
+MessageStatistics& MessageStatistics::shared()
+{
+    static NeverDestroyed<MessageStatistics> statistics;
+    return statistics;
+}
+
+MessageStatistics::MessageStatistics()
+    : m_isEnabled(getenv("WEBKIT_IPC_STATISTICS"))
+{
+}
+
+MessageStatistics::Counters::Counters()
+    : sentCount(0)
+    , sentBytes(0)
+    , encodeTime(0)
+    , receivedCount(0)
+    , receivedBytes(0)
+    , dispatchedCount(0)
+    , queueTime(0)
+    , dispatchTime(0)
+    , syncReplyCount(0)
+    , syncRoundTripTime(0)
+    , maxSyncRoundTripTime(0)
+{
+    memset(syncLatencyBuckets, 0, sizeof(syncLatencyBuckets));
+}
+
+MessageStatistics::Counters& MessageStatistics::countersFor(StringReference messageReceiverName, StringReference messageName)
+{
+    StringBuilder key;
+    key.append(messageReceiverName.data(), messageReceiverName.size());
+    key.appendLiteral("::");
+    key.append(messageName.data(), messageName.size());
+    return m_counters.add(key.toString(), Counters()).iterator->value;
+}
+
+void MessageStatistics::didEncodeMessage(StringReference messageReceiverName, StringReference messageName, double encodeTime)
+{
+    MutexLocker locker(m_countersLock);
+    countersFor(messageReceiverName, messageName).encodeTime += encodeTime;
+}
+
+void MessageStatistics::didSendMessage(StringReference messageReceiverName, StringReference messageName, size_t bodySize)
+{
+    MutexLocker locker(m_countersLock);
+    Counters& counters = countersFor(messageReceiverName, messageName);
+    counters.sentCount++;
+    counters.sentBytes += bodySize;
+}
+
+void MessageStatistics::didReceiveMessage(StringReference messageReceiverName, StringReference messageName, size_t bodySize)
+{
+    MutexLocker locker(m_countersLock);
+    Counters& counters = countersFor(messageReceiverName, messageName);
+    counters.receivedCount++;
+    counters.receivedBytes += bodySize;
+}
+
+void MessageStatistics::didDispatchMessage(StringReference messageReceiverName, StringReference messageName, double queueTime, double dispatchTime)
+{
+    MutexLocker locker(m_countersLock);
+    Counters& counters = countersFor(messageReceiverName, messageName);
+    counters.dispatchedCount++;
+    counters.queueTime += queueTime;
+    counters.dispatchTime += dispatchTime;
+}
+
+void MessageStatistics::didReceiveSyncReply(StringReference messageReceiverName, StringReference messageName, double roundTripTime)
+{
+    MutexLocker locker(m_countersLock);
+    Counters& counters = countersFor(messageReceiverName, messageName);
+    counters.syncReplyCount++;
+    counters.syncRoundTripTime += roundTripTime;
+    counters.maxSyncRoundTripTime = std::max(counters.maxSyncRoundTripTime, roundTripTime);
+
+    unsigned bucket = 0;
+    for (double limit = 0.001; bucket < syncLatencyBucketCount - 1 && roundTripTime >= limit; limit *= 2)
+        ++bucket;
+    counters.syncLatencyBuckets[bucket]++;
+}
+
+void MessageStatistics::addSample(const String& name, uint64_t value)
+{
+    MutexLocker locker(m_countersLock);
+    Samples& samples = m_samples.add(name, Samples()).iterator->value;
+    samples.count++;
+    samples.total += value;
+    samples.max = std::max(samples.max, value);
+}
+
+static inline uint64_t microseconds(double seconds)
+{
+    return static_cast<uint64_t>(seconds * 1000000);
+}
+
+void MessageStatistics::addStatistics(HashMap<String, uint64_t>& statistics, const String& processName)
+{
+    MutexLocker locker(m_countersLock);
+    for (auto& entry : m_counters) {
+        String prefix = processName + " IPC " + entry.key + ' ';
+        const Counters& counters = entry.value;
+        if (counters.sentCount) {
+            statistics.set(prefix + "SentCount", counters.sentCount);
+            statistics.set(prefix + "SentBytes", counters.sentBytes);
+        }
+        if (counters.encodeTime)
+            statistics.set(prefix + "EncodeMicroseconds", microseconds(counters.encodeTime));
+        if (counters.receivedCount) {
+            statistics.set(prefix + "ReceivedCount", counters.receivedCount);
+            statistics.set(prefix + "ReceivedBytes", counters.receivedBytes);
+        }
+        if (counters.dispatchedCount) {
+            statistics.set(prefix + "QueueMicroseconds", microseconds(counters.queueTime));
+            statistics.set(prefix + "DispatchMicroseconds", microseconds(counters.dispatchTime));
+        }
+        if (counters.syncReplyCount) {
+            statistics.set(prefix + "SyncReplyCount", counters.syncReplyCount);
+            statistics.set(prefix + "SyncRoundTripMicroseconds", microseconds(counters.syncRoundTripTime));
+            statistics.set(prefix + "MaxSyncRoundTripMicroseconds", microseconds(counters.maxSyncRoundTripTime));
+            for (unsigned i = 0; i < syncLatencyBucketCount; ++i) {
+                if (!counters.syncLatencyBuckets[i])
+                    continue;
+                if (i < syncLatencyBucketCount - 1)
+                    statistics.set(prefix + "SyncRoundTripsUnder" + String::number(1 << i) + "ms", counters.syncLatencyBuckets[i]);
+                else
+                    statistics.set(prefix + "SyncRoundTripsOver" + String::number(1 << (i - 1)) + "ms", counters.syncLatencyBuckets[i]);
+            }
+        }
+    }
+
+    for (auto& entry : m_samples) {
+        String prefix = processName + " IPC " + entry.key + ' ';
+        statistics.set(prefix + "Count", entry.value.count);
+        statistics.set(prefix + "Total", entry.value.total);
+        statistics.set(prefix + "Max", entry.value.max);
+    }
+}
+
+} // namespace IPC
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2014 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MessageStatistics_h
+#define MessageStatistics_h
+
+#include "StringReference.h"
+#include <wtf/HashMap.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/ThreadingPrimitives.h>
+#include <wtf/text/StringHash.h>
+#include <wtf/text/WTFString.h>
+
+namespace IPC {
+
+// Per message counters for finding out which messages dominate IPC traffic and which synchronous
+// messages block the sender for long. Collection is off unless WEBKIT_IPC_STATISTICS is set in the
+// environment of the UI process, which child processes inherit.
+class MessageStatistics {
+    WTF_MAKE_NONCOPYABLE(MessageStatistics);
+public:
+    static MessageStatistics& shared();
+
+    bool isEnabled() const { return m_isEnabled; }
+
+    // All times are in seconds.
+    void didEncodeMessage(StringReference messageReceiverName, StringReference messageName, double encodeTime);
+    void didSendMessage(StringReference messageReceiverName, StringReference messageName, size_t bodySize);
+    void didReceiveMessage(StringReference messageReceiverName, StringReference messageName, size_t bodySize);
+    void didDispatchMessage(StringReference messageReceiverName, StringReference messageName, double queueTime, double dispatchTime);
+    void didReceiveSyncReply(StringReference messageReceiverName, StringReference messageName, double roundTripTime);
+
+    // Records a value that is not tied to a single message, such as the number of messages a load took.
+    void addSample(const String& name, uint64_t value);
+
+    // Adds one entry per counter, with times in microseconds, to the given map. Keys start with
+    // the process name, so that the counters of several processes can go in one dictionary.
+    void addStatistics(HashMap<String, uint64_t>&, const String& processName);
+
+private:
+    friend class NeverDestroyed<MessageStatistics>;
+    MessageStatistics();
+
+    // Sync round trips are counted in buckets of under 1ms, under 2ms, under 4ms and so on.
+    static const unsigned syncLatencyBucketCount = 12;
+
+    struct Counters {
+        Counters();
+
+        uint64_t sentCount;
+        uint64_t sentBytes;
+        double encodeTime;
+        uint64_t receivedCount;
+        uint64_t receivedBytes;
+        uint64_t dispatchedCount;
+        double queueTime;
+        double dispatchTime;
+        uint64_t syncReplyCount;
+        double syncRoundTripTime;
+        double maxSyncRoundTripTime;
+        uint64_t syncLatencyBuckets[syncLatencyBucketCount];
+    };
+
+    struct Samples {
+        Samples()
+            : count(0)
+            , total(0)
+            , max(0)
+        {
+        }
+
+        uint64_t count;
+        uint64_t total;
+        uint64_t max;
+    };
+
+    Counters& countersFor(StringReference messageReceiverName, StringReference messageName);
+
+    bool m_isEnabled;
+    Mutex m_countersLock;
+    HashMap<String, Counters> m_counters;
+    HashMap<String, Samples> m_samples;
+};
+
+} // namespace IPC
+
+#endif // MessageStatistics_h
@@ -59,6 +59,33 @@ namespace IPC {
 static const size_t messageMaxSize = 4096;
 static const size_t attachmentMaxAmount = 255;
 
+// The ring holds the bodies of outgoing messages until the other side has decoded them.
+// Positions are byte counts that wrap around at 2^32, so the capacity has to be a power of two.
+static const uint32_t messageRingCapacity = 1 << 20;
+static const uint32_t messageRingMaxBodySize = Connection::maximumMessageRingBodySize;
+COMPILE_ASSERT(messageRingMaxBodySize <= messageRingCapacity / 4, MessageRingHoldsSeveralMaximumSizeBodies);
+static const size_t messageRingHeaderSize = 64;
+
+struct MessageRingHeader {
+    // Written by the receiving side once a message body has been copied out of the ring.
+    std::atomic<uint32_t> consumedPosition;
+};
+
+static inline uint32_t messageRingAllocationSize(size_t bodySize)
+{
+    return (bodySize + 7) & ~7;
+}
+
+static inline MessageRingHeader* messageRingHeader(WebKit::SharedMemory& ring)
+{
+    return static_cast<MessageRingHeader*>(ring.data());
+}
+
+static inline uint8_t* messageRingData(WebKit::SharedMemory& ring)
+{
+    return static_cast<uint8_t*>(ring.data()) + messageRingHeaderSize;
+}
+
 enum {
     MessageBodyIsOutOfLine = 1U << 31
 };
@@ -71,6 +98,9 @@ public:
         : m_bodySize(bodySize)
         , m_attachmentCount(initialAttachmentCount)
         , m_isMessageBodyOutOfLine(false)
+        , m_isMessageBodyInRing(false)
+        , m_isMessageRingSetup(false)
+        , m_ringPosition(0)
     {
     }
 
@@ -84,6 +114,19 @@ public:
 
     bool isMessageBodyIsOutOfLine() const { return m_isMessageBodyOutOfLine; }
 
+    void setMessageBodyIsInRing(uint32_t ringPosition)
+    {
+        m_isMessageBodyInRing = true;
+        m_ringPosition = ringPosition;
+    }
+
+    bool isMessageBodyInRing() const { return m_isMessageBodyInRing; }
+    uint32_t ringPosition() const { return m_ringPosition; }
+
+    // A message ring setup message carries the sender's ring as its only attachment, and has no body.
+    void setMessageRingSetup() { m_isMessageRingSetup = true; }
+    bool isMessageRingSetup() const { return m_isMessageRingSetup; }
+
     size_t bodySize() const { return m_bodySize; }
 
     size_t attachmentCount() const { return m_attachmentCount; }
@@ -92,6 +135,9 @@ private:
     size_t m_bodySize;
     size_t m_attachmentCount;
     bool m_isMessageBodyOutOfLine;
+    bool m_isMessageBodyInRing;
+    bool m_isMessageRingSetup;
+    uint32_t m_ringPosition;
 };
 
 class AttachmentInfo {
@@ -134,6 +180,8 @@ void Connection::platformInitialize(Identifier identifier)
     m_readBufferSize = 0;
     m_fileDescriptors.resize(attachmentMaxAmount);
     m_fileDescriptorsSize = 0;
+    m_outgoingMessageRingPosition = 0;
+    m_outgoingMessageRingFailed = false;
 }
 
 void Connection::platformInvalidate()
@@ -182,7 +230,8 @@ bool Connection::processMessage()
     memcpy(&messageInfo, messageData, sizeof(messageInfo));
     messageData += sizeof(messageInfo);
 
-    size_t messageLength = sizeof(MessageInfo) + messageInfo.attachmentCount() * sizeof(AttachmentInfo) + (messageInfo.isMessageBodyIsOutOfLine() ? 0 : messageInfo.bodySize());
+    bool messageBodyIsInline = !messageInfo.isMessageBodyIsOutOfLine() && !messageInfo.isMessageBodyInRing();
+    size_t messageLength = sizeof(MessageInfo) + messageInfo.attachmentCount() * sizeof(AttachmentInfo) + (messageBodyIsInline ? messageInfo.bodySize() : 0);
     if (m_readBufferSize < messageLength)
         return false;
 
@@ -258,13 +307,38 @@ bool Connection::processMessage()
 
     ASSERT(attachments.size() == (messageInfo.isMessageBodyIsOutOfLine() ? messageInfo.attachmentCount() - 1 : messageInfo.attachmentCount()));
 
-    uint8_t* messageBody = messageData;
-    if (messageInfo.isMessageBodyIsOutOfLine())
-        messageBody = reinterpret_cast<uint8_t*>(oolMessageBody->data());
+    if (messageInfo.isMessageRingSetup()) {
+        if (attachments.size() != 1 || attachments[0].type() != Attachment::MappedMemoryType || attachments[0].fileDescriptor() == -1) {
+            ASSERT_NOT_REACHED();
+            return false;
+        }
+
+        WebKit::SharedMemory::Handle handle;
+        size_t ringSize = attachments[0].size();
+        handle.adoptFromAttachment(attachments[0].releaseFileDescriptor(), ringSize);
+        if (ringSize == messageRingHeaderSize + messageRingCapacity)
+            m_incomingMessageRing = WebKit::SharedMemory::create(handle, WebKit::SharedMemory::ReadWrite);
+        ASSERT(m_incomingMessageRing);
+    } else {
+        uint8_t* messageBody = messageData;
+        if (messageInfo.isMessageBodyIsOutOfLine())
+            messageBody = reinterpret_cast<uint8_t*>(oolMessageBody->data());
+        else if (messageInfo.isMessageBodyInRing()) {
+            uint32_t ringOffset = messageInfo.ringPosition() & (messageRingCapacity - 1);
+            if (!m_incomingMessageRing || messageInfo.bodySize() > messageRingCapacity - ringOffset) {
+                ASSERT_NOT_REACHED();
+                return false;
+            }
+            messageBody = messageRingData(*m_incomingMessageRing) + ringOffset;
+        }
 
-    auto decoder = std::make_unique<MessageDecoder>(DataReference(messageBody, messageInfo.bodySize()), WTF::move(attachments));
+        // The decoder copies the body, so its space in the ring can be handed back right away.
+        auto decoder = std::make_unique<MessageDecoder>(DataReference(messageBody, messageInfo.bodySize()), WTF::move(attachments));
+        if (messageInfo.isMessageBodyInRing())
+            messageRingHeader(*m_incomingMessageRing)->consumedPosition.store(messageInfo.ringPosition() + messageRingAllocationSize(messageInfo.bodySize()), std::memory_order_release);
 
-    processIncomingMessage(WTF::move(decoder));
+        processIncomingMessage(WTF::move(decoder));
+    }
 
     if (m_readBufferSize > messageLength) {
         memmove(m_readBuffer.data(), m_readBuffer.data() + messageLength, m_readBufferSize - messageLength);
@@ -418,6 +492,107 @@ bool Connection::platformCanSendOutgoingMessages() const
     return m_isConnected;
 }
 
+static bool sendMessageToSocket(int socketDescriptor, struct msghdr& message)
+{
+    while (sendmsg(socketDescriptor, &message, 0) == -1) {
+        if (errno == EINTR)
+            continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            struct pollfd pollfd;
+
+            pollfd.fd = socketDescriptor;
+            pollfd.events = POLLOUT;
+            pollfd.revents = 0;
+            poll(&pollfd, 1, -1);
+            continue;
+        }
+
+        WTFLogAlways("Error sending IPC message: %s", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool Connection::createOutgoingMessageRing()
+{
+    m_outgoingMessageRing = WebKit::SharedMemory::create(messageRingHeaderSize + messageRingCapacity);
+    if (!m_outgoingMessageRing)
+        return false;
+
+    WebKit::SharedMemory::Handle handle;
+    if (!m_outgoingMessageRing->createHandle(handle, WebKit::SharedMemory::ReadWrite)) {
+        m_outgoingMessageRing = nullptr;
+        return false;
+    }
+
+    new (NotNull, m_outgoingMessageRing->data()) MessageRingHeader;
+    messageRingHeader(*m_outgoingMessageRing)->consumedPosition.store(0, std::memory_order_relaxed);
+    m_outgoingMessageRingPosition = 0;
+
+    Attachment attachment = handle.releaseToAttachment();
+    AttachmentInfo attachmentInfo;
+    attachmentInfo.setType(Attachment::MappedMemoryType);
+    attachmentInfo.setSize(attachment.size());
+
+    MessageInfo messageInfo(0, 1);
+    messageInfo.setMessageRingSetup();
+
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+
+    struct iovec iov[2];
+    iov[0].iov_base = reinterpret_cast<void*>(&messageInfo);
+    iov[0].iov_len = sizeof(messageInfo);
+    iov[1].iov_base = reinterpret_cast<void*>(&attachmentInfo);
+    iov[1].iov_len = sizeof(attachmentInfo);
+    message.msg_iov = iov;
+    message.msg_iovlen = 2;
+
+    char attachmentFDBuffer[CMSG_SPACE(sizeof(int))];
+    memset(attachmentFDBuffer, 0, sizeof(attachmentFDBuffer));
+    message.msg_control = attachmentFDBuffer;
+    message.msg_controllen = sizeof(attachmentFDBuffer);
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    *reinterpret_cast<int*>(CMSG_DATA(cmsg)) = attachment.fileDescriptor();
+
+    bool sent = sendMessageToSocket(m_socketDescriptor, message);
+    attachment.dispose();
+    if (!sent)
+        m_outgoingMessageRing = nullptr;
+    return sent;
+}
+
+bool Connection::writeMessageBodyToRing(const MessageEncoder& encoder, uint32_t& ringPosition)
+{
+    if (encoder.bufferSize() > messageRingMaxBodySize || m_outgoingMessageRingFailed)
+        return false;
+
+    if (!m_outgoingMessageRing && !createOutgoingMessageRing()) {
+        m_outgoingMessageRingFailed = true;
+        return false;
+    }
+
+    // A body never wraps around the end of the ring; the space left at the end is skipped instead.
+    uint32_t position = m_outgoingMessageRingPosition;
+    uint32_t contiguousSize = messageRingCapacity - (position & (messageRingCapacity - 1));
+    if (encoder.bufferSize() > contiguousSize)
+        position += contiguousSize;
+
+    uint32_t endPosition = position + messageRingAllocationSize(encoder.bufferSize());
+    uint32_t consumedPosition = messageRingHeader(*m_outgoingMessageRing)->consumedPosition.load(std::memory_order_acquire);
+    if (endPosition - consumedPosition > messageRingCapacity)
+        return false;
+
+    memcpy(messageRingData(*m_outgoingMessageRing) + (position & (messageRingCapacity - 1)), encoder.buffer(), encoder.bufferSize());
+    m_outgoingMessageRingPosition = endPosition;
+    ringPosition = position;
+    return true;
+}
+
 bool Connection::sendOutgoingMessage(std::unique_ptr<MessageEncoder> encoder)
 {
     COMPILE_ASSERT(sizeof(MessageInfo) + attachmentMaxAmount * sizeof(size_t) <= messageMaxSize, AttachmentsFitToMessageInline);
@@ -432,7 +607,10 @@ bool Connection::sendOutgoingMessage(std::unique_ptr<MessageEncoder> encoder)
 
     MessageInfo messageInfo(encoder->bufferSize(), attachments.size());
     size_t messageSizeWithBodyInline = sizeof(messageInfo) + (attachments.size() * sizeof(AttachmentInfo)) + encoder->bufferSize();
-    if (messageSizeWithBodyInline > messageMaxSize && encoder->bufferSize()) {
+    uint32_t ringPosition;
+    if (messageSizeWithBodyInline > messageMaxSize && encoder->bufferSize() && writeMessageBodyToRing(*encoder, ringPosition))
+        messageInfo.setMessageBodyIsInRing(ringPosition);
+    else if (messageSizeWithBodyInline > messageMaxSize && encoder->bufferSize()) {
         RefPtr<WebKit::SharedMemory> oolMessageBody = WebKit::SharedMemory::create(encoder->bufferSize());
         if (!oolMessageBody)
             return false;
@@ -513,7 +691,7 @@ bool Connection::sendOutgoingMessage(std::unique_ptr<MessageEncoder> encoder)
         ++iovLength;
     }
 
-    if (!messageInfo.isMessageBodyIsOutOfLine() && encoder->bufferSize()) {
+    if (!messageInfo.isMessageBodyIsOutOfLine() && !messageInfo.isMessageBodyInRing() && encoder->bufferSize()) {
         iov[iovLength].iov_base = reinterpret_cast<void*>(encoder->buffer());
         iov[iovLength].iov_len = encoder->bufferSize();
         ++iovLength;
@@ -521,24 +699,7 @@ bool Connection::sendOutgoingMessage(std::unique_ptr<MessageEncoder> encoder)
 
     message.msg_iovlen = iovLength;
 
-    int bytesSent = 0;
-    while ((bytesSent = sendmsg(m_socketDescriptor, &message, 0)) == -1) {
-        if (errno == EINTR)
-            continue;
-        if (errno == EAGAIN || errno == EWOULDBLOCK) {
-            struct pollfd pollfd;
-
-            pollfd.fd = m_socketDescriptor;
-            pollfd.events = POLLOUT;
-            pollfd.revents = 0;
-            poll(&pollfd, 1, -1);
-            continue;
-        }
-
-        WTFLogAlways("Error sending IPC message: %s", strerror(errno));
-        return false;
-    }
-    return true;
+    return sendMessageToSocket(m_socketDescriptor, message);
 }
 
 Connection::SocketPair Connection::createPlatformConnection(unsigned options)
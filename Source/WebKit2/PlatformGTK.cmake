@@ -586,6 +586,7 @@ if (ENABLE_PLUGIN_PROCESS_GTK2)
         Platform/IPC/MessageEncoder.cpp
         Platform/IPC/MessageReceiverMap.cpp
         Platform/IPC/MessageSender.cpp
+        Platform/IPC/MessageStatistics.cpp
         Platform/IPC/StringReference.cpp
 
         Platform/IPC/unix/AttachmentUnix.cpp
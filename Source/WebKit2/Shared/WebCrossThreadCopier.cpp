@@ -27,6 +27,7 @@
 
 #if ENABLE(INDEXED_DATABASE)
 
+#include "IDBCursorRecord.h"
 #include "IDBIdentifier.h"
 #include "SecurityOriginData.h"
 #include "UniqueIDBDatabaseIdentifier.h"
@@ -80,6 +81,16 @@ Vector<Vector<IDBKeyData>> CrossThreadCopierBase<false, false, Vector<Vector<IDB
     return result;
 }
 
+Vector<IDBCursorRecord> CrossThreadCopierBase<false, false, Vector<IDBCursorRecord>>::copy(const Vector<IDBCursorRecord>& vector)
+{
+    Vector<IDBCursorRecord> result;
+    result.reserveInitialCapacity(vector.size());
+    for (const auto& record : vector)
+        result.uncheckedAppend(record.isolatedCopy());
+
+    return result;
+}
+
 SecurityOriginData CrossThreadCopierBase<false, false, SecurityOriginData>::copy(const SecurityOriginData& securityOriginData)
 {
     return securityOriginData.isolatedCopy();
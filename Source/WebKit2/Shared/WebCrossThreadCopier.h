@@ -37,6 +37,7 @@ class UniqueIDBDatabaseIdentifier;
 
 enum class UniqueIDBDatabaseShutdownType;
 
+struct IDBCursorRecord;
 struct SecurityOriginData;
 }
 
@@ -82,6 +83,10 @@ template<> struct CrossThreadCopierBase<false, false, Vector<Vector<IDBKeyData>>
     static Vector<Vector<IDBKeyData>> copy(const Vector<Vector<IDBKeyData>>&);
 };
 
+template<> struct CrossThreadCopierBase<false, false, Vector<WebKit::IDBCursorRecord>> {
+    static Vector<WebKit::IDBCursorRecord> copy(const Vector<WebKit::IDBCursorRecord>&);
+};
+
 template<> struct CrossThreadCopierBase<false, false, WTF::ASCIILiteral> {
     static WTF::ASCIILiteral copy(const WTF::ASCIILiteral&);
 };
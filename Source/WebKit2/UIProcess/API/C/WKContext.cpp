@@ -515,6 +515,16 @@ void WKContextWarmInitialProcess(WKContextRef contextRef)
     toImpl(contextRef)->warmInitialProcess();
 }
 
+void WKContextSetPrewarmedProcessCount(WKContextRef contextRef, unsigned count)
+{
+    toImpl(contextRef)->setPrewarmedProcessCount(count);
+}
+
+unsigned WKContextGetPrewarmedProcessCount(WKContextRef contextRef)
+{
+    return toImpl(contextRef)->prewarmedProcessCount();
+}
+
 void WKContextGetStatistics(WKContextRef contextRef, void* context, WKContextGetStatisticsFunction callback)
 {
     toImpl(contextRef)->getStatistics(0xFFFFFFFF, toGenericCallbackFunction(context, callback));
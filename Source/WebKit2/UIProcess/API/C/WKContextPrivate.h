@@ -75,6 +75,10 @@ WK_EXPORT void WKContextSetHTTPPipeliningEnabled(WKContextRef context, bool enab
 
 WK_EXPORT void WKContextWarmInitialProcess(WKContextRef context);
 
+// Only used with kWKProcessModelMultipleSecondaryProcesses. Defaults to 0.
+WK_EXPORT void WKContextSetPrewarmedProcessCount(WKContextRef context, unsigned count);
+WK_EXPORT unsigned WKContextGetPrewarmedProcessCount(WKContextRef context);
+
 // FIXME: This function is temporary and useful during the development of the NetworkProcess feature.
 // At some point it should be removed.
 WK_EXPORT void WKContextSetUsesNetworkProcess(WKContextRef context, bool usesNetworkProcess);
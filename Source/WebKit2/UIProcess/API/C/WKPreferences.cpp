@@ -1295,3 +1295,13 @@ bool WKPreferencesGetLongMousePressEnabled(WKPreferencesRef preferencesRef)
 {
     return toImpl(preferencesRef)->longMousePressEnabled();
 }
+
+void WKPreferencesSetSharedMatchedPropertiesCacheEnabled(WKPreferencesRef preferencesRef, bool enabled)
+{
+    toImpl(preferencesRef)->setSharedMatchedPropertiesCacheEnabled(enabled);
+}
+
+bool WKPreferencesGetSharedMatchedPropertiesCacheEnabled(WKPreferencesRef preferencesRef)
+{
+    return toImpl(preferencesRef)->sharedMatchedPropertiesCacheEnabled();
+}
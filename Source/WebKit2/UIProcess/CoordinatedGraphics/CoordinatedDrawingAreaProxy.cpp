@@ -29,6 +29,7 @@
 #if USE(COORDINATED_GRAPHICS)
 #include "CoordinatedDrawingAreaProxy.h"
 
+#include "CoordinatedGraphicsScene.h"
 #include "CoordinatedLayerTreeHostProxy.h"
 #include "DrawingAreaMessages.h"
 #include "DrawingAreaProxyMessages.h"
@@ -110,6 +111,15 @@ void CoordinatedDrawingAreaProxy::paint(BackingStore::PlatformGraphicsContext co
 
 void CoordinatedDrawingAreaProxy::updateViewport()
 {
+    // When the scene is painted in software, only the parts of the view that changed need to be repainted.
+    Vector<IntRect> damagedRects;
+    if (m_coordinatedLayerTreeHostProxy && m_coordinatedLayerTreeHostProxy->coordinatedGraphicsScene()
+        && m_coordinatedLayerTreeHostProxy->coordinatedGraphicsScene()->collectDamagedRects(damagedRects)) {
+        for (size_t i = 0; i < damagedRects.size(); ++i)
+            m_webPageProxy.setViewNeedsDisplay(damagedRects[i]);
+        return;
+    }
+
     m_webPageProxy.setViewNeedsDisplay(viewportVisibleRect());
 }
 
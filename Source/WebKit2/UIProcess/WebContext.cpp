@@ -32,6 +32,7 @@
 #include "DownloadProxy.h"
 #include "DownloadProxyMessages.h"
 #include "Logging.h"
+#include "MessageStatistics.h"
 #include "MutableDictionary.h"
 #include "SandboxExtension.h"
 #include "StatisticsData.h"
@@ -63,6 +64,7 @@
 #include <WebCore/Language.h>
 #include <WebCore/LinkHash.h>
 #include <WebCore/Logging.h>
+#include <WebCore/MemoryPressureHandler.h>
 #include <WebCore/ResourceRequest.h>
 #include <WebCore/SessionID.h>
 #include <runtime/JSCInlines.h>
@@ -117,6 +119,9 @@ namespace WebKit {
 
 static const double sharedSecondaryProcessShutdownTimeout = 60;
 
+// Gives the page that just took a prewarmed process a head start before the replacement is launched.
+static const double prewarmedProcessRefillDelay = 1;
+
 DEFINE_DEBUG_ONLY_GLOBAL(WTF::RefCountedLeakCounter, webContextCounter, ("WebContext"));
 
 void WebContext::applyPlatformSpecificConfigurationDefaults(WebContextConfiguration& configuration)
@@ -154,10 +159,40 @@ const Vector<WebContext*>& WebContext::allContexts()
     return contexts();
 }
 
+#if !PLATFORM(COCOA)
+static void lowMemoryHandler(bool critical)
+{
+    for (auto* context : WebContext::allContexts())
+        context->trimPrewarmedProcesses(critical);
+
+    WTF::releaseFastMallocFreeMemory();
+}
+
+static void installMemoryPressureHandler()
+{
+    // WebKit1 and WebKit2 can share the UI process on Cocoa ports, and there can only be one
+    // WebCore::MemoryPressureHandler, so only the other ports watch for memory pressure here.
+    static bool installed;
+    if (installed)
+        return;
+    installed = true;
+
+    memoryPressureHandler().setLowMemoryHandler(lowMemoryHandler);
+    memoryPressureHandler().install();
+}
+#endif
+
 WebContext::WebContext(WebContextConfiguration configuration)
     : m_processModel(ProcessModelSharedSecondaryProcess)
     , m_webProcessCountLimit(UINT_MAX)
-    , m_haveInitialEmptyProcess(false)
+    , m_prewarmedProcessCount(0)
+    , m_prewarmedProcessRefillTimer(RunLoop::main(), this, &WebContext::prewarmedProcessRefillTimerFired)
+    , m_processLaunchCount(0)
+    , m_totalProcessLaunchTime(0)
+    , m_prewarmedProcessHitCount(0)
+    , m_prewarmedProcessMissCount(0)
+    , m_firstPaintCount(0)
+    , m_totalTimeToFirstPaint(0)
     , m_processWithPageCache(0)
     , m_defaultPageGroup(WebPageGroup::createNonNull())
     , m_injectedBundlePath(configuration.injectedBundlePath)
@@ -224,6 +259,10 @@ WebContext::WebContext(WebContextConfiguration configuration)
 
     contexts().append(this);
 
+#if !PLATFORM(COCOA)
+    installMemoryPressureHandler();
+#endif
+
     addLanguageChangeObserver(this, languageChanged);
 
 #if !LOG_DISABLED
@@ -731,7 +770,7 @@ WebProcessProxy& WebContext::createNewWebProcess()
 
 void WebContext::warmInitialProcess()  
 {
-    if (m_haveInitialEmptyProcess) {
+    if (!m_prewarmedProcesses.isEmpty()) {
         ASSERT(!m_processes.isEmpty());
         return;
     }
@@ -739,8 +778,67 @@ void WebContext::warmInitialProcess()
     if (m_processes.size() >= m_webProcessCountLimit)
         return;
 
-    createNewWebProcess();
-    m_haveInitialEmptyProcess = true;
+    m_prewarmedProcesses.append(&createNewWebProcess());
+}
+
+void WebContext::setPrewarmedProcessCount(unsigned prewarmedProcessCount)
+{
+    m_prewarmedProcessCount = prewarmedProcessCount;
+
+    if (m_prewarmedProcesses.size() > m_prewarmedProcessCount) {
+        terminatePrewarmedProcesses(m_prewarmedProcessCount);
+        return;
+    }
+
+    if (m_processModel == ProcessModelMultipleSecondaryProcesses && m_prewarmedProcesses.size() < m_prewarmedProcessCount)
+        m_prewarmedProcessRefillTimer.startOneShot(prewarmedProcessRefillDelay);
+}
+
+void WebContext::trimPrewarmedProcesses(bool critical)
+{
+    // Keep one process around for the next page unless memory is critically low. The pool is refilled
+    // the next time a page takes a process from it.
+    m_prewarmedProcessRefillTimer.stop();
+    terminatePrewarmedProcesses(critical ? 0 : 1);
+}
+
+void WebContext::terminatePrewarmedProcesses(size_t processesToKeep)
+{
+    // Processes that are still launching cannot be terminated yet, so they stay in the pool.
+    Vector<RefPtr<WebProcessProxy>> processesToTerminate;
+    for (size_t i = m_prewarmedProcesses.size(); i > 0 && m_prewarmedProcesses.size() > processesToKeep; --i) {
+        if (m_prewarmedProcesses[i - 1]->state() == WebProcessProxy::State::Running) {
+            processesToTerminate.append(m_prewarmedProcesses[i - 1]);
+            m_prewarmedProcesses.remove(i - 1);
+        }
+    }
+
+    for (auto& process : processesToTerminate)
+        process->requestTermination();
+}
+
+PassRefPtr<WebProcessProxy> WebContext::takePrewarmedProcess()
+{
+    while (!m_prewarmedProcesses.isEmpty()) {
+        RefPtr<WebProcessProxy> process = m_prewarmedProcesses.takeLast();
+        if (process->state() != WebProcessProxy::State::Terminated)
+            return process.release();
+    }
+    return nullptr;
+}
+
+void WebContext::prewarmedProcessRefillTimerFired()
+{
+    if (m_processModel != ProcessModelMultipleSecondaryProcesses)
+        return;
+
+    if (m_prewarmedProcesses.size() >= m_prewarmedProcessCount || m_processes.size() >= m_webProcessCountLimit)
+        return;
+
+    // Launch one process at a time so that the launches are spread out rather than competing with each other.
+    m_prewarmedProcesses.append(&createNewWebProcess());
+    if (m_prewarmedProcesses.size() < m_prewarmedProcessCount)
+        m_prewarmedProcessRefillTimer.startOneShot(prewarmedProcessRefillDelay);
 }
 
 void WebContext::enableProcessTermination()
@@ -787,6 +885,9 @@ void WebContext::processDidFinishLaunching(WebProcessProxy* process)
 {
     ASSERT(m_processes.contains(process));
 
+    ++m_processLaunchCount;
+    m_totalProcessLaunchTime += monotonicallyIncreasingTime() - process->launchStartTime();
+
     if (!m_visitedLinksPopulated) {
         populateVisitedLinks();
         m_visitedLinksPopulated = true;
@@ -806,12 +907,19 @@ void WebContext::processDidFinishLaunching(WebProcessProxy* process)
     m_connectionClient.didCreateConnection(this, process->webConnection());
 }
 
+void WebContext::pageDidFirstPaint(double timeSinceFirstLoad)
+{
+    ++m_firstPaintCount;
+    m_totalTimeToFirstPaint += timeSinceFirstLoad;
+}
+
 void WebContext::disconnectProcess(WebProcessProxy* process)
 {
     ASSERT(m_processes.contains(process));
 
-    if (m_haveInitialEmptyProcess && process == m_processes.last())
-        m_haveInitialEmptyProcess = false;
+    size_t prewarmedProcessIndex = m_prewarmedProcesses.find(process);
+    if (prewarmedProcessIndex != notFound)
+        m_prewarmedProcesses.remove(prewarmedProcessIndex);
 
     // FIXME (Multi-WebProcess): <rdar://problem/12239765> Some of the invalidation calls below are still necessary in multi-process mode, but they should only affect data structures pertaining to the process being disconnected.
     // Clearing everything causes assertion failures, so it's less trouble to skip that for now.
@@ -867,15 +975,20 @@ PassRefPtr<WebPageProxy> WebContext::createWebPage(PageClient& pageClient, WebPa
     RefPtr<WebProcessProxy> process;
     if (m_processModel == ProcessModelSharedSecondaryProcess) {
         process = &ensureSharedWebProcess();
+        m_prewarmedProcesses.clear();
     } else {
-        if (m_haveInitialEmptyProcess) {
-            process = m_processes.last();
-            m_haveInitialEmptyProcess = false;
-        } else if (configuration.relatedPage) {
+        if (configuration.relatedPage) {
             // Sharing processes, e.g. when creating the page via window.open().
             process = &configuration.relatedPage->process();
-        } else
+        } else if ((process = takePrewarmedProcess()))
+            ++m_prewarmedProcessHitCount;
+        else {
             process = &createNewWebProcessRespectingProcessCountLimit();
+            ++m_prewarmedProcessMissCount;
+        }
+
+        if (m_prewarmedProcesses.size() < m_prewarmedProcessCount && !m_prewarmedProcessRefillTimer.isActive())
+            m_prewarmedProcessRefillTimer.startOneShot(prewarmedProcessRefillDelay);
     }
 
     return process->createWebPage(pageClient, WTF::move(configuration));
@@ -1293,6 +1406,19 @@ void WebContext::getStatistics(uint32_t statisticsMask, std::function<void (Immu
     
     if (statisticsMask & StatisticsRequestTypeNetworking)
         requestNetworkingStatistics(request.get());
+
+    // Process launch and first paint times, and the UI process side of the IPC traffic, are measured
+    // in the UI process. They are added last, since completing the final outstanding request performs the callback.
+    // A context that never launched a process has nothing to report, and the request fails.
+    if (m_processes.isEmpty())
+        return;
+
+    uint64_t requestID = request->addOutstandingRequest();
+    StatisticsData statisticsData;
+    if (statisticsMask & StatisticsRequestTypeWebContent)
+        addProcessLaunchStatistics(statisticsData.statisticsNumbers);
+    IPC::MessageStatistics::shared().addStatistics(statisticsData.statisticsNumbers, ASCIILiteral("UIProcess"));
+    request->completedRequest(requestID, statisticsData);
 }
 
 void WebContext::requestWebContentStatistics(StatisticsRequest* request)
@@ -1310,6 +1436,17 @@ void WebContext::requestWebContentStatistics(StatisticsRequest* request)
     }
 }
 
+void WebContext::addProcessLaunchStatistics(HashMap<String, uint64_t>& statistics) const
+{
+    statistics.set(ASCIILiteral("WebProcessLaunchCount"), m_processLaunchCount);
+    statistics.set(ASCIILiteral("WebProcessAverageLaunchTimeInMilliseconds"), m_processLaunchCount ? static_cast<uint64_t>(m_totalProcessLaunchTime * 1000 / m_processLaunchCount) : 0);
+    statistics.set(ASCIILiteral("PrewarmedWebProcessCount"), m_prewarmedProcesses.size());
+    statistics.set(ASCIILiteral("PrewarmedWebProcessHitCount"), m_prewarmedProcessHitCount);
+    statistics.set(ASCIILiteral("PrewarmedWebProcessMissCount"), m_prewarmedProcessMissCount);
+    statistics.set(ASCIILiteral("FirstPaintCount"), m_firstPaintCount);
+    statistics.set(ASCIILiteral("AverageTimeToFirstPaintInMilliseconds"), m_firstPaintCount ? static_cast<uint64_t>(m_totalTimeToFirstPaint * 1000 / m_firstPaintCount) : 0);
+}
+
 void WebContext::requestNetworkingStatistics(StatisticsRequest* request)
 {
     bool networkProcessUnavailable;
@@ -49,6 +49,7 @@
 #include <wtf/HashSet.h>
 #include <wtf/PassRefPtr.h>
 #include <wtf/RefPtr.h>
+#include <wtf/RunLoop.h>
 #include <wtf/text/StringHash.h>
 #include <wtf/text/WTFString.h>
 
@@ -148,6 +149,12 @@ public:
     void setMaximumNumberOfProcesses(unsigned); // Can only be called when there are no processes running.
     unsigned maximumNumberOfProcesses() const { return m_webProcessCountLimit; }
 
+    // Number of launched but idle WebProcesses kept ready for new pages. The pool is refilled in the background
+    // as pages take processes from it. Only used when the process model is ProcessModelMultipleSecondaryProcesses.
+    void setPrewarmedProcessCount(unsigned);
+    unsigned prewarmedProcessCount() const { return m_prewarmedProcessCount; }
+    void trimPrewarmedProcesses(bool critical);
+
     const Vector<RefPtr<WebProcessProxy>>& processes() const { return m_processes; }
 
     // WebProcess or NetworkProcess as approporiate for current process model. The connection must be non-null.
@@ -167,6 +174,7 @@ public:
     void processWillOpenConnection(WebProcessProxy*);
     void processWillCloseConnection(WebProcessProxy*);
     void processDidFinishLaunching(WebProcessProxy*);
+    void pageDidFirstPaint(double timeSinceFirstLoad);
 
     void applicationWillTerminate();
     // Disconnect the process from the context.
@@ -360,6 +368,11 @@ private:
 
     WebProcessProxy& createNewWebProcess();
 
+    PassRefPtr<WebProcessProxy> takePrewarmedProcess();
+    void terminatePrewarmedProcesses(size_t processesToKeep);
+    void prewarmedProcessRefillTimerFired();
+    void addProcessLaunchStatistics(HashMap<String, uint64_t>&) const;
+
     void requestWebContentStatistics(StatisticsRequest*);
     void requestNetworkingStatistics(StatisticsRequest*);
 
@@ -452,7 +465,17 @@ private:
     unsigned m_webProcessCountLimit; // The limit has no effect when process model is ProcessModelSharedSecondaryProcess.
     
     Vector<RefPtr<WebProcessProxy>> m_processes;
-    bool m_haveInitialEmptyProcess;
+    // Processes that have not been given a page yet, also listed in m_processes.
+    Vector<RefPtr<WebProcessProxy>> m_prewarmedProcesses;
+    unsigned m_prewarmedProcessCount;
+    RunLoop::Timer<WebContext> m_prewarmedProcessRefillTimer;
+
+    uint64_t m_processLaunchCount;
+    double m_totalProcessLaunchTime;
+    uint64_t m_prewarmedProcessHitCount;
+    uint64_t m_prewarmedProcessMissCount;
+    uint64_t m_firstPaintCount;
+    double m_totalTimeToFirstPaint;
 
     WebProcessProxy* m_processWithPageCache;
 
@@ -100,6 +100,7 @@
 #include <WebCore/TextCheckerClient.h>
 #include <WebCore/WindowFeatures.h>
 #include <stdio.h>
+#include <wtf/CurrentTime.h>
 #include <wtf/NeverDestroyed.h>
 #include <wtf/text/StringView.h>
 
@@ -306,6 +307,8 @@ WebPageProxy::WebPageProxy(PageClient& pageClient, WebProcessProxy& process, uin
     , m_gapBetweenPages(0)
     , m_isValid(true)
     , m_isClosed(false)
+    , m_firstLoadStartTime(0)
+    , m_didReportFirstPaint(false)
     , m_canRunModal(false)
     , m_isInPrintingMode(false)
     , m_isPerformingDOMPrintOperation(false)
@@ -725,6 +728,9 @@ uint64_t WebPageProxy::loadRequest(const ResourceRequest& request, API::Object*
 
     uint64_t navigationID = generateNavigationID();
 
+    if (!m_firstLoadStartTime)
+        m_firstLoadStartTime = monotonicallyIncreasingTime();
+
     auto transaction = m_pageLoadState.transaction();
 
     m_pageLoadState.setPendingAPIRequestURL(transaction, request.url());
@@ -2779,8 +2785,15 @@ void WebPageProxy::didFirstVisuallyNonEmptyLayoutForFrame(uint64_t frameID, IPC:
 
     m_loaderClient->didFirstVisuallyNonEmptyLayoutForFrame(this, frame, userData.get());
 
-    if (frame->isMainFrame())
+    if (frame->isMainFrame()) {
         m_pageClient.didFirstVisuallyNonEmptyLayoutForMainFrame();
+
+        // The first visually non-empty layout is when the page is first painted with content.
+        if (m_firstLoadStartTime && !m_didReportFirstPaint) {
+            m_didReportFirstPaint = true;
+            m_process->context().pageDidFirstPaint(monotonicallyIncreasingTime() - m_firstLoadStartTime);
+        }
+    }
 }
 
 void WebPageProxy::didLayout(uint32_t layoutMilestones, IPC::MessageDecoder& decoder)
@@ -1421,6 +1421,10 @@ private:
     // Whether WebPageProxy::close() has been called on this page.
     bool m_isClosed;
 
+    // When the first load was requested, used to report the time to the first paint to the WebContext.
+    double m_firstLoadStartTime;
+    bool m_didReportFirstPaint;
+
     // Whether it can run modal child web pages.
     bool m_canRunModal;
 
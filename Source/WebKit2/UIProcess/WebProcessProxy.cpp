@@ -49,6 +49,7 @@
 #include <WebCore/SuddenTermination.h>
 #include <WebCore/URL.h>
 #include <stdio.h>
+#include <wtf/CurrentTime.h>
 #include <wtf/NeverDestroyed.h>
 #include <wtf/RunLoop.h>
 #include <wtf/text/CString.h>
@@ -91,6 +92,7 @@ WebProcessProxy::WebProcessProxy(WebContext& context)
     : m_responsivenessTimer(this)
     , m_context(context)
     , m_mayHaveUniversalFileReadSandboxExtension(false)
+    , m_launchStartTime(monotonicallyIncreasingTime())
 #if ENABLE(CUSTOM_PROTOCOLS)
     , m_customProtocolManagerProxy(this, context)
 #endif
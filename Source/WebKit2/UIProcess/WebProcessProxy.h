@@ -90,6 +90,8 @@ public:
     WTF::IteratorRange<WebPageProxyMap::const_iterator::Values> pages() const { return m_pageMap.values(); }
     unsigned pageCount() const { return m_pageMap.size(); }
 
+    double launchStartTime() const { return m_launchStartTime; }
+
     void addVisitedLinkProvider(VisitedLinkProvider&);
     void addWebUserContentControllerProxy(WebUserContentControllerProxy&);
     void didDestroyVisitedLinkProvider(VisitedLinkProvider&);
@@ -213,6 +215,7 @@ private:
     Ref<WebContext> m_context;
 
     bool m_mayHaveUniversalFileReadSandboxExtension; // True if a read extension for "/" was ever granted - we don't track whether WebProcess still has it.
+    double m_launchStartTime;
     HashSet<String> m_localPathsWithAssumedReadAccess;
 
     WebPageProxyMap m_pageMap;
@@ -40,6 +40,7 @@
 #include <WebCore/IDBDatabaseMetadata.h>
 #include <WebCore/IDBKeyRangeData.h>
 #include <WebCore/SecurityOrigin.h>
+#include <wtf/RunLoop.h>
 
 using namespace WebCore;
 
@@ -226,6 +227,8 @@ void WebIDBServerConnection::commitTransaction(int64_t transactionID, BoolCallba
 
     LOG(IDB, "WebProcess commitTransaction ID %lli (request ID %llu)", transactionID, requestID);
 
+    removePrefetchedCursorRecords(transactionID);
+
     send(Messages::DatabaseProcessIDBConnection::CommitTransaction(requestID, transactionID));
 }
 
@@ -251,6 +254,8 @@ void WebIDBServerConnection::resetTransaction(int64_t transactionID, std::functi
 
     LOG(IDB, "WebProcess resetTransaction ID %lli (request ID %llu)", transactionID, requestID);
 
+    removePrefetchedCursorRecords(transactionID);
+
     send(Messages::DatabaseProcessIDBConnection::ResetTransaction(requestID, transactionID));
 }
 
@@ -268,6 +273,8 @@ void WebIDBServerConnection::didResetTransaction(uint64_t requestID, bool)
 
 bool WebIDBServerConnection::resetTransactionSync(int64_t transactionID)
 {
+    removePrefetchedCursorRecords(transactionID);
+
     bool success;
     sendSync(Messages::DatabaseProcessIDBConnection::ResetTransactionSync(transactionID), Messages::DatabaseProcessIDBConnection::ResetTransactionSync::Reply(success));
     return success;
@@ -283,6 +290,8 @@ void WebIDBServerConnection::rollbackTransaction(int64_t transactionID, std::fun
 
     LOG(IDB, "WebProcess rollbackTransaction ID %lli (request ID %llu)", transactionID, requestID);
 
+    removePrefetchedCursorRecords(transactionID);
+
     send(Messages::DatabaseProcessIDBConnection::RollbackTransaction(requestID, transactionID));
 }
 
@@ -300,6 +309,8 @@ void WebIDBServerConnection::didRollbackTransaction(uint64_t requestID, bool)
 
 bool WebIDBServerConnection::rollbackTransactionSync(int64_t transactionID)
 {
+    removePrefetchedCursorRecords(transactionID);
+
     bool success;
     sendSync(Messages::DatabaseProcessIDBConnection::RollbackTransactionSync(transactionID), Messages::DatabaseProcessIDBConnection::RollbackTransactionSync::Reply(success));
     return success;
@@ -353,6 +364,8 @@ void WebIDBServerConnection::createIndex(IDBTransactionBackend&transaction, cons
 
     LOG(IDB, "WebProcess create index request ID %llu", requestID);
 
+    invalidatePrefetchedCursorRecords(transaction.id());
+
     send(Messages::DatabaseProcessIDBConnection::CreateIndex(requestID, transaction.id(), operation.objectStoreID(), operation.idbIndexMetadata()));
 }
 
@@ -382,6 +395,8 @@ void WebIDBServerConnection::deleteIndex(IDBTransactionBackend&transaction, cons
 
     LOG(IDB, "WebProcess delete index request ID %llu", requestID);
 
+    invalidatePrefetchedCursorRecords(transaction.id());
+
     send(Messages::DatabaseProcessIDBConnection::DeleteIndex(requestID, transaction.id(), operation.objectStoreID(), operation.idbIndexMetadata().id));
 }
 
@@ -430,6 +445,8 @@ void WebIDBServerConnection::put(IDBTransactionBackend& transaction, const PutOp
 
     LOG(IDB, "WebProcess put request ID %llu", requestID);
 
+    invalidatePrefetchedCursorRecords(transaction.id());
+
     ASSERT(operation.value());
 
     IPC::DataReference value(reinterpret_cast<const uint8_t*>(operation.value()->data()), operation.value()->size());
@@ -468,7 +485,7 @@ void WebIDBServerConnection::didGetRecord(uint64_t requestID, const WebCore::IDB
     serverRequest->completeRequest(getResult, errorCode ? IDBDatabaseError::create(errorCode, errorMessage) : nullptr);
 }
 
-void WebIDBServerConnection::didOpenCursor(uint64_t requestID, int64_t cursorID, const IDBKeyData& key, const IDBKeyData& primaryKey, const IPC::DataReference& valueData, uint32_t errorCode, const String& errorMessage)
+void WebIDBServerConnection::didOpenCursor(uint64_t requestID, int64_t cursorID, const IDBKeyData& key, const IDBKeyData& primaryKey, const IPC::DataReference& valueData, const Vector<IDBCursorRecord>& prefetchedRecords, uint32_t errorCode, const String& errorMessage)
 {
     LOG(IDB, "WebProcess didOpenCursor request ID %llu (error - %s)", requestID, errorMessage.utf8().data());
 
@@ -478,10 +495,10 @@ void WebIDBServerConnection::didOpenCursor(uint64_t requestID, int64_t cursorID,
         return;
 
     RefPtr<SharedBuffer> value = SharedBuffer::create(valueData.data(), valueData.size());
-    serverRequest->completeRequest(cursorID, key.maybeCreateIDBKey(), primaryKey.maybeCreateIDBKey(), value.release(), errorCode ? IDBDatabaseError::create(errorCode, errorMessage) : nullptr);
+    serverRequest->completeRequest(cursorID, key.maybeCreateIDBKey(), primaryKey.maybeCreateIDBKey(), value.release(), prefetchedRecords, errorCode ? IDBDatabaseError::create(errorCode, errorMessage) : nullptr);
 }
 
-void WebIDBServerConnection::didAdvanceCursor(uint64_t requestID, const IDBKeyData& key, const IDBKeyData& primaryKey, const IPC::DataReference& valueData, uint32_t errorCode, const String& errorMessage)
+void WebIDBServerConnection::didAdvanceCursor(uint64_t requestID, const IDBKeyData& key, const IDBKeyData& primaryKey, const IPC::DataReference& valueData, const Vector<IDBCursorRecord>& prefetchedRecords, uint32_t errorCode, const String& errorMessage)
 {
     LOG(IDB, "WebProcess didAdvanceCursor request ID %llu (error - %s)", requestID, errorMessage.utf8().data());
 
@@ -491,10 +508,10 @@ void WebIDBServerConnection::didAdvanceCursor(uint64_t requestID, const IDBKeyDa
         return;
 
     RefPtr<SharedBuffer> value = SharedBuffer::create(valueData.data(), valueData.size());
-    serverRequest->completeRequest(key.maybeCreateIDBKey(), primaryKey.maybeCreateIDBKey(), value.release(), errorCode ? IDBDatabaseError::create(errorCode, errorMessage) : nullptr);
+    serverRequest->completeRequest(key.maybeCreateIDBKey(), primaryKey.maybeCreateIDBKey(), value.release(), prefetchedRecords, errorCode ? IDBDatabaseError::create(errorCode, errorMessage) : nullptr);
 }
 
-void WebIDBServerConnection::didIterateCursor(uint64_t requestID, const IDBKeyData& key, const IDBKeyData& primaryKey, const IPC::DataReference& valueData, uint32_t errorCode, const String& errorMessage)
+void WebIDBServerConnection::didIterateCursor(uint64_t requestID, const IDBKeyData& key, const IDBKeyData& primaryKey, const IPC::DataReference& valueData, const Vector<IDBCursorRecord>& prefetchedRecords, uint32_t errorCode, const String& errorMessage)
 {
     LOG(IDB, "WebProcess didIterateCursor request ID %llu (error - %s)", requestID, errorMessage.utf8().data());
 
@@ -504,7 +521,7 @@ void WebIDBServerConnection::didIterateCursor(uint64_t requestID, const IDBKeyDa
         return;
 
     RefPtr<SharedBuffer> value = SharedBuffer::create(valueData.data(), valueData.size());
-    serverRequest->completeRequest(key.maybeCreateIDBKey(), primaryKey.maybeCreateIDBKey(), value.release(), errorCode ? IDBDatabaseError::create(errorCode, errorMessage) : nullptr);
+    serverRequest->completeRequest(key.maybeCreateIDBKey(), primaryKey.maybeCreateIDBKey(), value.release(), prefetchedRecords, errorCode ? IDBDatabaseError::create(errorCode, errorMessage) : nullptr);
 }
 
 void WebIDBServerConnection::count(IDBTransactionBackend& transaction, const CountOperation& operation, std::function<void(int64_t, PassRefPtr<IDBDatabaseError>)> completionCallback)
@@ -550,6 +567,8 @@ void WebIDBServerConnection::deleteRange(IDBTransactionBackend& transaction, con
 
     LOG(IDB, "WebProcess deleteRange request ID %llu", requestID);
 
+    invalidatePrefetchedCursorRecords(transaction.id());
+
     send(Messages::DatabaseProcessIDBConnection::DeleteRange(requestID, transaction.id(), operation.objectStoreID(), IDBKeyRangeData(operation.keyRange())));
 }
 
@@ -579,6 +598,8 @@ void WebIDBServerConnection::clearObjectStore(IDBTransactionBackend&, const Clea
 
     LOG(IDB, "WebProcess clearObjectStore request ID %llu", requestID);
 
+    invalidatePrefetchedCursorRecords(operation.transaction()->id());
+
     send(Messages::DatabaseProcessIDBConnection::ClearObjectStore(requestID, operation.transaction()->id(), operation.objectStoreID()));
 }
 
@@ -608,6 +629,8 @@ void WebIDBServerConnection::deleteObjectStore(IDBTransactionBackend&, const Del
 
     LOG(IDB, "WebProcess deleteObjectStore request ID %llu", requestID);
 
+    invalidatePrefetchedCursorRecords(operation.transaction()->id());
+
     send(Messages::DatabaseProcessIDBConnection::DeleteObjectStore(requestID, operation.transaction()->id(), operation.objectStoreMetadata().id));
 }
 
@@ -654,7 +677,19 @@ void WebIDBServerConnection::didChangeDatabaseVersion(uint64_t requestID, bool s
 
 void WebIDBServerConnection::openCursor(IDBTransactionBackend&, const OpenCursorOperation& operation, std::function<void(int64_t, PassRefPtr<IDBKey>, PassRefPtr<IDBKey>, PassRefPtr<SharedBuffer>, PassRefPtr<IDBDatabaseError>)> completionCallback)
 {
-    RefPtr<AsyncRequest> serverRequest = AsyncRequestImpl<int64_t, PassRefPtr<IDBKey>, PassRefPtr<IDBKey>, PassRefPtr<SharedBuffer>, PassRefPtr<IDBDatabaseError>>::create(completionCallback);
+    int64_t transactionID = operation.transactionID();
+    IndexedDB::CursorDirection direction = operation.direction();
+    RefPtr<AsyncRequest> serverRequest = AsyncRequestImpl<int64_t, PassRefPtr<IDBKey>, PassRefPtr<IDBKey>, PassRefPtr<SharedBuffer>, const Vector<IDBCursorRecord>&, PassRefPtr<IDBDatabaseError>>::create([this, transactionID, direction, completionCallback](int64_t cursorID, PassRefPtr<IDBKey> key, PassRefPtr<IDBKey> primaryKey, PassRefPtr<SharedBuffer> value, const Vector<IDBCursorRecord>& prefetchedRecords, PassRefPtr<IDBDatabaseError> error) {
+        if (!error) {
+            CursorPrefetch prefetch;
+            prefetch.transactionID = transactionID;
+            prefetch.direction = direction;
+            prefetch.recordsConsumed = 0;
+            m_cursorPrefetches.set(cursorID, prefetch);
+            setPrefetchedCursorRecords(cursorID, prefetchedRecords);
+        }
+        completionCallback(cursorID, key, primaryKey, value, error);
+    });
 
     serverRequest->setAbortHandler([completionCallback]() {
         completionCallback(0, nullptr, nullptr, nullptr, IDBDatabaseError::create(IDBDatabaseException::UnknownError, "Unknown error occured opening database cursor"));
@@ -671,7 +706,18 @@ void WebIDBServerConnection::openCursor(IDBTransactionBackend&, const OpenCursor
 
 void WebIDBServerConnection::cursorAdvance(IDBCursorBackend&, const CursorAdvanceOperation& operation, std::function<void(PassRefPtr<IDBKey>, PassRefPtr<IDBKey>, PassRefPtr<SharedBuffer>, PassRefPtr<IDBDatabaseError>)> completionCallback)
 {
-    RefPtr<AsyncRequest> serverRequest = AsyncRequestImpl<PassRefPtr<IDBKey>, PassRefPtr<IDBKey>, PassRefPtr<SharedBuffer>, PassRefPtr<IDBDatabaseError>>::create(completionCallback);
+    int64_t cursorID = operation.cursorID();
+
+    IDBCursorRecord record;
+    if (advanceCursorWithPrefetchedRecords(cursorID, operation.count(), record)) {
+        completeCursorOperationWithPrefetchedRecord(record, completionCallback);
+        return;
+    }
+
+    RefPtr<AsyncRequest> serverRequest = AsyncRequestImpl<PassRefPtr<IDBKey>, PassRefPtr<IDBKey>, PassRefPtr<SharedBuffer>, const Vector<IDBCursorRecord>&, PassRefPtr<IDBDatabaseError>>::create([this, cursorID, completionCallback](PassRefPtr<IDBKey> key, PassRefPtr<IDBKey> primaryKey, PassRefPtr<SharedBuffer> value, const Vector<IDBCursorRecord>& prefetchedRecords, PassRefPtr<IDBDatabaseError> error) {
+        setPrefetchedCursorRecords(cursorID, prefetchedRecords);
+        completionCallback(key, primaryKey, value, error);
+    });
 
     serverRequest->setAbortHandler([completionCallback]() {
         completionCallback(nullptr, nullptr, nullptr, IDBDatabaseError::create(IDBDatabaseException::UnknownError, "Unknown error occured advancing database cursor"));
@@ -683,12 +729,24 @@ void WebIDBServerConnection::cursorAdvance(IDBCursorBackend&, const CursorAdvanc
 
     LOG(IDB, "WebProcess cursorAdvance request ID %llu", requestID);
 
-    send(Messages::DatabaseProcessIDBConnection::CursorAdvance(requestID, operation.cursorID(), operation.count()));
+    send(Messages::DatabaseProcessIDBConnection::CursorAdvance(requestID, cursorID, operation.count(), takePrefetchedRecordsConsumed(cursorID)));
 }
 
 void WebIDBServerConnection::cursorIterate(IDBCursorBackend&, const CursorIterationOperation& operation, std::function<void(PassRefPtr<IDBKey>, PassRefPtr<IDBKey>, PassRefPtr<SharedBuffer>, PassRefPtr<IDBDatabaseError>)> completionCallback)
 {
-    RefPtr<AsyncRequest> serverRequest = AsyncRequestImpl<PassRefPtr<IDBKey>, PassRefPtr<IDBKey>, PassRefPtr<SharedBuffer>, PassRefPtr<IDBDatabaseError>>::create(completionCallback);
+    int64_t cursorID = operation.cursorID();
+    IDBKeyData targetKey(operation.key());
+
+    IDBCursorRecord record;
+    if (iterateCursorWithPrefetchedRecords(cursorID, targetKey, record)) {
+        completeCursorOperationWithPrefetchedRecord(record, completionCallback);
+        return;
+    }
+
+    RefPtr<AsyncRequest> serverRequest = AsyncRequestImpl<PassRefPtr<IDBKey>, PassRefPtr<IDBKey>, PassRefPtr<SharedBuffer>, const Vector<IDBCursorRecord>&, PassRefPtr<IDBDatabaseError>>::create([this, cursorID, completionCallback](PassRefPtr<IDBKey> key, PassRefPtr<IDBKey> primaryKey, PassRefPtr<SharedBuffer> value, const Vector<IDBCursorRecord>& prefetchedRecords, PassRefPtr<IDBDatabaseError> error) {
+        setPrefetchedCursorRecords(cursorID, prefetchedRecords);
+        completionCallback(key, primaryKey, value, error);
+    });
 
     serverRequest->setAbortHandler([completionCallback]() {
         completionCallback(nullptr, nullptr, nullptr, IDBDatabaseError::create(IDBDatabaseException::UnknownError, "Unknown error occured iterating database cursor"));
@@ -700,7 +758,111 @@ void WebIDBServerConnection::cursorIterate(IDBCursorBackend&, const CursorIterat
 
     LOG(IDB, "WebProcess cursorIterate request ID %llu", requestID);
 
-    send(Messages::DatabaseProcessIDBConnection::CursorIterate(requestID, operation.cursorID(), operation.key()));
+    send(Messages::DatabaseProcessIDBConnection::CursorIterate(requestID, cursorID, targetKey, takePrefetchedRecordsConsumed(cursorID)));
+}
+
+void WebIDBServerConnection::completeCursorOperationWithPrefetchedRecord(const IDBCursorRecord& record, std::function<void(PassRefPtr<IDBKey>, PassRefPtr<IDBKey>, PassRefPtr<SharedBuffer>, PassRefPtr<IDBDatabaseError>)> completionCallback)
+{
+    // Like replies from the DatabaseProcess, the result is delivered from the run loop rather
+    // than from within the operation.
+    RefPtr<IDBKey> key = record.key.maybeCreateIDBKey();
+    RefPtr<IDBKey> primaryKey = record.primaryKey.maybeCreateIDBKey();
+    RefPtr<SharedBuffer> value = SharedBuffer::create(record.valueBuffer.data(), record.valueBuffer.size());
+
+    RunLoop::main().dispatch([key, primaryKey, value, completionCallback]() {
+        completionCallback(key, primaryKey, value, nullptr);
+    });
+}
+
+void WebIDBServerConnection::setPrefetchedCursorRecords(int64_t cursorID, const Vector<IDBCursorRecord>& records)
+{
+    auto it = m_cursorPrefetches.find(cursorID);
+    if (it == m_cursorPrefetches.end())
+        return;
+
+    // The DatabaseProcess has moved past the records used so far, and sent the ones following.
+    it->value.records.clear();
+    for (const auto& record : records)
+        it->value.records.append(record);
+    it->value.recordsConsumed = 0;
+}
+
+uint64_t WebIDBServerConnection::takePrefetchedRecordsConsumed(int64_t cursorID)
+{
+    auto it = m_cursorPrefetches.find(cursorID);
+    if (it == m_cursorPrefetches.end())
+        return 0;
+
+    uint64_t recordsConsumed = it->value.recordsConsumed;
+    it->value.records.clear();
+    it->value.recordsConsumed = 0;
+    return recordsConsumed;
+}
+
+bool WebIDBServerConnection::advanceCursorWithPrefetchedRecords(int64_t cursorID, uint64_t count, IDBCursorRecord& result)
+{
+    auto it = m_cursorPrefetches.find(cursorID);
+    if (it == m_cursorPrefetches.end() || !count || it->value.records.size() < count)
+        return false;
+
+    CursorPrefetch& prefetch = it->value;
+    for (uint64_t i = 0; i < count; ++i)
+        result = prefetch.records.takeFirst();
+    prefetch.recordsConsumed += count;
+
+    return true;
+}
+
+bool WebIDBServerConnection::iterateCursorWithPrefetchedRecords(int64_t cursorID, const IDBKeyData& targetKey, IDBCursorRecord& result)
+{
+    auto it = m_cursorPrefetches.find(cursorID);
+    if (it == m_cursorPrefetches.end())
+        return false;
+
+    // Iterating moves at least one record, then on to the first key at or past the target key.
+    // If none of the prefetched records qualifies, they are all used and the DatabaseProcess
+    // continues from the last one.
+    CursorPrefetch& prefetch = it->value;
+    bool isNext = prefetch.direction == IndexedDB::CursorDirection::Next || prefetch.direction == IndexedDB::CursorDirection::NextNoDuplicate;
+    size_t i = 0;
+    for (const auto& record : prefetch.records) {
+        if (targetKey.isNull || record.key.isNull)
+            break;
+        int comparison = record.key.compare(targetKey);
+        if (isNext ? comparison >= 0 : comparison <= 0)
+            break;
+        ++i;
+    }
+
+    if (i == prefetch.records.size()) {
+        prefetch.recordsConsumed += prefetch.records.size();
+        prefetch.records.clear();
+        return false;
+    }
+
+    return advanceCursorWithPrefetchedRecords(cursorID, i + 1, result);
+}
+
+void WebIDBServerConnection::invalidatePrefetchedCursorRecords(int64_t transactionID)
+{
+    // The prefetched records may no longer match the object stores. The records already used
+    // still count, as the DatabaseProcess has not moved past them yet.
+    for (auto& prefetch : m_cursorPrefetches.values()) {
+        if (prefetch.transactionID == transactionID)
+            prefetch.records.clear();
+    }
+}
+
+void WebIDBServerConnection::removePrefetchedCursorRecords(int64_t transactionID)
+{
+    Vector<int64_t> cursorIDs;
+    for (const auto& it : m_cursorPrefetches) {
+        if (it.value.transactionID == transactionID)
+            cursorIDs.append(it.key);
+    }
+
+    for (int64_t cursorID : cursorIDs)
+        m_cursorPrefetches.remove(cursorID);
 }
 
 IPC::Connection* WebIDBServerConnection::messageSenderConnection()
@@ -29,9 +29,12 @@
 
 #if ENABLE(INDEXED_DATABASE) && ENABLE(DATABASE_PROCESS)
 
+#include "IDBCursorRecord.h"
 #include "MessageSender.h"
 #include <WebCore/IDBDatabaseMetadata.h>
 #include <WebCore/IDBServerConnection.h>
+#include <wtf/Deque.h>
+#include <wtf/HashMap.h>
 
 namespace WebCore {
 struct IDBKeyData;
@@ -113,12 +116,29 @@ private:
     void didDeleteIndex(uint64_t requestID, bool success);
     void didPutRecord(uint64_t requestID, const WebCore::IDBKeyData&, uint32_t errorCode, const String& errorMessage);
     void didGetRecord(uint64_t requestID, const WebCore::IDBGetResult&, uint32_t errorCode, const String& errorMessage);
-    void didOpenCursor(uint64_t requestID, int64_t cursorID, const WebCore::IDBKeyData&, const WebCore::IDBKeyData&, const IPC::DataReference&, uint32_t errorCode, const String& errorMessage);
-    void didAdvanceCursor(uint64_t requestID, const WebCore::IDBKeyData&, const WebCore::IDBKeyData&, const IPC::DataReference&, uint32_t errorCode, const String& errorMessage);
-    void didIterateCursor(uint64_t requestID, const WebCore::IDBKeyData&, const WebCore::IDBKeyData&, const IPC::DataReference&, uint32_t errorCode, const String& errorMessage);
+    void didOpenCursor(uint64_t requestID, int64_t cursorID, const WebCore::IDBKeyData&, const WebCore::IDBKeyData&, const IPC::DataReference&, const Vector<IDBCursorRecord>&, uint32_t errorCode, const String& errorMessage);
+    void didAdvanceCursor(uint64_t requestID, const WebCore::IDBKeyData&, const WebCore::IDBKeyData&, const IPC::DataReference&, const Vector<IDBCursorRecord>&, uint32_t errorCode, const String& errorMessage);
+    void didIterateCursor(uint64_t requestID, const WebCore::IDBKeyData&, const WebCore::IDBKeyData&, const IPC::DataReference&, const Vector<IDBCursorRecord>&, uint32_t errorCode, const String& errorMessage);
     void didCount(uint64_t requestID, int64_t count, uint32_t errorCode, const String& errorMessage);
     void didDeleteRange(uint64_t requestID, uint32_t errorCode, const String& errorMessage);
 
+    // Records the DatabaseProcess read ahead for a cursor. Advancing or iterating through them is
+    // answered here, and the number used is reported with the next request for that cursor.
+    struct CursorPrefetch {
+        int64_t transactionID;
+        WebCore::IndexedDB::CursorDirection direction;
+        Deque<IDBCursorRecord> records;
+        uint64_t recordsConsumed;
+    };
+
+    void setPrefetchedCursorRecords(int64_t cursorID, const Vector<IDBCursorRecord>&);
+    uint64_t takePrefetchedRecordsConsumed(int64_t cursorID);
+    bool advanceCursorWithPrefetchedRecords(int64_t cursorID, uint64_t count, IDBCursorRecord&);
+    bool iterateCursorWithPrefetchedRecords(int64_t cursorID, const WebCore::IDBKeyData&, IDBCursorRecord&);
+    void completeCursorOperationWithPrefetchedRecord(const IDBCursorRecord&, std::function<void(PassRefPtr<WebCore::IDBKey>, PassRefPtr<WebCore::IDBKey>, PassRefPtr<WebCore::SharedBuffer>, PassRefPtr<WebCore::IDBDatabaseError>)> completionCallback);
+    void invalidatePrefetchedCursorRecords(int64_t transactionID);
+    void removePrefetchedCursorRecords(int64_t transactionID);
+
     uint64_t m_serverConnectionIdentifier;
 
     String m_databaseName;
@@ -126,6 +146,7 @@ private:
     Ref<WebCore::SecurityOrigin> m_mainFrameOrigin;
 
     HashMap<uint64_t, RefPtr<AsyncRequest>> m_serverRequests;
+    HashMap<int64_t, CursorPrefetch> m_cursorPrefetches;
 };
 
 } // namespace WebKit
@@ -88,6 +88,16 @@ size_t WKBundleGetJavaScriptObjectsCount(WKBundleRef bundleRef)
     return toImpl(bundleRef)->javaScriptObjectsCount();
 }
 
+WKStringRef WKBundleCopyStyleResolverStatistics(WKBundleRef bundleRef)
+{
+    return toCopiedAPI(toImpl(bundleRef)->styleResolverStatistics());
+}
+
+void WKBundleResetStyleResolverStatistics(WKBundleRef bundleRef)
+{
+    toImpl(bundleRef)->resetStyleResolverStatistics();
+}
+
 void WKBundleSetAlwaysAcceptCookies(WKBundleRef bundleRef, bool accept)
 {
     toImpl(bundleRef)->setAlwaysAcceptCookies(accept);
@@ -97,6 +97,10 @@ WK_EXPORT void WKBundleGarbageCollectJavaScriptObjects(WKBundleRef bundle);
 WK_EXPORT void WKBundleGarbageCollectJavaScriptObjectsOnAlternateThreadForDebugging(WKBundleRef bundle, bool waitUntilDone);
 WK_EXPORT size_t WKBundleGetJavaScriptObjectsCount(WKBundleRef bundle);
 
+// Style resolution API
+WK_EXPORT WKStringRef WKBundleCopyStyleResolverStatistics(WKBundleRef bundle);
+WK_EXPORT void WKBundleResetStyleResolverStatistics(WKBundleRef bundle);
+
 WK_EXPORT bool WKBundleIsProcessingUserGesture(WKBundleRef bundle);
 
 WK_EXPORT void WKBundleSetTabKeyCyclesThroughElements(WKBundleRef bundle, WKBundlePageRef page, bool enabled);
@@ -70,6 +70,7 @@
 #include <WebCore/SecurityPolicy.h>
 #include <WebCore/SessionID.h>
 #include <WebCore/Settings.h>
+#include <WebCore/StyleResolver.h>
 #include <WebCore/UserGestureIndicator.h>
 
 #if ENABLE(CSS_REGIONS) || ENABLE(CSS_COMPOSITING)
@@ -221,7 +222,8 @@ void InjectedBundle::overrideBoolPreferenceForTestRunner(WebPageGroupProxy* page
     macro(WebKitShouldRespectImageOrientation, ShouldRespectImageOrientation, shouldRespectImageOrientation) \
     macro(WebKitEnableCaretBrowsing, CaretBrowsingEnabled, caretBrowsingEnabled) \
     macro(WebKitDisplayImagesKey, LoadsImagesAutomatically, loadsImagesAutomatically) \
-    macro(WebKitMediaStreamEnabled, MediaStreamEnabled, mediaStreamEnabled)
+    macro(WebKitMediaStreamEnabled, MediaStreamEnabled, mediaStreamEnabled) \
+    macro(WebKitSharedMatchedPropertiesCacheEnabled, SharedMatchedPropertiesCacheEnabled, sharedMatchedPropertiesCacheEnabled)
 
 #define OVERRIDE_PREFERENCE_AND_SET_IN_EXISTING_PAGES(TestRunnerName, SettingsName, WebPreferencesName) \
     if (preference == #TestRunnerName) { \
@@ -527,6 +529,16 @@ size_t InjectedBundle::javaScriptObjectsCount()
     return JSDOMWindow::commonVM().heap.objectCount();
 }
 
+String InjectedBundle::styleResolverStatistics()
+{
+    return StyleResolver::statisticsAsText();
+}
+
+void InjectedBundle::resetStyleResolverStatistics()
+{
+    StyleResolver::statistics().reset();
+}
+
 void InjectedBundle::reportException(JSContextRef context, JSValueRef exception)
 {
     if (!context || !exception)
@@ -155,6 +155,10 @@ public:
     void garbageCollectJavaScriptObjectsOnAlternateThreadForDebugging(bool waitUntilDone);
     size_t javaScriptObjectsCount();
 
+    // Style resolution API
+    String styleResolverStatistics();
+    void resetStyleResolverStatistics();
+
     // Callback hooks
     void didCreatePage(WebPage*);
     void willDestroyPage(WebPage*);
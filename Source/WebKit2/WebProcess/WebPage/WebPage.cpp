@@ -2842,6 +2842,7 @@ void WebPage::updatePreferences(const WebPreferencesStore& store)
 #endif
 
     settings.setLongMousePressEnabled(store.getBoolValueForKey(WebPreferencesKey::longMousePressEnabledKey()));
+    settings.setSharedMatchedPropertiesCacheEnabled(store.getBoolValueForKey(WebPreferencesKey::sharedMatchedPropertiesCacheEnabledKey()));
 
 #if ENABLE(GAMEPAD)
     RuntimeEnabledFeatures::sharedFeatures().setGamepadsEnabled(store.getBoolValueForKey(WebPreferencesKey::gamepadsEnabledKey()));
@@ -33,6 +33,7 @@
 #include "InjectedBundle.h"
 #include "InjectedBundleUserMessageCoders.h"
 #include "Logging.h"
+#include "MessageStatistics.h"
 #include "PluginProcessConnectionManager.h"
 #include "SessionTracker.h"
 #include "StatisticsData.h"
@@ -131,6 +132,10 @@
 #include "WebSoupRequestManager.h"
 #endif
 
+#if USE(COORDINATED_GRAPHICS)
+#include <WebCore/UpdateAtlas.h>
+#endif
+
 using namespace JSC;
 using namespace WebCore;
 
@@ -930,6 +935,19 @@ void WebProcess::getWebCoreStatistics(uint64_t callbackID)
     
     // Get WebCore memory cache statistics
     getWebCoreMemoryCacheStatistics(data.webCoreCacheStatistics);
+
+#if USE(COORDINATED_GRAPHICS)
+    // Gather update atlas statistics.
+    const UpdateAtlas::Statistics& updateAtlasStatistics = UpdateAtlas::statistics();
+    data.statisticsNumbers.set(ASCIILiteral("UpdateAtlasAllocationCount"), updateAtlasStatistics.allocationCount);
+    data.statisticsNumbers.set(ASCIILiteral("UpdateAtlasFailedAllocationCount"), updateAtlasStatistics.failedAllocationCount);
+    data.statisticsNumbers.set(ASCIILiteral("UpdateAtlasAllocatedArea"), updateAtlasStatistics.allocatedArea);
+    data.statisticsNumbers.set(ASCIILiteral("UpdateAtlasCreationCount"), updateAtlasStatistics.atlasCreationCount);
+    data.statisticsNumbers.set(ASCIILiteral("UpdateAtlasReuseCount"), updateAtlasStatistics.atlasReuseCount);
+#endif
+
+    // Gather IPC statistics, when they are being collected.
+    IPC::MessageStatistics::shared().addStatistics(data.statisticsNumbers, ASCIILiteral("WebProcess"));
     
     parentProcessConnection()->send(Messages::WebContext::DidGetStatistics(data, callbackID), 0);
 }
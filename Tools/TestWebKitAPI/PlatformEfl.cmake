@@ -45,7 +45,14 @@ set(webkit2_api_harness_SOURCES
 # Release builds before adding it to test_{webkit2_api|webcore}_BINARIES.
 
 set(test_webcore_BINARIES
+    AnimatedImageFrameWindow
+    AreaAveragingDownsampler
+    FEGaussianBlurSSE2
+    GIFImageDecoder
+    ImageBufferCairoSSE2
     LayoutUnit
+    SkylineAreaAllocator
+    TextureMapperLayer
     URL
 )
 
@@ -81,8 +88,10 @@ set(test_webkit2_api_BINARIES
     PageLoadDidChangeLocationWithinPageForFrame
     ParentFrame
     PreventEmptyUserAgent
+    PrewarmedProcesses
     PrivateBrowsingPushStateNoHistoryCallback
     ResponsivenessTimerDoesntFireEarly
+    SharedMatchedPropertiesCache
     ShouldGoToBackForwardListItem
     TerminateTwice
     WKPreferences
@@ -92,10 +92,12 @@ add_executable(TestWebKit2
     ${TESTWEBKITAPI_DIR}/Tests/WebKit2/PageLoadDidChangeLocationWithinPageForFrame.cpp
     ${TESTWEBKITAPI_DIR}/Tests/WebKit2/ParentFrame.cpp
     ${TESTWEBKITAPI_DIR}/Tests/WebKit2/PreventEmptyUserAgent.cpp
+    ${TESTWEBKITAPI_DIR}/Tests/WebKit2/PrewarmedProcesses.cpp
     ${TESTWEBKITAPI_DIR}/Tests/WebKit2/PrivateBrowsingPushStateNoHistoryCallback.cpp
     ${TESTWEBKITAPI_DIR}/Tests/WebKit2/ReloadPageAfterCrash.cpp
     ${TESTWEBKITAPI_DIR}/Tests/WebKit2/ResizeWindowAfterCrash.cpp
     ${TESTWEBKITAPI_DIR}/Tests/WebKit2/RestoreSessionStateContainingFormData.cpp
+    ${TESTWEBKITAPI_DIR}/Tests/WebKit2/SharedMatchedPropertiesCache.cpp
     ${TESTWEBKITAPI_DIR}/Tests/WebKit2/ShouldGoToBackForwardListItem.cpp
     ${TESTWEBKITAPI_DIR}/Tests/WebKit2/UserMessage.cpp
     ${TESTWEBKITAPI_DIR}/Tests/WebKit2/WillSendSubmitEvent.cpp
@@ -126,7 +128,14 @@ add_executable(TestWebCore
     ${test_main_SOURCES}
     ${TestWebCoreGtk_SOURCES}
     ${TESTWEBKITAPI_DIR}/TestsController.cpp
+    ${TESTWEBKITAPI_DIR}/Tests/WebCore/AnimatedImageFrameWindow.cpp
+    ${TESTWEBKITAPI_DIR}/Tests/WebCore/AreaAveragingDownsampler.cpp
+    ${TESTWEBKITAPI_DIR}/Tests/WebCore/FEGaussianBlurSSE2.cpp
+    ${TESTWEBKITAPI_DIR}/Tests/WebCore/GIFImageDecoder.cpp
+    ${TESTWEBKITAPI_DIR}/Tests/WebCore/ImageBufferCairoSSE2.cpp
     ${TESTWEBKITAPI_DIR}/Tests/WebCore/LayoutUnit.cpp
+    ${TESTWEBKITAPI_DIR}/Tests/WebCore/SkylineAreaAllocator.cpp
+    ${TESTWEBKITAPI_DIR}/Tests/WebCore/TextureMapperLayer.cpp
     ${TESTWEBKITAPI_DIR}/Tests/WebCore/URL.cpp
 )
 
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2014 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <atomic>
+#include <wtf/ParallelJobs.h>
+
+namespace TestWebKitAPI {
+
+struct JobParameters {
+    std::atomic<unsigned>* counter;
+    unsigned* result;
+    unsigned value;
+    unsigned nestedJobs;
+};
+
+static void squareJob(JobParameters* parameters)
+{
+    *parameters->result = parameters->value * parameters->value;
+    ++*parameters->counter;
+}
+
+static void nestedJob(JobParameters* parameters)
+{
+    Vector<unsigned> results(parameters->nestedJobs);
+    ParallelJobs<JobParameters> parallelJobs(&squareJob, parameters->nestedJobs);
+    for (size_t i = 0; i < parallelJobs.numberOfJobs(); ++i) {
+        JobParameters& nestedParameters = parallelJobs.parameter(i);
+        nestedParameters.counter = parameters->counter;
+        nestedParameters.result = &results[i];
+        nestedParameters.value = i;
+        nestedParameters.nestedJobs = 0;
+    }
+    parallelJobs.execute();
+
+    unsigned sum = 0;
+    for (size_t i = 0; i < parallelJobs.numberOfJobs(); ++i)
+        sum += results[i];
+    *parameters->result = sum;
+}
+
+TEST(WTF_ParallelJobs, EveryJobRunsOnce)
+{
+    for (unsigned requestedJobs = 1; requestedJobs <= 64; ++requestedJobs) {
+        std::atomic<unsigned> counter(0);
+        Vector<unsigned> results(requestedJobs);
+
+        ParallelJobs<JobParameters> parallelJobs(&squareJob, requestedJobs);
+        ASSERT_GE(parallelJobs.numberOfJobs(), 1U);
+        ASSERT_LE(parallelJobs.numberOfJobs(), requestedJobs);
+        for (size_t i = 0; i < parallelJobs.numberOfJobs(); ++i) {
+            JobParameters& parameters = parallelJobs.parameter(i);
+            parameters.counter = &counter;
+            parameters.result = &results[i];
+            parameters.value = i;
+            parameters.nestedJobs = 0;
+        }
+        parallelJobs.execute();
+
+        EXPECT_EQ(parallelJobs.numberOfJobs(), counter.load());
+        for (size_t i = 0; i < parallelJobs.numberOfJobs(); ++i)
+            EXPECT_EQ(i * i, results[i]);
+    }
+}
+
+TEST(WTF_ParallelJobs, Nested)
+{
+    std::atomic<unsigned> counter(0);
+    Vector<unsigned> results(8);
+
+    ParallelJobs<JobParameters> parallelJobs(&nestedJob, 8);
+    for (size_t i = 0; i < parallelJobs.numberOfJobs(); ++i) {
+        JobParameters& parameters = parallelJobs.parameter(i);
+        parameters.counter = &counter;
+        parameters.result = &results[i];
+        parameters.value = 0;
+        parameters.nestedJobs = 4;
+    }
+    parallelJobs.execute();
+
+    // Each nested batch squares 0, 1, 2 and 3.
+    EXPECT_EQ(parallelJobs.numberOfJobs() * 4, counter.load());
+    for (size_t i = 0; i < parallelJobs.numberOfJobs(); ++i)
+        EXPECT_EQ(14U, results[i]);
+}
+
+} // namespace TestWebKitAPI
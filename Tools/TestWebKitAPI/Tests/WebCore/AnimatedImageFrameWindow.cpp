@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2014 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <WebCore/BitmapImage.h>
+
+using namespace WebCore;
+
+namespace TestWebKitAPI {
+
+static const unsigned largeAnimationCutoff = 60;
+static const unsigned budget = 100;
+
+static Vector<unsigned> frameSizes(std::initializer_list<unsigned> sizes)
+{
+    Vector<unsigned> frameBytes;
+    for (unsigned size : sizes)
+        frameBytes.append(size);
+    return frameBytes;
+}
+
+static Vector<size_t> frameIndices(std::initializer_list<size_t> indices)
+{
+    Vector<size_t> frames;
+    for (size_t index : indices)
+        frames.append(index);
+    return frames;
+}
+
+TEST(WebCoreAnimatedImageFrameWindow, WithinBudget)
+{
+    AnimatedImageFrameWindow frameWindow(largeAnimationCutoff, budget);
+    EXPECT_FALSE(frameWindow.isOverBudget(budget));
+    EXPECT_EQ(largeAnimationCutoff, frameWindow.windowBytes(0, 1));
+    EXPECT_EQ(largeAnimationCutoff, frameWindow.windowBytes(budget, 10));
+}
+
+TEST(WebCoreAnimatedImageFrameWindow, OverBudget)
+{
+    // Every animated image gets an equal share of the budget, but never more
+    // than the cutoff.
+    AnimatedImageFrameWindow frameWindow(largeAnimationCutoff, budget);
+    EXPECT_TRUE(frameWindow.isOverBudget(budget + 1));
+    EXPECT_EQ(largeAnimationCutoff, frameWindow.windowBytes(150, 1));
+    EXPECT_EQ(50u, frameWindow.windowBytes(150, 2));
+    EXPECT_EQ(25u, frameWindow.windowBytes(150, 4));
+}
+
+TEST(WebCoreAnimatedImageFrameWindow, KeepsFramesThatFollowTheCurrentOne)
+{
+    // The window starts at the current frame and wraps around at the end of
+    // the animation.
+    Vector<unsigned> frameBytes = frameSizes({ 10, 10, 10, 10, 10 });
+    EXPECT_TRUE(frameIndices({ 0, 1, 2 }) == AnimatedImageFrameWindow::framesOutsideWindow(frameBytes, 3, 25));
+    EXPECT_TRUE(frameIndices({ 3 }) == AnimatedImageFrameWindow::framesOutsideWindow(frameBytes, 4, 40));
+    EXPECT_TRUE(AnimatedImageFrameWindow::framesOutsideWindow(frameBytes, 2, 50).isEmpty());
+}
+
+TEST(WebCoreAnimatedImageFrameWindow, KeepsCurrentFrame)
+{
+    Vector<unsigned> frameBytes = frameSizes({ 50, 10 });
+    EXPECT_TRUE(frameIndices({ 1 }) == AnimatedImageFrameWindow::framesOutsideWindow(frameBytes, 0, 20));
+    EXPECT_TRUE(frameIndices({ 0 }) == AnimatedImageFrameWindow::framesOutsideWindow(frameBytes, 1, 20));
+}
+
+TEST(WebCoreAnimatedImageFrameWindow, SkipsFramesThatAreNotDecoded)
+{
+    // Frames that are not decoded take no room in the window and are not
+    // returned, even when they are the current frame.
+    Vector<unsigned> frameBytes = frameSizes({ 10, 0, 10, 10 });
+    EXPECT_TRUE(frameIndices({ 0 }) == AnimatedImageFrameWindow::framesOutsideWindow(frameBytes, 1, 20));
+    EXPECT_TRUE(AnimatedImageFrameWindow::framesOutsideWindow(frameSizes({ 0, 0 }), 0, 0).isEmpty());
+    EXPECT_TRUE(AnimatedImageFrameWindow::framesOutsideWindow(Vector<unsigned>(), 0, 0).isEmpty());
+}
+
+TEST(WebCoreAnimatedImageFrameWindow, WindowIsContiguous)
+{
+    // Once a frame does not fit, the frames after it are outside the window
+    // too, even the ones that would still fit.
+    Vector<unsigned> frameBytes = frameSizes({ 10, 30, 5 });
+    EXPECT_TRUE(frameIndices({ 1, 2 }) == AnimatedImageFrameWindow::framesOutsideWindow(frameBytes, 0, 20));
+}
+
+TEST(WebCoreAnimatedImageFrameWindow, CurrentFramePastFrameCount)
+{
+    // The animation can advance past the frames that were created so far.
+    Vector<unsigned> frameBytes = frameSizes({ 10, 10, 10 });
+    EXPECT_TRUE(frameIndices({ 1 }) == AnimatedImageFrameWindow::framesOutsideWindow(frameBytes, 5, 20));
+}
+
+} // namespace TestWebKitAPI
@@ -0,0 +1,359 @@
+/*
+ * Copyright (C) 2014 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <WebCore/GIFImageDecoder.h>
+#include <WebCore/ImageDecoder.h>
+#include <WebCore/SharedBuffer.h>
+
+using namespace WebCore;
+
+namespace TestWebKitAPI {
+
+static const unsigned char opaqueBlack[] = { 0, 0, 0, 255 };
+
+static unsigned red(ImageFrame::PixelData pixel) { return (pixel >> 16) & 0xFF; }
+static unsigned green(ImageFrame::PixelData pixel) { return (pixel >> 8) & 0xFF; }
+static unsigned blue(ImageFrame::PixelData pixel) { return pixel & 0xFF; }
+static unsigned alpha(ImageFrame::PixelData pixel) { return pixel >> 24; }
+
+// Downsamples a source image given as rows of RGBA samples into |frame|,
+// which is left unpremultiplied so that the averages can be read back as is.
+static unsigned char downsample(ImageFrame& frame, const Vector<Vector<unsigned char>>& rows, int sourceWidth, SubsamplingLevel level)
+{
+    int sourceHeight = rows.size();
+    frame.setPremultiplyAlpha(false);
+    EXPECT_TRUE(frame.setSize(ImageDecoder::subsampledLength(sourceWidth, level), ImageDecoder::subsampledLength(sourceHeight, level)));
+
+    AreaAveragingDownsampler downsampler;
+    downsampler.initialize(sourceWidth, sourceHeight, level);
+    unsigned char nonTrivialAlphaMask = 0;
+    for (int y = 0; y < sourceHeight; ++y)
+        downsampler.addRow(frame, y, rows[y].data(), 4, nonTrivialAlphaMask);
+    return nonTrivialAlphaMask;
+}
+
+TEST(WebCoreAreaAveragingDownsampler, SubsampledLength)
+{
+    EXPECT_EQ(7, ImageDecoder::subsampledLength(7, 0));
+    EXPECT_EQ(4, ImageDecoder::subsampledLength(7, 1));
+    EXPECT_EQ(2, ImageDecoder::subsampledLength(7, 2));
+    EXPECT_EQ(1, ImageDecoder::subsampledLength(7, 3));
+    EXPECT_EQ(4, ImageDecoder::subsampledLength(8, 1));
+    EXPECT_EQ(2, ImageDecoder::subsampledLength(8, 2));
+    EXPECT_EQ(1, ImageDecoder::subsampledLength(8, 3));
+    EXPECT_EQ(2, ImageDecoder::subsampledLength(9, 3));
+    EXPECT_EQ(1, ImageDecoder::subsampledLength(1, 3));
+}
+
+TEST(WebCoreAreaAveragingDownsampler, CompletedRows)
+{
+    // A row is completed by the last source row of each block, and by the last
+    // source row of the image when the image height is not a multiple of the
+    // block height.
+    const int sourceWidth = 10;
+    const int sourceHeight = 13;
+    Vector<unsigned char> samples;
+    for (int x = 0; x < sourceWidth; ++x)
+        samples.append(opaqueBlack, 4);
+
+    for (SubsamplingLevel level = 0; level <= 3; ++level) {
+        const int blockSize = 1 << level;
+        ImageFrame frame;
+        ASSERT_TRUE(frame.setSize(ImageDecoder::subsampledLength(sourceWidth, level), ImageDecoder::subsampledLength(sourceHeight, level)));
+
+        AreaAveragingDownsampler downsampler;
+        downsampler.initialize(sourceWidth, sourceHeight, level);
+        unsigned char nonTrivialAlphaMask = 0;
+        int completedRows = 0;
+        for (int y = 0; y < sourceHeight; ++y) {
+            int row = downsampler.addRow(frame, y, samples.data(), 4, nonTrivialAlphaMask);
+            if ((y + 1) % blockSize && y + 1 < sourceHeight)
+                EXPECT_EQ(-1, row) << "Level " << level << ", source row " << y;
+            else
+                EXPECT_EQ(completedRows++, row) << "Level " << level << ", source row " << y;
+        }
+        EXPECT_EQ(ImageDecoder::subsampledLength(sourceHeight, level), completedRows);
+        EXPECT_EQ(0, nonTrivialAlphaMask);
+    }
+}
+
+TEST(WebCoreAreaAveragingDownsampler, OpaqueBlocks)
+{
+    Vector<Vector<unsigned char>> rows(2);
+    const unsigned char row0[] = { 0, 0, 0, 255, 255, 255, 255, 255 };
+    const unsigned char row1[] = { 100, 50, 10, 255, 1, 2, 3, 255 };
+    rows[0].append(row0, sizeof(row0));
+    rows[1].append(row1, sizeof(row1));
+
+    ImageFrame frame;
+    EXPECT_EQ(0, downsample(frame, rows, 2, 1));
+
+    // The channels are averaged and rounded to the nearest value.
+    ImageFrame::PixelData pixel = *frame.getAddr(0, 0);
+    EXPECT_EQ(89u, red(pixel));
+    EXPECT_EQ(77u, green(pixel));
+    EXPECT_EQ(67u, blue(pixel));
+    EXPECT_EQ(255u, alpha(pixel));
+}
+
+TEST(WebCoreAreaAveragingDownsampler, TransparentPixelsDoNotBleed)
+{
+    // One opaque red pixel and three transparent green ones.
+    Vector<Vector<unsigned char>> rows(2);
+    const unsigned char row0[] = { 255, 0, 0, 255, 0, 255, 0, 0 };
+    const unsigned char row1[] = { 0, 255, 0, 0, 0, 255, 0, 0 };
+    rows[0].append(row0, sizeof(row0));
+    rows[1].append(row1, sizeof(row1));
+
+    ImageFrame frame;
+    EXPECT_NE(0, downsample(frame, rows, 2, 1));
+
+    ImageFrame::PixelData pixel = *frame.getAddr(0, 0);
+    EXPECT_EQ(255u, red(pixel));
+    EXPECT_EQ(0u, green(pixel));
+    EXPECT_EQ(0u, blue(pixel));
+    EXPECT_EQ(64u, alpha(pixel));
+}
+
+TEST(WebCoreAreaAveragingDownsampler, TransparentBlock)
+{
+    Vector<Vector<unsigned char>> rows(2);
+    const unsigned char row[] = { 10, 20, 30, 0, 40, 50, 60, 0 };
+    rows[0].append(row, sizeof(row));
+    rows[1].append(row, sizeof(row));
+
+    ImageFrame frame;
+    EXPECT_EQ(255, downsample(frame, rows, 2, 1));
+    EXPECT_EQ(0u, *frame.getAddr(0, 0));
+}
+
+TEST(WebCoreAreaAveragingDownsampler, EdgeBlocks)
+{
+    // A 3x3 image at half size: the blocks on the right and bottom edges only
+    // cover the pixels that are inside the image.
+    Vector<Vector<unsigned char>> rows(3);
+    const unsigned char row0[] = { 0, 0, 0, 255, 0, 0, 0, 255, 100, 0, 0, 255 };
+    const unsigned char row1[] = { 0, 0, 0, 255, 0, 0, 0, 255, 201, 0, 0, 255 };
+    const unsigned char row2[] = { 0, 40, 0, 255, 0, 80, 0, 255, 0, 0, 7, 128 };
+    rows[0].append(row0, sizeof(row0));
+    rows[1].append(row1, sizeof(row1));
+    rows[2].append(row2, sizeof(row2));
+
+    ImageFrame frame;
+    EXPECT_NE(0, downsample(frame, rows, 3, 1));
+
+    EXPECT_EQ(0xFF000000u, *frame.getAddr(0, 0));
+
+    ImageFrame::PixelData topRight = *frame.getAddr(1, 0);
+    EXPECT_EQ(151u, red(topRight));
+    EXPECT_EQ(255u, alpha(topRight));
+
+    ImageFrame::PixelData bottomLeft = *frame.getAddr(0, 1);
+    EXPECT_EQ(60u, green(bottomLeft));
+    EXPECT_EQ(255u, alpha(bottomLeft));
+
+    // A single pixel block is copied as is.
+    ImageFrame::PixelData bottomRight = *frame.getAddr(1, 1);
+    EXPECT_EQ(0u, red(bottomRight));
+    EXPECT_EQ(7u, blue(bottomRight));
+    EXPECT_EQ(128u, alpha(bottomRight));
+}
+
+TEST(WebCoreAreaAveragingDownsampler, RGBSamples)
+{
+    const unsigned char row0[] = { 10, 20, 30, 20, 30, 40 };
+    const unsigned char row1[] = { 30, 40, 50, 40, 50, 61 };
+
+    ImageFrame frame;
+    frame.setPremultiplyAlpha(false);
+    ASSERT_TRUE(frame.setSize(1, 1));
+
+    AreaAveragingDownsampler downsampler;
+    downsampler.initialize(2, 2, 1);
+    unsigned char nonTrivialAlphaMask = 0;
+    EXPECT_EQ(-1, downsampler.addRow(frame, 0, row0, 3, nonTrivialAlphaMask));
+    EXPECT_EQ(0, downsampler.addRow(frame, 1, row1, 3, nonTrivialAlphaMask));
+    EXPECT_EQ(0, nonTrivialAlphaMask);
+
+    ImageFrame::PixelData pixel = *frame.getAddr(0, 0);
+    EXPECT_EQ(25u, red(pixel));
+    EXPECT_EQ(35u, green(pixel));
+    EXPECT_EQ(45u, blue(pixel));
+    EXPECT_EQ(255u, alpha(pixel));
+}
+
+TEST(WebCoreAreaAveragingDownsampler, PremultipliedPixels)
+{
+    // Half transparent red and opaque blue, premultiplied, next to two
+    // transparent pixels.
+    const ImageFrame::PixelData row0[] = { 0x80800000, 0xFF0000FF };
+    const ImageFrame::PixelData row1[] = { 0, 0 };
+
+    ImageFrame frame;
+    frame.setPremultiplyAlpha(false);
+    ASSERT_TRUE(frame.setSize(1, 1));
+
+    AreaAveragingDownsampler downsampler;
+    downsampler.initialize(2, 2, 1);
+    unsigned char nonTrivialAlphaMask = 0;
+    EXPECT_EQ(-1, downsampler.addRow(frame, 0, row0, true, nonTrivialAlphaMask));
+    EXPECT_EQ(0, downsampler.addRow(frame, 1, row1, true, nonTrivialAlphaMask));
+    EXPECT_NE(0, nonTrivialAlphaMask);
+
+    ImageFrame::PixelData pixel = *frame.getAddr(0, 0);
+    EXPECT_EQ(85u, red(pixel));
+    EXPECT_EQ(0u, green(pixel));
+    EXPECT_EQ(170u, blue(pixel));
+    EXPECT_EQ(96u, alpha(pixel));
+}
+
+TEST(WebCoreAreaAveragingDownsampler, PremultipliedOutput)
+{
+    // With a premultiplying frame the average is premultiplied when written.
+    const unsigned char row0[] = { 255, 0, 0, 255, 0, 0, 0, 0 };
+    const unsigned char row1[] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+    ImageFrame frame;
+    ASSERT_TRUE(frame.setSize(1, 1));
+
+    AreaAveragingDownsampler downsampler;
+    downsampler.initialize(2, 2, 1);
+    unsigned char nonTrivialAlphaMask = 0;
+    downsampler.addRow(frame, 0, row0, 4, nonTrivialAlphaMask);
+    downsampler.addRow(frame, 1, row1, 4, nonTrivialAlphaMask);
+
+    ImageFrame::PixelData pixel = *frame.getAddr(0, 0);
+    EXPECT_EQ(64u, red(pixel));
+    EXPECT_EQ(64u, alpha(pixel));
+}
+
+static void appendLittleEndian16(Vector<char>& data, unsigned value)
+{
+    data.append(value & 0xFF);
+    data.append(value >> 8);
+}
+
+// Encodes a GIF with a four color palette. The LZW dictionary is cleared every
+// two pixels so that all codes are literals of three bits.
+static PassRefPtr<SharedBuffer> createGIF(int width, int height, const unsigned char* indices)
+{
+    static const unsigned char palette[] = {
+        0, 0, 0,
+        255, 255, 255,
+        255, 0, 0,
+        0, 0, 255
+    };
+    const unsigned clearCode = 4;
+    const unsigned endCode = 5;
+    const unsigned codeSize = 3;
+
+    Vector<char> data;
+    data.append("GIF89a", 6);
+    appendLittleEndian16(data, width);
+    appendLittleEndian16(data, height);
+    data.append(0x81); // Global color table of four entries.
+    data.append(0);
+    data.append(0);
+    data.append(reinterpret_cast<const char*>(palette), sizeof(palette));
+
+    data.append(0x2C);
+    appendLittleEndian16(data, 0);
+    appendLittleEndian16(data, 0);
+    appendLittleEndian16(data, width);
+    appendLittleEndian16(data, height);
+    data.append(0);
+
+    Vector<char> codes;
+    unsigned bits = 0;
+    unsigned bitCount = 0;
+    auto appendCode = [&](unsigned code) {
+        bits |= code << bitCount;
+        for (bitCount += codeSize; bitCount >= 8; bitCount -= 8, bits >>= 8)
+            codes.append(bits & 0xFF);
+    };
+    for (int i = 0; i < width * height; ++i) {
+        if (!(i % 2))
+            appendCode(clearCode);
+        appendCode(indices[i]);
+    }
+    appendCode(endCode);
+    if (bitCount)
+        codes.append(bits & 0xFF);
+
+    data.append(2); // Minimum code size.
+    for (size_t i = 0; i < codes.size(); i += 255) {
+        size_t length = std::min<size_t>(255, codes.size() - i);
+        data.append(length);
+        data.append(codes.data() + i, length);
+    }
+    data.append(0);
+    data.append(0x3B);
+
+    return SharedBuffer::create(data.data(), data.size());
+}
+
+TEST(WebCoreAreaAveragingDownsampler, SubsampledGIF)
+{
+    // Each 2x2 block averages to a different color: black and white, red,
+    // blue, and three black pixels with one white one.
+    const unsigned char indices[] = {
+        0, 1, 2, 2,
+        1, 0, 2, 2,
+        3, 3, 0, 0,
+        3, 3, 0, 1
+    };
+    RefPtr<SharedBuffer> data = createGIF(4, 4, indices);
+
+    GIFImageDecoder fullSizeDecoder(ImageSource::AlphaNotPremultiplied, ImageSource::GammaAndColorProfileIgnored);
+    fullSizeDecoder.setData(data.get(), true);
+    ImageFrame* fullSizeFrame = fullSizeDecoder.frameBufferAtIndex(0);
+    ASSERT_TRUE(fullSizeFrame);
+    ASSERT_EQ(ImageFrame::FrameComplete, fullSizeFrame->status());
+    EXPECT_EQ(0, fullSizeDecoder.subsamplingLevel());
+    EXPECT_EQ(0xFFFFFFFFu, *fullSizeFrame->getAddr(1, 0));
+    EXPECT_EQ(0xFFFF0000u, *fullSizeFrame->getAddr(2, 0));
+    EXPECT_EQ(0xFF0000FFu, *fullSizeFrame->getAddr(0, 3));
+
+    GIFImageDecoder decoder(ImageSource::AlphaNotPremultiplied, ImageSource::GammaAndColorProfileIgnored);
+    decoder.setSubsamplingLevel(1);
+    decoder.setData(data.get(), true);
+    ImageFrame* frame = decoder.frameBufferAtIndex(0);
+    ASSERT_TRUE(frame);
+    ASSERT_EQ(ImageFrame::FrameComplete, frame->status());
+    EXPECT_EQ(1, decoder.subsamplingLevel());
+    EXPECT_EQ(2, decoder.subsampledSize().width());
+    EXPECT_EQ(2, decoder.subsampledSize().height());
+    EXPECT_EQ(2, frame->originalFrameRect().width());
+    EXPECT_EQ(2, frame->originalFrameRect().height());
+
+    EXPECT_EQ(0xFF808080u, *frame->getAddr(0, 0));
+    EXPECT_EQ(0xFFFF0000u, *frame->getAddr(1, 0));
+    EXPECT_EQ(0xFF0000FFu, *frame->getAddr(0, 1));
+    EXPECT_EQ(0xFF404040u, *frame->getAddr(1, 1));
+}
+
+} // namespace TestWebKitAPI
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2014 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <WebCore/FEGaussianBlurSSE2.h>
+#include <random>
+
+#if ENABLE(FILTERS) && HAVE(SSE2_INTRINSICS)
+
+using namespace WebCore;
+
+namespace TestWebKitAPI {
+
+static PassRefPtr<Uint8ClampedArray> createRandomPixels(std::mt19937& random, int width, int height)
+{
+    RefPtr<Uint8ClampedArray> pixels = Uint8ClampedArray::createUninitialized(width * height * 4);
+    std::uniform_int_distribution<int> channel(0, 255);
+    for (unsigned i = 0; i < pixels->length(); ++i)
+        pixels->data()[i] = channel(random);
+    return pixels.release();
+}
+
+// The box blur FEGaussianBlur's scalar path computes: each channel is the sum of the pixels in
+// [position - left, position + right), clipped to the image, divided by the kernel size.
+static PassRefPtr<Uint8ClampedArray> boxBlur(Uint8ClampedArray* source, unsigned kernelSize, int left, int right, int width, int height, bool horizontal)
+{
+    RefPtr<Uint8ClampedArray> result = Uint8ClampedArray::createUninitialized(source->length());
+    int length = horizontal ? width : height;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            int position = horizontal ? x : y;
+            for (int channel = 0; channel < 4; ++channel) {
+                unsigned sum = 0;
+                for (int i = std::max(position - left, 0); i < std::min(position + right, length); ++i) {
+                    int pixel = horizontal ? y * width + i : i * width + x;
+                    sum += source->data()[pixel * 4 + channel];
+                }
+                result->data()[(y * width + x) * 4 + channel] = sum / kernelSize;
+            }
+        }
+    }
+    return result.release();
+}
+
+static void expectSamePixels(Uint8ClampedArray* expected, Uint8ClampedArray* actual, int width)
+{
+    ASSERT_EQ(expected->length(), actual->length());
+    for (unsigned i = 0; i < expected->length(); ++i) {
+        if (expected->data()[i] != actual->data()[i]) {
+            ADD_FAILURE() << "Pixel (" << i / 4 % width << ", " << i / 4 / width << ") channel " << i % 4
+                << " is " << static_cast<int>(actual->data()[i]) << ", expected " << static_cast<int>(expected->data()[i]);
+            return;
+        }
+    }
+}
+
+static void testKernel(std::mt19937& random, int width, int height, unsigned kernelSize, int left, int right)
+{
+    SCOPED_TRACE(testing::Message() << width << "x" << height << ", kernel " << kernelSize << " (" << left << ", " << right << ")");
+
+    RefPtr<Uint8ClampedArray> source = createRandomPixels(random, width, height);
+    RefPtr<Uint8ClampedArray> destination = Uint8ClampedArray::create(source->length());
+
+    boxBlurHorizontalSSE2(source.get(), destination.get(), kernelSize, left, right, width, height);
+    expectSamePixels(boxBlur(source.get(), kernelSize, left, right, width, height, true).get(), destination.get(), width);
+
+    boxBlurVerticalSSE2(source.get(), destination.get(), kernelSize, left, right, width, height);
+    expectSamePixels(boxBlur(source.get(), kernelSize, left, right, width, height, false).get(), destination.get(), width);
+}
+
+// Runs the three kernel positions FEGaussianBlur uses for a kernel size.
+static void testKernelSize(std::mt19937& random, int width, int height, unsigned kernelSize)
+{
+    int left = kernelSize % 2 ? kernelSize / 2 : kernelSize / 2 - 1;
+    int right = kernelSize - left;
+    testKernel(random, width, height, kernelSize, left, right);
+    if (kernelSize % 2)
+        return;
+    testKernel(random, width, height, kernelSize, left + 1, right - 1);
+    testKernel(random, width, height, kernelSize + 1, left + 1, right);
+}
+
+TEST(WebCoreFEGaussianBlurSSE2, MatchesScalarBoxBlur)
+{
+    std::mt19937 random(1);
+    const unsigned kernelSizes[] = { 1, 2, 3, 4, 7, 10, 25, 64 };
+    for (unsigned kernelSize : kernelSizes)
+        testKernelSize(random, 37, 29, kernelSize);
+}
+
+TEST(WebCoreFEGaussianBlurSSE2, EdgeWidths)
+{
+    std::mt19937 random(2);
+    const int sizes[] = { 1, 2, 3, 4, 5, 15, 16, 17 };
+    for (int width : sizes) {
+        for (int height : sizes) {
+            testKernelSize(random, width, height, 3);
+            testKernelSize(random, width, height, 8);
+        }
+    }
+}
+
+TEST(WebCoreFEGaussianBlurSSE2, LargeKernels)
+{
+    // The largest kernel FEGaussianBlur uses is 500 pixels, which must not lose precision in the float division.
+    std::mt19937 random(3);
+    testKernelSize(random, 600, 3, 500);
+    testKernelSize(random, 3, 600, 500);
+    testKernelSize(random, 20, 20, 500);
+
+    // Saturated input gives the largest sums.
+    RefPtr<Uint8ClampedArray> source = Uint8ClampedArray::create(600 * 4);
+    memset(source->data(), 255, source->length());
+    RefPtr<Uint8ClampedArray> destination = Uint8ClampedArray::create(source->length());
+    boxBlurHorizontalSSE2(source.get(), destination.get(), 500, 249, 251, 600, 1);
+    expectSamePixels(boxBlur(source.get(), 500, 249, 251, 600, 1, true).get(), destination.get(), 600);
+}
+
+} // namespace TestWebKitAPI
+
+#endif // ENABLE(FILTERS) && HAVE(SSE2_INTRINSICS)
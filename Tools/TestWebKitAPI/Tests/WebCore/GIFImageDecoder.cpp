@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2014 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <WebCore/GIFImageDecoder.h>
+#include <WebCore/ImageDecoder.h>
+#include <WebCore/SharedBuffer.h>
+
+using namespace WebCore;
+
+namespace TestWebKitAPI {
+
+struct GIFFrame {
+    int x;
+    int y;
+    int width;
+    int height;
+    unsigned char colorIndex;
+    ImageFrame::FrameDisposalMethod disposalMethod;
+};
+
+static void appendLittleEndian16(Vector<char>& data, unsigned value)
+{
+    data.append(value & 0xFF);
+    data.append(value >> 8);
+}
+
+// Encodes an animated GIF with a four color palette, where each frame fills its
+// rectangle with one color. The LZW dictionary is cleared before every pixel so
+// that all codes are literals of three bits.
+static PassRefPtr<SharedBuffer> createAnimatedGIF(int width, int height, const GIFFrame* frames, size_t frameCount)
+{
+    static const unsigned char palette[] = {
+        0, 0, 0,
+        255, 255, 255,
+        255, 0, 0,
+        0, 0, 255
+    };
+    const unsigned clearCode = 4;
+    const unsigned endCode = 5;
+    const unsigned codeSize = 3;
+
+    Vector<char> data;
+    data.append("GIF89a", 6);
+    appendLittleEndian16(data, width);
+    appendLittleEndian16(data, height);
+    data.append(0x81); // Global color table of four entries.
+    data.append(0);
+    data.append(0);
+    data.append(reinterpret_cast<const char*>(palette), sizeof(palette));
+
+    for (size_t i = 0; i < frameCount; ++i) {
+        const GIFFrame& frame = frames[i];
+
+        // Graphic control extension with the disposal method and a delay of 10ms.
+        data.append(0x21);
+        data.append(0xF9);
+        data.append(4);
+        data.append(frame.disposalMethod << 2);
+        appendLittleEndian16(data, 1);
+        data.append(0);
+        data.append(0);
+
+        data.append(0x2C);
+        appendLittleEndian16(data, frame.x);
+        appendLittleEndian16(data, frame.y);
+        appendLittleEndian16(data, frame.width);
+        appendLittleEndian16(data, frame.height);
+        data.append(0);
+
+        Vector<char> codes;
+        unsigned bits = 0;
+        unsigned bitCount = 0;
+        auto appendCode = [&](unsigned code) {
+            bits |= code << bitCount;
+            for (bitCount += codeSize; bitCount >= 8; bitCount -= 8, bits >>= 8)
+                codes.append(bits & 0xFF);
+        };
+        for (int pixel = 0; pixel < frame.width * frame.height; ++pixel) {
+            appendCode(clearCode);
+            appendCode(frame.colorIndex);
+        }
+        appendCode(endCode);
+        if (bitCount)
+            codes.append(bits & 0xFF);
+
+        data.append(2); // Minimum code size.
+        for (size_t offset = 0; offset < codes.size(); offset += 255) {
+            size_t length = std::min<size_t>(255, codes.size() - offset);
+            data.append(length);
+            data.append(codes.data() + offset, length);
+        }
+        data.append(0);
+    }
+    data.append(0x3B);
+
+    return SharedBuffer::create(data.data(), data.size());
+}
+
+static Vector<ImageFrame::PixelData> pixels(ImageFrame* frame, int width, int height)
+{
+    Vector<ImageFrame::PixelData> result;
+    if (!frame || frame->status() != ImageFrame::FrameComplete)
+        return result;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x)
+            result.append(*frame->getAddr(x, y));
+    }
+    return result;
+}
+
+// A 4x4 black frame, and then three frames that each paint a 2x2 square on
+// top of the frames before them.
+static const GIFFrame compositedFrames[] = {
+    { 0, 0, 4, 4, 0, ImageFrame::DisposeKeep },
+    { 0, 0, 2, 2, 1, ImageFrame::DisposeKeep },
+    { 2, 0, 2, 2, 2, ImageFrame::DisposeKeep },
+    { 0, 2, 2, 2, 3, ImageFrame::DisposeKeep },
+};
+
+static Vector<ImageFrame*> decodeAllFrames(GIFImageDecoder& decoder, SharedBuffer* data)
+{
+    decoder.setData(data, true);
+    Vector<ImageFrame*> frames;
+    for (size_t i = 0; i < decoder.frameCount(); ++i)
+        frames.append(decoder.frameBufferAtIndex(i));
+    return frames;
+}
+
+TEST(WebCoreGIFImageDecoder, ClearedFramesAreDecodedAgain)
+{
+    RefPtr<SharedBuffer> data = createAnimatedGIF(4, 4, compositedFrames, WTF_ARRAY_LENGTH(compositedFrames));
+    GIFImageDecoder decoder(ImageSource::AlphaNotPremultiplied, ImageSource::GammaAndColorProfileIgnored);
+    Vector<ImageFrame*> frames = decodeAllFrames(decoder, data.get());
+    ASSERT_EQ(4u, frames.size());
+
+    Vector<Vector<ImageFrame::PixelData>> decodedPixels;
+    for (auto* frame : frames) {
+        decodedPixels.append(pixels(frame, 4, 4));
+        ASSERT_EQ(16u, decodedPixels.last().size());
+    }
+    EXPECT_EQ(0xFFFFFFFFu, decodedPixels[3][0]);
+    EXPECT_EQ(0xFFFF0000u, decodedPixels[3][3]);
+    EXPECT_EQ(0xFF0000FFu, decodedPixels[3][12]);
+    EXPECT_EQ(0xFF000000u, decodedPixels[3][15]);
+
+    decoder.clearFrameBuffer(1);
+    decoder.clearFrameBuffer(2);
+    EXPECT_EQ(ImageFrame::FrameEmpty, frames[1]->status());
+    EXPECT_EQ(ImageFrame::FrameEmpty, frames[2]->status());
+
+    // Frame 2 is built on frame 1, which is built on frame 0. Frame 0 is still
+    // decoded, so decoding resumes from frame 1.
+    EXPECT_TRUE(decodedPixels[2] == pixels(decoder.frameBufferAtIndex(2), 4, 4));
+    EXPECT_TRUE(decodedPixels[1] == pixels(frames[1], 4, 4));
+    EXPECT_TRUE(decodedPixels[0] == pixels(frames[0], 4, 4));
+    EXPECT_TRUE(decodedPixels[3] == pixels(frames[3], 4, 4));
+}
+
+TEST(WebCoreGIFImageDecoder, DecodingResumesFromCheckpoint)
+{
+    // Frame 1 covers the whole image and is cleared to the background when it
+    // is done, so frame 2 does not depend on frames 0 and 1.
+    const GIFFrame gifFrames[] = {
+        { 0, 0, 4, 4, 0, ImageFrame::DisposeKeep },
+        { 0, 0, 4, 4, 1, ImageFrame::DisposeOverwriteBgcolor },
+        { 2, 0, 2, 2, 2, ImageFrame::DisposeKeep },
+        { 0, 2, 2, 2, 3, ImageFrame::DisposeKeep },
+    };
+    RefPtr<SharedBuffer> data = createAnimatedGIF(4, 4, gifFrames, WTF_ARRAY_LENGTH(gifFrames));
+    GIFImageDecoder decoder(ImageSource::AlphaNotPremultiplied, ImageSource::GammaAndColorProfileIgnored);
+    Vector<ImageFrame*> frames = decodeAllFrames(decoder, data.get());
+    ASSERT_EQ(4u, frames.size());
+
+    Vector<ImageFrame::PixelData> lastFramePixels = pixels(frames[3], 4, 4);
+    ASSERT_EQ(16u, lastFramePixels.size());
+    EXPECT_EQ(0u, lastFramePixels[0]);
+    EXPECT_EQ(0xFFFF0000u, lastFramePixels[3]);
+    EXPECT_EQ(0xFF0000FFu, lastFramePixels[12]);
+
+    for (size_t i = 0; i < frames.size(); ++i)
+        decoder.clearFrameBuffer(i);
+
+    // Decoding resumes from frame 2, so the earlier frames stay cleared.
+    EXPECT_TRUE(lastFramePixels == pixels(decoder.frameBufferAtIndex(3), 4, 4));
+    EXPECT_EQ(ImageFrame::FrameComplete, frames[2]->status());
+    EXPECT_EQ(ImageFrame::FrameEmpty, frames[1]->status());
+    EXPECT_EQ(ImageFrame::FrameEmpty, frames[0]->status());
+}
+
+TEST(WebCoreGIFImageDecoder, KeepsStartingStateOfNextFrame)
+{
+    RefPtr<SharedBuffer> data = createAnimatedGIF(4, 4, compositedFrames, WTF_ARRAY_LENGTH(compositedFrames));
+    GIFImageDecoder decoder(ImageSource::AlphaNotPremultiplied, ImageSource::GammaAndColorProfileIgnored);
+    decoder.setData(data.get(), true);
+    ASSERT_EQ(4u, decoder.frameCount());
+
+    // Frame 2 is decoded next and starts from frame 1, so frame 1 is kept.
+    ImageFrame* frame0 = decoder.frameBufferAtIndex(0);
+    ImageFrame* frame1 = decoder.frameBufferAtIndex(1);
+    ASSERT_EQ(ImageFrame::FrameComplete, frame1->status());
+    decoder.clearFrameBuffer(0);
+    decoder.clearFrameBuffer(1);
+    EXPECT_EQ(ImageFrame::FrameEmpty, frame0->status());
+    EXPECT_EQ(ImageFrame::FrameComplete, frame1->status());
+
+    Vector<ImageFrame::PixelData> frame2Pixels = pixels(decoder.frameBufferAtIndex(2), 4, 4);
+    ASSERT_EQ(16u, frame2Pixels.size());
+    EXPECT_EQ(0xFFFFFFFFu, frame2Pixels[0]);
+    EXPECT_EQ(0xFFFF0000u, frame2Pixels[3]);
+    EXPECT_EQ(0xFF000000u, frame2Pixels[12]);
+    EXPECT_EQ(ImageFrame::FrameEmpty, frame0->status());
+}
+
+} // namespace TestWebKitAPI
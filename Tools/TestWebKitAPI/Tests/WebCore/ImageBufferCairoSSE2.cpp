@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2014 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <WebCore/ImageBufferCairoSSE2.h>
+#include <wtf/Vector.h>
+
+#if USE(CAIRO) && HAVE(SSE2_INTRINSICS)
+
+using namespace WebCore;
+
+namespace TestWebKitAPI {
+
+// Every pair of color and alpha values, in two layouts: with the alpha changing every fourth pixel,
+// groups of four pixels share their alpha, so opaque groups take the fast path. With the alpha
+// changing every pixel, all groups mix alpha values. The green and blue channels get other colors
+// than red, so that swapped channels are noticed.
+static const unsigned pixelCount = 256 * 256;
+
+static void colorAndAlphaForPixel(unsigned pixel, bool alphaChangesEveryPixel, unsigned& color, unsigned& alpha)
+{
+    if (alphaChangesEveryPixel) {
+        alpha = pixel & 0xFF;
+        color = pixel >> 8;
+    } else {
+        alpha = pixel >> 8;
+        color = pixel & 0xFF;
+    }
+}
+
+static uint32_t argb32Pixel(unsigned pixel, bool alphaChangesEveryPixel)
+{
+    unsigned color;
+    unsigned alpha;
+    colorAndAlphaForPixel(pixel, alphaChangesEveryPixel, color, alpha);
+    return alpha << 24 | color << 16 | (255 - color) << 8 | (color * 7 & 0xFF);
+}
+
+// The scalar conversions in ImageBufferCairo.cpp.
+static unsigned unpremultipliedChannel(unsigned channel, unsigned alpha)
+{
+    if (!alpha || alpha == 255)
+        return channel;
+    return std::min(channel * 255 / alpha, 255u);
+}
+
+static unsigned premultipliedChannel(unsigned channel, unsigned alpha)
+{
+    if (alpha == 255)
+        return channel;
+    return (channel * alpha + 254) / 255;
+}
+
+static void testARGB32ToRGBA(bool alphaChangesEveryPixel, bool unpremultiply)
+{
+    Vector<uint32_t> source(pixelCount);
+    for (unsigned i = 0; i < pixelCount; ++i)
+        source[i] = argb32Pixel(i, alphaChangesEveryPixel);
+
+    Vector<unsigned char> destination(pixelCount * 4);
+    ASSERT_EQ(static_cast<int>(pixelCount), copyARGB32ToRGBASSE2(source.data(), destination.data(), pixelCount, unpremultiply));
+
+    for (unsigned i = 0; i < pixelCount; ++i) {
+        unsigned alpha = source[i] >> 24;
+        unsigned expected[4] = { source[i] >> 16 & 0xFF, source[i] >> 8 & 0xFF, source[i] & 0xFF, alpha };
+        if (unpremultiply) {
+            for (unsigned channel = 0; channel < 3; ++channel)
+                expected[channel] = unpremultipliedChannel(expected[channel], alpha);
+        }
+        for (unsigned channel = 0; channel < 4; ++channel) {
+            if (destination[i * 4 + channel] != expected[channel]) {
+                ADD_FAILURE() << "Pixel 0x" << std::hex << source[i] << std::dec << " channel " << channel
+                    << " is " << static_cast<unsigned>(destination[i * 4 + channel]) << ", expected " << expected[channel];
+                return;
+            }
+        }
+    }
+}
+
+static void testRGBAToARGB32(bool alphaChangesEveryPixel, bool premultiply)
+{
+    Vector<unsigned char> source(pixelCount * 4);
+    for (unsigned i = 0; i < pixelCount; ++i) {
+        uint32_t pixel = argb32Pixel(i, alphaChangesEveryPixel);
+        source[i * 4] = pixel >> 16 & 0xFF;
+        source[i * 4 + 1] = pixel >> 8 & 0xFF;
+        source[i * 4 + 2] = pixel & 0xFF;
+        source[i * 4 + 3] = pixel >> 24;
+    }
+
+    Vector<uint32_t> destination(pixelCount);
+    ASSERT_EQ(static_cast<int>(pixelCount), copyRGBAToARGB32SSE2(source.data(), destination.data(), pixelCount, premultiply));
+
+    for (unsigned i = 0; i < pixelCount; ++i) {
+        const unsigned char* pixel = source.data() + i * 4;
+        unsigned alpha = pixel[3];
+        unsigned red = premultiply ? premultipliedChannel(pixel[0], alpha) : pixel[0];
+        unsigned green = premultiply ? premultipliedChannel(pixel[1], alpha) : pixel[1];
+        unsigned blue = premultiply ? premultipliedChannel(pixel[2], alpha) : pixel[2];
+        uint32_t expected = alpha << 24 | red << 16 | green << 8 | blue;
+        if (destination[i] != expected) {
+            ADD_FAILURE() << std::hex << "Pixel R " << static_cast<unsigned>(pixel[0]) << " G " << static_cast<unsigned>(pixel[1])
+                << " B " << static_cast<unsigned>(pixel[2]) << " A " << alpha << " is 0x" << destination[i] << ", expected 0x" << expected;
+            return;
+        }
+    }
+}
+
+TEST(WebCoreImageBufferCairoSSE2, Unpremultiply)
+{
+    testARGB32ToRGBA(false, true);
+    testARGB32ToRGBA(true, true);
+}
+
+TEST(WebCoreImageBufferCairoSSE2, CopyPremultipliedToRGBA)
+{
+    testARGB32ToRGBA(false, false);
+    testARGB32ToRGBA(true, false);
+}
+
+TEST(WebCoreImageBufferCairoSSE2, Premultiply)
+{
+    testRGBAToARGB32(false, true);
+    testRGBAToARGB32(true, true);
+}
+
+TEST(WebCoreImageBufferCairoSSE2, CopyPremultipliedToARGB32)
+{
+    testRGBAToARGB32(false, false);
+    testRGBAToARGB32(true, false);
+}
+
+TEST(WebCoreImageBufferCairoSSE2, LeftoverPixels)
+{
+    // Only whole groups of four pixels are converted, the scalar code does the rest.
+    Vector<uint32_t> source(7);
+    Vector<unsigned char> destination(7 * 4);
+    for (int count = 0; count < 7; ++count)
+        EXPECT_EQ(count / 4 * 4, copyARGB32ToRGBASSE2(source.data(), destination.data(), count, true));
+
+    Vector<uint32_t> converted(7);
+    for (int count = 0; count < 7; ++count)
+        EXPECT_EQ(count / 4 * 4, copyRGBAToARGB32SSE2(destination.data(), converted.data(), count, true));
+}
+
+} // namespace TestWebKitAPI
+
+#endif // USE(CAIRO) && HAVE(SSE2_INTRINSICS)
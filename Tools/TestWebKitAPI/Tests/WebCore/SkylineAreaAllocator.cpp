@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2014 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <WebCore/AreaAllocator.h>
+#include <random>
+
+#if USE(COORDINATED_GRAPHICS)
+
+using namespace WebCore;
+
+namespace TestWebKitAPI {
+
+static void expectInBoundsAndDisjoint(const Vector<IntRect>& rects, const IntSize& size)
+{
+    IntRect bounds(IntPoint(), size);
+    for (size_t i = 0; i < rects.size(); ++i) {
+        EXPECT_TRUE(bounds.contains(rects[i])) << "Rect " << i << " is outside of the allocator";
+        for (size_t j = i + 1; j < rects.size(); ++j)
+            EXPECT_FALSE(rects[i].intersects(rects[j])) << "Rects " << i << " and " << j << " overlap";
+    }
+}
+
+static Vector<IntRect> allocateRandomRects(SkylineAreaAllocator& allocator, unsigned seed, int maximumDimension)
+{
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<int> dimension(1, maximumDimension);
+
+    // Keep allocating until a few allocations in a row fail.
+    Vector<IntRect> rects;
+    for (unsigned failures = 0; failures < 20;) {
+        IntSize size(dimension(random), dimension(random));
+        IntRect rect = allocator.allocate(size);
+        if (rect.isEmpty()) {
+            ++failures;
+            continue;
+        }
+        EXPECT_TRUE(rect.size() == size);
+        rects.append(rect);
+    }
+    return rects;
+}
+
+TEST(WebCoreSkylineAreaAllocator, AllocationsDoNotOverlap)
+{
+    IntSize size(256, 256);
+    SkylineAreaAllocator allocator(size);
+    EXPECT_TRUE(allocator.isEmpty());
+
+    Vector<IntRect> rects = allocateRandomRects(allocator, 1, 40);
+    ASSERT_FALSE(rects.isEmpty());
+    expectInBoundsAndDisjoint(rects, size);
+
+    int area = 0;
+    for (auto& rect : rects)
+        area += rect.width() * rect.height();
+    EXPECT_EQ(area, allocator.allocatedArea());
+    EXPECT_LE(area, size.width() * size.height());
+}
+
+TEST(WebCoreSkylineAreaAllocator, Bounds)
+{
+    SkylineAreaAllocator allocator(IntSize(100, 50));
+
+    EXPECT_TRUE(allocator.allocate(IntSize(101, 1)).isEmpty());
+    EXPECT_TRUE(allocator.allocate(IntSize(1, 51)).isEmpty());
+    EXPECT_TRUE(allocator.allocate(IntSize(0, 10)).isEmpty());
+    EXPECT_TRUE(allocator.allocate(IntSize(10, 0)).isEmpty());
+    EXPECT_TRUE(allocator.isEmpty());
+
+    // Rects that exactly fill the allocator all fit, and nothing fits after them.
+    EXPECT_TRUE(allocator.allocate(IntSize(60, 50)) == IntRect(0, 0, 60, 50));
+    EXPECT_TRUE(allocator.allocate(IntSize(40, 30)) == IntRect(60, 0, 40, 30));
+    EXPECT_TRUE(allocator.allocate(IntSize(40, 20)) == IntRect(60, 30, 40, 20));
+    EXPECT_TRUE(allocator.allocate(IntSize(1, 1)).isEmpty());
+    EXPECT_EQ(100 * 50, allocator.allocatedArea());
+}
+
+TEST(WebCoreSkylineAreaAllocator, Margin)
+{
+    // The margin is kept free to the right of and below each rect.
+    IntSize size(128, 128);
+    SkylineAreaAllocator allocator(size);
+    allocator.setMargin(IntSize(2, 2));
+
+    Vector<IntRect> rects = allocateRandomRects(allocator, 2, 30);
+    ASSERT_FALSE(rects.isEmpty());
+
+    Vector<IntRect> rectsWithMargin;
+    for (auto& rect : rects)
+        rectsWithMargin.append(IntRect(rect.location(), rect.size() + IntSize(2, 2)));
+    expectInBoundsAndDisjoint(rectsWithMargin, size);
+}
+
+TEST(WebCoreSkylineAreaAllocator, ClearAndReuse)
+{
+    IntSize size(200, 150);
+    SkylineAreaAllocator allocator(size);
+
+    Vector<IntRect> rects = allocateRandomRects(allocator, 3, 50);
+    ASSERT_FALSE(rects.isEmpty());
+    EXPECT_TRUE(allocator.allocate(size).isEmpty());
+
+    // Clearing frees the whole area, which can then be allocated at once.
+    allocator.clear();
+    EXPECT_TRUE(allocator.isEmpty());
+    EXPECT_EQ(0, allocator.allocatedArea());
+    EXPECT_TRUE(allocator.allocate(size) == IntRect(IntPoint(), size));
+
+    // The same allocations after a clear give the same rects.
+    allocator.clear();
+    Vector<IntRect> reusedRects = allocateRandomRects(allocator, 3, 50);
+    EXPECT_TRUE(reusedRects == rects);
+}
+
+TEST(WebCoreSkylineAreaAllocator, Expand)
+{
+    SkylineAreaAllocator allocator(IntSize(64, 64));
+    Vector<IntRect> rects = allocateRandomRects(allocator, 4, 16);
+
+    // Expanding keeps the existing rects and makes room for more.
+    allocator.expand(IntSize(128, 96));
+    EXPECT_TRUE(allocator.size() == IntSize(128, 96));
+    Vector<IntRect> moreRects = allocateRandomRects(allocator, 5, 16);
+    ASSERT_FALSE(moreRects.isEmpty());
+
+    rects.appendVector(moreRects);
+    expectInBoundsAndDisjoint(rects, allocator.size());
+}
+
+} // namespace TestWebKitAPI
+
+#endif // USE(COORDINATED_GRAPHICS)
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2014 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#if USE(TEXTURE_MAPPER)
+
+#include <WebCore/Color.h>
+#include <WebCore/FloatRect.h>
+#include <WebCore/Region.h>
+#include <WebCore/TextureMapperLayer.h>
+
+#if ENABLE(CSS_FILTERS)
+#include <WebCore/FilterOperations.h>
+#endif
+
+using namespace WebCore;
+
+namespace TestWebKitAPI {
+
+class DamageTestLayers {
+public:
+    DamageTestLayers()
+    {
+        m_root.setSize(FloatSize(800, 600));
+
+        // A static layer drawing a solid color, which has no backing store and no animations.
+        m_layer.setPosition(FloatPoint(10, 20));
+        m_layer.setSize(FloatSize(100, 50));
+        m_layer.setContentsRect(FloatRect(0, 0, 100, 50));
+        m_layer.setSolidColor(Color(255, 0, 0));
+        m_root.addChild(&m_layer);
+
+        // Drop the damage of the initial layer tree.
+        collectDamage();
+    }
+
+    TextureMapperLayer& layer() { return m_layer; }
+
+    Region collectDamage()
+    {
+        Region damage;
+        m_root.collectDamage(damage);
+        return damage;
+    }
+
+private:
+    TextureMapperLayer m_root;
+    TextureMapperLayer m_layer;
+};
+
+TEST(WebCoreTextureMapperLayer, NoDamageWithoutChanges)
+{
+    DamageTestLayers layers;
+    EXPECT_TRUE(layers.collectDamage().isEmpty());
+}
+
+TEST(WebCoreTextureMapperLayer, StaticOpacityChangeDamagesLayer)
+{
+    DamageTestLayers layers;
+
+    layers.layer().setOpacity(0.5);
+    EXPECT_TRUE(layers.collectDamage().bounds() == IntRect(10, 20, 100, 50));
+
+    // Setting the same opacity again is not a change.
+    layers.layer().setOpacity(0.5);
+    EXPECT_TRUE(layers.collectDamage().isEmpty());
+}
+
+#if ENABLE(CSS_FILTERS)
+TEST(WebCoreTextureMapperLayer, StaticFilterChangeDamagesLayer)
+{
+    DamageTestLayers layers;
+
+    FilterOperations filters;
+    filters.operations().append(BasicColorMatrixFilterOperation::create(0.5, FilterOperation::GRAYSCALE));
+    layers.layer().setFilters(filters);
+    EXPECT_FALSE(layers.collectDamage().isEmpty());
+
+    layers.layer().setFilters(filters);
+    EXPECT_TRUE(layers.collectDamage().isEmpty());
+}
+#endif
+
+} // namespace TestWebKitAPI
+
+#endif // USE(TEXTURE_MAPPER)
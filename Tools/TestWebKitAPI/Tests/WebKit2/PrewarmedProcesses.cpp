@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2014 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "PlatformUtilities.h"
+#include "PlatformWebView.h"
+#include "Test.h"
+#include <WebKit/WKContextPrivate.h>
+#include <WebKit/WKNumber.h>
+#include <WebKit/WKRetainPtr.h>
+
+namespace TestWebKitAPI {
+
+static bool didGetStatistics;
+static bool didFirstVisuallyNonEmptyLayout;
+
+static void getStatisticsCallback(WKDictionaryRef statistics, WKErrorRef, void* functionContext)
+{
+    *static_cast<WKRetainPtr<WKDictionaryRef>*>(functionContext) = statistics;
+    didGetStatistics = true;
+}
+
+static WKRetainPtr<WKDictionaryRef> webContentStatistics(WKContextRef context)
+{
+    WKRetainPtr<WKDictionaryRef> statistics;
+    didGetStatistics = false;
+    WKContextGetStatisticsWithOptions(context, kWKStatisticsOptionsWebContent, &statistics, getStatisticsCallback);
+    Util::run(&didGetStatistics);
+    return statistics;
+}
+
+static uint64_t statisticForKey(WKDictionaryRef statistics, const char* key)
+{
+    WKTypeRef value = WKDictionaryGetItemForKey(statistics, Util::toWK(key).get());
+    EXPECT_NOT_NULL(value);
+    if (!value || WKGetTypeID(value) != WKUInt64GetTypeID())
+        return 0;
+    return WKUInt64GetValue(static_cast<WKUInt64Ref>(value));
+}
+
+static void didFirstVisuallyNonEmptyLayoutForFrame(WKPageRef, WKFrameRef frame, WKTypeRef, const void*)
+{
+    if (WKFrameIsMainFrame(frame))
+        didFirstVisuallyNonEmptyLayout = true;
+}
+
+TEST(WebKit2, PrewarmedProcesses)
+{
+    WKRetainPtr<WKContextRef> context = adoptWK(WKContextCreate());
+    WKContextSetProcessModel(context.get(), kWKProcessModelMultipleSecondaryProcesses);
+
+    EXPECT_EQ(0u, WKContextGetPrewarmedProcessCount(context.get()));
+    WKContextSetPrewarmedProcessCount(context.get(), 1);
+    EXPECT_EQ(1u, WKContextGetPrewarmedProcessCount(context.get()));
+
+    // The pool is filled from a timer. Until it fires, the context has no process and the request fails.
+    WKRetainPtr<WKDictionaryRef> statistics = webContentStatistics(context.get());
+    while (!statistics || !statisticForKey(statistics.get(), "PrewarmedWebProcessCount"))
+        statistics = webContentStatistics(context.get());
+    EXPECT_EQ(1u, statisticForKey(statistics.get(), "PrewarmedWebProcessCount"));
+    EXPECT_EQ(0u, statisticForKey(statistics.get(), "PrewarmedWebProcessHitCount"));
+    EXPECT_EQ(0u, statisticForKey(statistics.get(), "FirstPaintCount"));
+
+    PlatformWebView webView(context.get());
+
+    WKPageLoaderClientV3 loaderClient;
+    memset(&loaderClient, 0, sizeof(loaderClient));
+    loaderClient.base.version = 3;
+    loaderClient.didFirstVisuallyNonEmptyLayoutForFrame = didFirstVisuallyNonEmptyLayoutForFrame;
+    WKPageSetPageLoaderClient(webView.page(), &loaderClient.base);
+
+    WKPageLoadURL(webView.page(), adoptWK(Util::createURLForResource("lots-of-text", "html")).get());
+    Util::run(&didFirstVisuallyNonEmptyLayout);
+
+    statistics = webContentStatistics(context.get());
+    ASSERT_NOT_NULL(statistics.get());
+    EXPECT_EQ(1u, statisticForKey(statistics.get(), "PrewarmedWebProcessHitCount"));
+    EXPECT_EQ(0u, statisticForKey(statistics.get(), "PrewarmedWebProcessMissCount"));
+    EXPECT_LE(1u, statisticForKey(statistics.get(), "WebProcessLaunchCount"));
+    EXPECT_EQ(1u, statisticForKey(statistics.get(), "FirstPaintCount"));
+}
+
+} // namespace TestWebKitAPI
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2014 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "PlatformUtilities.h"
+#include "PlatformWebView.h"
+#include <WebKit/WKContextPrivate.h>
+#include <WebKit/WKPreferencesRefPrivate.h>
+
+namespace TestWebKitAPI {
+
+static bool didReceiveStatistics;
+static std::string statistics;
+
+static void didReceiveMessageFromInjectedBundle(WKContextRef, WKStringRef messageName, WKTypeRef body, const void*)
+{
+    EXPECT_WK_STREQ("StyleResolverStatistics", messageName);
+    EXPECT_EQ(WKStringGetTypeID(), WKGetTypeID(body));
+
+    statistics = Util::toSTD(static_cast<WKStringRef>(body));
+    didReceiveStatistics = true;
+}
+
+static unsigned counter(const std::string& name)
+{
+    size_t position = statistics.find(", " + name + " ");
+    if (position == std::string::npos)
+        return 0;
+    return strtoul(statistics.c_str() + position + name.length() + 3, nullptr, 10);
+}
+
+static void loadFramesSharingStyleSheet(bool sharedMatchedPropertiesCacheEnabled)
+{
+    WKRetainPtr<WKContextRef> context = adoptWK(Util::createContextForInjectedBundleTest("SharedMatchedPropertiesCacheTest"));
+
+    WKContextInjectedBundleClientV0 injectedBundleClient;
+    memset(&injectedBundleClient, 0, sizeof(injectedBundleClient));
+    injectedBundleClient.base.version = 0;
+    injectedBundleClient.didReceiveMessageFromInjectedBundle = didReceiveMessageFromInjectedBundle;
+    WKContextSetInjectedBundleClient(context.get(), &injectedBundleClient.base);
+
+    // Both frames are file URLs, which are only same-origin with each other when file access from file URLs is allowed.
+    WKRetainPtr<WKPageGroupRef> pageGroup = adoptWK(WKPageGroupCreateWithIdentifier(Util::toWK("SharedMatchedPropertiesCachePageGroup").get()));
+    WKPreferencesRef preferences = WKPageGroupGetPreferences(pageGroup.get());
+    WKPreferencesSetFileAccessFromFileURLsAllowed(preferences, true);
+    WKPreferencesSetSharedMatchedPropertiesCacheEnabled(preferences, sharedMatchedPropertiesCacheEnabled);
+
+    PlatformWebView webView(context.get(), pageGroup.get());
+
+    didReceiveStatistics = false;
+    WKPageLoadURL(webView.page(), adoptWK(Util::createURLForResource("shared-matched-properties-cache", "html")).get());
+    Util::run(&didReceiveStatistics);
+}
+
+TEST(WebKit2, SharedMatchedPropertiesCache)
+{
+    loadFramesSharingStyleSheet(true);
+
+    // The second frame adopts the cache of the first one, as both use the same style sheet.
+    EXPECT_LE(1u, counter("adoptions"));
+}
+
+TEST(WebKit2, SharedMatchedPropertiesCacheDisabled)
+{
+    loadFramesSharingStyleSheet(false);
+
+    EXPECT_NE(std::string::npos, statistics.find(", adoptions 0"));
+}
+
+} // namespace TestWebKitAPI
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2014 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "InjectedBundleTest.h"
+
+#include "PlatformUtilities.h"
+#include <WebKit/WKBundleFrame.h>
+#include <WebKit/WKBundlePage.h>
+#include <WebKit/WKBundlePrivate.h>
+#include <WebKit/WKRetainPtr.h>
+
+namespace TestWebKitAPI {
+
+class SharedMatchedPropertiesCacheTest : public InjectedBundleTest {
+public:
+    SharedMatchedPropertiesCacheTest(const std::string& identifier);
+
+private:
+    virtual void didCreatePage(WKBundleRef, WKBundlePageRef) override;
+};
+
+static InjectedBundleTest::Register<SharedMatchedPropertiesCacheTest> registrar("SharedMatchedPropertiesCacheTest");
+
+static WKBundleRef testBundle;
+
+SharedMatchedPropertiesCacheTest::SharedMatchedPropertiesCacheTest(const std::string& identifier)
+    : InjectedBundleTest(identifier)
+{
+}
+
+static void didFinishLoadForFrame(WKBundlePageRef, WKBundleFrameRef frame, WKTypeRef*, const void*)
+{
+    // The main frame finishes loading after both of its subframes.
+    if (!WKBundleFrameIsMainFrame(frame))
+        return;
+
+    WKBundlePostMessage(testBundle, Util::toWK("StyleResolverStatistics").get(), adoptWK(WKBundleCopyStyleResolverStatistics(testBundle)).get());
+}
+
+void SharedMatchedPropertiesCacheTest::didCreatePage(WKBundleRef bundle, WKBundlePageRef page)
+{
+    testBundle = bundle;
+    WKBundleResetStyleResolverStatistics(bundle);
+
+    WKBundlePageLoaderClientV1 pageLoaderClient;
+    memset(&pageLoaderClient, 0, sizeof(pageLoaderClient));
+
+    pageLoaderClient.base.version = 1;
+    pageLoaderClient.didFinishLoadForFrame = didFinishLoadForFrame;
+
+    WKBundlePageSetPageLoaderClient(page, &pageLoaderClient.base);
+}
+
+} // namespace TestWebKitAPI
@@ -257,6 +257,7 @@ void InjectedBundle::beginTesting(WKDictionaryRef settings)
     WKBundleSetAlwaysAcceptCookies(m_bundle, false);
     WKBundleSetSerialLoadingEnabled(m_bundle, false);
     WKBundleSetCacheModel(m_bundle, 1 /*CacheModelDocumentBrowser*/);
+    WKBundleResetStyleResolverStatistics(m_bundle);
 
     WKBundleRemoveAllUserContent(m_bundle, m_pageGroup);
 
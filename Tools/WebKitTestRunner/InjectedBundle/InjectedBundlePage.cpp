@@ -870,6 +870,11 @@ void InjectedBundlePage::dump()
     if (InjectedBundle::shared().testRunner()->shouldDumpBackForwardListsForAllWindows())
         InjectedBundle::shared().dumpBackForwardListsForAllPages(stringBuilder);
 
+    if (InjectedBundle::shared().testRunner()->shouldDumpStyleResolverStatistics()) {
+        stringBuilder.appendLiteral("\nStyle resolver statistics:\n");
+        stringBuilder.append(toWTFString(adoptWK(WKBundleCopyStyleResolverStatistics(InjectedBundle::shared().bundle()))));
+    }
+
     if (InjectedBundle::shared().shouldDumpPixels() && InjectedBundle::shared().testRunner()->shouldDumpPixels()) {
         WKSnapshotOptions options = kWKSnapshotOptionsShareable | kWKSnapshotOptionsInViewCoordinates;
         if (InjectedBundle::shared().testRunner()->shouldDumpSelectionRect())
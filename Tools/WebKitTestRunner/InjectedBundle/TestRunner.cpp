@@ -70,6 +70,7 @@ TestRunner::TestRunner()
     , m_shouldCloseExtraWindows(false)
     , m_dumpEditingCallbacks(false)
     , m_dumpStatusCallbacks(false)
+    , m_dumpStyleResolverStatistics(false)
     , m_dumpTitleChanges(false)
     , m_dumpPixels(true)
     , m_dumpSelectionRect(false)
@@ -69,6 +69,7 @@ public:
     void dumpEditingCallbacks() { m_dumpEditingCallbacks = true; }
     void dumpSelectionRect() { m_dumpSelectionRect = true; }
     void dumpStatusCallbacks() { m_dumpStatusCallbacks = true; }
+    void dumpStyleResolverStatistics() { m_dumpStyleResolverStatistics = true; }
     void dumpTitleChanges() { m_dumpTitleChanges = true; }
     void dumpFullScreenCallbacks() { m_dumpFullScreenCallbacks = true; }
     void dumpFrameLoadCallbacks() { setShouldDumpFrameLoadCallbacks(true); }
@@ -165,6 +166,7 @@ public:
     bool shouldDumpEditingCallbacks() const { return m_dumpEditingCallbacks; }
     bool shouldDumpMainFrameScrollPosition() const { return m_whatToDump == RenderTree; }
     bool shouldDumpStatusCallbacks() const { return m_dumpStatusCallbacks; }
+    bool shouldDumpStyleResolverStatistics() const { return m_dumpStyleResolverStatistics; }
     bool shouldDumpTitleChanges() const { return m_dumpTitleChanges; }
     bool shouldDumpPixels() const { return m_dumpPixels; }
     bool shouldDumpFullScreenCallbacks() const { return m_dumpFullScreenCallbacks; }
@@ -290,6 +292,7 @@ private:
 
     bool m_dumpEditingCallbacks;
     bool m_dumpStatusCallbacks;
+    bool m_dumpStyleResolverStatistics;
     bool m_dumpTitleChanges;
     bool m_dumpPixels;
     bool m_dumpSelectionRect;
@@ -594,7 +594,9 @@ int WINAPI wWinMain(HINSTANCE, HINSTANCE, PWSTR, int nCmdShow)
     viewClient.base.version = 0;
     viewClient.base.clientInfo = 0;
     viewClient.viewNeedsDisplay = [] (WKViewRef view, WKRect area, const void* clientInfo) {
-        ::InvalidateRect(gViewWindow, NULL, FALSE);
+        RECT rect = { static_cast<LONG>(area.origin.x), static_cast<LONG>(area.origin.y),
+            static_cast<LONG>(area.origin.x + area.size.width), static_cast<LONG>(area.origin.y + area.size.height) };
+        ::InvalidateRect(gViewWindow, &rect, FALSE);
     };
 
     WKViewSetViewClient(gWKView, &viewClient.base);